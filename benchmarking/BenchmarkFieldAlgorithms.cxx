@@ -19,12 +19,16 @@
 #include <vtkm/cont/Invoker.h>
 #include <vtkm/cont/Timer.h>
 
+#include <vtkm/worklet/AverageByKey.h>
+#include <vtkm/worklet/Keys.h>
 #include <vtkm/worklet/WorkletMapField.h>
 #include <vtkm/worklet/WorkletMapTopology.h>
 
 #include "Benchmarker.h"
 
+#include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <random>
 #include <string>
 #include <utility>
@@ -185,6 +189,22 @@ public:
   }
 };
 
+// Simple arithmetic called on batches of Width lanes on the host devices.
+template <vtkm::IdComponent Width>
+class BatchedMag : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = _2(_1);
+  using BatchLanes = vtkm::worklet::BatchWidth<Width>;
+
+  template <typename T>
+  VTKM_EXEC T operator()(const vtkm::Vec<T, 3>& vec) const
+  {
+    return vtkm::Sqrt(vtkm::Dot(vec, vec));
+  }
+};
+
 class GenerateEdges : public vtkm::worklet::WorkletVisitCellsWithPoints
 {
 public:
@@ -624,6 +644,67 @@ void BenchFusedMathMultiplexerN(::benchmark::State& state)
 };
 VTKM_BENCHMARK_TEMPLATES(BenchFusedMathMultiplexerN, ValueTypes);
 
+template <typename Value, vtkm::IdComponent Width>
+void BenchBatchedMagImpl(::benchmark::State& state)
+{
+  const vtkm::cont::DeviceAdapterId device = Config.Device;
+  const vtkm::Id arraySize = ARRAY_SIZE;
+
+  vtkm::cont::ArrayHandle<vtkm::Vec<Value, 3>> input;
+  {
+    std::mt19937 rng;
+    std::uniform_real_distribution<Value> range;
+    input.Allocate(arraySize);
+    auto portal = input.WritePortal();
+    for (vtkm::Id i = 0; i < arraySize; ++i)
+    {
+      portal.Set(i, vtkm::Vec<Value, 3>{ range(rng), range(rng), range(rng) });
+    }
+  }
+  vtkm::cont::ArrayHandle<Value> result;
+
+  {
+    const vtkm::Id numBytes = arraySize * static_cast<vtkm::Id>(4 * sizeof(Value));
+    std::ostringstream desc;
+    desc << "NumValues:" << arraySize << " (" << vtkm::cont::GetHumanReadableSize(numBytes)
+         << ") Lanes:" << Width;
+    state.SetLabel(desc.str());
+  }
+
+  vtkm::cont::Timer timer{ device };
+  vtkm::cont::Invoker invoker{ device };
+
+  for (auto _ : state)
+  {
+    (void)_;
+    timer.Start();
+    invoker(BatchedMag<Width>{}, input, result);
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+
+  const int64_t iterations = static_cast<int64_t>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(arraySize) * iterations);
+  state.SetBytesProcessed(static_cast<int64_t>(arraySize) * iterations *
+                          static_cast<int64_t>(4 * sizeof(Value)));
+}
+
+// Compares calling a worklet on one value at a time with calling it on batches of lanes.
+template <typename ValueType>
+void BenchMagnitudeSingleLane(::benchmark::State& state)
+{
+  BenchBatchedMagImpl<ValueType, 1>(state);
+}
+VTKM_BENCHMARK_TEMPLATES(BenchMagnitudeSingleLane, ValueTypes);
+
+template <typename ValueType>
+void BenchMagnitudeBatchedLanes(::benchmark::State& state)
+{
+  BenchBatchedMagImpl<ValueType, 8>(state);
+}
+VTKM_BENCHMARK_TEMPLATES(BenchMagnitudeBatchedLanes, ValueTypes);
+
 template <typename Value>
 struct BenchEdgeInterpImpl
 {
@@ -816,6 +897,112 @@ void Bench2ImplicitFunctions(::benchmark::State& state)
 }
 VTKM_BENCHMARK(Bench2ImplicitFunctions);
 
+// Bins random points in a grid with about 4 points per bin, the way point merging and vertex
+// clustering do, and returns the bin of each point along with a point field.
+struct KeysBenchData
+{
+  vtkm::cont::ArrayHandle<vtkm::Id3> BinIds;
+  vtkm::cont::ArrayHandle<vtkm::Float32> Values;
+};
+
+static KeysBenchData MakeKeysBenchData(vtkm::Id numPoints)
+{
+  const vtkm::Id binsPerAxis = std::max(
+    static_cast<vtkm::Id>(std::cbrt(static_cast<vtkm::Float64>(numPoints) / 4.0)), vtkm::Id(1));
+
+  KeysBenchData data;
+  data.BinIds.Allocate(numPoints);
+  data.Values.Allocate(numPoints);
+
+  std::mt19937 rng;
+  std::uniform_int_distribution<vtkm::Id> binRange(0, binsPerAxis - 1);
+  std::uniform_real_distribution<vtkm::Float32> valueRange;
+  auto binPortal = data.BinIds.WritePortal();
+  auto valuePortal = data.Values.WritePortal();
+  for (vtkm::Id i = 0; i < numPoints; ++i)
+  {
+    binPortal.Set(i, vtkm::Id3{ binRange(rng), binRange(rng), binRange(rng) });
+    valuePortal.Set(i, valueRange(rng));
+  }
+  return data;
+}
+
+static std::string KeysSortTypeName(vtkm::worklet::KeysSortType sortType)
+{
+  switch (sortType)
+  {
+    case vtkm::worklet::KeysSortType::Unstable:
+      return "Unstable";
+    case vtkm::worklet::KeysSortType::Stable:
+      return "Stable";
+    case vtkm::worklet::KeysSortType::Hashed:
+      return "Hashed";
+  }
+  return "Unknown";
+}
+
+// Measures building the keys, and optionally averaging a field over them as AverageByKey does.
+void BenchKeysImpl(::benchmark::State& state, bool average)
+{
+  const vtkm::cont::DeviceAdapterId device = Config.Device;
+  const auto sortType = static_cast<vtkm::worklet::KeysSortType>(state.range(0));
+  const vtkm::Id numPoints = static_cast<vtkm::Id>(state.range(1));
+
+  KeysBenchData data = MakeKeysBenchData(numPoints);
+  vtkm::cont::ArrayHandle<vtkm::Float32> averages;
+
+  {
+    std::ostringstream desc;
+    desc << KeysSortTypeName(sortType) << " | " << numPoints << " points";
+    state.SetLabel(desc.str());
+  }
+
+  vtkm::cont::Timer timer{ device };
+  for (auto _ : state)
+  {
+    (void)_;
+    timer.Start();
+    vtkm::worklet::Keys<vtkm::Id3> keys;
+    keys.BuildArrays(data.BinIds, sortType, device);
+    if (average)
+    {
+      vtkm::worklet::AverageByKey::Run(keys, data.Values, averages);
+    }
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+
+  const int64_t iterations = static_cast<int64_t>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(numPoints) * iterations);
+}
+
+void BenchKeysGenerator(::benchmark::internal::Benchmark* bm)
+{
+  bm->ArgNames({ "SortType", "NumPoints" });
+  for (int64_t numPoints : { int64_t{ 1 } << 20, int64_t{ 1 } << 23 })
+  {
+    for (auto sortType : { vtkm::worklet::KeysSortType::Unstable,
+                           vtkm::worklet::KeysSortType::Stable,
+                           vtkm::worklet::KeysSortType::Hashed })
+    {
+      bm->Args({ static_cast<int64_t>(sortType), numPoints });
+    }
+  }
+}
+
+void BenchKeysBuild(::benchmark::State& state)
+{
+  BenchKeysImpl(state, false);
+}
+VTKM_BENCHMARK_APPLY(BenchKeysBuild, BenchKeysGenerator);
+
+void BenchKeysAverage(::benchmark::State& state)
+{
+  BenchKeysImpl(state, true);
+}
+VTKM_BENCHMARK_APPLY(BenchKeysAverage, BenchKeysGenerator);
+
 } // end anon namespace
 
 int main(int argc, char* argv[])
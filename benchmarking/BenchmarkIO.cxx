@@ -0,0 +1,137 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include "Benchmarker.h"
+
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/RuntimeDeviceTracker.h>
+#include <vtkm/cont/Timer.h>
+
+#include <vtkm/filter/geometry_refinement/Tetrahedralize.h>
+
+#include <vtkm/io/VTKDataSetReader.h>
+#include <vtkm/io/VTKDataSetWriter.h>
+
+#include <vtkm/source/Wavelet.h>
+
+#include <cstdio>
+#include <set>
+#include <sstream>
+#include <string>
+
+// Benchmarks of the legacy VTK readers. The input files are unstructured grids generated by
+// tetrahedralizing a wavelet. They are written to the working directory before the first
+// benchmark that needs them and removed at exit.
+
+namespace
+{
+
+// Make this global so benchmarks can access the current device id:
+vtkm::cont::InitializeResult Config;
+
+std::set<std::string> GeneratedFiles;
+
+std::string GetInputFile(vtkm::Id dim, bool binary)
+{
+  std::ostringstream fileName;
+  fileName << "BenchmarkIO-" << dim << (binary ? "-binary" : "-ascii") << ".vtk";
+  if (GeneratedFiles.find(fileName.str()) == GeneratedFiles.end())
+  {
+    vtkm::source::Wavelet source;
+    source.SetExtent(vtkm::Id3(0), vtkm::Id3(dim - 1));
+    vtkm::filter::geometry_refinement::Tetrahedralize tetrahedralize;
+    vtkm::cont::DataSet data = tetrahedralize.Execute(source.Execute());
+
+    vtkm::io::VTKDataSetWriter writer(fileName.str());
+    if (binary)
+    {
+      writer.SetFileTypeToBinary();
+    }
+    else
+    {
+      writer.SetFileTypeToAscii();
+    }
+    writer.WriteDataSet(data);
+    GeneratedFiles.insert(fileName.str());
+  }
+  return fileName.str();
+}
+
+void BenchReadVTK(::benchmark::State& state)
+{
+  const vtkm::Id dim = static_cast<vtkm::Id>(state.range(0));
+  const bool binary = static_cast<bool>(state.range(1));
+  const bool useMemoryMapping = static_cast<bool>(state.range(2));
+
+  const std::string fileName = GetInputFile(dim, binary);
+
+  vtkm::cont::Timer timer{ Config.Device };
+  vtkm::cont::DataSet result;
+  for (auto _ : state)
+  {
+    (void)_;
+    timer.Start();
+    vtkm::io::VTKDataSetReader reader(fileName);
+    reader.SetUseMemoryMapping(useMemoryMapping);
+    result = reader.ReadDataSet();
+    timer.Stop();
+
+    state.SetIterationTime(timer.GetElapsedTime());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(result.GetNumberOfCells()) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+void BenchReadVTKGenerator(::benchmark::internal::Benchmark* bm)
+{
+  bm->ArgNames({ "Dim", "Binary", "MemoryMapped" });
+  for (int64_t dim : { 32, 64 })
+  {
+    for (int binary = 0; binary < 2; ++binary)
+    {
+      bm->Args({ dim, binary, 0 });
+      bm->Args({ dim, binary, 1 });
+    }
+  }
+}
+
+VTKM_BENCHMARK_APPLY(BenchReadVTK, BenchReadVTKGenerator);
+
+} // end anon namespace
+
+int main(int argc, char* argv[])
+{
+  auto opts = vtkm::cont::InitializeOptions::RequireDevice;
+
+  std::vector<char*> args(argv, argv + argc);
+  vtkm::bench::detail::InitializeArgs(&argc, args, opts);
+
+  // Parse VTK-m options:
+  Config = vtkm::cont::Initialize(argc, args.data(), opts);
+
+  // This occurs when it is help
+  if (opts == vtkm::cont::InitializeOptions::None)
+  {
+    std::cout << Config.Usage << std::endl;
+  }
+  else
+  {
+    vtkm::cont::GetRuntimeDeviceTracker().ForceDevice(Config.Device);
+  }
+
+  // handle benchmarking related args and run benchmarks:
+  VTKM_EXECUTE_BENCHMARKS(argc, args.data());
+
+  for (const std::string& file : GeneratedFiles)
+  {
+    std::remove(file.c_str());
+  }
+}
@@ -36,6 +36,8 @@ vtkm::cont::InitializeResult Config;
 
 void BenchRayTracing(::benchmark::State& state)
 {
+  const bool packetTraversal = static_cast<bool>(state.range(0));
+
   vtkm::source::Tangle maker;
   maker.SetPointDimensions({ 128, 128, 128 });
   vtkm::cont::DataSet dataset = maker.Execute();
@@ -54,6 +56,7 @@ void BenchRayTracing(::benchmark::State& state)
     vtkm::rendering::raytracing::TriangleIntersector());
 
   vtkm::rendering::raytracing::RayTracer tracer;
+  triIntersector->SetPacketTraversal(packetTraversal);
   triIntersector->SetData(coords, triExtractor.GetTriangles());
   tracer.AddShapeIntersector(triIntersector);
 
@@ -105,7 +108,7 @@ void BenchRayTracing(::benchmark::State& state)
   }
 }
 
-VTKM_BENCHMARK(BenchRayTracing);
+VTKM_BENCHMARK_OPTS(BenchRayTracing, ->ArgName("PacketTraversal")->DenseRange(0, 1));
 
 } // end namespace vtkm::benchmarking
 
@@ -679,8 +679,8 @@ public:
   ///
   /// \warning After calling this method it is required to subsequently
   /// call a method like one of the `Prepare` methods that attaches the token
-  /// to this `ArrayHandle`. Otherwise, the enqueued token will block any subsequent
-  /// access to the `ArrayHandle`, even if the `Token` is destroyed.
+  /// to this `ArrayHandle` (or to call `Dequeue`). Otherwise, the enqueued token will block any
+  /// subsequent access to the `ArrayHandle`, even if the `Token` is destroyed.
   ///
   VTKM_CONT void Enqueue(const vtkm::cont::Token& token) const
   {
@@ -690,6 +690,19 @@ public:
     }
   }
 
+  /// \brief Remove a token from the queue of this ArrayHandle.
+  ///
+  /// This gives up the place in the queue taken with `Enqueue` when the token will not be
+  /// used to access the `ArrayHandle` after all. Nothing happens if the token is not in the queue.
+  ///
+  VTKM_CONT void Dequeue(const vtkm::cont::Token& token) const
+  {
+    for (auto&& buffer : this->Buffers)
+    {
+      buffer.Dequeue(token);
+    }
+  }
+
   /// \brief Deep copies the data in the array.
   ///
   /// Takes the data that is in \a source and copies that data into this array.
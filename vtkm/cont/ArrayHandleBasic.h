@@ -14,6 +14,7 @@
 #include <vtkm/cont/ArrayPortalToIterators.h>
 #include <vtkm/cont/SerializableTypeString.h>
 #include <vtkm/cont/Serialization.h>
+#include <vtkm/cont/SerializationCodec.h>
 #include <vtkm/cont/Storage.h>
 
 #include <vtkm/internal/ArrayPortalBasic.h>
@@ -332,14 +333,14 @@ struct Serialization<vtkm::cont::ArrayHandleBasic<T>>
   static VTKM_CONT void save(BinaryBuffer& bb,
                              const vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagBasic>& obj)
   {
-    vtkmdiy::save(bb, obj.GetBuffers()[0]);
+    vtkm::cont::internal::SaveEncodedBuffer<T>(bb, obj.GetBuffers()[0]);
   }
 
   static VTKM_CONT void load(BinaryBuffer& bb,
                              vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagBasic>& obj)
   {
     vtkm::cont::internal::Buffer buffer;
-    vtkmdiy::load(bb, buffer);
+    vtkm::cont::internal::LoadEncodedBuffer(bb, buffer);
 
     obj = vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagBasic>(
       vtkm::cont::internal::CreateBuffers(buffer));
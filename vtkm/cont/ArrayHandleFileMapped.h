@@ -0,0 +1,86 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_ArrayHandleFileMapped_h
+#define vtk_m_cont_ArrayHandleFileMapped_h
+
+#include <vtkm/cont/ArrayHandleBasic.h>
+#include <vtkm/cont/vtkm_cont_export.h>
+
+#include <string>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// How `make_ArrayHandleFileMapped` maps a file.
+enum struct FileMapMode
+{
+  /// Maps an existing file. Values written to the array are kept in memory and never make it
+  /// back to the file.
+  Read,
+  /// Maps an existing file. Values written to the array are written to the file.
+  ReadWrite,
+  /// Creates the file (or truncates an existing one) with room for the requested values and maps
+  /// it. Values written to the array are written to the file.
+  Create
+};
+
+namespace internal
+{
+
+/// \brief Maps `numBytes` of a file into host memory.
+///
+/// When `numBytes` is negative, the whole file is mapped. Throws `vtkm::cont::ErrorBadValue` if
+/// the file cannot be mapped.
+///
+VTKM_CONT_EXPORT VTKM_CONT vtkm::cont::internal::BufferInfo MapFile(const std::string& fileName,
+                                                                    vtkm::cont::FileMapMode mode,
+                                                                    vtkm::BufferSizeType numBytes);
+
+} // namespace internal
+
+/// \brief Creates a basic array whose host memory is a memory-mapped file.
+///
+/// The array holds values of type `T` stored in native byte order from the start of the file.
+/// When `numberOfValues` is negative, the size is taken from the file. `FileMapMode::Create`
+/// requires the number of values. The pages of the file are only read when they are first
+/// touched, so arrays larger than the physical memory can be used as long as the memory budget
+/// set with `vtkm::cont::internal::SetFileMappedMemoryBudget` evicts the pages no longer in use.
+/// Resizing an array mapped with `FileMapMode::ReadWrite` or `FileMapMode::Create` resizes the
+/// file.
+///
+/// The returned array is an `ArrayHandleBasic`, so it can be used by every filter without
+/// compiling anything else. Devices that do not share memory with the host copy the data as
+/// they would for any other array.
+///
+template <typename T>
+VTKM_CONT vtkm::cont::ArrayHandleBasic<T> make_ArrayHandleFileMapped(
+  const std::string& fileName,
+  vtkm::cont::FileMapMode mode = vtkm::cont::FileMapMode::Read,
+  vtkm::Id numberOfValues = -1)
+{
+  const vtkm::BufferSizeType numBytes = (numberOfValues < 0)
+    ? -1
+    : vtkm::internal::NumberOfValuesToNumberOfBytes<T>(numberOfValues);
+  vtkm::cont::internal::TransferredBuffer buffer =
+    vtkm::cont::internal::MapFile(fileName, mode, numBytes).TransferOwnership();
+  return vtkm::cont::ArrayHandleBasic<T>(
+    reinterpret_cast<T*>(buffer.Memory),
+    buffer.Container,
+    static_cast<vtkm::Id>(buffer.Size / static_cast<vtkm::BufferSizeType>(sizeof(T))),
+    buffer.Delete,
+    buffer.Reallocate);
+}
+
+}
+} // namespace vtkm::cont
+
+#endif //vtk_m_cont_ArrayHandleFileMapped_h
@@ -12,6 +12,7 @@
 
 #include <vtkm/cont/ArrayExtractComponent.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/SerializationCodec.h>
 
 #include <vtkm/Math.h>
 #include <vtkm/VecTraits.h>
@@ -518,13 +519,14 @@ template <typename ValueType>
 struct Serialization<vtkm::cont::ArrayHandleSOA<ValueType>>
 {
   using BaseType = vtkm::cont::ArrayHandle<ValueType, vtkm::cont::StorageTagSOA>;
+  using ComponentType = typename vtkm::VecTraits<ValueType>::ComponentType;
   static constexpr vtkm::IdComponent NUM_COMPONENTS = vtkm::VecTraits<ValueType>::NUM_COMPONENTS;
 
   static VTKM_CONT void save(BinaryBuffer& bb, const BaseType& obj)
   {
     for (vtkm::IdComponent componentIndex = 0; componentIndex < NUM_COMPONENTS; ++componentIndex)
     {
-      vtkmdiy::save(bb, obj.GetBuffers()[componentIndex]);
+      vtkm::cont::internal::SaveEncodedBuffer<ComponentType>(bb, obj.GetBuffers()[componentIndex]);
     }
   }
 
@@ -533,7 +535,7 @@ struct Serialization<vtkm::cont::ArrayHandleSOA<ValueType>>
     std::vector<vtkm::cont::internal::Buffer> buffers(NUM_COMPONENTS);
     for (std::size_t componentIndex = 0; componentIndex < NUM_COMPONENTS; ++componentIndex)
     {
-      vtkmdiy::load(bb, buffers[componentIndex]);
+      vtkm::cont::internal::LoadEncodedBuffer(bb, buffers[componentIndex]);
     }
     obj = BaseType(buffers);
   }
@@ -423,7 +423,7 @@ public:
     vtkmdiy::save(bb, obj.GetOffset());
     vtkmdiy::save(bb, obj.GetModulo());
     vtkmdiy::save(bb, obj.GetDivisor());
-    vtkmdiy::save(bb, obj.GetBuffers()[1]);
+    vtkm::cont::internal::SaveEncodedBuffer<T>(bb, obj.GetBuffers()[1]);
   }
 
   static VTKM_CONT void load(BinaryBuffer& bb, BaseType& obj)
@@ -440,9 +440,9 @@ public:
     vtkmdiy::load(bb, offset);
     vtkmdiy::load(bb, modulo);
     vtkmdiy::load(bb, divisor);
-    vtkmdiy::load(bb, buffer);
+    vtkm::cont::internal::LoadEncodedBuffer(bb, buffer);
 
-    obj = vtkm::cont::ArrayHandleStride<T>(buffer, stride, offset, modulo, divisor);
+    obj = vtkm::cont::ArrayHandleStride<T>(buffer, numValues, stride, offset, modulo, divisor);
   }
 };
 
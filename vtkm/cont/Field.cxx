@@ -18,20 +18,35 @@
 #include <vtkm/TypeList.h>
 
 #include <vtkm/cont/ArrayRangeCompute.h>
+#include <vtkm/cont/FieldStatisticsCompute.h>
+
+#include <mutex>
 
 namespace vtkm
 {
 namespace cont
 {
 
+struct Field::CacheStruct
+{
+  std::mutex Mutex;
+
+  bool HasRange = false;
+  std::vector<vtkm::UInt64> RangeVersions;
+  vtkm::cont::ArrayHandle<vtkm::Range> Range;
+
+  bool HasStatistics = false;
+  std::vector<vtkm::UInt64> StatisticsVersions;
+  vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics> Statistics;
+};
+
 /// constructors for points / whole mesh
 VTKM_CONT
 Field::Field(std::string name, Association association, const vtkm::cont::UnknownArrayHandle& data)
   : Name(name)
   , FieldAssociation(association)
   , Data(data)
-  , Range()
-  , ModifiedFlag(true)
+  , Cache(std::make_shared<CacheStruct>())
 {
 }
 
@@ -40,8 +55,7 @@ Field::Field(const vtkm::cont::Field& src)
   : Name(src.Name)
   , FieldAssociation(src.FieldAssociation)
   , Data(src.Data)
-  , Range(src.Range)
-  , ModifiedFlag(src.ModifiedFlag)
+  , Cache(src.Cache)
 {
 }
 
@@ -50,8 +64,7 @@ Field::Field(vtkm::cont::Field&& src) noexcept
   : Name(std::move(src.Name))
   , FieldAssociation(std::move(src.FieldAssociation))
   , Data(std::move(src.Data))
-  , Range(std::move(src.Range))
-  , ModifiedFlag(std::move(src.ModifiedFlag))
+  , Cache(std::move(src.Cache))
 {
 }
 
@@ -61,8 +74,7 @@ Field& Field::operator=(const vtkm::cont::Field& src)
   this->Name = src.Name;
   this->FieldAssociation = src.FieldAssociation;
   this->Data = src.Data;
-  this->Range = src.Range;
-  this->ModifiedFlag = src.ModifiedFlag;
+  this->Cache = src.Cache;
   return *this;
 }
 
@@ -72,8 +84,7 @@ Field& Field::operator=(vtkm::cont::Field&& src) noexcept
   this->Name = std::move(src.Name);
   this->FieldAssociation = std::move(src.FieldAssociation);
   this->Data = std::move(src.Data);
-  this->Range = std::move(src.Range);
-  this->ModifiedFlag = std::move(src.ModifiedFlag);
+  this->Cache = std::move(src.Cache);
   return *this;
 }
 
@@ -120,23 +131,95 @@ const vtkm::cont::UnknownArrayHandle& Field::GetData() const
 VTKM_CONT
 vtkm::cont::UnknownArrayHandle& Field::GetData()
 {
-  this->ModifiedFlag = true;
+  // The array might be replaced through the returned reference.
+  this->DetachCache();
   return this->Data;
 }
 
+VTKM_CONT Field::CacheStruct& Field::GetCache() const
+{
+  // Default constructed and moved-from fields get their cache on first use.
+  if (!this->Cache)
+  {
+    this->Cache = std::make_shared<CacheStruct>();
+  }
+  return *this->Cache;
+}
+
+VTKM_CONT void Field::DetachCache()
+{
+  this->Cache = std::make_shared<CacheStruct>();
+}
+
+VTKM_CONT bool Field::HasCachedStatistics() const
+{
+  CacheStruct& cache = this->GetCache();
+  std::vector<vtkm::UInt64> versions = this->Data.GetBufferVersions();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  if (cache.HasStatistics && (cache.StatisticsVersions == versions))
+  {
+    this->Statistics = cache.Statistics;
+    return true;
+  }
+  return false;
+}
+
+VTKM_CONT void Field::SetCachedStatistics(
+  const std::vector<vtkm::UInt64>& versions,
+  const vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>& statistics,
+  const vtkm::cont::ArrayHandle<vtkm::Range>& ranges) const
+{
+  CacheStruct& cache = this->GetCache();
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  cache.HasStatistics = true;
+  cache.StatisticsVersions = versions;
+  cache.Statistics = statistics;
+  cache.HasRange = true;
+  cache.RangeVersions = versions;
+  cache.Range = ranges;
+  this->Statistics = statistics;
+  this->Range = ranges;
+}
+
 VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::Range>& Field::GetRange() const
 {
   VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "Field::GetRange");
 
-  if (this->ModifiedFlag)
+  CacheStruct& cache = this->GetCache();
+  // Take the versions before reading the data so that a concurrent write leaves the
+  // result tagged as out of date.
+  std::vector<vtkm::UInt64> versions = this->Data.GetBufferVersions();
   {
-    this->Range = vtkm::cont::ArrayRangeCompute(this->Data);
-    this->ModifiedFlag = false;
+    std::lock_guard<std::mutex> lock(cache.Mutex);
+    if (cache.HasRange && (cache.RangeVersions == versions))
+    {
+      this->Range = cache.Range;
+      return this->Range;
+    }
   }
 
+  this->Range = vtkm::cont::ArrayRangeCompute(this->Data);
+
+  std::lock_guard<std::mutex> lock(cache.Mutex);
+  cache.HasRange = true;
+  cache.RangeVersions = std::move(versions);
+  cache.Range = this->Range;
   return this->Range;
 }
 
+VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>& Field::GetStatistics()
+  const
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "Field::GetStatistics");
+
+  if (!this->HasCachedStatistics())
+  {
+    vtkm::cont::internal::FieldStatisticsCache::Compute({ this });
+  }
+
+  return this->Statistics;
+}
+
 VTKM_CONT void Field::GetRange(vtkm::Range* range) const
 {
   this->GetRange();
@@ -151,7 +234,7 @@ VTKM_CONT void Field::GetRange(vtkm::Range* range) const
 VTKM_CONT void Field::SetData(const vtkm::cont::UnknownArrayHandle& newdata)
 {
   this->Data = newdata;
-  this->ModifiedFlag = true;
+  this->DetachCache();
 }
 
 namespace
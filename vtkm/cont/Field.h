@@ -17,13 +17,21 @@
 
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/CastAndCall.h>
+#include <vtkm/cont/FieldStatistics.h>
 #include <vtkm/cont/UnknownArrayHandle.h>
 
+#include <memory>
+#include <vector>
+
 namespace vtkm
 {
 namespace cont
 {
 
+namespace internal
+{
+struct FieldStatisticsCache;
+}
 
 /// A \c Field encapsulates an array on some piece of the mesh, such as
 /// the points, a cell set, a point logical dimension, or the whole mesh.
@@ -86,10 +94,28 @@ public:
   const vtkm::cont::UnknownArrayHandle& GetData() const;
   vtkm::cont::UnknownArrayHandle& GetData();
 
+  /// \brief Get the range of each component of the field.
+  ///
+  /// The range is computed on the first call and kept for later calls. It is
+  /// shared by the copies of this field (such as the `CoordinateSystem`s
+  /// returned by a `DataSet`) until their data are replaced. The range is
+  /// recomputed when the array is written to through any handle, which is
+  /// detected with the version stamps of its buffers.
+  ///
   VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::Range>& GetRange() const;
 
   VTKM_CONT void GetRange(vtkm::Range* range) const;
 
+  /// \brief Get the statistics of each component of the field.
+  ///
+  /// The minimum, maximum, mean, variance, and number of NaN values of all the
+  /// components are computed together in one pass over the data. The result is
+  /// cached like the range, and the range is kept along with it so that a
+  /// following `GetRange` is free. To compute the statistics of many fields
+  /// at once, use `vtkm::cont::FieldStatisticsCompute`.
+  ///
+  VTKM_CONT const vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>& GetStatistics() const;
+
   /// \brief Get the data as an array with `vtkm::FloatDefault` components.
   ///
   /// Returns a `vtkm::cont::UnknownArrayHandle` that contains an array that either contains
@@ -156,15 +182,32 @@ public:
   {
     this->Data.ReleaseResourcesExecution();
     this->Range.ReleaseResourcesExecution();
+    this->Statistics.ReleaseResourcesExecution();
   }
 
 private:
+  friend struct internal::FieldStatisticsCache;
+
+  // Results derived from the data. Each is tagged with the buffer versions of the data it was
+  // computed from and is only used while they still match.
+  struct CacheStruct;
+
   std::string Name; ///< name of field
 
   Association FieldAssociation = Association::Any;
   vtkm::cont::UnknownArrayHandle Data;
+  mutable std::shared_ptr<CacheStruct> Cache;
   mutable vtkm::cont::ArrayHandle<vtkm::Range> Range;
-  mutable bool ModifiedFlag = true;
+  mutable vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics> Statistics;
+
+  VTKM_CONT CacheStruct& GetCache() const;
+  VTKM_CONT bool HasCachedStatistics() const;
+  VTKM_CONT void SetCachedStatistics(
+    const std::vector<vtkm::UInt64>& versions,
+    const vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>& statistics,
+    const vtkm::cont::ArrayHandle<vtkm::Range>& ranges) const;
+  // Stops sharing the cache with copies of this field, whose data are about to differ.
+  VTKM_CONT void DetachCache();
 };
 
 template <typename Functor, typename... Args>
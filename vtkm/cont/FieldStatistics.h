@@ -0,0 +1,72 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_FieldStatistics_h
+#define vtk_m_cont_FieldStatistics_h
+
+#include <vtkm/Math.h>
+#include <vtkm/Range.h>
+#include <vtkm/Types.h>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// \brief Summary statistics of one component of a field.
+///
+/// NaN values are counted in `NumberOfNaNs` and left out of everything else.
+/// Infinite values are included, so the range matches the one returned by
+/// `vtkm::cont::ArrayRangeCompute`. `Variance` is the population variance.
+/// `Mean` and `Variance` are NaN when there are no values to average.
+///
+struct FieldStatistics
+{
+  vtkm::Range Range;
+  vtkm::Float64 Mean = vtkm::Nan64();
+  vtkm::Float64 Variance = vtkm::Nan64();
+  vtkm::Id NumberOfValues = 0;
+  vtkm::Id NumberOfNaNs = 0;
+
+  /// Combines the statistics of two disjoint sets of values.
+  VTKM_EXEC_CONT FieldStatistics Union(const FieldStatistics& other) const
+  {
+    if (other.NumberOfValues == 0)
+    {
+      FieldStatistics result = *this;
+      result.NumberOfNaNs += other.NumberOfNaNs;
+      return result;
+    }
+    if (this->NumberOfValues == 0)
+    {
+      FieldStatistics result = other;
+      result.NumberOfNaNs += this->NumberOfNaNs;
+      return result;
+    }
+
+    const vtkm::Float64 n1 = static_cast<vtkm::Float64>(this->NumberOfValues);
+    const vtkm::Float64 n2 = static_cast<vtkm::Float64>(other.NumberOfValues);
+    const vtkm::Float64 n = n1 + n2;
+    const vtkm::Float64 delta = other.Mean - this->Mean;
+
+    FieldStatistics result;
+    result.Range = this->Range.Union(other.Range);
+    result.Mean = this->Mean + delta * (n2 / n);
+    result.Variance =
+      (this->Variance * n1 + other.Variance * n2 + delta * delta * (n1 * n2 / n)) / n;
+    result.NumberOfValues = this->NumberOfValues + other.NumberOfValues;
+    result.NumberOfNaNs = this->NumberOfNaNs + other.NumberOfNaNs;
+    return result;
+  }
+};
+
+}
+} // namespace vtkm::cont
+
+#endif //vtk_m_cont_FieldStatistics_h
@@ -0,0 +1,307 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/FieldStatisticsCompute.h>
+
+#include <vtkm/TypeList.h>
+
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleRecombineVec.h>
+#include <vtkm/cont/ErrorBadType.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/Logging.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+
+using AllScalars = vtkm::TypeListBaseC;
+
+// Each chunk of values is visited by one thread, which computes the statistics of every
+// component of the chunk. The number of chunks is capped so that combining them is cheap.
+constexpr vtkm::Id MIN_CHUNK_SIZE = 1024;
+constexpr vtkm::Id MAX_NUMBER_OF_CHUNKS = 4096;
+
+struct ComputeChunkStatistics : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn chunkIndex,
+                                WholeArrayIn values,
+                                WholeArrayOut chunkStatistics);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  vtkm::Id ChunkSize;
+  vtkm::IdComponent NumberOfComponents;
+
+  VTKM_CONT ComputeChunkStatistics(vtkm::Id chunkSize, vtkm::IdComponent numComponents)
+    : ChunkSize(chunkSize)
+    , NumberOfComponents(numComponents)
+  {
+  }
+
+  template <typename ValuesPortal, typename StatisticsPortal>
+  VTKM_EXEC void operator()(vtkm::Id chunkIndex,
+                            const ValuesPortal& values,
+                            const StatisticsPortal& chunkStatistics) const
+  {
+    const vtkm::Id begin = chunkIndex * this->ChunkSize;
+    const vtkm::Id end = vtkm::Min(begin + this->ChunkSize, values.GetNumberOfValues());
+
+    for (vtkm::IdComponent cIndex = 0; cIndex < this->NumberOfComponents; ++cIndex)
+    {
+      vtkm::Range range;
+      vtkm::Id count = 0;
+      vtkm::Id numNaNs = 0;
+      vtkm::Float64 mean = 0;
+      vtkm::Float64 m2 = 0;
+      for (vtkm::Id index = begin; index < end; ++index)
+      {
+        const vtkm::Float64 value = static_cast<vtkm::Float64>(values.Get(index)[cIndex].Get());
+        if (vtkm::IsNan(value))
+        {
+          ++numNaNs;
+          continue;
+        }
+        // Welford's update keeps the variance accurate when the mean is large.
+        ++count;
+        const vtkm::Float64 delta = value - mean;
+        mean += delta / static_cast<vtkm::Float64>(count);
+        m2 += delta * (value - mean);
+        range.Include(value);
+      }
+
+      vtkm::cont::FieldStatistics statistics;
+      statistics.NumberOfNaNs = numNaNs;
+      if (count > 0)
+      {
+        statistics.Range = range;
+        statistics.Mean = mean;
+        statistics.Variance = m2 / static_cast<vtkm::Float64>(count);
+        statistics.NumberOfValues = count;
+      }
+      chunkStatistics.Set(chunkIndex * this->NumberOfComponents + cIndex, statistics);
+    }
+  }
+};
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+
+namespace internal
+{
+
+namespace
+{
+
+// Computes the statistics of fields that have the same number of values and base component type
+// with one pass over all of their components.
+template <typename T>
+void ComputeFieldGroup(const std::vector<const vtkm::cont::Field*>& fields,
+                       vtkm::cont::DeviceAdapterId device)
+{
+  const vtkm::Id numValues = fields.front()->GetNumberOfValues();
+
+  // Record the versions before reading so that concurrent writes leave the results out of date.
+  std::vector<std::vector<vtkm::UInt64>> versions;
+  vtkm::cont::ArrayHandleRecombineVec<T> values;
+  for (const vtkm::cont::Field* field : fields)
+  {
+    const vtkm::cont::UnknownArrayHandle& data = field->GetData();
+    versions.push_back(data.GetBufferVersions());
+    const vtkm::IdComponent numComponents = data.GetNumberOfComponentsFlat();
+    for (vtkm::IdComponent cIndex = 0; cIndex < numComponents; ++cIndex)
+    {
+      values.AppendComponentArray(data.ExtractComponent<T>(cIndex));
+    }
+  }
+  const vtkm::IdComponent totalComponents = values.GetNumberOfComponents();
+
+  std::vector<vtkm::cont::FieldStatistics> statistics(static_cast<std::size_t>(totalComponents));
+  if ((numValues > 0) && (totalComponents > 0))
+  {
+    const vtkm::Id chunkSize = std::max(
+      MIN_CHUNK_SIZE, (numValues + MAX_NUMBER_OF_CHUNKS - 1) / MAX_NUMBER_OF_CHUNKS);
+    const vtkm::Id numChunks = (numValues + chunkSize - 1) / chunkSize;
+
+    vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics> chunkStatistics;
+    chunkStatistics.Allocate(numChunks * totalComponents);
+    vtkm::cont::Invoker invoke(device);
+    invoke(ComputeChunkStatistics{ chunkSize, totalComponents },
+           vtkm::cont::ArrayHandleIndex(numChunks),
+           values,
+           chunkStatistics);
+
+    auto portal = chunkStatistics.ReadPortal();
+    for (vtkm::Id chunk = 0; chunk < numChunks; ++chunk)
+    {
+      for (vtkm::IdComponent cIndex = 0; cIndex < totalComponents; ++cIndex)
+      {
+        auto& result = statistics[static_cast<std::size_t>(cIndex)];
+        result = result.Union(portal.Get(chunk * totalComponents + cIndex));
+      }
+    }
+  }
+
+  // Hand the results back to each field, along with the range.
+  auto nextStatistics = statistics.begin();
+  for (std::size_t fieldIndex = 0; fieldIndex < fields.size(); ++fieldIndex)
+  {
+    const vtkm::cont::Field* field = fields[fieldIndex];
+    const vtkm::IdComponent numComponents = field->GetData().GetNumberOfComponentsFlat();
+    std::vector<vtkm::cont::FieldStatistics> fieldStatistics(nextStatistics,
+                                                             nextStatistics + numComponents);
+    nextStatistics += numComponents;
+
+    std::vector<vtkm::Range> fieldRanges;
+    for (const auto& componentStatistics : fieldStatistics)
+    {
+      fieldRanges.push_back(componentStatistics.Range);
+    }
+
+    FieldStatisticsCache::Store(*field,
+                                versions[fieldIndex],
+                                vtkm::cont::make_ArrayHandleMove(std::move(fieldStatistics)),
+                                vtkm::cont::make_ArrayHandleMove(std::move(fieldRanges)));
+  }
+}
+
+} // anonymous namespace
+
+void FieldStatisticsCache::Compute(const std::vector<const vtkm::cont::Field*>& fields,
+                                   vtkm::cont::DeviceAdapterId device)
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "FieldStatisticsCache::Compute");
+
+  std::vector<const vtkm::cont::Field*> pending;
+  for (const vtkm::cont::Field* field : fields)
+  {
+    if ((std::find(pending.begin(), pending.end(), field) == pending.end()) &&
+        !field->HasCachedStatistics())
+    {
+      pending.push_back(field);
+    }
+  }
+  std::vector<bool> done(pending.size(), false);
+
+  vtkm::ListForEach(
+    [&](auto typeObj) {
+      using T = decltype(typeObj);
+      std::map<vtkm::Id, std::vector<const vtkm::cont::Field*>> groups;
+      for (std::size_t index = 0; index < pending.size(); ++index)
+      {
+        if (!done[index] && pending[index]->GetData().IsBaseComponentType<T>())
+        {
+          groups[pending[index]->GetNumberOfValues()].push_back(pending[index]);
+          done[index] = true;
+        }
+      }
+      for (const auto& group : groups)
+      {
+        ComputeFieldGroup<T>(group.second, device);
+      }
+    },
+    AllScalars{});
+
+  for (std::size_t index = 0; index < pending.size(); ++index)
+  {
+    if (!done[index])
+    {
+      throw vtkm::cont::ErrorBadType("Cannot compute statistics of field " +
+                                     pending[index]->GetName() + " with array " +
+                                     pending[index]->GetData().GetArrayTypeName());
+    }
+  }
+}
+
+void FieldStatisticsCache::Store(const vtkm::cont::Field& field,
+                                 const std::vector<vtkm::UInt64>& versions,
+                                 const vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>& stats,
+                                 const vtkm::cont::ArrayHandle<vtkm::Range>& ranges)
+{
+  field.SetCachedStatistics(versions, stats, ranges);
+}
+
+} // namespace internal
+
+std::vector<vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>> FieldStatisticsCompute(
+  const vtkm::cont::DataSet& dataset,
+  const std::vector<std::string>& names,
+  vtkm::cont::Field::Association assoc,
+  vtkm::cont::DeviceAdapterId device)
+{
+  std::vector<const vtkm::cont::Field*> fields;
+  for (const std::string& name : names)
+  {
+    if (dataset.HasField(name, assoc))
+    {
+      fields.push_back(&dataset.GetField(name, assoc));
+    }
+  }
+  internal::FieldStatisticsCache::Compute(fields, device);
+
+  std::vector<vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>> result;
+  for (const std::string& name : names)
+  {
+    if (dataset.HasField(name, assoc))
+    {
+      result.push_back(dataset.GetField(name, assoc).GetStatistics());
+    }
+    else
+    {
+      // field missing, return empty statistics.
+      result.emplace_back();
+    }
+  }
+  return result;
+}
+
+std::vector<vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>> FieldStatisticsCompute(
+  const vtkm::cont::PartitionedDataSet& pds,
+  const std::vector<std::string>& names,
+  vtkm::cont::Field::Association assoc,
+  vtkm::cont::DeviceAdapterId device)
+{
+  std::vector<std::vector<vtkm::cont::FieldStatistics>> combined(names.size());
+  for (const vtkm::cont::DataSet& dataset : pds)
+  {
+    auto partitionStatistics = vtkm::cont::FieldStatisticsCompute(dataset, names, assoc, device);
+    for (std::size_t fieldIndex = 0; fieldIndex < names.size(); ++fieldIndex)
+    {
+      auto portal = partitionStatistics[fieldIndex].ReadPortal();
+      std::vector<vtkm::cont::FieldStatistics>& result = combined[fieldIndex];
+
+      // if the current partition has more components than we have seen so far,
+      // resize the result to fit all components.
+      result.resize(std::max(result.size(), static_cast<size_t>(portal.GetNumberOfValues())));
+      for (vtkm::Id cIndex = 0; cIndex < portal.GetNumberOfValues(); ++cIndex)
+      {
+        auto& componentResult = result[static_cast<std::size_t>(cIndex)];
+        componentResult = componentResult.Union(portal.Get(cIndex));
+      }
+    }
+  }
+
+  std::vector<vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>> result;
+  for (auto& fieldStatistics : combined)
+  {
+    result.push_back(vtkm::cont::make_ArrayHandleMove(std::move(fieldStatistics)));
+  }
+  return result;
+}
+
+}
+} // namespace vtkm::cont
@@ -0,0 +1,83 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_FieldStatisticsCompute_h
+#define vtk_m_cont_FieldStatisticsCompute_h
+
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/DeviceAdapterTag.h>
+#include <vtkm/cont/Field.h>
+#include <vtkm/cont/FieldStatistics.h>
+#include <vtkm/cont/PartitionedDataSet.h>
+
+#include <string>
+#include <vector>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// \brief Compute the statistics of several fields of a `DataSet`.
+///
+/// Returns one array per name, holding a `vtkm::cont::FieldStatistics` for
+/// each component of the field. The array is empty when the field is missing.
+///
+/// Fields with the same number of values and the same base component type
+/// are visited together in a single pass, which computes the range, mean,
+/// variance, and number of NaN values of every component at once. The results
+/// are cached on the fields of `dataset`, so asking again for the statistics
+/// or the range of a field that was not modified costs nothing.
+///
+VTKM_CONT_EXPORT
+VTKM_CONT
+std::vector<vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>> FieldStatisticsCompute(
+  const vtkm::cont::DataSet& dataset,
+  const std::vector<std::string>& names,
+  vtkm::cont::Field::Association assoc = vtkm::cont::Field::Association::Any,
+  vtkm::cont::DeviceAdapterId device = vtkm::cont::DeviceAdapterTagAny{});
+
+/// \brief Compute the statistics of several fields of a `PartitionedDataSet`.
+///
+/// The fields of each partition are computed as with the `DataSet` version,
+/// then the statistics of all partitions are combined. When partitions have
+/// different numbers of components for a field, the result has as many
+/// components as the largest of them.
+///
+VTKM_CONT_EXPORT
+VTKM_CONT
+std::vector<vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>> FieldStatisticsCompute(
+  const vtkm::cont::PartitionedDataSet& pds,
+  const std::vector<std::string>& names,
+  vtkm::cont::Field::Association assoc = vtkm::cont::Field::Association::Any,
+  vtkm::cont::DeviceAdapterId device = vtkm::cont::DeviceAdapterTagAny{});
+
+namespace internal
+{
+
+/// Fills the statistics (and range) caches of a group of fields.
+struct VTKM_CONT_EXPORT FieldStatisticsCache
+{
+  VTKM_CONT static void Compute(
+    const std::vector<const vtkm::cont::Field*>& fields,
+    vtkm::cont::DeviceAdapterId device = vtkm::cont::DeviceAdapterTagAny{});
+
+  /// Stores the statistics computed from the data when its buffers had `versions`.
+  VTKM_CONT static void Store(const vtkm::cont::Field& field,
+                              const std::vector<vtkm::UInt64>& versions,
+                              const vtkm::cont::ArrayHandle<vtkm::cont::FieldStatistics>& stats,
+                              const vtkm::cont::ArrayHandle<vtkm::Range>& ranges);
+};
+
+} // namespace internal
+
+}
+} // namespace vtkm::cont
+
+#endif //vtk_m_cont_FieldStatisticsCompute_h
@@ -13,7 +13,17 @@
 #include <vtkm/worklet/internal/MaskBase.h>
 #include <vtkm/worklet/internal/ScatterBase.h>
 
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/RuntimeDeviceTracker.h>
+#include <vtkm/cont/Token.h>
 #include <vtkm/cont/TryExecute.h>
+#include <vtkm/cont/internal/AsyncInvokeQueue.h>
+
+#include <array>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <utility>
 
 namespace vtkm
 {
@@ -26,8 +36,99 @@ template <typename T>
 using scatter_or_mask = std::integral_constant<bool,
                                                vtkm::worklet::internal::is_mask<T>::value ||
                                                  vtkm::worklet::internal::is_scatter<T>::value>;
+
+// Places the token in the queue of the arrays passed to an asynchronous invoke so that the
+// launches get access to the arrays in the order they were made.
+struct InvokeEnqueueArgument
+{
+  const vtkm::cont::Token& Token;
+
+  template <typename T>
+  VTKM_CONT void operator()(const T& arg) const
+  {
+    this->DoEnqueue(arg, typename vtkm::cont::internal::ArrayHandleCheck<T>::type{});
+  }
+
+  template <typename T>
+  VTKM_CONT void DoEnqueue(const T& array, std::true_type) const
+  {
+    array.Enqueue(this->Token);
+  }
+
+  template <typename T>
+  VTKM_CONT void DoEnqueue(const T&, std::false_type) const
+  {
+  }
+};
+
+// Removes the token from the queues of the arrays it was enqueued on. An enqueued token that
+// never attaches to an array blocks all other access to it, so this is called when an
+// asynchronous invoke fails.
+struct InvokeReleaseArgument
+{
+  const vtkm::cont::Token& Token;
+
+  template <typename T>
+  VTKM_CONT void operator()(const T& arg) const
+  {
+    this->DoRelease(arg, typename vtkm::cont::internal::ArrayHandleCheck<T>::type{});
+  }
+
+  template <typename T>
+  VTKM_CONT void DoRelease(const T& array, std::true_type) const
+  {
+    array.Dequeue(this->Token);
+  }
+
+  template <typename T>
+  VTKM_CONT void DoRelease(const T&, std::false_type) const
+  {
+  }
+};
+
+template <typename Tuple, typename Functor, std::size_t... Is>
+VTKM_CONT void InvokeForEachArgument(const Tuple& arguments,
+                                     const Functor& functor,
+                                     std::index_sequence<Is...>)
+{
+  (void)functor;
+  // Expand the calls in order with an initializer list.
+  (void)std::initializer_list<int>{ (functor(std::get<Is>(arguments)), 0)... };
 }
 
+using InvokeEnabledDevices = std::array<bool, VTKM_MAX_DEVICE_ADAPTER_ID>;
+
+VTKM_CONT inline InvokeEnabledDevices InvokeGetEnabledDevices()
+{
+  InvokeEnabledDevices enabled{};
+  const vtkm::cont::RuntimeDeviceTracker& tracker = vtkm::cont::GetRuntimeDeviceTracker();
+  for (vtkm::Int8 i = 1; i < VTKM_MAX_DEVICE_ADAPTER_ID; ++i)
+  {
+    enabled[static_cast<std::size_t>(i)] = tracker.CanRunOn(vtkm::cont::make_DeviceAdapterId(i));
+  }
+  return enabled;
+}
+
+// The runtime device tracker is per thread, so copy the state of the launching thread to the
+// thread running the worklet.
+VTKM_CONT inline void InvokeSetEnabledDevices(vtkm::cont::RuntimeDeviceTracker& tracker,
+                                              const InvokeEnabledDevices& enabled)
+{
+  for (vtkm::Int8 i = 1; i < VTKM_MAX_DEVICE_ADAPTER_ID; ++i)
+  {
+    vtkm::cont::DeviceAdapterId device = vtkm::cont::make_DeviceAdapterId(i);
+    if (enabled[static_cast<std::size_t>(i)])
+    {
+      tracker.ResetDevice(device);
+    }
+    else
+    {
+      tracker.DisableDevice(device);
+    }
+  }
+}
+} // namespace detail
+
 /// \brief Allows launching any worklet without a dispatcher.
 ///
 /// \c Invoker is a generalized \c Dispatcher that is able to automatically
@@ -72,6 +173,7 @@ struct Invoker
 
     DispatcherType dispatcher(worklet, scatterOrMask);
     dispatcher.SetDevice(this->DeviceId);
+    this->SetDispatcherToken(dispatcher);
     dispatcher.Invoke(std::forward<Args>(args)...);
   }
 
@@ -97,6 +199,7 @@ struct Invoker
 
     DispatcherType dispatcher(worklet, scatterOrMaskA, scatterOrMaskB);
     dispatcher.SetDevice(this->DeviceId);
+    this->SetDispatcherToken(dispatcher);
     dispatcher.Invoke(std::forward<Args>(args)...);
   }
 
@@ -115,15 +218,96 @@ struct Invoker
 
     DispatcherType dispatcher(worklet);
     dispatcher.SetDevice(this->DeviceId);
+    this->SetDispatcherToken(dispatcher);
     dispatcher.Invoke(std::forward<T>(t), std::forward<Args>(args)...);
   }
 
+  /// \brief Launch a worklet asynchronously.
+  ///
+  /// `Async` takes the same arguments as the call operator, but returns immediately. The worklet
+  /// is run by one of the persistent worker threads of `internal::AsyncInvokeQueue`, and the
+  /// returned `std::future` becomes ready when it is finished. Any exception thrown by the invoke
+  /// is rethrown by `std::future::get`. Independent launches overlap, and the calling thread can
+  /// do other work (such as allocating the arrays of the next launch) while the worklets run.
+  /// When `internal::AsyncInvokeQueue::GetMaximumPendingLaunches` launches are already waiting
+  /// for a worker, `Async` blocks until one of them starts.
+  ///
+  /// The arguments are copied, which shares the data of `ArrayHandle`s. Before returning,
+  /// `Async` places a `Token` in the queue of each `ArrayHandle` argument. The launches are
+  /// started in the order `Async` was called, and they get access to the arrays they share in
+  /// the same order: a launch reading an array waits for an earlier launch writing it (and vice
+  /// versa). Any access to these arrays from the calling thread, such as getting a portal, waits
+  /// for the launch to finish. Dependencies through objects other than `ArrayHandle` arguments,
+  /// such as arrays held by a cell set or an `UnknownArrayHandle`, are not tracked. The `Token`
+  /// of a launch is detached from all the arrays when the launch finishes or fails.
+  ///
+  /// A launch runs even if the returned future is discarded. `Async` called from inside an
+  /// asynchronous launch runs the worklet right away on the calling thread.
+  ///
+  template <typename... Args>
+  VTKM_CONT std::future<void> Async(Args&&... args) const
+  {
+    auto token = std::make_shared<vtkm::cont::Token>();
+    auto arguments = std::make_tuple(args...);
+    using Indices = std::index_sequence_for<Args...>;
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> future = promise->get_future();
+
+    const detail::InvokeEnabledDevices enabledDevices = detail::InvokeGetEnabledDevices();
+    const vtkm::cont::DeviceAdapterId device = this->DeviceId;
+    auto launch = [token, arguments, enabledDevices, device, promise]() mutable {
+      try
+      {
+        vtkm::cont::ScopedRuntimeDeviceTracker tracker;
+        detail::InvokeSetEnabledDevices(tracker, enabledDevices);
+
+        Invoker invoke(device);
+        invoke.InvokeToken = token.get();
+        invoke.InvokeTuple(arguments, Indices{});
+        token->DetachFromAll();
+      }
+      catch (...)
+      {
+        // Remove the token from the arrays the launch never got access to.
+        detail::InvokeForEachArgument(
+          arguments, detail::InvokeReleaseArgument{ *token }, Indices{});
+        token->DetachFromAll();
+        promise->set_exception(std::current_exception());
+        return;
+      }
+      promise->set_value();
+    };
+
+    vtkm::cont::internal::AsyncInvokeQueue::Push(
+      [&]() {
+        detail::InvokeForEachArgument(arguments, detail::InvokeEnqueueArgument{ *token }, Indices{});
+      },
+      std::move(launch));
+    return future;
+  }
+
   /// Get the device adapter that this Invoker is bound too
   ///
   vtkm::cont::DeviceAdapterId GetDevice() const { return DeviceId; }
 
 private:
+  template <typename DispatcherType>
+  VTKM_CONT void SetDispatcherToken(DispatcherType& dispatcher) const
+  {
+    if (this->InvokeToken != nullptr)
+    {
+      dispatcher.SetToken(*this->InvokeToken);
+    }
+  }
+
+  template <typename Tuple, std::size_t... Is>
+  VTKM_CONT void InvokeTuple(Tuple& arguments, std::index_sequence<Is...>) const
+  {
+    (*this)(std::get<Is>(arguments)...);
+  }
+
   vtkm::cont::DeviceAdapterId DeviceId;
+  vtkm::cont::Token* InvokeToken = nullptr;
 };
 }
 }
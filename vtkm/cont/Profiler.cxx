@@ -0,0 +1,304 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/Profiler.h>
+
+#include <vtkm/cont/ErrorBadValue.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+
+using ClockType = std::chrono::steady_clock;
+
+struct ProfilerState
+{
+  std::mutex Mutex;
+  std::atomic<bool> Enabled{ false };
+  ClockType::time_point Epoch = ClockType::now();
+
+  std::vector<vtkm::cont::ProfilerLaunchRecord> Launches;
+  std::vector<vtkm::cont::ProfilerTransferRecord> Transfers;
+  std::unordered_map<std::thread::id, vtkm::Id> ThreadIndices;
+};
+
+ProfilerState& GetProfilerState()
+{
+  // Intentionally never destroyed so that launches made during static destruction are safe.
+  static ProfilerState* state = new ProfilerState;
+  return *state;
+}
+
+vtkm::Float64 Bandwidth(vtkm::BufferSizeType numBytes, vtkm::Float64 elapsedTime)
+{
+  return (elapsedTime > 0) ? static_cast<vtkm::Float64>(numBytes) / elapsedTime : 0;
+}
+
+std::string EscapeJson(const std::string& str)
+{
+  std::string escaped;
+  escaped.reserve(str.size());
+  for (char c : str)
+  {
+    if ((c == '"') || (c == '\\'))
+    {
+      escaped.push_back('\\');
+      escaped.push_back(c);
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      escaped.push_back(' ');
+    }
+    else
+    {
+      escaped.push_back(c);
+    }
+  }
+  return escaped;
+}
+
+// Chrome traces are in microseconds.
+vtkm::Float64 ToMicroseconds(vtkm::Float64 seconds)
+{
+  return seconds * 1e6;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+
+vtkm::Float64 ProfilerLaunchRecord::GetBandwidth() const
+{
+  return Bandwidth(this->BytesRead + this->BytesWritten, this->ElapsedTime);
+}
+
+vtkm::Float64 ProfilerWorkletSummary::GetBandwidth() const
+{
+  return Bandwidth(this->BytesRead + this->BytesWritten, this->ElapsedTime);
+}
+
+void SetProfilingEnabled(bool enabled)
+{
+  ProfilerState& state = GetProfilerState();
+  if (enabled && !state.Enabled)
+  {
+    ResetProfiling();
+  }
+  state.Enabled = enabled;
+}
+
+bool GetProfilingEnabled()
+{
+  return GetProfilerState().Enabled.load(std::memory_order_relaxed);
+}
+
+void ResetProfiling()
+{
+  ProfilerState& state = GetProfilerState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Epoch = ClockType::now();
+  state.Launches.clear();
+  state.Transfers.clear();
+}
+
+std::vector<vtkm::cont::ProfilerLaunchRecord> GetProfilerLaunches()
+{
+  ProfilerState& state = GetProfilerState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.Launches;
+}
+
+std::vector<vtkm::cont::ProfilerTransferRecord> GetProfilerTransfers()
+{
+  ProfilerState& state = GetProfilerState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  return state.Transfers;
+}
+
+std::vector<vtkm::cont::ProfilerWorkletSummary> GetProfilerSummary()
+{
+  std::map<std::string, vtkm::cont::ProfilerWorkletSummary> summaries;
+  for (const vtkm::cont::ProfilerLaunchRecord& launch : GetProfilerLaunches())
+  {
+    vtkm::cont::ProfilerWorkletSummary& summary = summaries[launch.WorkletName];
+    summary.WorkletName = launch.WorkletName;
+    summary.NumberOfLaunches += 1;
+    summary.DomainSize += launch.DomainSize;
+    summary.BytesRead += launch.BytesRead;
+    summary.BytesWritten += launch.BytesWritten;
+    summary.ElapsedTime += launch.ElapsedTime;
+  }
+
+  std::vector<vtkm::cont::ProfilerWorkletSummary> result;
+  result.reserve(summaries.size());
+  for (auto&& summary : summaries)
+  {
+    result.push_back(summary.second);
+  }
+  std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+    return a.ElapsedTime > b.ElapsedTime;
+  });
+  return result;
+}
+
+void PrintProfilerSummary(std::ostream& out)
+{
+  std::vector<vtkm::cont::ProfilerWorkletSummary> summaries = GetProfilerSummary();
+  vtkm::Float64 totalTime = 0;
+  for (const auto& summary : summaries)
+  {
+    totalTime += summary.ElapsedTime;
+  }
+
+  std::stringstream table;
+  table << std::setw(10) << "Time (s)" << std::setw(8) << "%" << std::setw(10) << "Launches"
+        << std::setw(14) << "Values" << std::setw(14) << "MB read" << std::setw(14)
+        << "MB written" << std::setw(12) << "GB/s"
+        << "  Worklet\n";
+  table << std::fixed;
+  for (const auto& summary : summaries)
+  {
+    table << std::setw(10) << std::setprecision(6) << summary.ElapsedTime << std::setw(8)
+          << std::setprecision(1)
+          << ((totalTime > 0) ? 100 * summary.ElapsedTime / totalTime : 0.0) << std::setw(10)
+          << summary.NumberOfLaunches << std::setw(14) << summary.DomainSize << std::setw(14)
+          << std::setprecision(3) << static_cast<vtkm::Float64>(summary.BytesRead) / 1e6
+          << std::setw(14) << static_cast<vtkm::Float64>(summary.BytesWritten) / 1e6
+          << std::setw(12) << summary.GetBandwidth() / 1e9 << "  " << summary.WorkletName
+          << "\n";
+  }
+
+  vtkm::Id numToDevice = 0;
+  vtkm::Id numToHost = 0;
+  vtkm::BufferSizeType bytesToDevice = 0;
+  vtkm::BufferSizeType bytesToHost = 0;
+  vtkm::Float64 transferTime = 0;
+  for (const vtkm::cont::ProfilerTransferRecord& transfer : GetProfilerTransfers())
+  {
+    if (transfer.ToDevice)
+    {
+      ++numToDevice;
+      bytesToDevice += transfer.NumberOfBytes;
+    }
+    else
+    {
+      ++numToHost;
+      bytesToHost += transfer.NumberOfBytes;
+    }
+    transferTime += transfer.ElapsedTime;
+  }
+  table << std::setprecision(3) << "Transfers to devices: " << numToDevice << " ("
+        << static_cast<vtkm::Float64>(bytesToDevice) / 1e6 << " MB), to host: " << numToHost
+        << " (" << static_cast<vtkm::Float64>(bytesToHost) / 1e6 << " MB), "
+        << std::setprecision(6) << transferTime << " s\n";
+
+  out << table.str();
+}
+
+void WriteProfilerChromeTrace(std::ostream& out)
+{
+  std::vector<vtkm::cont::ProfilerLaunchRecord> launches = GetProfilerLaunches();
+  std::vector<vtkm::cont::ProfilerTransferRecord> transfers = GetProfilerTransfers();
+
+  std::stringstream trace;
+  trace << std::fixed << std::setprecision(3);
+  trace << "{\"traceEvents\":[";
+  bool first = true;
+  for (const vtkm::cont::ProfilerLaunchRecord& launch : launches)
+  {
+    trace << (first ? "\n" : ",\n");
+    first = false;
+    trace << "{\"name\":\"" << EscapeJson(launch.WorkletName) << "\",\"cat\":\"worklet\""
+          << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << launch.ThreadIndex
+          << ",\"ts\":" << ToMicroseconds(launch.StartTime)
+          << ",\"dur\":" << ToMicroseconds(launch.ElapsedTime) << ",\"args\":{\"device\":\""
+          << EscapeJson(launch.Device.GetName()) << "\",\"domainSize\":" << launch.DomainSize
+          << ",\"bytesRead\":" << launch.BytesRead << ",\"bytesWritten\":" << launch.BytesWritten
+          << ",\"bandwidthGBs\":" << launch.GetBandwidth() / 1e9 << "}}";
+  }
+  for (const vtkm::cont::ProfilerTransferRecord& transfer : transfers)
+  {
+    trace << (first ? "\n" : ",\n");
+    first = false;
+    trace << "{\"name\":\"" << (transfer.ToDevice ? "HostToDevice" : "DeviceToHost")
+          << "\",\"cat\":\"transfer\",\"ph\":\"X\",\"pid\":0,\"tid\":" << transfer.ThreadIndex
+          << ",\"ts\":" << ToMicroseconds(transfer.StartTime)
+          << ",\"dur\":" << ToMicroseconds(transfer.ElapsedTime) << ",\"args\":{\"device\":\""
+          << EscapeJson(transfer.Device.GetName()) << "\",\"bytes\":" << transfer.NumberOfBytes
+          << "}}";
+  }
+  trace << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  out << trace.str();
+}
+
+void WriteProfilerChromeTrace(const std::string& fileName)
+{
+  std::ofstream file(fileName);
+  if (!file)
+  {
+    throw vtkm::cont::ErrorBadValue("Could not open profiler trace file " + fileName);
+  }
+  WriteProfilerChromeTrace(file);
+}
+
+namespace detail
+{
+
+vtkm::Float64 ProfilerTime()
+{
+  ProfilerState& state = GetProfilerState();
+  ClockType::time_point now = ClockType::now();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  std::chrono::duration<vtkm::Float64> elapsed = now - state.Epoch;
+  return elapsed.count();
+}
+
+vtkm::Id ProfilerThreadIndex()
+{
+  ProfilerState& state = GetProfilerState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  auto inserted = state.ThreadIndices.emplace(std::this_thread::get_id(),
+                                              static_cast<vtkm::Id>(state.ThreadIndices.size()));
+  return inserted.first->second;
+}
+
+void ProfilerRecordLaunch(vtkm::cont::ProfilerLaunchRecord&& record)
+{
+  ProfilerState& state = GetProfilerState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Launches.push_back(std::move(record));
+}
+
+void ProfilerRecordTransfer(const vtkm::cont::ProfilerTransferRecord& record)
+{
+  ProfilerState& state = GetProfilerState();
+  std::lock_guard<std::mutex> lock(state.Mutex);
+  state.Transfers.push_back(record);
+}
+
+} // namespace detail
+
+}
+} // namespace vtkm::cont
@@ -0,0 +1,140 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_Profiler_h
+#define vtk_m_cont_Profiler_h
+
+#include <vtkm/Types.h>
+
+#include <vtkm/cont/DeviceAdapterTag.h>
+#include <vtkm/cont/internal/DeviceAdapterMemoryManager.h>
+#include <vtkm/cont/vtkm_cont_export.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// \brief The record of one worklet launch collected by the profiler.
+///
+/// Times are in seconds. Start times are measured from when profiling was enabled (or last
+/// reset). The bytes read and written are the sizes of the arrays passed to the worklet, counted
+/// according to whether the `ControlSignature` reads, writes, or does both with each argument.
+/// Arrays that do not hold memory (such as implicit arrays) count as zero bytes.
+///
+struct ProfilerLaunchRecord
+{
+  std::string WorkletName;
+  vtkm::cont::DeviceAdapterId Device = vtkm::cont::DeviceAdapterTagUndefined{};
+  /// Number of instances the worklet was scheduled on.
+  vtkm::Id DomainSize = 0;
+  vtkm::BufferSizeType BytesRead = 0;
+  vtkm::BufferSizeType BytesWritten = 0;
+  vtkm::Float64 StartTime = 0;
+  /// Time to transport the arguments and run the worklet.
+  vtkm::Float64 ElapsedTime = 0;
+  /// Small index identifying the thread that launched the worklet.
+  vtkm::Id ThreadIndex = 0;
+
+  /// Bytes read and written per second.
+  VTKM_CONT vtkm::Float64 GetBandwidth() const;
+};
+
+/// \brief The record of one copy of a `Buffer` between the host and a device.
+///
+/// Only actual copies are recorded. Devices that share memory with the host (such as Serial,
+/// TBB, and OpenMP) do not copy.
+///
+struct ProfilerTransferRecord
+{
+  vtkm::cont::DeviceAdapterId Device = vtkm::cont::DeviceAdapterTagUndefined{};
+  /// True for a copy from the host to `Device`, false for a copy from `Device` to the host.
+  bool ToDevice = true;
+  vtkm::BufferSizeType NumberOfBytes = 0;
+  vtkm::Float64 StartTime = 0;
+  vtkm::Float64 ElapsedTime = 0;
+  vtkm::Id ThreadIndex = 0;
+};
+
+/// \brief Aggregated profile of all the launches of a worklet.
+///
+struct ProfilerWorkletSummary
+{
+  std::string WorkletName;
+  vtkm::Id NumberOfLaunches = 0;
+  vtkm::Id DomainSize = 0;
+  vtkm::BufferSizeType BytesRead = 0;
+  vtkm::BufferSizeType BytesWritten = 0;
+  vtkm::Float64 ElapsedTime = 0;
+
+  /// Bytes read and written per second over all launches.
+  VTKM_CONT vtkm::Float64 GetBandwidth() const;
+};
+
+/// \brief Turns the worklet profiler on or off.
+///
+/// When profiling is on, every worklet launched through a dispatcher or `vtkm::cont::Invoker`
+/// is timed, along with the bytes of the arrays it reads and writes, and every copy of a
+/// `Buffer` between the host and a device is recorded. Launches are synchronized with the
+/// device while profiling so that the times cover the execution of the worklet. Profiling is
+/// off by default and costs one check per launch when off. Turning profiling on resets the
+/// records.
+///
+VTKM_CONT_EXPORT VTKM_CONT void SetProfilingEnabled(bool enabled);
+VTKM_CONT_EXPORT VTKM_CONT bool GetProfilingEnabled();
+
+/// Discards the records collected so far and restarts the clock.
+VTKM_CONT_EXPORT VTKM_CONT void ResetProfiling();
+
+/// Returns the worklet launches recorded so far, in the order they finished.
+VTKM_CONT_EXPORT VTKM_CONT std::vector<vtkm::cont::ProfilerLaunchRecord> GetProfilerLaunches();
+
+/// Returns the buffer transfers recorded so far, in the order they finished.
+VTKM_CONT_EXPORT VTKM_CONT std::vector<vtkm::cont::ProfilerTransferRecord>
+GetProfilerTransfers();
+
+/// Returns the launches aggregated per worklet, sorted by decreasing total time.
+VTKM_CONT_EXPORT VTKM_CONT std::vector<vtkm::cont::ProfilerWorkletSummary> GetProfilerSummary();
+
+/// Writes a table of the aggregated launches and transfers.
+VTKM_CONT_EXPORT VTKM_CONT void PrintProfilerSummary(std::ostream& out);
+
+/// \brief Writes the records in the Chrome trace event format.
+///
+/// The output can be loaded in `chrome://tracing` or Perfetto. Each launch and transfer is a
+/// complete event on the timeline of the thread that made it, with the device, sizes and
+/// bandwidth as arguments.
+///
+VTKM_CONT_EXPORT VTKM_CONT void WriteProfilerChromeTrace(std::ostream& out);
+VTKM_CONT_EXPORT VTKM_CONT void WriteProfilerChromeTrace(const std::string& fileName);
+
+namespace detail
+{
+
+/// Seconds since profiling was enabled. Used to time the records.
+VTKM_CONT_EXPORT VTKM_CONT vtkm::Float64 ProfilerTime();
+
+/// Index of the calling thread in the records.
+VTKM_CONT_EXPORT VTKM_CONT vtkm::Id ProfilerThreadIndex();
+
+VTKM_CONT_EXPORT VTKM_CONT void ProfilerRecordLaunch(vtkm::cont::ProfilerLaunchRecord&& record);
+
+VTKM_CONT_EXPORT VTKM_CONT void ProfilerRecordTransfer(
+  const vtkm::cont::ProfilerTransferRecord& record);
+
+} // namespace detail
+
+}
+} // namespace vtkm::cont
+
+#endif //vtk_m_cont_Profiler_h
@@ -0,0 +1,706 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/SerializationCodec.h>
+
+#include <vtkm/cont/DIYMemoryManagement.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/RuntimeDeviceInformation.h>
+#include <vtkm/cont/Token.h>
+#include <vtkm/cont/internal/DeviceAdapterMemoryManager.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+// Value stored in the thread-local override when no ScopedSerializationCodec is active.
+constexpr vtkm::UInt8 NoCodecOverride = 0xFF;
+
+std::atomic<vtkm::UInt8> GlobalCodec{ static_cast<vtkm::UInt8>(
+  vtkm::cont::SerializationCodec::None) };
+
+vtkm::UInt8& ThreadCodec()
+{
+  thread_local vtkm::UInt8 codec = NoCodecOverride;
+  return codec;
+}
+
+void CheckCodec(vtkm::cont::SerializationCodec codec)
+{
+  if (static_cast<vtkm::UInt8>(codec) >
+      static_cast<vtkm::UInt8>(vtkm::cont::SerializationCodec::DeltaShuffleLZ))
+  {
+    throw vtkm::cont::ErrorBadValue("Unknown serialization codec " +
+                                    std::to_string(static_cast<int>(codec)));
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Delta stage. The data is split in integers of `IntegerSize` bytes. Each one is replaced with its
+// difference to the integer `distance` places before it, which is the same component of the
+// previous value. Trailing bytes that do not make a full integer are left alone.
+
+template <typename UIntType>
+void DeltaEncodeTyped(char* data, std::size_t numBytes, std::size_t distance)
+{
+  const std::size_t count = numBytes / sizeof(UIntType);
+  if (count <= distance)
+  {
+    return;
+  }
+  // Go backward so that each difference is taken with the original value.
+  for (std::size_t index = count - 1; index >= distance; --index)
+  {
+    UIntType value;
+    UIntType previous;
+    std::memcpy(&value, data + index * sizeof(UIntType), sizeof(UIntType));
+    std::memcpy(&previous, data + (index - distance) * sizeof(UIntType), sizeof(UIntType));
+    value = static_cast<UIntType>(value - previous);
+    std::memcpy(data + index * sizeof(UIntType), &value, sizeof(UIntType));
+  }
+}
+
+template <typename UIntType>
+void DeltaDecodeTyped(char* data, std::size_t numBytes, std::size_t distance)
+{
+  const std::size_t count = numBytes / sizeof(UIntType);
+  for (std::size_t index = distance; index < count; ++index)
+  {
+    UIntType value;
+    UIntType previous;
+    std::memcpy(&value, data + index * sizeof(UIntType), sizeof(UIntType));
+    std::memcpy(&previous, data + (index - distance) * sizeof(UIntType), sizeof(UIntType));
+    value = static_cast<UIntType>(value + previous);
+    std::memcpy(data + index * sizeof(UIntType), &value, sizeof(UIntType));
+  }
+}
+
+template <bool Encode>
+void Delta(char* data,
+           std::size_t numBytes,
+           const vtkm::cont::internal::SerializationCodecLayout& layout)
+{
+  const std::size_t distance = layout.ValueSize / layout.IntegerSize;
+  switch (layout.IntegerSize)
+  {
+    case 1:
+      Encode ? DeltaEncodeTyped<vtkm::UInt8>(data, numBytes, distance)
+             : DeltaDecodeTyped<vtkm::UInt8>(data, numBytes, distance);
+      break;
+    case 2:
+      Encode ? DeltaEncodeTyped<vtkm::UInt16>(data, numBytes, distance)
+             : DeltaDecodeTyped<vtkm::UInt16>(data, numBytes, distance);
+      break;
+    case 4:
+      Encode ? DeltaEncodeTyped<vtkm::UInt32>(data, numBytes, distance)
+             : DeltaDecodeTyped<vtkm::UInt32>(data, numBytes, distance);
+      break;
+    case 8:
+      Encode ? DeltaEncodeTyped<vtkm::UInt64>(data, numBytes, distance)
+             : DeltaDecodeTyped<vtkm::UInt64>(data, numBytes, distance);
+      break;
+    default:
+      // Unusual integer sizes are left as they are.
+      break;
+  }
+}
+
+bool UseDelta(vtkm::cont::SerializationCodec codec,
+              const vtkm::cont::internal::SerializationCodecLayout& layout)
+{
+  return (codec == vtkm::cont::SerializationCodec::DeltaShuffleLZ) && (layout.IntegerSize > 0) &&
+    (layout.ValueSize % layout.IntegerSize == 0);
+}
+
+//-----------------------------------------------------------------------------
+// Shuffle stage. Byte k of value i moves to position k * numValues + i. Trailing bytes that
+// do not make a full value are copied at the end.
+
+void Shuffle(const char* input, char* output, std::size_t numBytes, std::size_t valueSize)
+{
+  const std::size_t numValues = numBytes / valueSize;
+  for (std::size_t byte = 0; byte < valueSize; ++byte)
+  {
+    const char* in = input + byte;
+    char* out = output + byte * numValues;
+    for (std::size_t index = 0; index < numValues; ++index)
+    {
+      out[index] = in[index * valueSize];
+    }
+  }
+  const std::size_t shuffled = numValues * valueSize;
+  std::memcpy(output + shuffled, input + shuffled, numBytes - shuffled);
+}
+
+void Unshuffle(const char* input, char* output, std::size_t numBytes, std::size_t valueSize)
+{
+  const std::size_t numValues = numBytes / valueSize;
+  for (std::size_t byte = 0; byte < valueSize; ++byte)
+  {
+    const char* in = input + byte * numValues;
+    char* out = output + byte;
+    for (std::size_t index = 0; index < numValues; ++index)
+    {
+      out[index * valueSize] = in[index];
+    }
+  }
+  const std::size_t shuffled = numValues * valueSize;
+  std::memcpy(output + shuffled, input + shuffled, numBytes - shuffled);
+}
+
+bool UseShuffle(vtkm::cont::SerializationCodec codec,
+                const vtkm::cont::internal::SerializationCodecLayout& layout)
+{
+  return (codec != vtkm::cont::SerializationCodec::LZ) && (layout.ValueSize > 1);
+}
+
+//-----------------------------------------------------------------------------
+// LZ stage. The output is a list of sequences as in an LZ4 block. Each sequence is a token
+// byte holding the number of literals (high 4 bits) and the match length minus 4 (low 4 bits),
+// extra literal length bytes if the count is 15, the literals, a 2 byte match offset, and extra
+// match length bytes if the count is 15. The last sequence only has literals.
+
+constexpr std::size_t LZMinMatch = 4;
+constexpr std::size_t LZMaxOffset = 65535;
+// The last match must end this many bytes before the end of the input.
+constexpr std::size_t LZLastLiterals = 5;
+// A match must start this many bytes before the end of the input.
+constexpr std::size_t LZMatchLimit = 12;
+constexpr int LZHashBits = 16;
+
+vtkm::UInt32 LZRead32(const vtkm::UInt8* pointer)
+{
+  vtkm::UInt32 value;
+  std::memcpy(&value, pointer, sizeof(value));
+  return value;
+}
+
+std::size_t LZHash(vtkm::UInt32 sequence)
+{
+  return static_cast<std::size_t>((sequence * 2654435761U) >> (32 - LZHashBits));
+}
+
+void LZWriteLength(std::vector<vtkm::UInt8>& output, std::size_t length)
+{
+  while (length >= 255)
+  {
+    output.push_back(255);
+    length -= 255;
+  }
+  output.push_back(static_cast<vtkm::UInt8>(length));
+}
+
+void LZWriteSequence(std::vector<vtkm::UInt8>& output,
+                     const vtkm::UInt8* literals,
+                     std::size_t numLiterals,
+                     std::size_t offset,
+                     std::size_t matchLength)
+{
+  const std::size_t matchCode = (matchLength > 0) ? matchLength - LZMinMatch : 0;
+  const std::size_t literalCode = std::min(numLiterals, std::size_t(15));
+  const vtkm::UInt8 token =
+    static_cast<vtkm::UInt8>((literalCode << 4) | std::min(matchCode, std::size_t(15)));
+  output.push_back(token);
+  if (numLiterals >= 15)
+  {
+    LZWriteLength(output, numLiterals - 15);
+  }
+  output.insert(output.end(), literals, literals + numLiterals);
+  if (matchLength > 0)
+  {
+    output.push_back(static_cast<vtkm::UInt8>(offset & 0xFF));
+    output.push_back(static_cast<vtkm::UInt8>(offset >> 8));
+    if (matchCode >= 15)
+    {
+      LZWriteLength(output, matchCode - 15);
+    }
+  }
+}
+
+// Returns false if the compressed data would not be smaller than the input.
+bool LZCompress(const vtkm::UInt8* input, std::size_t numBytes, std::vector<vtkm::UInt8>& output)
+{
+  output.clear();
+  output.reserve(numBytes);
+
+  // Positions are stored plus one so that 0 means empty.
+  std::vector<std::size_t> table(std::size_t(1) << LZHashBits, 0);
+
+  std::size_t anchor = 0;
+  std::size_t position = 0;
+  const std::size_t limit = (numBytes > LZMatchLimit) ? numBytes - LZMatchLimit : 0;
+  const std::size_t matchEnd = (numBytes > LZLastLiterals) ? numBytes - LZLastLiterals : 0;
+  while (position < limit)
+  {
+    const vtkm::UInt32 sequence = LZRead32(input + position);
+    std::size_t& entry = table[LZHash(sequence)];
+    const std::size_t candidate = entry;
+    entry = position + 1;
+    if ((candidate == 0) || (position - (candidate - 1) > LZMaxOffset) ||
+        (LZRead32(input + candidate - 1) != sequence))
+    {
+      // Skip faster through data that does not compress.
+      position += 1 + ((position - anchor) >> 6);
+      continue;
+    }
+
+    const std::size_t reference = candidate - 1;
+    std::size_t matchLength = LZMinMatch;
+    while ((position + matchLength < matchEnd) &&
+           (input[reference + matchLength] == input[position + matchLength]))
+    {
+      ++matchLength;
+    }
+
+    LZWriteSequence(
+      output, input + anchor, position - anchor, position - reference, matchLength);
+    if (output.size() >= numBytes)
+    {
+      return false;
+    }
+
+    position += matchLength;
+    anchor = position;
+  }
+
+  LZWriteSequence(output, input + anchor, numBytes - anchor, 0, 0);
+  return output.size() < numBytes;
+}
+
+[[noreturn]] void LZCorrupt()
+{
+  throw vtkm::cont::ErrorBadValue("Corrupt compressed data in serialized buffer.");
+}
+
+std::size_t LZReadLength(const vtkm::UInt8*& input, const vtkm::UInt8* inputEnd)
+{
+  std::size_t length = 0;
+  vtkm::UInt8 byte;
+  do
+  {
+    if (input >= inputEnd)
+    {
+      LZCorrupt();
+    }
+    byte = *input++;
+    length += byte;
+  } while (byte == 255);
+  return length;
+}
+
+void LZDecompress(const vtkm::UInt8* input,
+                  std::size_t numInputBytes,
+                  vtkm::UInt8* output,
+                  std::size_t numBytes)
+{
+  const vtkm::UInt8* inputEnd = input + numInputBytes;
+  std::size_t position = 0;
+  while (true)
+  {
+    if (input >= inputEnd)
+    {
+      LZCorrupt();
+    }
+    const vtkm::UInt8 token = *input++;
+
+    std::size_t numLiterals = token >> 4;
+    if (numLiterals == 15)
+    {
+      numLiterals += LZReadLength(input, inputEnd);
+    }
+    if ((numLiterals > static_cast<std::size_t>(inputEnd - input)) ||
+        (numLiterals > numBytes - position))
+    {
+      LZCorrupt();
+    }
+    std::memcpy(output + position, input, numLiterals);
+    input += numLiterals;
+    position += numLiterals;
+    if (position == numBytes)
+    {
+      return;
+    }
+
+    if (inputEnd - input < 2)
+    {
+      LZCorrupt();
+    }
+    const std::size_t offset = static_cast<std::size_t>(input[0]) |
+      (static_cast<std::size_t>(input[1]) << 8);
+    input += 2;
+    std::size_t matchLength = (token & 0x0F) + LZMinMatch;
+    if ((token & 0x0F) == 15)
+    {
+      matchLength += LZReadLength(input, inputEnd);
+    }
+    if ((offset == 0) || (offset > position) || (matchLength > numBytes - position))
+    {
+      LZCorrupt();
+    }
+    // The match may overlap the bytes it produces, so copy byte by byte.
+    const vtkm::UInt8* match = output + position - offset;
+    for (std::size_t index = 0; index < matchLength; ++index)
+    {
+      output[position + index] = match[index];
+    }
+    position += matchLength;
+  }
+}
+
+//-----------------------------------------------------------------------------
+// Framing shared by the buffers and memory buffers. The codec is saved first. Data encoded with a
+// codec other than None follows with its layout, its decoded size and its encoded bytes.
+//
+// Array buffers are always saved as one DIY blob. Without a codec, the blob holds the raw bytes,
+// as before codecs existed. Encoded buffers are framed in the blob behind a marker, so the
+// loading side recognizes them whatever codec it selected. Raw data that starts with the marker
+// is framed with the None codec when a codec is selected.
+
+constexpr char EncodedBlobMarker[8] = { '\x89', 'V', 'T', 'K', 'm', 'C', 'd', 'c' };
+
+bool StartsWithEncodedBlobMarker(const char* data, std::size_t numBytes)
+{
+  return (numBytes >= sizeof(EncodedBlobMarker)) &&
+    (std::memcmp(data, EncodedBlobMarker, sizeof(EncodedBlobMarker)) == 0);
+}
+
+// Checks the first bytes of a buffer where DIY reads it from. Only those bytes are copied to the
+// host.
+bool BufferStartsWithEncodedBlobMarker(const vtkm::cont::internal::Buffer& buffer)
+{
+  constexpr vtkm::BufferSizeType markerSize = sizeof(EncodedBlobMarker);
+  if (buffer.GetNumberOfBytes() < markerSize)
+  {
+    return false;
+  }
+
+  const vtkm::cont::DeviceAdapterId device = vtkm::cont::GetDIYDeviceAdapter();
+  auto& memoryManager = vtkm::cont::RuntimeDeviceInformation().GetMemoryManager(device);
+  vtkm::cont::Token token;
+  vtkm::cont::internal::BufferInfo head =
+    memoryManager.ManageArray(const_cast<void*>(buffer.ReadPointerDevice(device, token)),
+                              nullptr,
+                              markerSize,
+                              [](void*) {},
+                              [](void*&, void*&, vtkm::BufferSizeType, vtkm::BufferSizeType) {});
+  vtkm::cont::internal::BufferInfo hostHead = vtkm::cont::internal::AllocateOnHost(markerSize);
+  memoryManager.CopyDeviceToHost(head, hostHead);
+  return StartsWithEncodedBlobMarker(static_cast<const char*>(hostHead.GetPointer()),
+                                     sizeof(EncodedBlobMarker));
+}
+
+void SaveEncodedHeader(mangled_diy_namespace::BinaryBuffer& bb,
+                       const vtkm::cont::internal::SerializationCodecLayout& layout,
+                       std::size_t numBytes,
+                       const std::vector<char>& encoded)
+{
+  vtkmdiy::save(bb, layout.ValueSize);
+  vtkmdiy::save(bb, layout.IntegerSize);
+  vtkmdiy::save(bb, static_cast<vtkm::UInt64>(numBytes));
+  vtkmdiy::save(bb, static_cast<vtkm::UInt64>(encoded.size()));
+  bb.save_binary(encoded.data(), encoded.size());
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+
+void SetSerializationCodec(vtkm::cont::SerializationCodec codec)
+{
+  CheckCodec(codec);
+  GlobalCodec.store(static_cast<vtkm::UInt8>(codec));
+}
+
+vtkm::cont::SerializationCodec GetSerializationCodec()
+{
+  vtkm::UInt8 codec = ThreadCodec();
+  if (codec == NoCodecOverride)
+  {
+    codec = GlobalCodec.load();
+  }
+  return static_cast<vtkm::cont::SerializationCodec>(codec);
+}
+
+ScopedSerializationCodec::ScopedSerializationCodec(vtkm::cont::SerializationCodec codec)
+  : Previous(ThreadCodec())
+{
+  CheckCodec(codec);
+  ThreadCodec() = static_cast<vtkm::UInt8>(codec);
+}
+
+ScopedSerializationCodec::~ScopedSerializationCodec()
+{
+  ThreadCodec() = this->Previous;
+}
+
+namespace internal
+{
+
+std::vector<char> EncodeBytes(const void* data,
+                              std::size_t numBytes,
+                              vtkm::cont::SerializationCodec& codec,
+                              const SerializationCodecLayout& layout)
+{
+  CheckCodec(codec);
+  if ((codec == vtkm::cont::SerializationCodec::None) || (numBytes == 0))
+  {
+    codec = vtkm::cont::SerializationCodec::None;
+    return {};
+  }
+
+  const char* input = static_cast<const char*>(data);
+  std::vector<char> scratch;
+  if (UseDelta(codec, layout))
+  {
+    scratch.assign(input, input + numBytes);
+    Delta<true>(scratch.data(), numBytes, layout);
+    input = scratch.data();
+  }
+  if (UseShuffle(codec, layout))
+  {
+    std::vector<char> shuffled(numBytes);
+    Shuffle(input, shuffled.data(), numBytes, layout.ValueSize);
+    scratch.swap(shuffled);
+    input = scratch.data();
+  }
+
+  std::vector<vtkm::UInt8> compressed;
+  if (!LZCompress(reinterpret_cast<const vtkm::UInt8*>(input), numBytes, compressed))
+  {
+    codec = vtkm::cont::SerializationCodec::None;
+    return {};
+  }
+  return std::vector<char>(compressed.begin(), compressed.end());
+}
+
+void DecodeBytes(const char* encoded,
+                 std::size_t numEncodedBytes,
+                 vtkm::cont::SerializationCodec codec,
+                 const SerializationCodecLayout& layout,
+                 void* output,
+                 std::size_t numBytes)
+{
+  CheckCodec(codec);
+  char* out = static_cast<char*>(output);
+  if (codec == vtkm::cont::SerializationCodec::None)
+  {
+    if (numEncodedBytes != numBytes)
+    {
+      LZCorrupt();
+    }
+    if (numBytes > 0)
+    {
+      std::memcpy(out, encoded, numBytes);
+    }
+    return;
+  }
+  if ((layout.ValueSize == 0) ||
+      ((layout.IntegerSize > 0) && (layout.ValueSize % layout.IntegerSize != 0)))
+  {
+    throw vtkm::cont::ErrorBadValue("Bad value layout for serialized buffer.");
+  }
+
+  const bool shuffle = UseShuffle(codec, layout);
+  std::vector<char> shuffled(shuffle ? numBytes : 0);
+  LZDecompress(reinterpret_cast<const vtkm::UInt8*>(encoded),
+               numEncodedBytes,
+               reinterpret_cast<vtkm::UInt8*>(shuffle ? shuffled.data() : out),
+               numBytes);
+  if (shuffle)
+  {
+    Unshuffle(shuffled.data(), out, numBytes, layout.ValueSize);
+  }
+  if (UseDelta(codec, layout))
+  {
+    Delta<false>(out, numBytes, layout);
+  }
+}
+
+void SaveEncodedBuffer(mangled_diy_namespace::BinaryBuffer& bb,
+                       const vtkm::cont::internal::Buffer& buffer,
+                       const SerializationCodecLayout& layout)
+{
+  vtkm::cont::SerializationCodec codec = vtkm::cont::GetSerializationCodec();
+  if ((codec == vtkm::cont::SerializationCodec::None) && !BufferStartsWithEncodedBlobMarker(buffer))
+  {
+    // Without a codec the buffer is saved as it was before codecs existed, as a raw blob that is
+    // handed to DIY without a copy.
+    vtkmdiy::save(bb, buffer);
+    return;
+  }
+
+  std::vector<char> encoded;
+  const std::size_t numBytes = static_cast<std::size_t>(buffer.GetNumberOfBytes());
+  vtkm::cont::Token token;
+  const char* data =
+    (numBytes > 0) ? static_cast<const char*>(buffer.ReadPointerHost(token)) : nullptr;
+  if (codec != vtkm::cont::SerializationCodec::None)
+  {
+    if (numBytes > 0)
+    {
+      encoded = EncodeBytes(data, numBytes, codec, layout);
+    }
+    else
+    {
+      codec = vtkm::cont::SerializationCodec::None;
+    }
+    if ((codec == vtkm::cont::SerializationCodec::None) &&
+        !StartsWithEncodedBlobMarker(data, numBytes))
+    {
+      vtkmdiy::save(bb, buffer);
+      return;
+    }
+  }
+  if (codec == vtkm::cont::SerializationCodec::None)
+  {
+    // Raw data that looks like an encoded blob is framed so that it is not mistaken for one.
+    encoded.assign(data, data + numBytes);
+  }
+
+  mangled_diy_namespace::MemoryBuffer frame;
+  frame.save_binary(EncodedBlobMarker, sizeof(EncodedBlobMarker));
+  vtkmdiy::save(frame, static_cast<vtkm::UInt8>(codec));
+  SaveEncodedHeader(frame, layout, numBytes, encoded);
+  auto blob = new std::vector<char>(std::move(frame.buffer));
+  bb.save_binary_blob(blob->data(), blob->size(), [blob](const char[]) { delete blob; });
+}
+
+void LoadEncodedBuffer(mangled_diy_namespace::BinaryBuffer& bb,
+                       vtkm::cont::internal::Buffer& buffer)
+{
+  auto blob = bb.load_binary_blob();
+  const char* data = blob.pointer.get();
+  vtkm::cont::Token token;
+  if (!StartsWithEncodedBlobMarker(data, blob.size))
+  {
+    // A raw blob, saved without a codec (see `Serialization<Buffer>::load`).
+    const vtkm::BufferSizeType size = static_cast<vtkm::BufferSizeType>(blob.size);
+    buffer.SetNumberOfBytes(size, vtkm::CopyFlag::Off, token);
+    if (size > 0)
+    {
+      auto device = vtkm::cont::GetDIYDeviceAdapter();
+      void* ptr = buffer.WritePointerDevice(device, token);
+      vtkm::cont::RuntimeDeviceInformation().GetMemoryManager(device).CopyDeviceToDeviceRawPointer(
+        data, ptr, size);
+    }
+    return;
+  }
+
+  std::size_t position = sizeof(EncodedBlobMarker);
+  auto read = [&](auto& value) {
+    if (sizeof(value) > blob.size - position)
+    {
+      LZCorrupt();
+    }
+    std::memcpy(&value, data + position, sizeof(value));
+    position += sizeof(value);
+  };
+
+  vtkm::UInt8 codecValue;
+  SerializationCodecLayout layout;
+  vtkm::UInt64 numBytes;
+  vtkm::UInt64 numEncodedBytes;
+  read(codecValue);
+  read(layout.ValueSize);
+  read(layout.IntegerSize);
+  read(numBytes);
+  read(numEncodedBytes);
+  const auto codec = static_cast<vtkm::cont::SerializationCodec>(codecValue);
+  CheckCodec(codec);
+  if (numEncodedBytes != blob.size - position)
+  {
+    LZCorrupt();
+  }
+
+  buffer.SetNumberOfBytes(static_cast<vtkm::BufferSizeType>(numBytes), vtkm::CopyFlag::Off, token);
+  DecodeBytes(data + position,
+              static_cast<std::size_t>(numEncodedBytes),
+              codec,
+              layout,
+              buffer.WritePointerHost(token),
+              static_cast<std::size_t>(numBytes));
+}
+
+void EncodeMemoryBuffer(mangled_diy_namespace::MemoryBuffer& bb)
+{
+  // Messages are a mix of values of different types, so they are compressed as plain bytes.
+  const SerializationCodecLayout layout;
+  vtkm::cont::SerializationCodec codec = vtkm::cont::GetSerializationCodec();
+  std::vector<char> encoded = EncodeBytes(bb.buffer.data(), bb.buffer.size(), codec, layout);
+  if (codec != vtkm::cont::SerializationCodec::None)
+  {
+    mangled_diy_namespace::MemoryBuffer result;
+    SaveEncodedHeader(result, layout, bb.buffer.size(), encoded);
+    bb.buffer.swap(result.buffer);
+  }
+
+  // The codec goes last so that a message sent without a codec is not copied.
+  bb.buffer.push_back(static_cast<char>(codec));
+  bb.reset();
+}
+
+void DecodeMemoryBuffer(mangled_diy_namespace::MemoryBuffer& bb)
+{
+  bb.reset();
+  if (bb.buffer.empty())
+  {
+    LZCorrupt();
+  }
+  const auto codec = static_cast<vtkm::cont::SerializationCodec>(bb.buffer.back());
+  CheckCodec(codec);
+  bb.buffer.pop_back();
+  if (codec == vtkm::cont::SerializationCodec::None)
+  {
+    return;
+  }
+
+  const std::size_t available = bb.buffer.size();
+  auto checkSize = [&](std::size_t numBytes) {
+    if (numBytes > available - bb.position)
+    {
+      LZCorrupt();
+    }
+  };
+
+  SerializationCodecLayout layout;
+  vtkm::UInt64 numBytes;
+  vtkm::UInt64 numEncodedBytes;
+  checkSize(sizeof(layout.ValueSize) + sizeof(layout.IntegerSize) + 2 * sizeof(numBytes));
+  vtkmdiy::load(bb, layout.ValueSize);
+  vtkmdiy::load(bb, layout.IntegerSize);
+  vtkmdiy::load(bb, numBytes);
+  vtkmdiy::load(bb, numEncodedBytes);
+  if (numEncodedBytes != available - bb.position)
+  {
+    LZCorrupt();
+  }
+
+  std::vector<char> decoded(static_cast<std::size_t>(numBytes));
+  DecodeBytes(bb.buffer.data() + bb.position,
+              static_cast<std::size_t>(numEncodedBytes),
+              codec,
+              layout,
+              decoded.data(),
+              decoded.size());
+
+  bb.buffer.swap(decoded);
+  bb.reset();
+}
+
+} // namespace internal
+}
+} // namespace vtkm::cont
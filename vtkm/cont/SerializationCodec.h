@@ -0,0 +1,201 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_SerializationCodec_h
+#define vtk_m_cont_SerializationCodec_h
+
+#include <vtkm/VecTraits.h>
+
+#include <vtkm/cont/Serialization.h>
+#include <vtkm/cont/internal/Buffer.h>
+
+#include <type_traits>
+#include <vector>
+
+namespace vtkm
+{
+namespace cont
+{
+
+/// \brief Lossless codecs applied to array data when it is serialized.
+///
+/// The codec is applied to the data of basic, SOA and stride arrays when they are saved to a
+/// DIY buffer (for example when they are exchanged between ranks), and to the messages sent by
+/// the particle advection messengers. The stages of the codecs are:
+///
+/// - *delta*: each integer component is replaced by its difference with the same component of
+///   the previous value. Slowly varying integers, such as cell connectivity or point ids, turn
+///   into small numbers.
+/// - *shuffle*: the bytes of the values are regrouped so that byte `k` of every value is stored
+///   together. The high bytes of small integers and the exponents of floats become long runs.
+/// - *LZ*: a fast LZ77 compressor using the block layout of LZ4.
+///
+/// With `SerializationCodec::None`, array buffers are saved exactly as before codecs existed, so
+/// peers built without codecs can still exchange arrays. (The only exception are buffers whose
+/// first 8 bytes happen to be the marker of encoded buffers, which are framed so that the raw data
+/// is never ambiguous.) When a codec is selected, each encoded
+/// buffer starts with a marker followed by how it was encoded. The stream therefore describes
+/// itself: the side that loads the data does not need to select the same codec, or any codec,
+/// which matters because `ScopedSerializationCodec` only applies to the calling thread and not to
+/// the worker threads of DIY. Only peers built without codecs cannot read encoded buffers. When a
+/// codec does not make the data smaller, the data is saved raw.
+///
+enum class SerializationCodec : vtkm::UInt8
+{
+  /// Save raw bytes. The data is handed to DIY without a copy.
+  None = 0,
+  /// Compress the bytes with LZ.
+  LZ = 1,
+  /// Shuffle the bytes of the values, then compress with LZ.
+  ShuffleLZ = 2,
+  /// Take the delta of integer components, shuffle, then compress with LZ. Floating point
+  /// values skip the delta stage.
+  DeltaShuffleLZ = 3
+};
+
+/// \brief Sets the codec used when serializing array data.
+///
+/// This is the default for all threads. The default is `SerializationCodec::None`. The ranks that
+/// load the arrays do not need to select the same codec (see `SerializationCodec`).
+///
+VTKM_CONT_EXPORT VTKM_CONT void SetSerializationCodec(vtkm::cont::SerializationCodec codec);
+
+/// \brief Returns the codec used when serializing array data in this thread.
+///
+/// This is the codec of the innermost `ScopedSerializationCodec` of the calling thread, if any,
+/// or else the one set with `SetSerializationCodec`.
+///
+VTKM_CONT_EXPORT VTKM_CONT vtkm::cont::SerializationCodec GetSerializationCodec();
+
+/// \brief Selects the codec used when serializing array data for the lifetime of the object.
+///
+/// This only affects the calling thread, so it can be used to pick a codec for a single
+/// exchange. Arrays saved by other threads, such as the worker threads of a DIY `Master` with
+/// more than one thread, use the codec set with `SetSerializationCodec`.
+///
+/// \code{.cpp}
+/// {
+///   vtkm::cont::ScopedSerializationCodec codec(vtkm::cont::SerializationCodec::DeltaShuffleLZ);
+///   vtkm::cont::DIYMasterExchange(master);
+/// }
+/// \endcode
+///
+class VTKM_CONT_EXPORT ScopedSerializationCodec
+{
+public:
+  VTKM_CONT explicit ScopedSerializationCodec(vtkm::cont::SerializationCodec codec);
+  VTKM_CONT ~ScopedSerializationCodec();
+
+  ScopedSerializationCodec(const ScopedSerializationCodec&) = delete;
+  ScopedSerializationCodec& operator=(const ScopedSerializationCodec&) = delete;
+
+private:
+  vtkm::UInt8 Previous;
+};
+
+namespace internal
+{
+
+/// \brief Describes the values of a run of bytes to the codecs.
+///
+/// `ValueSize` is the number of bytes of each value, which the shuffle stage groups by.
+/// `IntegerSize` is the size of the components of the values if they are integers, or 0
+/// otherwise, in which case the delta stage is skipped.
+///
+struct SerializationCodecLayout
+{
+  vtkm::UInt32 ValueSize = 1;
+  vtkm::UInt8 IntegerSize = 0;
+};
+
+template <typename T>
+VTKM_CONT SerializationCodecLayout MakeSerializationCodecLayout()
+{
+  using ComponentType = typename vtkm::VecTraits<T>::BaseComponentType;
+  SerializationCodecLayout layout;
+  layout.ValueSize = static_cast<vtkm::UInt32>(sizeof(T));
+  if (std::is_integral<ComponentType>::value && (sizeof(T) % sizeof(ComponentType) == 0))
+  {
+    layout.IntegerSize = static_cast<vtkm::UInt8>(sizeof(ComponentType));
+  }
+  return layout;
+}
+
+/// \brief Encodes `numBytes` bytes with `codec`.
+///
+/// The encoded bytes are returned. If the codec does not make the data smaller, an empty
+/// vector is returned and `codec` is set to `SerializationCodec::None`.
+///
+VTKM_CONT_EXPORT VTKM_CONT std::vector<char> EncodeBytes(const void* data,
+                                                         std::size_t numBytes,
+                                                         vtkm::cont::SerializationCodec& codec,
+                                                         const SerializationCodecLayout& layout);
+
+/// \brief Decodes bytes produced by `EncodeBytes` into `numBytes` bytes at `output`.
+///
+/// Throws `vtkm::cont::ErrorBadValue` if the encoded bytes are corrupt.
+///
+VTKM_CONT_EXPORT VTKM_CONT void DecodeBytes(const char* encoded,
+                                            std::size_t numEncodedBytes,
+                                            vtkm::cont::SerializationCodec codec,
+                                            const SerializationCodecLayout& layout,
+                                            void* output,
+                                            std::size_t numBytes);
+
+/// \brief Saves a buffer with the codec returned by `GetSerializationCodec`.
+///
+/// With `SerializationCodec::None`, this is the same as `vtkmdiy::save(bb, buffer)`, except for
+/// buffers starting with the marker of encoded buffers. Those are framed as encoded buffers
+/// without a codec so that they cannot be mistaken for one.
+///
+VTKM_CONT_EXPORT VTKM_CONT void SaveEncodedBuffer(mangled_diy_namespace::BinaryBuffer& bb,
+                                                  const vtkm::cont::internal::Buffer& buffer,
+                                                  const SerializationCodecLayout& layout);
+
+template <typename T>
+VTKM_CONT void SaveEncodedBuffer(mangled_diy_namespace::BinaryBuffer& bb,
+                                 const vtkm::cont::internal::Buffer& buffer)
+{
+  SaveEncodedBuffer(bb, buffer, MakeSerializationCodecLayout<T>());
+}
+
+/// \brief Loads a buffer saved with `SaveEncodedBuffer`.
+///
+/// How the buffer was encoded is read from the stream, so the codec returned by
+/// `GetSerializationCodec` does not matter. Throws `vtkm::cont::ErrorBadValue` if an encoded
+/// buffer is corrupt.
+///
+VTKM_CONT_EXPORT VTKM_CONT void LoadEncodedBuffer(mangled_diy_namespace::BinaryBuffer& bb,
+                                                  vtkm::cont::internal::Buffer& buffer);
+
+/// Largest number of bytes that `EncodeMemoryBuffer` adds to a buffer.
+constexpr std::size_t MemoryBufferEncodingOverhead =
+  2 * sizeof(vtkm::UInt8) + sizeof(vtkm::UInt32) + 2 * sizeof(vtkm::UInt64);
+
+/// \brief Replaces the contents of a memory buffer with their encoding.
+///
+/// Only the bytes of the buffer are encoded; binary blobs are left alone. The buffer is
+/// rewound. The codec is appended as a last byte, so the receiver must call
+/// `DecodeMemoryBuffer` even when the codec is `SerializationCodec::None`. With
+/// `SerializationCodec::None`, that byte is all that is added and the data are not copied.
+///
+VTKM_CONT_EXPORT VTKM_CONT void EncodeMemoryBuffer(mangled_diy_namespace::MemoryBuffer& bb);
+
+/// \brief Reverts `EncodeMemoryBuffer`. The buffer is rewound.
+///
+/// The buffer must hold exactly the bytes produced by `EncodeMemoryBuffer`, since the codec is
+/// read from its last byte.
+///
+VTKM_CONT_EXPORT VTKM_CONT void DecodeMemoryBuffer(mangled_diy_namespace::MemoryBuffer& bb);
+
+} // namespace internal
+}
+} // namespace vtkm::cont
+
+#endif //vtk_m_cont_SerializationCodec_h
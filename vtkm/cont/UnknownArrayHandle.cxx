@@ -428,6 +428,21 @@ VTKM_CONT void UnknownArrayHandle::ReleaseResources() const
   }
 }
 
+VTKM_CONT std::vector<vtkm::UInt64> UnknownArrayHandle::GetBufferVersions() const
+{
+  std::vector<vtkm::UInt64> versions;
+  if (this->Container)
+  {
+    const auto& buffers = this->Container->Buffers(this->Container->ArrayHandlePointer);
+    versions.reserve(buffers.size());
+    for (const vtkm::cont::internal::Buffer& buffer : buffers)
+    {
+      versions.push_back(buffer.GetVersion());
+    }
+  }
+  return versions;
+}
+
 VTKM_CONT void UnknownArrayHandle::PrintSummary(std::ostream& out, bool full) const
 {
   if (this->Container)
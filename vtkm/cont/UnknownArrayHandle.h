@@ -939,6 +939,14 @@ public:
   ///
   VTKM_CONT void ReleaseResources() const;
 
+  /// \brief Returns the version stamps of the buffers of the contained array.
+  ///
+  /// The stamps change whenever the data of the array might have been modified (see
+  /// `vtkm::cont::internal::Buffer::GetVersion`), so comparing them with an earlier call tells
+  /// whether results derived from the array are still current. An empty handle has no stamps.
+  ///
+  VTKM_CONT std::vector<vtkm::UInt64> GetBufferVersions() const;
+
   VTKM_CONT void PrintSummary(std::ostream& out, bool full = false) const;
 };
 
@@ -0,0 +1,121 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/internal/AsyncInvokeQueue.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+
+// The workers only wait on the launches; the worklets themselves run on the threads of the
+// device. A few workers are enough to overlap independent launches.
+constexpr vtkm::IdComponent NumberOfWorkers = 4;
+constexpr vtkm::IdComponent MaximumPendingLaunches = 64;
+
+thread_local bool IsWorkerThread = false;
+
+class LaunchQueue
+{
+public:
+  LaunchQueue()
+  {
+    for (vtkm::IdComponent i = 0; i < NumberOfWorkers; ++i)
+    {
+      // The queue is never destroyed, so the workers can outlive `main` waiting for work.
+      std::thread([this]() { this->RunWorker(); }).detach();
+    }
+  }
+
+  void Push(const std::function<void()>& enqueue, std::function<void()>&& launch)
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->HasRoom.wait(lock, [this]() {
+      return this->Launches.size() < static_cast<std::size_t>(MaximumPendingLaunches);
+    });
+    this->Launches.push_back(std::move(launch));
+    try
+    {
+      enqueue();
+    }
+    catch (...)
+    {
+      this->Launches.pop_back();
+      throw;
+    }
+    this->HasLaunches.notify_one();
+  }
+
+private:
+  void RunWorker()
+  {
+    IsWorkerThread = true;
+    while (true)
+    {
+      std::function<void()> launch;
+      {
+        std::unique_lock<std::mutex> lock(this->Mutex);
+        this->HasLaunches.wait(lock, [this]() { return !this->Launches.empty(); });
+        launch = std::move(this->Launches.front());
+        this->Launches.pop_front();
+      }
+      this->HasRoom.notify_one();
+      launch();
+    }
+  }
+
+  std::mutex Mutex;
+  std::condition_variable HasLaunches;
+  std::condition_variable HasRoom;
+  std::deque<std::function<void()>> Launches;
+};
+
+LaunchQueue& GetLaunchQueue()
+{
+  static LaunchQueue* queue = new LaunchQueue;
+  return *queue;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+void AsyncInvokeQueue::Push(const std::function<void()>& enqueue, std::function<void()> launch)
+{
+  if (IsWorkerThread)
+  {
+    enqueue();
+    launch();
+    return;
+  }
+  GetLaunchQueue().Push(enqueue, std::move(launch));
+}
+
+vtkm::IdComponent AsyncInvokeQueue::GetNumberOfWorkers()
+{
+  return NumberOfWorkers;
+}
+
+vtkm::IdComponent AsyncInvokeQueue::GetMaximumPendingLaunches()
+{
+  return MaximumPendingLaunches;
+}
+
+}
+}
+} // namespace vtkm::cont::internal
@@ -0,0 +1,60 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_internal_AsyncInvokeQueue_h
+#define vtk_m_cont_internal_AsyncInvokeQueue_h
+
+#include <vtkm/Types.h>
+
+#include <vtkm/cont/vtkm_cont_export.h>
+
+#include <functional>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+/// \brief The queue of the launches made with `Invoker::Async`.
+///
+/// The launches are run by a fixed set of worker threads that are started with the first
+/// launch and live until the program ends, so an asynchronous launch does not pay for
+/// starting a thread. The workers take the launches in the order they were pushed. At most
+/// `GetMaximumPendingLaunches` launches wait in the queue; pushing more blocks the caller
+/// until a worker takes one.
+///
+class VTKM_CONT_EXPORT AsyncInvokeQueue
+{
+public:
+  /// \brief Adds a launch to the queue.
+  ///
+  /// `enqueue` is called right after the launch is added, under the lock of the queue, so
+  /// that the tokens it places on the arrays of the launch are in the same order as the
+  /// launches. A worker cannot take the launch before `enqueue` returns. When called from a
+  /// worker thread (a launch making an asynchronous launch), `enqueue` and `launch` are run
+  /// right away on the calling thread, since waiting for a free worker could deadlock.
+  /// Exceptions thrown before `launch` is queued (such as failing to start the workers) are
+  /// passed on, and `enqueue` is then not called.
+  ///
+  static VTKM_CONT void Push(const std::function<void()>& enqueue, std::function<void()> launch);
+
+  /// Number of worker threads running the launches.
+  static VTKM_CONT vtkm::IdComponent GetNumberOfWorkers();
+
+  /// Number of launches that can wait in the queue before `Push` blocks.
+  static VTKM_CONT vtkm::IdComponent GetMaximumPendingLaunches();
+};
+
+}
+}
+} // namespace vtkm::cont::internal
+
+#endif //vtk_m_cont_internal_AsyncInvokeQueue_h
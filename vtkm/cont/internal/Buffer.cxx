@@ -15,6 +15,7 @@
 #include <vtkm/cont/ErrorBadAllocation.h>
 #include <vtkm/cont/ErrorBadDevice.h>
 #include <vtkm/cont/ErrorBadType.h>
+#include <vtkm/cont/Profiler.h>
 #include <vtkm/cont/RuntimeDeviceInformation.h>
 #include <vtkm/cont/TryExecute.h>
 
@@ -23,6 +24,7 @@
 
 #include <vtkm/exec/FunctorBase.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <cstring>
 #include <deque>
@@ -258,6 +260,20 @@ namespace cont
 namespace internal
 {
 
+namespace
+{
+
+// Source of the version stamps of all buffers. Sharing one counter keeps stamps unique even when
+// a buffer is replaced by a different one.
+std::atomic<vtkm::UInt64> GlobalBufferVersion{ 0 };
+
+vtkm::UInt64 NextBufferVersion()
+{
+  return ++GlobalBufferVersion;
+}
+
+} // anonymous namespace
+
 class Buffer::InternalsStruct
 {
 public:
@@ -281,6 +297,8 @@ private:
   DeviceBufferMap DeviceBuffers;
   BufferState HostBuffer;
 
+  vtkm::UInt64 Version = NextBufferVersion();
+
 public:
   std::mutex Mutex;
   std::condition_variable ConditionVariable;
@@ -328,6 +346,18 @@ public:
     this->CheckLock(lock);
     this->NumberOfBytes = numberOfBytes;
   }
+
+  VTKM_CONT vtkm::UInt64 GetVersion(const LockType& lock)
+  {
+    this->CheckLock(lock);
+    return this->Version;
+  }
+  // Called whenever the data might be modified.
+  VTKM_CONT void Modified(const LockType& lock)
+  {
+    this->CheckLock(lock);
+    this->Version = NextBufferVersion();
+  }
 };
 
 namespace detail
@@ -362,6 +392,20 @@ struct VTKM_NEVER_EXPORT BufferHelper
     queue.push_back(token.GetReference());
   }
 
+  static void Dequeue(const std::shared_ptr<Buffer::InternalsStruct>& internals,
+                      const LockType& lock,
+                      const vtkm::cont::Token& token)
+  {
+    auto& queue = internals->GetQueue(lock);
+    auto entry = std::find(queue.begin(), queue.end(), token.GetReference());
+    if (entry != queue.end())
+    {
+      queue.erase(entry);
+      // Someone else might now be at the front of the queue.
+      internals->ConditionVariable.notify_all();
+    }
+  }
+
   static bool CanRead(const std::shared_ptr<Buffer::InternalsStruct>& internals,
                       const LockType& lock,
                       const vtkm::cont::Token& token)
@@ -489,6 +533,7 @@ struct VTKM_NEVER_EXPORT BufferHelper
     BufferHelper::WaitToWrite(internals, lock, token);
 
     internals->SetNumberOfBytes(lock, numberOfBytes);
+    internals->Modified(lock);
     if ((preserve == vtkm::CopyFlag::Off) || (numberOfBytes == 0))
     {
       // No longer need these buffers. Just release them.
@@ -505,6 +550,28 @@ struct VTKM_NEVER_EXPORT BufferHelper
     }
   }
 
+  // Devices that share memory with the host hand back the same memory instead of copying, so
+  // only record a transfer when the data actually moved.
+  static void RecordTransfer(vtkm::cont::DeviceAdapterId device,
+                             bool toDevice,
+                             const BufferState& source,
+                             const BufferState& destination,
+                             vtkm::Float64 startTime)
+  {
+    if (source.GetPointer() == destination.GetPointer())
+    {
+      return;
+    }
+    vtkm::cont::ProfilerTransferRecord record;
+    record.Device = device;
+    record.ToDevice = toDevice;
+    record.NumberOfBytes = destination.GetSize();
+    record.StartTime = startTime;
+    record.ElapsedTime = vtkm::cont::detail::ProfilerTime() - startTime;
+    record.ThreadIndex = vtkm::cont::detail::ProfilerThreadIndex();
+    vtkm::cont::detail::ProfilerRecordTransfer(record);
+  }
+
   static void AllocateOnHost(const std::shared_ptr<Buffer::InternalsStruct>& internals,
                              std::unique_lock<std::mutex>& lock,
                              vtkm::cont::Token& token,
@@ -540,6 +607,8 @@ struct VTKM_NEVER_EXPORT BufferHelper
         deviceBuffer.second.Reallocate(targetSize);
       }
 
+      const bool profile = vtkm::cont::GetProfilingEnabled();
+      vtkm::Float64 startTime = profile ? vtkm::cont::detail::ProfilerTime() : 0;
       if (!hostBuffer.Pinned)
       {
         hostBuffer = memoryManager.CopyDeviceToHost(deviceBuffer.second);
@@ -549,6 +618,10 @@ struct VTKM_NEVER_EXPORT BufferHelper
         hostBuffer.Reallocate(targetSize);
         memoryManager.CopyDeviceToHost(deviceBuffer.second, hostBuffer);
       }
+      if (profile)
+      {
+        RecordTransfer(deviceBuffer.first, false, deviceBuffer.second, hostBuffer, startTime);
+      }
 
       if (hostBuffer.GetSize() != targetSize)
       {
@@ -621,6 +694,8 @@ struct VTKM_NEVER_EXPORT BufferHelper
         hostBuffer.Reallocate(targetSize);
       }
 
+      const bool profile = vtkm::cont::GetProfilingEnabled();
+      vtkm::Float64 startTime = profile ? vtkm::cont::detail::ProfilerTime() : 0;
       if (!deviceBuffers[device].Pinned)
       {
         deviceBuffers[device] = memoryManager.CopyHostToDevice(hostBuffer);
@@ -630,6 +705,10 @@ struct VTKM_NEVER_EXPORT BufferHelper
         deviceBuffers[device].Reallocate(targetSize);
         memoryManager.CopyHostToDevice(hostBuffer, deviceBuffers[device]);
       }
+      if (profile)
+      {
+        RecordTransfer(device, true, hostBuffer, deviceBuffers[device], startTime);
+      }
 
       if (deviceBuffers[device].GetSize() != targetSize)
       {
@@ -683,6 +762,7 @@ struct VTKM_NEVER_EXPORT BufferHelper
                 static_cast<std::size_t>(size));
 
     destInternals->MetaData.DeepCopyFrom(srcInternals->MetaData);
+    destInternals->Modified(destLock);
   }
 
   static void CopyOnDevice(
@@ -725,6 +805,7 @@ struct VTKM_NEVER_EXPORT BufferHelper
     destInternals->SetNumberOfBytes(destLock, srcInternals->GetNumberOfBytes(srcLock));
 
     destInternals->MetaData.DeepCopyFrom(srcInternals->MetaData);
+    destInternals->Modified(destLock);
   }
 };
 
@@ -770,6 +851,12 @@ vtkm::BufferSizeType Buffer::GetNumberOfBytes() const
   return this->Internals->GetNumberOfBytes(lock);
 }
 
+vtkm::UInt64 Buffer::GetVersion() const
+{
+  LockType lock = this->Internals->GetLock();
+  return this->Internals->GetVersion(lock);
+}
+
 void Buffer::SetNumberOfBytes(vtkm::BufferSizeType numberOfBytes,
                               vtkm::CopyFlag preserve,
                               vtkm::cont::Token& token) const
@@ -794,6 +881,9 @@ void Buffer::SetMetaData(void* data,
                          detail::CopierType* copier) const
 {
   this->Internals->MetaData.Initialize(data, type, deleter, copier);
+
+  LockType lock = this->Internals->GetLock();
+  this->Internals->Modified(lock);
 }
 
 void* Buffer::GetMetaData(const std::string& type) const
@@ -901,6 +991,8 @@ void* Buffer::WritePointerHost(vtkm::cont::Token& token) const
   detail::BufferHelper::AllocateOnHost(
     this->Internals, lock, token, detail::BufferHelper::AccessMode::WRITE);
 
+  this->Internals->Modified(lock);
+
   // Array is being written on host. All other buffers invalidated, so delete them.
   for (auto&& deviceBuffer : this->Internals->GetDeviceBuffers(lock))
   {
@@ -919,6 +1011,8 @@ void* Buffer::WritePointerDevice(vtkm::cont::DeviceAdapterId device, vtkm::cont:
     detail::BufferHelper::AllocateOnDevice(
       this->Internals, lock, token, device, detail::BufferHelper::AccessMode::WRITE);
 
+    this->Internals->Modified(lock);
+
     // Array is being written on this device. All other buffers invalided, so delete them.
     this->Internals->GetHostBuffer(lock).Release();
     for (auto&& deviceBuffer : this->Internals->GetDeviceBuffers(lock))
@@ -947,6 +1041,12 @@ void Buffer::Enqueue(const vtkm::cont::Token& token) const
   detail::BufferHelper::Enqueue(this->Internals, lock, token);
 }
 
+void Buffer::Dequeue(const vtkm::cont::Token& token) const
+{
+  LockType lock = this->Internals->GetLock();
+  detail::BufferHelper::Dequeue(this->Internals, lock, token);
+}
+
 void Buffer::DeepCopyFrom(const vtkm::cont::internal::Buffer& src) const
 {
   // A Token should not be declared within the scope of a lock. when the token goes out of scope
@@ -1030,6 +1130,7 @@ void Buffer::Reset(const vtkm::cont::internal::BufferInfo& bufferInfo)
   }
 
   this->Internals->SetNumberOfBytes(lock, bufferInfo.GetSize());
+  this->Internals->Modified(lock);
 }
 
 void Buffer::ReleaseDeviceResources() const
@@ -125,6 +125,15 @@ public:
                                   vtkm::CopyFlag preserve,
                                   vtkm::cont::Token& token) const;
 
+  /// \brief Returns a stamp that changes whenever the data of the buffer might change.
+  ///
+  /// A new stamp is taken each time a write pointer is acquired, the buffer is resized, reset,
+  /// filled, or copied into. Stamps are unique across all buffers, so two buffers never share
+  /// one. This lets objects that derive results from the data (such as the range cached in a
+  /// `vtkm::cont::Field`) tell whether those results are out of date.
+  ///
+  VTKM_CONT vtkm::UInt64 GetVersion() const;
+
 private:
   VTKM_CONT bool MetaDataIsType(const std::string& type) const;
   VTKM_CONT void SetMetaData(void* data,
@@ -246,12 +255,18 @@ public:
   /// `ReadPointerDevice`), it will use this place in the queue while waiting for
   ///
   /// \warning After calling this method it is required to subsequently call a
-  /// method that attaches the token to this `Buffer`. Otherwise, the enqueued
-  /// token will block any subsequent access to the `ArrayHandle`, even if the
+  /// method that attaches the token to this `Buffer` (or to call `Dequeue`). Otherwise, the
+  /// enqueued token will block any subsequent access to the `ArrayHandle`, even if the
   /// `Token` is destroyed.
   ///
   VTKM_CONT void Enqueue(const vtkm::cont::Token& token) const;
 
+  /// \brief Remove a token from the queue of tokens waiting for access to the buffer.
+  ///
+  /// Nothing happens if the token is not in the queue.
+  ///
+  VTKM_CONT void Dequeue(const vtkm::cont::Token& token) const;
+
   /// @{
   /// \brief Copies the data from the provided buffer into this buffer.
   ///
@@ -10,6 +10,8 @@
 
 #include <vtkm/cont/ErrorBadAllocation.h>
 #include <vtkm/cont/internal/DeviceAdapterMemoryManager.h>
+#include <vtkm/cont/internal/FileMappedMemory.h>
+#include <vtkm/cont/internal/HostMemoryPool.h>
 
 #include <vtkm/Math.h>
 
@@ -309,6 +311,22 @@ TransferredBuffer BufferInfo::TransferOwnership()
 //----------------------------------------------------------------------------------------
 vtkm::cont::internal::BufferInfo AllocateOnHost(vtkm::BufferSizeType size)
 {
+  if (vtkm::cont::internal::ShouldSpillHostAllocation(size))
+  {
+    vtkm::cont::internal::BufferInfo spilled =
+      vtkm::cont::internal::AllocateSpilledHostMemory(size);
+    if (spilled.GetPointer() != nullptr)
+    {
+      return spilled;
+    }
+    // Could not create the spill file. Fall back to system memory.
+  }
+
+  if (vtkm::cont::internal::GetHostMemoryPoolEnabled())
+  {
+    return vtkm::cont::internal::AllocateFromHostMemoryPool(size);
+  }
+
   void* memory = HostAllocate(size);
 
   return vtkm::cont::internal::BufferInfo(
@@ -84,6 +84,13 @@ void DeviceAdapterMemoryManagerShared::CopyDeviceToDevice(
   std::memcpy(dest.GetPointer(), src.GetPointer(), static_cast<std::size_t>(src.GetSize()));
 }
 
+void* DeviceAdapterMemoryManagerShared::AllocateRawPointer(vtkm::BufferSizeType size) const
+{
+  // Raw pointers are freed with `DeleteRawPointer`, which knows nothing about the host memory
+  // pool. Thus, they bypass the pool.
+  return vtkm::cont::internal::HostAllocate(size);
+}
+
 void DeviceAdapterMemoryManagerShared::DeleteRawPointer(void* mem) const
 {
   vtkm::cont::internal::HostDeleter(mem);
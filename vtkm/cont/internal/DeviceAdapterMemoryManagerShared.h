@@ -51,6 +51,8 @@ public:
     const vtkm::cont::internal::BufferInfo& src,
     const vtkm::cont::internal::BufferInfo& dest) const override;
 
+  VTKM_CONT virtual void* AllocateRawPointer(vtkm::BufferSizeType size) const override;
+
   VTKM_CONT virtual void DeleteRawPointer(void* mem) const override;
 };
 }
@@ -0,0 +1,566 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandleFileMapped.h>
+#include <vtkm/cont/internal/FileMappedMemory.h>
+
+#include <vtkm/Math.h>
+#include <vtkm/cont/ErrorBadAllocation.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#if defined(VTKM_POSIX)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+// A file mapped into memory. This is the container of the buffers created by `MapFile` and
+// `AllocateSpilledHostMemory`.
+struct FileMapping
+{
+  int FileDescriptor = -1;
+  void* Data = nullptr;
+  vtkm::BufferSizeType Size = 0;
+  // Shared mappings write to the file. Private mappings keep modified pages in memory.
+  bool Shared = false;
+  // Set once a private mapping has been reallocated into regular host memory.
+  void* HostMemory = nullptr;
+};
+
+struct FileMappedMemoryState
+{
+  std::mutex Mutex;
+  vtkm::BufferSizeType Budget = std::numeric_limits<vtkm::BufferSizeType>::max();
+
+  // Checked on every host allocation, so they can be read without the lock.
+  std::atomic<bool> SpillEnabled{ false };
+  std::atomic<vtkm::BufferSizeType> SpillThreshold{ vtkm::BufferSizeType{ 64 } << 20 };
+  std::string SpillDirectory;
+
+  // Live mappings, least recently created or resized first.
+  std::list<FileMapping*> Mappings;
+
+  vtkm::cont::internal::FileMappedMemoryStatistics Statistics;
+};
+
+FileMappedMemoryState& GetState()
+{
+  // Intentionally never destroyed. Buffers held in static objects may be released after this
+  // function's statics would have been destroyed.
+  static FileMappedMemoryState* state = new FileMappedMemoryState;
+  return *state;
+}
+
+#if defined(VTKM_POSIX)
+
+#if defined(__APPLE__)
+using MincoreVecType = char;
+#else
+using MincoreVecType = unsigned char;
+#endif
+
+std::size_t GetPageSize()
+{
+  static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  return pageSize;
+}
+
+std::string ErrorString()
+{
+  return std::strerror(errno);
+}
+
+void* MapDescriptor(int fileDescriptor, vtkm::BufferSizeType numBytes, bool shared)
+{
+  if (numBytes <= 0)
+  {
+    return nullptr;
+  }
+  void* data = mmap(nullptr,
+                    static_cast<std::size_t>(numBytes),
+                    PROT_READ | PROT_WRITE,
+                    shared ? MAP_SHARED : MAP_PRIVATE,
+                    fileDescriptor,
+                    0);
+  return (data != MAP_FAILED) ? data : nullptr;
+}
+
+vtkm::BufferSizeType GetResidentBytes(const FileMapping& mapping)
+{
+  if (mapping.Data == nullptr)
+  {
+    return 0;
+  }
+
+  // Query the pages in chunks to keep the residency vector small for huge mappings.
+  const std::size_t pageSize = GetPageSize();
+  const std::size_t chunkPages = 1 << 16;
+  const std::size_t size = static_cast<std::size_t>(mapping.Size);
+  std::vector<MincoreVecType> residency(chunkPages);
+  std::size_t residentPages = 0;
+  for (std::size_t offset = 0; offset < size; offset += chunkPages * pageSize)
+  {
+    const std::size_t length = std::min(chunkPages * pageSize, size - offset);
+    if (mincore(static_cast<char*>(mapping.Data) + offset, length, residency.data()) != 0)
+    {
+      continue;
+    }
+    const std::size_t numPages = (length + pageSize - 1) / pageSize;
+    for (std::size_t page = 0; page < numPages; ++page)
+    {
+      residentPages += residency[page] & 1;
+    }
+  }
+  return static_cast<vtkm::BufferSizeType>(std::min(residentPages * pageSize, size));
+}
+
+// Drops the pages of a mapping from memory. Returns false if the system cannot do that without
+// losing data.
+bool EvictPages(const FileMapping& mapping)
+{
+  if (mapping.Data == nullptr)
+  {
+    return false;
+  }
+  const std::size_t size = static_cast<std::size_t>(mapping.Size);
+
+  if (mapping.Shared)
+  {
+    // Write modified pages back to the file. Dropping them is then safe, and the next access
+    // reads them back from the file.
+    msync(mapping.Data, size, MS_SYNC);
+    madvise(mapping.Data, size, MADV_DONTNEED);
+#if defined(POSIX_FADV_DONTNEED)
+    posix_fadvise(mapping.FileDescriptor, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    return true;
+  }
+
+#if defined(MADV_PAGEOUT)
+  // Modified pages of private mappings only exist in memory. Paging them out keeps them.
+  return madvise(mapping.Data, size, MADV_PAGEOUT) == 0;
+#else
+  return false;
+#endif
+}
+
+// Evicts the coldest mappings until no more than `maxResidentBytes` are resident.
+void EvictMappings(FileMappedMemoryState& state,
+                   const std::unique_lock<std::mutex>& lock,
+                   vtkm::BufferSizeType maxResidentBytes)
+{
+  VTKM_ASSERT(lock.owns_lock());
+  (void)lock;
+
+  std::vector<vtkm::BufferSizeType> residentBytes;
+  vtkm::BufferSizeType totalResidentBytes = 0;
+  for (FileMapping* mapping : state.Mappings)
+  {
+    residentBytes.push_back(GetResidentBytes(*mapping));
+    totalResidentBytes += residentBytes.back();
+  }
+
+  vtkm::Int64 numEvicted = 0;
+  vtkm::BufferSizeType bytesEvicted = 0;
+  auto resident = residentBytes.begin();
+  for (auto mapping = state.Mappings.begin();
+       (totalResidentBytes > maxResidentBytes) && (mapping != state.Mappings.end());
+       ++mapping, ++resident)
+  {
+    if ((*resident > 0) && EvictPages(**mapping))
+    {
+      const vtkm::BufferSizeType released = *resident - GetResidentBytes(**mapping);
+      totalResidentBytes -= released;
+      bytesEvicted += released;
+      ++numEvicted;
+    }
+  }
+
+  state.Statistics.NumberOfEvictions += numEvicted;
+  state.Statistics.BytesEvicted += bytesEvicted;
+  if (numEvicted > 0)
+  {
+    VTKM_LOG_S(vtkm::cont::LogLevel::Perf,
+               "Evicted " << vtkm::cont::GetHumanReadableSize(bytesEvicted) << " from "
+                          << numEvicted << " mapped files");
+  }
+}
+
+#endif // VTKM_POSIX
+
+void EnforceBudget()
+{
+#if defined(VTKM_POSIX)
+  FileMappedMemoryState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  if (state.Statistics.BytesMapped > state.Budget)
+  {
+    EvictMappings(state, lock, state.Budget);
+  }
+#endif
+}
+
+void RegisterMapping(FileMapping* mapping)
+{
+  FileMappedMemoryState& state = GetState();
+  {
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    state.Mappings.push_back(mapping);
+    ++state.Statistics.NumberOfMappings;
+    state.Statistics.BytesMapped += mapping->Size;
+  }
+  EnforceBudget();
+}
+
+void UnregisterMapping(FileMapping* mapping, const std::unique_lock<std::mutex>& lock)
+{
+  VTKM_ASSERT(lock.owns_lock());
+  (void)lock;
+
+  FileMappedMemoryState& state = GetState();
+  auto entry = std::find(state.Mappings.begin(), state.Mappings.end(), mapping);
+  if (entry != state.Mappings.end())
+  {
+    state.Mappings.erase(entry);
+    --state.Statistics.NumberOfMappings;
+    state.Statistics.BytesMapped -= mapping->Size;
+  }
+}
+
+void FileMappingDeleter(void* container)
+{
+  FileMapping* mapping = reinterpret_cast<FileMapping*>(container);
+  {
+    FileMappedMemoryState& state = GetState();
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    UnregisterMapping(mapping, lock);
+  }
+
+#if defined(VTKM_POSIX)
+  if (mapping->Data != nullptr)
+  {
+    munmap(mapping->Data, static_cast<std::size_t>(mapping->Size));
+  }
+  if (mapping->FileDescriptor >= 0)
+  {
+    close(mapping->FileDescriptor);
+  }
+#endif
+  vtkm::cont::internal::HostDeleter(mapping->HostMemory);
+  delete mapping;
+}
+
+void FileMappingReallocater(void*& memory,
+                            void*& container,
+                            vtkm::BufferSizeType oldSize,
+                            vtkm::BufferSizeType newSize)
+{
+  FileMapping* mapping = reinterpret_cast<FileMapping*>(container);
+  FileMappedMemoryState& state = GetState();
+
+  if (!mapping->Shared)
+  {
+    // Resizing a private mapping cannot change the file. Move the data to regular host memory.
+    void* newMemory = vtkm::cont::internal::HostAllocate(newSize);
+    if ((memory != nullptr) && (newMemory != nullptr))
+    {
+      std::memcpy(newMemory, memory, static_cast<std::size_t>(vtkm::Min(oldSize, newSize)));
+    }
+
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    UnregisterMapping(mapping, lock);
+#if defined(VTKM_POSIX)
+    if (mapping->Data != nullptr)
+    {
+      munmap(mapping->Data, static_cast<std::size_t>(mapping->Size));
+    }
+#endif
+    mapping->Data = nullptr;
+    mapping->Size = 0;
+    vtkm::cont::internal::HostDeleter(mapping->HostMemory);
+    mapping->HostMemory = newMemory;
+    memory = newMemory;
+    return;
+  }
+
+#if defined(VTKM_POSIX)
+  {
+    // Hold the lock so that the mapping is not evicted while it is replaced.
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    if (ftruncate(mapping->FileDescriptor, static_cast<off_t>(newSize)) != 0)
+    {
+      throw vtkm::cont::ErrorBadAllocation("Could not resize mapped file: " + ErrorString());
+    }
+
+    UnregisterMapping(mapping, lock);
+    if (mapping->Data != nullptr)
+    {
+      munmap(mapping->Data, static_cast<std::size_t>(mapping->Size));
+    }
+    mapping->Data = MapDescriptor(mapping->FileDescriptor, newSize, true);
+    mapping->Size = (mapping->Data != nullptr) ? newSize : 0;
+    memory = mapping->Data;
+    if ((newSize > 0) && (mapping->Data == nullptr))
+    {
+      throw vtkm::cont::ErrorBadAllocation("Could not map resized file: " + ErrorString());
+    }
+  }
+  RegisterMapping(mapping);
+#else
+  (void)oldSize;
+  (void)newSize;
+  (void)memory;
+#endif
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+vtkm::cont::internal::BufferInfo MapFile(const std::string& fileName,
+                                         vtkm::cont::FileMapMode mode,
+                                         vtkm::BufferSizeType numBytes)
+{
+#if defined(VTKM_POSIX)
+  if ((mode == vtkm::cont::FileMapMode::Create) && (numBytes < 0))
+  {
+    throw vtkm::cont::ErrorBadValue("The size of " + fileName + " is needed to create it.");
+  }
+
+  int flags = O_RDWR;
+  if (mode == vtkm::cont::FileMapMode::Read)
+  {
+    flags = O_RDONLY;
+  }
+  else if (mode == vtkm::cont::FileMapMode::Create)
+  {
+    flags = O_RDWR | O_CREAT | O_TRUNC;
+  }
+  const int fileDescriptor = open(fileName.c_str(), flags, 0644);
+  if (fileDescriptor < 0)
+  {
+    throw vtkm::cont::ErrorBadValue("Could not open " + fileName + ": " + ErrorString());
+  }
+
+  struct stat fileStat;
+  if (fstat(fileDescriptor, &fileStat) != 0)
+  {
+    close(fileDescriptor);
+    throw vtkm::cont::ErrorBadValue("Could not read size of " + fileName + ": " + ErrorString());
+  }
+  const vtkm::BufferSizeType fileSize = static_cast<vtkm::BufferSizeType>(fileStat.st_size);
+  if (numBytes < 0)
+  {
+    numBytes = fileSize;
+  }
+  else if (numBytes > fileSize)
+  {
+    if ((mode == vtkm::cont::FileMapMode::Read) ||
+        (ftruncate(fileDescriptor, static_cast<off_t>(numBytes)) != 0))
+    {
+      close(fileDescriptor);
+      throw vtkm::cont::ErrorBadValue("File " + fileName + " is smaller than the requested " +
+                                      std::to_string(numBytes) + " bytes.");
+    }
+  }
+
+  FileMapping* mapping = new FileMapping;
+  mapping->Shared = (mode != vtkm::cont::FileMapMode::Read);
+  mapping->Data = MapDescriptor(fileDescriptor, numBytes, mapping->Shared);
+  if ((numBytes > 0) && (mapping->Data == nullptr))
+  {
+    close(fileDescriptor);
+    delete mapping;
+    throw vtkm::cont::ErrorBadValue("Could not map " + fileName + ": " + ErrorString());
+  }
+  mapping->Size = numBytes;
+  if (mapping->Shared)
+  {
+    // Kept to resize the file and drop its cached pages.
+    mapping->FileDescriptor = fileDescriptor;
+  }
+  else
+  {
+    // The mapping stays valid after the file descriptor is closed.
+    close(fileDescriptor);
+  }
+
+  RegisterMapping(mapping);
+  return vtkm::cont::internal::BufferInfo(vtkm::cont::DeviceAdapterTagUndefined{},
+                                          mapping->Data,
+                                          mapping,
+                                          numBytes,
+                                          FileMappingDeleter,
+                                          FileMappingReallocater);
+#else
+  (void)mode;
+  (void)numBytes;
+  throw vtkm::cont::ErrorBadValue("Cannot map " + fileName +
+                                  ". Memory mapped files are only supported on POSIX systems.");
+#endif
+}
+
+void SetFileMappedMemoryBudget(vtkm::BufferSizeType numBytes)
+{
+  VTKM_ASSERT(numBytes >= 0);
+  {
+    FileMappedMemoryState& state = GetState();
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    state.Budget = numBytes;
+  }
+  EnforceBudget();
+}
+
+vtkm::BufferSizeType GetFileMappedMemoryBudget()
+{
+  FileMappedMemoryState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  return state.Budget;
+}
+
+void EvictFileMappedMemory(vtkm::BufferSizeType maxResidentBytes)
+{
+#if defined(VTKM_POSIX)
+  FileMappedMemoryState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  EvictMappings(state, lock, maxResidentBytes);
+#else
+  (void)maxResidentBytes;
+#endif
+}
+
+vtkm::BufferSizeType GetFileMappedResidentBytes()
+{
+  vtkm::BufferSizeType residentBytes = 0;
+#if defined(VTKM_POSIX)
+  FileMappedMemoryState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  for (FileMapping* mapping : state.Mappings)
+  {
+    residentBytes += GetResidentBytes(*mapping);
+  }
+#endif
+  return residentBytes;
+}
+
+void SetHostMemorySpillDirectory(const std::string& directory)
+{
+  FileMappedMemoryState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  state.SpillDirectory = directory;
+#if defined(VTKM_POSIX)
+  state.SpillEnabled = !directory.empty();
+#endif
+}
+
+std::string GetHostMemorySpillDirectory()
+{
+  FileMappedMemoryState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  return state.SpillDirectory;
+}
+
+void SetHostMemorySpillThreshold(vtkm::BufferSizeType numBytes)
+{
+  VTKM_ASSERT(numBytes > 0);
+  GetState().SpillThreshold = numBytes;
+}
+
+vtkm::BufferSizeType GetHostMemorySpillThreshold()
+{
+  return GetState().SpillThreshold;
+}
+
+vtkm::cont::internal::FileMappedMemoryStatistics GetFileMappedMemoryStatistics()
+{
+  FileMappedMemoryState& state = GetState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  return state.Statistics;
+}
+
+bool ShouldSpillHostAllocation(vtkm::BufferSizeType numBytes)
+{
+  FileMappedMemoryState& state = GetState();
+  return state.SpillEnabled && (numBytes >= state.SpillThreshold);
+}
+
+vtkm::cont::internal::BufferInfo AllocateSpilledHostMemory(vtkm::BufferSizeType numBytes)
+{
+#if defined(VTKM_POSIX)
+  const std::string directory = GetHostMemorySpillDirectory();
+  std::string fileName = directory + "/vtkm-spill-XXXXXX";
+  const int fileDescriptor = mkstemp(&fileName[0]);
+  if (fileDescriptor < 0)
+  {
+    VTKM_LOG_S(vtkm::cont::LogLevel::Warn,
+               "Could not create spill file in " << directory << ": " << ErrorString());
+    return vtkm::cont::internal::BufferInfo{};
+  }
+  // Remove the name right away. The file lives as long as it is open.
+  unlink(fileName.c_str());
+
+  FileMapping* mapping = new FileMapping;
+  mapping->Shared = true;
+  mapping->FileDescriptor = fileDescriptor;
+  if (ftruncate(fileDescriptor, static_cast<off_t>(numBytes)) == 0)
+  {
+    mapping->Data = MapDescriptor(fileDescriptor, numBytes, true);
+  }
+  if (mapping->Data == nullptr)
+  {
+    VTKM_LOG_S(vtkm::cont::LogLevel::Warn,
+               "Could not spill " << vtkm::cont::GetHumanReadableSize(numBytes) << " to "
+                                  << directory << ": " << ErrorString());
+    close(fileDescriptor);
+    delete mapping;
+    return vtkm::cont::internal::BufferInfo{};
+  }
+  mapping->Size = numBytes;
+
+  {
+    FileMappedMemoryState& state = GetState();
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    ++state.Statistics.NumberOfSpilledAllocations;
+  }
+  RegisterMapping(mapping);
+  return vtkm::cont::internal::BufferInfo(vtkm::cont::DeviceAdapterTagUndefined{},
+                                          mapping->Data,
+                                          mapping,
+                                          numBytes,
+                                          FileMappingDeleter,
+                                          FileMappingReallocater);
+#else
+  (void)numBytes;
+  return vtkm::cont::internal::BufferInfo{};
+#endif
+}
+
+}
+}
+} // namespace vtkm::cont::internal
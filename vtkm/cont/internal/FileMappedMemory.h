@@ -0,0 +1,102 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_internal_FileMappedMemory_h
+#define vtk_m_cont_internal_FileMappedMemory_h
+
+#include <vtkm/cont/internal/DeviceAdapterMemoryManager.h>
+
+#include <string>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+/// \brief Counters of the memory backed by mapped files.
+///
+/// All sizes are in bytes. This covers both arrays created with
+/// `vtkm::cont::make_ArrayHandleFileMapped` and host allocations spilled to disk.
+///
+struct FileMappedMemoryStatistics
+{
+  /// Number of mappings currently held by buffers.
+  vtkm::Int64 NumberOfMappings = 0;
+  /// Size of all mappings currently held by buffers.
+  vtkm::BufferSizeType BytesMapped = 0;
+  /// Number of host allocations that were served by a spill file.
+  vtkm::Int64 NumberOfSpilledAllocations = 0;
+  /// Number of times the pages of a mapping were evicted.
+  vtkm::Int64 NumberOfEvictions = 0;
+  /// Resident memory released by evictions.
+  vtkm::BufferSizeType BytesEvicted = 0;
+};
+
+/// \brief Limit on the resident memory of mapped files.
+///
+/// Whenever a mapping is created or resized and the mapped files exceed this budget, the pages of
+/// the mappings that were least recently created or resized are evicted until the resident
+/// memory is back under the budget. Evicted pages are read back from the file when they are next
+/// touched. The default has no limit.
+///
+VTKM_CONT_EXPORT VTKM_CONT void SetFileMappedMemoryBudget(vtkm::BufferSizeType numBytes);
+VTKM_CONT_EXPORT VTKM_CONT vtkm::BufferSizeType GetFileMappedMemoryBudget();
+
+/// \brief Evicts pages of mapped files until no more than `maxResidentBytes` are resident.
+///
+/// Modified pages of arrays that write to their file (including spilled allocations) are written
+/// back first. Modified pages of arrays mapped with `FileMapMode::Read` only exist in memory, so
+/// they are handed to the system to page out, which is only possible where the system supports
+/// it (Linux 5.4 and later).
+///
+VTKM_CONT_EXPORT VTKM_CONT void EvictFileMappedMemory(vtkm::BufferSizeType maxResidentBytes = 0);
+
+/// Returns the memory of all mapped files that currently resides in physical memory.
+VTKM_CONT_EXPORT VTKM_CONT vtkm::BufferSizeType GetFileMappedResidentBytes();
+
+/// \brief Directory in which large host allocations are spilled.
+///
+/// When a directory is set, `AllocateOnHost` (and thus the memory managers of the Serial, TBB
+/// and OpenMP devices) backs every request of at least the spill threshold with an anonymous
+/// file in this directory instead of system memory. Together with `SetFileMappedMemoryBudget`,
+/// this lets filters produce results larger than the physical memory. The files are removed
+/// as soon as they are created, so nothing is left behind when the buffers are released (or
+/// the process dies).
+///
+/// Spilling is off (no directory) by default. It is only supported on POSIX systems.
+///
+VTKM_CONT_EXPORT VTKM_CONT void SetHostMemorySpillDirectory(const std::string& directory);
+VTKM_CONT_EXPORT VTKM_CONT std::string GetHostMemorySpillDirectory();
+
+/// Smallest host allocation that is spilled to disk. The default is 64 MiB.
+VTKM_CONT_EXPORT VTKM_CONT void SetHostMemorySpillThreshold(vtkm::BufferSizeType numBytes);
+VTKM_CONT_EXPORT VTKM_CONT vtkm::BufferSizeType GetHostMemorySpillThreshold();
+
+/// Returns a snapshot of the counters of the memory backed by mapped files.
+VTKM_CONT_EXPORT VTKM_CONT vtkm::cont::internal::FileMappedMemoryStatistics
+GetFileMappedMemoryStatistics();
+
+/// Returns true if a host allocation of `numBytes` should be spilled to disk.
+VTKM_CONT_EXPORT VTKM_CONT bool ShouldSpillHostAllocation(vtkm::BufferSizeType numBytes);
+
+/// \brief Allocates `numBytes` of host memory backed by a file in the spill directory.
+///
+/// Returns an invalid (null) buffer if the file could not be created. Resizing the buffer resizes
+/// the file.
+///
+VTKM_CONT_EXPORT VTKM_CONT vtkm::cont::internal::BufferInfo AllocateSpilledHostMemory(
+  vtkm::BufferSizeType numBytes);
+
+}
+}
+} // namespace vtkm::cont::internal
+
+#endif //vtk_m_cont_internal_FileMappedMemory_h
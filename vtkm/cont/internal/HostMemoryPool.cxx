@@ -0,0 +1,301 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/internal/HostMemoryPool.h>
+
+#include <vtkm/Math.h>
+
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+struct HostMemoryPoolState
+{
+  std::mutex Mutex;
+  std::atomic<bool> Enabled{ false };
+  vtkm::BufferSizeType HighWaterMark = std::numeric_limits<vtkm::BufferSizeType>::max();
+
+  // Cached blocks, keyed by size class.
+  std::map<vtkm::BufferSizeType, std::vector<void*>> FreeBlocks;
+  // Size class of every block currently held by a buffer.
+  std::unordered_map<void*, vtkm::BufferSizeType> LiveBlocks;
+
+  vtkm::cont::internal::HostMemoryPoolStatistics Statistics;
+};
+
+HostMemoryPoolState& GetPoolState()
+{
+  // Intentionally never destroyed. Buffers held in static objects may be released after this
+  // function's statics would have been destroyed.
+  static HostMemoryPoolState* state = new HostMemoryPoolState;
+  return *state;
+}
+
+// Rounds a request up to a size class. Each power of two is split into 4 classes so that no
+// more than 25% of a block is wasted.
+vtkm::BufferSizeType GetSizeClass(vtkm::BufferSizeType numBytes)
+{
+  constexpr vtkm::BufferSizeType minimumSizeClass = 256;
+  if (numBytes <= minimumSizeClass)
+  {
+    return minimumSizeClass;
+  }
+
+  vtkm::BufferSizeType power = minimumSizeClass;
+  while ((power * 2) <= numBytes)
+  {
+    power *= 2;
+  }
+  const vtkm::BufferSizeType step = power / 4;
+  return ((numBytes + step - 1) / step) * step;
+}
+
+// Returns cached blocks to the system, largest first, until at most `maxCachedBytes` are cached.
+void ReleaseCachedBlocks(HostMemoryPoolState& state,
+                         const std::unique_lock<std::mutex>& lock,
+                         vtkm::BufferSizeType maxCachedBytes)
+{
+  VTKM_ASSERT(lock.owns_lock());
+  (void)lock;
+
+  vtkm::Int64 numReleased = 0;
+  vtkm::BufferSizeType bytesReleased = 0;
+  auto sizeClass = state.FreeBlocks.rbegin();
+  while ((state.Statistics.BytesCached > maxCachedBytes) && (sizeClass != state.FreeBlocks.rend()))
+  {
+    std::vector<void*>& blocks = sizeClass->second;
+    while ((state.Statistics.BytesCached > maxCachedBytes) && !blocks.empty())
+    {
+      vtkm::cont::internal::HostDeleter(blocks.back());
+      blocks.pop_back();
+      state.Statistics.BytesCached -= sizeClass->first;
+      bytesReleased += sizeClass->first;
+      ++numReleased;
+    }
+    ++sizeClass;
+  }
+  state.Statistics.NumberOfReleasedBlocks += numReleased;
+
+  if (numReleased > 0)
+  {
+    VTKM_LOG_F(vtkm::cont::LogLevel::MemCont,
+               "Host memory pool released %lld cached blocks (%s).",
+               static_cast<long long>(numReleased),
+               vtkm::cont::GetSizeString(bytesReleased).c_str());
+  }
+}
+
+void EnforceHighWaterMark(HostMemoryPoolState& state,
+                          const std::unique_lock<std::mutex>& lock,
+                          vtkm::BufferSizeType numBytesToAdd)
+{
+  const vtkm::BufferSizeType inUse = state.Statistics.BytesInUse + numBytesToAdd;
+  const vtkm::BufferSizeType maxCachedBytes =
+    vtkm::Max(state.HighWaterMark - inUse, vtkm::BufferSizeType{ 0 });
+  if (maxCachedBytes < state.Statistics.BytesCached)
+  {
+    ReleaseCachedBlocks(state, lock, maxCachedBytes);
+  }
+}
+
+void* PoolAllocate(vtkm::BufferSizeType numBytes)
+{
+  if (numBytes <= 0)
+  {
+    return nullptr;
+  }
+
+  HostMemoryPoolState& state = GetPoolState();
+  const vtkm::BufferSizeType sizeClass = GetSizeClass(numBytes);
+
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  ++state.Statistics.NumberOfAllocations;
+
+  void* memory = nullptr;
+  auto blocks = state.FreeBlocks.find(sizeClass);
+  if ((blocks != state.FreeBlocks.end()) && !blocks->second.empty())
+  {
+    memory = blocks->second.back();
+    blocks->second.pop_back();
+    state.Statistics.BytesCached -= sizeClass;
+    ++state.Statistics.NumberOfCacheHits;
+  }
+  else
+  {
+    ++state.Statistics.NumberOfCacheMisses;
+    EnforceHighWaterMark(state, lock, sizeClass);
+    memory = vtkm::cont::internal::HostAllocate(sizeClass);
+    if (memory == nullptr)
+    {
+      // The system may be out of memory because of what we cache. Give it all back and retry.
+      ReleaseCachedBlocks(state, lock, 0);
+      memory = vtkm::cont::internal::HostAllocate(sizeClass);
+      if (memory == nullptr)
+      {
+        return nullptr;
+      }
+    }
+  }
+
+  state.LiveBlocks[memory] = sizeClass;
+  state.Statistics.BytesInUse += sizeClass;
+  state.Statistics.PeakBytesInUse =
+    vtkm::Max(state.Statistics.PeakBytesInUse, state.Statistics.BytesInUse);
+  return memory;
+}
+
+void PoolDeleter(void* memory)
+{
+  if (memory == nullptr)
+  {
+    return;
+  }
+
+  HostMemoryPoolState& state = GetPoolState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+
+  auto block = state.LiveBlocks.find(memory);
+  VTKM_ASSERT(block != state.LiveBlocks.end());
+  const vtkm::BufferSizeType sizeClass = block->second;
+  state.LiveBlocks.erase(block);
+  state.Statistics.BytesInUse -= sizeClass;
+
+  if (state.Enabled)
+  {
+    state.FreeBlocks[sizeClass].push_back(memory);
+    state.Statistics.BytesCached += sizeClass;
+    EnforceHighWaterMark(state, lock, 0);
+  }
+  else
+  {
+    vtkm::cont::internal::HostDeleter(memory);
+  }
+}
+
+void PoolReallocate(void*& memory,
+                    void*& container,
+                    vtkm::BufferSizeType oldSize,
+                    vtkm::BufferSizeType newSize)
+{
+  VTKM_ASSERT(memory == container);
+
+  // If the new size still fits in the block and is not much smaller than the old size, just
+  // reuse the block (and waste a little memory).
+  if ((memory != nullptr) && (newSize > ((3 * oldSize) / 4)))
+  {
+    HostMemoryPoolState& state = GetPoolState();
+    std::unique_lock<std::mutex> lock(state.Mutex);
+    auto block = state.LiveBlocks.find(memory);
+    VTKM_ASSERT(block != state.LiveBlocks.end());
+    if (newSize <= block->second)
+    {
+      return;
+    }
+  }
+
+  void* newBuffer = PoolAllocate(newSize);
+  if ((newBuffer != nullptr) && (memory != nullptr))
+  {
+    std::memcpy(newBuffer, memory, static_cast<std::size_t>(vtkm::Min(newSize, oldSize)));
+  }
+
+  PoolDeleter(memory);
+
+  memory = container = newBuffer;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+void SetHostMemoryPoolEnabled(bool enabled)
+{
+  HostMemoryPoolState& state = GetPoolState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  state.Enabled = enabled;
+  if (!enabled)
+  {
+    ReleaseCachedBlocks(state, lock, 0);
+  }
+}
+
+bool GetHostMemoryPoolEnabled()
+{
+  return GetPoolState().Enabled;
+}
+
+void SetHostMemoryPoolHighWaterMark(vtkm::BufferSizeType numBytes)
+{
+  VTKM_ASSERT(numBytes >= 0);
+  HostMemoryPoolState& state = GetPoolState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  state.HighWaterMark = numBytes;
+  EnforceHighWaterMark(state, lock, 0);
+}
+
+vtkm::BufferSizeType GetHostMemoryPoolHighWaterMark()
+{
+  HostMemoryPoolState& state = GetPoolState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  return state.HighWaterMark;
+}
+
+void TrimHostMemoryPool(vtkm::BufferSizeType maxCachedBytes)
+{
+  HostMemoryPoolState& state = GetPoolState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  ReleaseCachedBlocks(state, lock, vtkm::Max(maxCachedBytes, vtkm::BufferSizeType{ 0 }));
+}
+
+vtkm::cont::internal::HostMemoryPoolStatistics GetHostMemoryPoolStatistics()
+{
+  HostMemoryPoolState& state = GetPoolState();
+  std::unique_lock<std::mutex> lock(state.Mutex);
+  return state.Statistics;
+}
+
+void LogHostMemoryPoolStatistics(vtkm::cont::LogLevel level)
+{
+  vtkm::cont::internal::HostMemoryPoolStatistics stats = GetHostMemoryPoolStatistics();
+  VTKM_LOG_F(level,
+             "Host memory pool: %lld allocations (%lld cache hits, %lld misses), "
+             "%lld blocks released, in use %s, peak %s, cached %s.",
+             static_cast<long long>(stats.NumberOfAllocations),
+             static_cast<long long>(stats.NumberOfCacheHits),
+             static_cast<long long>(stats.NumberOfCacheMisses),
+             static_cast<long long>(stats.NumberOfReleasedBlocks),
+             vtkm::cont::GetSizeString(stats.BytesInUse).c_str(),
+             vtkm::cont::GetSizeString(stats.PeakBytesInUse).c_str(),
+             vtkm::cont::GetSizeString(stats.BytesCached).c_str());
+}
+
+vtkm::cont::internal::BufferInfo AllocateFromHostMemoryPool(vtkm::BufferSizeType numBytes)
+{
+  void* memory = PoolAllocate(numBytes);
+
+  return vtkm::cont::internal::BufferInfo(
+    vtkm::cont::DeviceAdapterTagUndefined{}, memory, memory, numBytes, PoolDeleter, PoolReallocate);
+}
+
+}
+}
+} // namespace vtkm::cont::internal
@@ -0,0 +1,87 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_internal_HostMemoryPool_h
+#define vtk_m_cont_internal_HostMemoryPool_h
+
+#include <vtkm/cont/Logging.h>
+#include <vtkm/cont/internal/DeviceAdapterMemoryManager.h>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+/// \brief Counters of the host memory pool.
+///
+/// All sizes are in bytes. Sizes are those of the size classes the requests were rounded up to.
+///
+struct HostMemoryPoolStatistics
+{
+  /// Number of allocations served by the pool.
+  vtkm::Int64 NumberOfAllocations = 0;
+  /// Number of allocations that were served from a cached block.
+  vtkm::Int64 NumberOfCacheHits = 0;
+  /// Number of allocations that had to request fresh memory from the system.
+  vtkm::Int64 NumberOfCacheMisses = 0;
+  /// Number of cached blocks that were returned to the system.
+  vtkm::Int64 NumberOfReleasedBlocks = 0;
+  /// Memory currently held by live buffers.
+  vtkm::BufferSizeType BytesInUse = 0;
+  /// Largest value `BytesInUse` has had.
+  vtkm::BufferSizeType PeakBytesInUse = 0;
+  /// Memory held by the pool for reuse, but not by any buffer.
+  vtkm::BufferSizeType BytesCached = 0;
+};
+
+/// \brief Turns the caching pool for host memory on or off.
+///
+/// When the pool is enabled, `AllocateOnHost` (and thus the memory managers of the Serial, TBB
+/// and OpenMP devices) round each request up to a size class and reuse blocks that previously
+/// freed buffers have returned to the pool. This avoids the page faults of fresh memory when the
+/// same large temporaries are allocated and released over and over again.
+///
+/// The pool is off by default. Buffers that were allocated by the pool go back to it when
+/// released even after the pool has been disabled. At that point, they are returned to the
+/// system instead of being cached.
+///
+VTKM_CONT_EXPORT VTKM_CONT void SetHostMemoryPoolEnabled(bool enabled);
+VTKM_CONT_EXPORT VTKM_CONT bool GetHostMemoryPoolEnabled();
+
+/// \brief Limit on the memory held by the host memory pool.
+///
+/// Whenever the memory in use plus the memory cached by the pool exceeds this high-water mark,
+/// cached blocks are released (largest first) until the pool is back under the mark or the
+/// cache is empty. Memory held by live buffers is never released. The default has no limit.
+///
+VTKM_CONT_EXPORT VTKM_CONT void SetHostMemoryPoolHighWaterMark(vtkm::BufferSizeType numBytes);
+VTKM_CONT_EXPORT VTKM_CONT vtkm::BufferSizeType GetHostMemoryPoolHighWaterMark();
+
+/// Releases cached blocks, largest first, until no more than `maxCachedBytes` are cached.
+VTKM_CONT_EXPORT VTKM_CONT void TrimHostMemoryPool(vtkm::BufferSizeType maxCachedBytes = 0);
+
+/// Returns a snapshot of the counters of the host memory pool.
+VTKM_CONT_EXPORT VTKM_CONT vtkm::cont::internal::HostMemoryPoolStatistics
+GetHostMemoryPoolStatistics();
+
+/// Writes the counters of the host memory pool to the log.
+VTKM_CONT_EXPORT VTKM_CONT void LogHostMemoryPoolStatistics(
+  vtkm::cont::LogLevel level = vtkm::cont::LogLevel::Perf);
+
+/// Allocates `numBytes` from the pool. The returned buffer is managed by the pool.
+VTKM_CONT_EXPORT VTKM_CONT vtkm::cont::internal::BufferInfo AllocateFromHostMemoryPool(
+  vtkm::BufferSizeType numBytes);
+
+}
+}
+} // namespace vtkm::cont::internal
+
+#endif //vtk_m_cont_internal_HostMemoryPool_h
@@ -37,6 +37,12 @@ struct PSortTag
 {
 };
 
+// Radix sort of keys made of integers packed into unsigned words. See
+// ParallelRadixSortPacked.h.
+struct PackedRadixSortTag
+{
+};
+
 // Detect supported functors for radix sort:
 template <typename T>
 struct is_valid_compare_type : std::integral_constant<bool, false>
@@ -59,6 +65,33 @@ struct is_valid_compare_type<vtkm::SortGreater> : std::integral_constant<bool, t
 {
 };
 
+// Detect functors that sort in descending order:
+template <typename T>
+struct is_descending_compare : std::integral_constant<bool, false>
+{
+};
+template <typename T>
+struct is_descending_compare<std::greater<T>> : std::integral_constant<bool, true>
+{
+};
+template <>
+struct is_descending_compare<vtkm::SortGreater> : std::integral_constant<bool, true>
+{
+};
+
+// Detect keys whose components are all integers, which can be packed into
+// unsigned words for radix sort:
+template <typename T>
+struct is_packable_key
+  : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value>
+{
+};
+template <typename T, vtkm::IdComponent N>
+struct is_packable_key<vtkm::Vec<T, N>>
+  : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value>
+{
+};
+
 // Convert vtkm::Sort[Less|Greater] to the std:: equivalents:
 template <typename BComp, typename T>
 BComp&& get_std_compare(BComp&& b, T&&)
@@ -89,8 +122,12 @@ struct sort_tag_type<T, vtkm::cont::StorageTagBasic, BinaryCompare>
   using PrimT = std::is_arithmetic<T>;
   using LongDT = std::is_same<T, long double>;
   using BComp = is_valid_compare_type<BinaryCompare>;
-  using type = typename std::
-    conditional<PrimT::value && BComp::value && !LongDT::value, RadixSortTag, PSortTag>::type;
+  using PackedT = is_packable_key<T>;
+  using type = typename std::conditional<
+    PrimT::value && BComp::value && !LongDT::value,
+    RadixSortTag,
+    typename std::conditional<PackedT::value && BComp::value, PackedRadixSortTag, PSortTag>::type>::
+    type;
 };
 
 template <typename KeyType,
@@ -113,12 +150,49 @@ struct sortbykey_tag_type<KeyType,
   using PrimValue = std::is_arithmetic<ValueType>;
   using LongDKey = std::is_same<KeyType, long double>;
   using BComp = is_valid_compare_type<BinaryCompare>;
-  using type = typename std::conditional<PrimKey::value && PrimValue::value && BComp::value &&
-                                           !LongDKey::value,
-                                         RadixSortTag,
+  using PackedKey = is_packable_key<KeyType>;
+  using type = typename std::conditional<
+    PrimKey::value && PrimValue::value && BComp::value && !LongDKey::value,
+    RadixSortTag,
+    typename std::conditional<PackedKey::value && BComp::value, PackedRadixSortTag, PSortTag>::
+      type>::type;
+};
+
+// Determine if a device without a compiled radix sort (see
+// ParallelRadixSortPacked.h) can radix sort a given key type.
+template <typename T, typename StorageTag, typename BinaryCompare>
+struct packed_sort_tag_type
+{
+  using type = PSortTag;
+};
+template <typename T, typename BinaryCompare>
+struct packed_sort_tag_type<T, vtkm::cont::StorageTagBasic, BinaryCompare>
+{
+  using type = typename std::conditional<is_packable_key<T>::value &&
+                                           is_valid_compare_type<BinaryCompare>::value,
+                                         PackedRadixSortTag,
                                          PSortTag>::type;
 };
 
+template <typename KeyType,
+          typename ValueType,
+          typename KeyStorageTagType,
+          typename ValueStorageTagType,
+          class BinaryCompare>
+struct packed_sortbykey_tag_type
+{
+  using type = PSortTag;
+};
+template <typename KeyType, typename ValueType, class BinaryCompare>
+struct packed_sortbykey_tag_type<KeyType,
+                                 ValueType,
+                                 vtkm::cont::StorageTagBasic,
+                                 vtkm::cont::StorageTagBasic,
+                                 BinaryCompare>
+  : packed_sort_tag_type<KeyType, vtkm::cont::StorageTagBasic, BinaryCompare>
+{
+};
+
 #define VTKM_INTERNAL_RADIX_SORT_DECLARE(key_type)                                         \
   VTKM_CONT_EXPORT void parallel_radix_sort(                                               \
     key_type* data, size_t num_elems, const std::greater<key_type>& comp);                 \
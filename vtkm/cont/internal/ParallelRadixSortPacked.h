@@ -0,0 +1,481 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_cont_internal_ParallelRadixSortPacked_h
+#define vtk_m_cont_internal_ParallelRadixSortPacked_h
+
+#include <vtkm/Types.h>
+#include <vtkm/VecTraits.h>
+#include <vtkm/cont/internal/ParallelRadixSortInterface.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Radix sort of keys made of integers (vtkm::Id, vtkm::Id2, vtkm::Id3, ...).
+//
+// The range of each component of the keys is found first. Each component is then stored as its
+// offset from the minimum of its range (from the maximum for descending sorts) using just enough
+// bits for the range. The first component goes in the most significant bits, so that sorting the
+// packed words in ascending order sorts the keys in lexicographic order. Keys that fit in 32 or
+// 64 bits are sorted as one word, and are unpacked back from the sorted words. Keys that fit in
+// 128 bits are sorted by index with two stable passes (low word, then high word) and then
+// permuted. Keys whose ranges need more than 128 bits are not handled here.
+//
+// The device provides the parallelism with a policy class:
+//
+// struct PackedSortPolicyExample
+// {
+//   // Calls body(chunk) for all the chunks in [0, numChunks), possibly in parallel.
+//   template <typename Body>
+//   static void ForEachChunk(vtkm::Id numChunks, const Body& body);
+//
+//   // Sorts words in ascending order. Only the lowest numBits bits of the words are set.
+//   template <typename WordType>
+//   static void SortKeys(WordType* keys, std::size_t numValues, vtkm::IdComponent numBits);
+//
+//   // Same as SortKeys, but also moves the values along with the keys. Must be stable.
+//   template <typename WordType>
+//   static void SortPairs(WordType* keys,
+//                         vtkm::Id* values,
+//                         std::size_t numValues,
+//                         vtkm::IdComponent numBits);
+// };
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+namespace radix
+{
+
+// Arrays smaller than this are left to the comparison sorts.
+const vtkm::Id MIN_VALUES_FOR_PACKED_SORT = 256;
+
+// Number of values processed by each call of the body given to ForEachChunk.
+const vtkm::Id PACKED_SORT_CHUNK_SIZE = 16384;
+
+// Packs keys into two 64-bit words (the low and high halves of a 128-bit integer).
+template <typename KeyType>
+class KeyPacker
+{
+  using Traits = vtkm::VecTraits<KeyType>;
+  using ComponentType = typename Traits::ComponentType;
+  static constexpr vtkm::IdComponent NUM_COMPONENTS = Traits::NUM_COMPONENTS;
+
+public:
+  KeyPacker(const KeyType& minKey, const KeyType& maxKey, bool descending)
+    : Descending(descending)
+  {
+    this->NumberOfBits = 0;
+    for (vtkm::IdComponent c = NUM_COMPONENTS - 1; c >= 0; --c)
+    {
+      const vtkm::UInt64 minValue = ToWord(Traits::GetComponent(minKey, c));
+      const vtkm::UInt64 maxValue = ToWord(Traits::GetComponent(maxKey, c));
+      this->Origin[c] = descending ? maxValue : minValue;
+      this->Shift[c] = this->NumberOfBits;
+      this->Bits[c] = BitWidth(maxValue - minValue);
+      this->NumberOfBits += this->Bits[c];
+    }
+  }
+
+  vtkm::IdComponent GetNumberOfBits() const { return this->NumberOfBits; }
+
+  void Pack(const KeyType& key, vtkm::UInt64& low, vtkm::UInt64& high) const
+  {
+    low = 0;
+    high = 0;
+    for (vtkm::IdComponent c = 0; c < NUM_COMPONENTS; ++c)
+    {
+      if (this->Bits[c] == 0)
+      {
+        continue;
+      }
+      const vtkm::UInt64 component = ToWord(Traits::GetComponent(key, c));
+      const vtkm::UInt64 offset =
+        this->Descending ? this->Origin[c] - component : component - this->Origin[c];
+      const vtkm::IdComponent shift = this->Shift[c];
+      if (shift >= 64)
+      {
+        high |= offset << (shift - 64);
+      }
+      else
+      {
+        low |= offset << shift;
+        if (shift + this->Bits[c] > 64)
+        {
+          high |= offset >> (64 - shift);
+        }
+      }
+    }
+  }
+
+  KeyType Unpack(vtkm::UInt64 low, vtkm::UInt64 high) const
+  {
+    KeyType key;
+    for (vtkm::IdComponent c = 0; c < NUM_COMPONENTS; ++c)
+    {
+      const vtkm::IdComponent shift = this->Shift[c];
+      const vtkm::IdComponent bits = this->Bits[c];
+      vtkm::UInt64 offset = 0;
+      if (bits > 0)
+      {
+        if (shift >= 64)
+        {
+          offset = high >> (shift - 64);
+        }
+        else
+        {
+          offset = low >> shift;
+          if (shift + bits > 64)
+          {
+            offset |= high << (64 - shift);
+          }
+        }
+        if (bits < 64)
+        {
+          offset &= (vtkm::UInt64(1) << bits) - 1;
+        }
+      }
+      const vtkm::UInt64 component =
+        this->Descending ? this->Origin[c] - offset : this->Origin[c] + offset;
+      Traits::SetComponent(key, c, static_cast<ComponentType>(component));
+    }
+    return key;
+  }
+
+private:
+  // Signed components are sign extended, so the difference of two components is their distance
+  // in modulo arithmetic.
+  static vtkm::UInt64 ToWord(ComponentType value) { return static_cast<vtkm::UInt64>(value); }
+
+  static vtkm::IdComponent BitWidth(vtkm::UInt64 value)
+  {
+    vtkm::IdComponent bits = 0;
+    while (value != 0)
+    {
+      ++bits;
+      value >>= 1;
+    }
+    return bits;
+  }
+
+  vtkm::UInt64 Origin[NUM_COMPONENTS];
+  vtkm::IdComponent Shift[NUM_COMPONENTS];
+  vtkm::IdComponent Bits[NUM_COMPONENTS];
+  vtkm::IdComponent NumberOfBits;
+  bool Descending;
+};
+
+template <typename Policy, typename KeyType>
+class PackedSorter
+{
+  using Traits = vtkm::VecTraits<KeyType>;
+  static constexpr vtkm::IdComponent NUM_COMPONENTS = Traits::NUM_COMPONENTS;
+
+  // Payload of a sort without values.
+  struct NoValues
+  {
+  };
+
+public:
+  /// Sorts the keys. Returns false, without modifying the keys, when the
+  /// keys cannot be packed in 128 bits or are too few to be worth it.
+  static bool Sort(KeyType* keys, vtkm::Id numValues, bool descending)
+  {
+    return Run(keys, NoValues{}, numValues, descending);
+  }
+
+  /// Sorts the keys and moves the values with them. The sort is stable. Returns
+  /// false, without modifying the arrays, when the keys cannot be packed in
+  /// 128 bits or are too few to be worth it.
+  template <typename ValueType>
+  static bool SortByKey(KeyType* keys, ValueType* values, vtkm::Id numValues, bool descending)
+  {
+    return Run(keys, values, numValues, descending);
+  }
+
+private:
+  template <typename Body>
+  static void ForEachValue(vtkm::Id numValues, const Body& body)
+  {
+    const vtkm::Id numChunks = (numValues + PACKED_SORT_CHUNK_SIZE - 1) / PACKED_SORT_CHUNK_SIZE;
+    Policy::ForEachChunk(numChunks, [&](vtkm::Id chunk) {
+      const vtkm::Id begin = chunk * PACKED_SORT_CHUNK_SIZE;
+      const vtkm::Id end = std::min(begin + PACKED_SORT_CHUNK_SIZE, numValues);
+      for (vtkm::Id index = begin; index < end; ++index)
+      {
+        body(index);
+      }
+    });
+  }
+
+  static KeyPacker<KeyType> MakePacker(const KeyType* keys, vtkm::Id numValues, bool descending)
+  {
+    const vtkm::Id numChunks = (numValues + PACKED_SORT_CHUNK_SIZE - 1) / PACKED_SORT_CHUNK_SIZE;
+    std::vector<KeyType> chunkMin(static_cast<std::size_t>(numChunks));
+    std::vector<KeyType> chunkMax(static_cast<std::size_t>(numChunks));
+    Policy::ForEachChunk(numChunks, [&](vtkm::Id chunk) {
+      const vtkm::Id begin = chunk * PACKED_SORT_CHUNK_SIZE;
+      const vtkm::Id end = std::min(begin + PACKED_SORT_CHUNK_SIZE, numValues);
+      KeyType minKey = keys[begin];
+      KeyType maxKey = keys[begin];
+      for (vtkm::Id index = begin + 1; index < end; ++index)
+      {
+        MinMax(keys[index], minKey, maxKey);
+      }
+      chunkMin[static_cast<std::size_t>(chunk)] = minKey;
+      chunkMax[static_cast<std::size_t>(chunk)] = maxKey;
+    });
+
+    KeyType minKey = chunkMin[0];
+    KeyType maxKey = chunkMax[0];
+    for (std::size_t chunk = 1; chunk < chunkMin.size(); ++chunk)
+    {
+      MinMax(chunkMin[chunk], minKey, maxKey);
+      MinMax(chunkMax[chunk], minKey, maxKey);
+    }
+    return KeyPacker<KeyType>(minKey, maxKey, descending);
+  }
+
+  static void MinMax(const KeyType& key, KeyType& minKey, KeyType& maxKey)
+  {
+    for (vtkm::IdComponent c = 0; c < NUM_COMPONENTS; ++c)
+    {
+      const auto component = Traits::GetComponent(key, c);
+      if (component < Traits::GetComponent(minKey, c))
+      {
+        Traits::SetComponent(minKey, c, component);
+      }
+      if (Traits::GetComponent(maxKey, c) < component)
+      {
+        Traits::SetComponent(maxKey, c, component);
+      }
+    }
+  }
+
+  template <typename ValuesType>
+  static bool Run(KeyType* keys, ValuesType values, vtkm::Id numValues, bool descending)
+  {
+    if (numValues < MIN_VALUES_FOR_PACKED_SORT)
+    {
+      return false;
+    }
+
+    const KeyPacker<KeyType> packer = MakePacker(keys, numValues, descending);
+    const vtkm::IdComponent numBits = packer.GetNumberOfBits();
+    if (numBits == 0)
+    {
+      // All the keys are the same.
+      return true;
+    }
+    else if (numBits <= 32)
+    {
+      RunOneWord<vtkm::UInt32>(keys, values, numValues, packer);
+    }
+    else if (numBits <= 64)
+    {
+      RunOneWord<vtkm::UInt64>(keys, values, numValues, packer);
+    }
+    else if (numBits <= 128)
+    {
+      RunTwoWords(keys, values, numValues, packer);
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  }
+
+  template <typename WordType, typename ValuesType>
+  static void RunOneWord(KeyType* keys,
+                         ValuesType values,
+                         vtkm::Id numValues,
+                         const KeyPacker<KeyType>& packer)
+  {
+    std::unique_ptr<WordType[]> words(new WordType[static_cast<std::size_t>(numValues)]);
+    ForEachValue(numValues, [&](vtkm::Id index) {
+      vtkm::UInt64 low, high;
+      packer.Pack(keys[index], low, high);
+      words[index] = static_cast<WordType>(low);
+    });
+
+    SortWords(words.get(), values, numValues, packer.GetNumberOfBits());
+
+    ForEachValue(numValues, [&](vtkm::Id index) {
+      keys[index] = packer.Unpack(static_cast<vtkm::UInt64>(words[index]), 0);
+    });
+  }
+
+  template <typename WordType>
+  static void SortWords(WordType* words, NoValues, vtkm::Id numValues, vtkm::IdComponent numBits)
+  {
+    Policy::SortKeys(words, static_cast<std::size_t>(numValues), numBits);
+  }
+
+  // Index payloads are sorted directly.
+  template <typename WordType>
+  static void SortWords(WordType* words,
+                        vtkm::Id* values,
+                        vtkm::Id numValues,
+                        vtkm::IdComponent numBits)
+  {
+    Policy::SortPairs(words, values, static_cast<std::size_t>(numValues), numBits);
+  }
+
+  // Other values are permuted after sorting their indices.
+  template <typename WordType, typename ValueType>
+  static void SortWords(WordType* words,
+                        ValueType* values,
+                        vtkm::Id numValues,
+                        vtkm::IdComponent numBits)
+  {
+    std::unique_ptr<vtkm::Id[]> permutation(new vtkm::Id[static_cast<std::size_t>(numValues)]);
+    ForEachValue(numValues, [&](vtkm::Id index) { permutation[index] = index; });
+    Policy::SortPairs(words, permutation.get(), static_cast<std::size_t>(numValues), numBits);
+    Permute(values, permutation.get(), numValues);
+  }
+
+  template <typename ValuesType>
+  static void RunTwoWords(KeyType* keys,
+                          ValuesType values,
+                          vtkm::Id numValues,
+                          const KeyPacker<KeyType>& packer)
+  {
+    const std::size_t size = static_cast<std::size_t>(numValues);
+    std::unique_ptr<vtkm::UInt64[]> low(new vtkm::UInt64[size]);
+    std::unique_ptr<vtkm::UInt64[]> high(new vtkm::UInt64[size]);
+    std::unique_ptr<vtkm::Id[]> permutation(new vtkm::Id[size]);
+    ForEachValue(numValues, [&](vtkm::Id index) {
+      packer.Pack(keys[index], low[index], high[index]);
+      permutation[index] = index;
+    });
+
+    // Least significant word first. The second pass keeps the order of the
+    // first one for equal high words.
+    Policy::SortPairs(low.get(), permutation.get(), size, 64);
+    ForEachValue(numValues, [&](vtkm::Id index) { low[index] = high[permutation[index]]; });
+    Policy::SortPairs(low.get(), permutation.get(), size, packer.GetNumberOfBits() - 64);
+
+    Permute(keys, permutation.get(), numValues);
+    Permute(values, permutation.get(), numValues);
+  }
+
+  static void Permute(NoValues, const vtkm::Id*, vtkm::Id) {}
+
+  template <typename ValueType>
+  static void Permute(ValueType* values, const vtkm::Id* permutation, vtkm::Id numValues)
+  {
+    std::unique_ptr<ValueType[]> permuted(new ValueType[static_cast<std::size_t>(numValues)]);
+    ForEachValue(numValues,
+                 [&](vtkm::Id index) { permuted[index] = values[permutation[index]]; });
+    ForEachValue(numValues, [&](vtkm::Id index) { values[index] = permuted[index]; });
+  }
+};
+
+/// Serial least significant digit radix sort of words. Passes over digits
+/// that are the same for all the words are skipped.
+template <typename WordType>
+void serial_radix_sort_words(WordType* keys,
+                             vtkm::Id* values,
+                             std::size_t numValues,
+                             vtkm::IdComponent numBits)
+{
+  constexpr vtkm::IdComponent DIGIT_BITS = 11;
+  constexpr std::size_t NUM_BUCKETS = std::size_t(1) << DIGIT_BITS;
+
+  std::unique_ptr<WordType[]> keysBuffer(new WordType[numValues]);
+  std::unique_ptr<vtkm::Id[]> valuesBuffer(values ? new vtkm::Id[numValues] : nullptr);
+  WordType* srcKeys = keys;
+  WordType* dstKeys = keysBuffer.get();
+  vtkm::Id* srcValues = values;
+  vtkm::Id* dstValues = valuesBuffer.get();
+
+  for (vtkm::IdComponent shift = 0; shift < numBits; shift += DIGIT_BITS)
+  {
+    std::size_t offsets[NUM_BUCKETS] = {};
+    for (std::size_t index = 0; index < numValues; ++index)
+    {
+      ++offsets[(srcKeys[index] >> shift) & (NUM_BUCKETS - 1)];
+    }
+    if (offsets[(srcKeys[0] >> shift) & (NUM_BUCKETS - 1)] == numValues)
+    {
+      continue;
+    }
+
+    std::size_t sum = 0;
+    for (std::size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket)
+    {
+      const std::size_t count = offsets[bucket];
+      offsets[bucket] = sum;
+      sum += count;
+    }
+
+    for (std::size_t index = 0; index < numValues; ++index)
+    {
+      const std::size_t position = offsets[(srcKeys[index] >> shift) & (NUM_BUCKETS - 1)]++;
+      dstKeys[position] = srcKeys[index];
+      if (values)
+      {
+        dstValues[position] = srcValues[index];
+      }
+    }
+    std::swap(srcKeys, dstKeys);
+    std::swap(srcValues, dstValues);
+  }
+
+  if (srcKeys != keys)
+  {
+    std::copy(srcKeys, srcKeys + numValues, keys);
+    if (values)
+    {
+      std::copy(srcValues, srcValues + numValues, values);
+    }
+  }
+}
+
+/// Policy for PackedSorter on devices that run on the calling thread.
+struct PackedSortPolicySerial
+{
+  template <typename Body>
+  static void ForEachChunk(vtkm::Id numChunks, const Body& body)
+  {
+    for (vtkm::Id chunk = 0; chunk < numChunks; ++chunk)
+    {
+      body(chunk);
+    }
+  }
+
+  template <typename WordType>
+  static void SortKeys(WordType* keys, std::size_t numValues, vtkm::IdComponent numBits)
+  {
+    serial_radix_sort_words(keys, nullptr, numValues, numBits);
+  }
+
+  template <typename WordType>
+  static void SortPairs(WordType* keys,
+                        vtkm::Id* values,
+                        std::size_t numValues,
+                        vtkm::IdComponent numBits)
+  {
+    serial_radix_sort_words(keys, values, numValues, numBits);
+  }
+};
+}
+}
+}
+} // end vtkm::cont::internal::radix
+
+#endif // vtk_m_cont_internal_ParallelRadixSortPacked_h
@@ -0,0 +1,233 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/internal/ScheduleTuner.h>
+
+#include <vtkm/cont/ErrorBadValue.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+
+std::atomic<bool> ScheduleTuningEnabled{ false };
+std::atomic<vtkm::Id> ScheduleTuningMinimumSize{ 16384 };
+
+// After all the options have been measured, one launch in this many probes an option other
+// than the best one.
+constexpr vtkm::Id PROBE_INTERVAL = 16;
+
+// Weight of a new measurement in the running average of an option.
+constexpr vtkm::Float64 MEASUREMENT_WEIGHT = 0.25;
+
+struct OptionStatistics
+{
+  vtkm::Id NumberOfMeasurements = 0;
+  vtkm::Float64 TimePerValue = 0;
+};
+
+struct KernelStatistics
+{
+  std::vector<OptionStatistics> Options;
+  vtkm::IdComponent BestOption = -1;
+  vtkm::Id NumberOfLaunches = 0;
+  vtkm::IdComponent NextProbe = 0;
+};
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+void SetScheduleTuningEnabled(bool enabled)
+{
+  ScheduleTuningEnabled = enabled;
+}
+
+bool GetScheduleTuningEnabled()
+{
+  return ScheduleTuningEnabled.load(std::memory_order_relaxed);
+}
+
+void SetScheduleTuningMinimumSize(vtkm::Id numValues)
+{
+  if (numValues < 0)
+  {
+    throw vtkm::cont::ErrorBadValue("The minimum size of tuned schedules cannot be negative.");
+  }
+  ScheduleTuningMinimumSize = numValues;
+}
+
+vtkm::Id GetScheduleTuningMinimumSize()
+{
+  return ScheduleTuningMinimumSize.load(std::memory_order_relaxed);
+}
+
+struct ScheduleTuner::InternalsType
+{
+  std::vector<vtkm::cont::internal::ScheduleOption> Options;
+
+  mutable std::mutex Mutex;
+  std::unordered_map<std::uintptr_t, KernelStatistics> Kernels;
+};
+
+ScheduleTuner::ScheduleTuner()
+  : ScheduleTuner(DefaultOptions())
+{
+}
+
+ScheduleTuner::ScheduleTuner(const std::vector<vtkm::cont::internal::ScheduleOption>& options)
+  : Internals(new InternalsType)
+{
+  if (options.empty())
+  {
+    throw vtkm::cont::ErrorBadValue("ScheduleTuner needs at least one option.");
+  }
+  this->Internals->Options = options;
+}
+
+ScheduleTuner::~ScheduleTuner() = default;
+
+std::vector<vtkm::cont::internal::ScheduleOption> ScheduleTuner::DefaultOptions()
+{
+  std::vector<vtkm::cont::internal::ScheduleOption> options;
+  for (vtkm::Id grainSize : { 16, 128, 1024, 8192 })
+  {
+    for (bool affinity : { false, true })
+    {
+      vtkm::cont::internal::ScheduleOption option;
+      option.GrainSize = grainSize;
+      option.Affinity = affinity;
+      options.push_back(option);
+    }
+  }
+  return options;
+}
+
+const std::vector<vtkm::cont::internal::ScheduleOption>& ScheduleTuner::GetOptions() const
+{
+  return this->Internals->Options;
+}
+
+vtkm::IdComponent ScheduleTuner::Begin(std::uintptr_t key, vtkm::Id numValues)
+{
+  if (!GetScheduleTuningEnabled() || (numValues < GetScheduleTuningMinimumSize()) ||
+      (numValues < 1))
+  {
+    return -1;
+  }
+
+  const vtkm::IdComponent numOptions =
+    static_cast<vtkm::IdComponent>(this->Internals->Options.size());
+
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  KernelStatistics& kernel = this->Internals->Kernels[key];
+  if (kernel.Options.empty())
+  {
+    kernel.Options.resize(this->Internals->Options.size());
+  }
+
+  // Measure every option once before choosing.
+  if (kernel.BestOption < 0)
+  {
+    for (vtkm::IdComponent option = 0; option < numOptions; ++option)
+    {
+      if (kernel.Options[static_cast<std::size_t>(option)].NumberOfMeasurements == 0)
+      {
+        return option;
+      }
+    }
+    // All options are being measured by other threads.
+    return 0;
+  }
+
+  ++kernel.NumberOfLaunches;
+  if ((numOptions > 1) && ((kernel.NumberOfLaunches % PROBE_INTERVAL) == 0))
+  {
+    vtkm::IdComponent probe = kernel.NextProbe;
+    if (probe == kernel.BestOption)
+    {
+      probe = (probe + 1) % numOptions;
+    }
+    kernel.NextProbe = (probe + 1) % numOptions;
+    return probe;
+  }
+  return kernel.BestOption;
+}
+
+void ScheduleTuner::End(std::uintptr_t key,
+                        vtkm::IdComponent option,
+                        vtkm::Id numValues,
+                        vtkm::Float64 elapsedTime)
+{
+  if ((option < 0) || (numValues < 1))
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  KernelStatistics& kernel = this->Internals->Kernels[key];
+  if (kernel.Options.empty())
+  {
+    // Reset was called during the launch.
+    return;
+  }
+
+  OptionStatistics& statistics = kernel.Options[static_cast<std::size_t>(option)];
+  const vtkm::Float64 timePerValue = elapsedTime / static_cast<vtkm::Float64>(numValues);
+  if (statistics.NumberOfMeasurements == 0)
+  {
+    statistics.TimePerValue = timePerValue;
+  }
+  else
+  {
+    statistics.TimePerValue += MEASUREMENT_WEIGHT * (timePerValue - statistics.TimePerValue);
+  }
+  ++statistics.NumberOfMeasurements;
+
+  vtkm::IdComponent best = -1;
+  for (std::size_t index = 0; index < kernel.Options.size(); ++index)
+  {
+    const OptionStatistics& candidate = kernel.Options[index];
+    if (candidate.NumberOfMeasurements == 0)
+    {
+      return;
+    }
+    if ((best < 0) ||
+        (candidate.TimePerValue < kernel.Options[static_cast<std::size_t>(best)].TimePerValue))
+    {
+      best = static_cast<vtkm::IdComponent>(index);
+    }
+  }
+  kernel.BestOption = best;
+}
+
+vtkm::IdComponent ScheduleTuner::GetBestOption(std::uintptr_t key) const
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  auto kernel = this->Internals->Kernels.find(key);
+  return (kernel != this->Internals->Kernels.end()) ? kernel->second.BestOption : -1;
+}
+
+void ScheduleTuner::Reset()
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  this->Internals->Kernels.clear();
+}
+
+}
+}
+} // namespace vtkm::cont::internal
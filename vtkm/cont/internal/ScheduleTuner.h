@@ -0,0 +1,105 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_cont_internal_ScheduleTuner_h
+#define vtk_m_cont_internal_ScheduleTuner_h
+
+#include <vtkm/Types.h>
+
+#include <vtkm/cont/vtkm_cont_export.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vtkm
+{
+namespace cont
+{
+namespace internal
+{
+
+/// \brief Turns the tuning of the schedules of the TBB and OpenMP devices on or off.
+///
+/// When tuning is enabled, each 1D schedule of a worklet or functor on the TBB or OpenMP device
+/// is timed. The schedule options (grain size and whether chunks keep their affinity to threads)
+/// are tried in turn for each kernel, and then the option with the best measured time per value
+/// is used for the following launches of that kernel. The other options keep being probed
+/// once in a while so that the choice follows changes in the data. Launches smaller than
+/// `GetScheduleTuningMinimumSize` are not tuned and use the default schedule of the device.
+///
+/// Tuning is off by default.
+///
+VTKM_CONT_EXPORT VTKM_CONT void SetScheduleTuningEnabled(bool enabled);
+VTKM_CONT_EXPORT VTKM_CONT bool GetScheduleTuningEnabled();
+
+/// Smallest number of values of a tuned schedule. The default is 16384.
+VTKM_CONT_EXPORT VTKM_CONT void SetScheduleTuningMinimumSize(vtkm::Id numValues);
+VTKM_CONT_EXPORT VTKM_CONT vtkm::Id GetScheduleTuningMinimumSize();
+
+/// \brief A way to schedule a 1D task.
+///
+struct ScheduleOption
+{
+  /// Number of values given to a thread at once.
+  vtkm::Id GrainSize = 1024;
+  /// When true, the chunks of repeated launches of the same size go to the same threads so that
+  /// the values stay in the caches (and NUMA domain) of the thread that first touched them.
+  /// Otherwise the chunks are balanced dynamically between the threads.
+  bool Affinity = false;
+};
+
+/// \brief Picks the schedule of each kernel from measured launch times.
+///
+/// Each device keeps a `ScheduleTuner` with the options it supports. Before a launch, the
+/// device calls `Begin` with a key identifying the kernel (see `TaskTiling1D::GetTaskKey`) and
+/// the number of values. If the returned index is negative, the launch is not tuned and the
+/// device uses its default schedule. Otherwise, the device schedules with the returned option
+/// and calls `End` with the elapsed time.
+///
+/// All the methods are thread safe.
+///
+class VTKM_CONT_EXPORT ScheduleTuner
+{
+public:
+  /// Creates a tuner choosing between the `DefaultOptions`.
+  VTKM_CONT ScheduleTuner();
+  VTKM_CONT ScheduleTuner(const std::vector<vtkm::cont::internal::ScheduleOption>& options);
+  VTKM_CONT ~ScheduleTuner();
+
+  /// The options shared by the host devices: grain sizes of 16, 128, 1024 and 8192 values,
+  /// each with and without affinity.
+  VTKM_CONT static std::vector<vtkm::cont::internal::ScheduleOption> DefaultOptions();
+
+  VTKM_CONT const std::vector<vtkm::cont::internal::ScheduleOption>& GetOptions() const;
+
+  VTKM_CONT vtkm::IdComponent Begin(std::uintptr_t key, vtkm::Id numValues);
+
+  VTKM_CONT void End(std::uintptr_t key,
+                     vtkm::IdComponent option,
+                     vtkm::Id numValues,
+                     vtkm::Float64 elapsedTime);
+
+  /// The option currently thought best for the kernel, or -1 if not all the options have been
+  /// measured yet.
+  VTKM_CONT vtkm::IdComponent GetBestOption(std::uintptr_t key) const;
+
+  /// Forgets all the measurements.
+  VTKM_CONT void Reset();
+
+private:
+  struct InternalsType;
+  std::unique_ptr<InternalsType> Internals;
+};
+
+}
+}
+} // namespace vtkm::cont::internal
+
+#endif //vtk_m_cont_internal_ScheduleTuner_h
@@ -12,9 +12,23 @@
 #include <vtkm/cont/openmp/internal/FunctorsOpenMP.h>
 
 #include <vtkm/cont/ErrorExecution.h>
+#include <vtkm/cont/internal/ScheduleTuner.h>
+
+#include <chrono>
 
 #include <omp.h>
 
+namespace
+{
+
+vtkm::cont::internal::ScheduleTuner& GetScheduleTuner()
+{
+  static vtkm::cont::internal::ScheduleTuner tuner;
+  return tuner;
+}
+
+} // anonymous namespace
+
 namespace vtkm
 {
 namespace cont
@@ -45,17 +59,53 @@ void DeviceAdapterAlgorithm<vtkm::cont::DeviceAdapterTagOpenMP>::ScheduleTask(
     return std::min(max, std::max(min, result));
   };
 
+  const std::uintptr_t key = functor.GetTaskKey();
+  vtkm::cont::internal::ScheduleTuner& tuner = GetScheduleTuner();
+  const vtkm::IdComponent tunedOption = tuner.Begin(key, size);
+
   // Figure out how to chunk the data:
-  const vtkm::Id chunkSize = computeChunkSize(size, 256, 1, 1024);
+  vtkm::Id chunkSize = computeChunkSize(size, 256, 1, 1024);
+  bool affinity = false;
+  if (tunedOption >= 0)
+  {
+    const vtkm::cont::internal::ScheduleOption& option =
+      tuner.GetOptions()[static_cast<std::size_t>(tunedOption)];
+    chunkSize = option.GrainSize;
+    affinity = option.Affinity;
+  }
   const vtkm::Id numChunks = (size + chunkSize - 1) / chunkSize;
 
-  VTKM_OPENMP_DIRECTIVE(parallel for
-                        schedule(guided))
-  for (vtkm::Id i = 0; i < numChunks; ++i)
+  const auto startTime = std::chrono::steady_clock::now();
+  if (affinity)
+  {
+    // A static schedule gives each thread the same contiguous range of the values on every
+    // launch, so repeated passes find the values in the caches (and NUMA domain) of the thread
+    // that first touched them.
+    VTKM_OPENMP_DIRECTIVE(parallel for
+                          schedule(static))
+    for (vtkm::Id i = 0; i < numChunks; ++i)
+    {
+      const vtkm::Id first = i * chunkSize;
+      const vtkm::Id last = std::min((i + 1) * chunkSize, size);
+      functor(first, last);
+    }
+  }
+  else
+  {
+    VTKM_OPENMP_DIRECTIVE(parallel for
+                          schedule(guided))
+    for (vtkm::Id i = 0; i < numChunks; ++i)
+    {
+      const vtkm::Id first = i * chunkSize;
+      const vtkm::Id last = std::min((i + 1) * chunkSize, size);
+      functor(first, last);
+    }
+  }
+  if (tunedOption >= 0)
   {
-    const vtkm::Id first = i * chunkSize;
-    const vtkm::Id last = std::min((i + 1) * chunkSize, size);
-    functor(first, last);
+    const std::chrono::duration<vtkm::Float64> elapsed =
+      std::chrono::steady_clock::now() - startTime;
+    tuner.End(key, tunedOption, size, elapsed.count());
   }
 
   if (errorMessage.IsErrorRaised())
@@ -16,6 +16,7 @@
 #include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandleZip.h>
+#include <vtkm/cont/internal/ParallelRadixSortPacked.h>
 
 #include <omp.h>
 
@@ -70,6 +71,56 @@ void parallel_sort(vtkm::cont::ArrayHandle<T, StorageT>& values,
     valuesPortal.GetIteratorBegin(), static_cast<std::size_t>(values.GetNumberOfValues()), c);
 }
 
+// Radix sort of integer keys packed into words:
+struct PackedSortPolicyOpenMP
+{
+  template <typename Body>
+  static void ForEachChunk(vtkm::Id numChunks, const Body& body)
+  {
+    VTKM_OPENMP_DIRECTIVE(parallel for schedule(static))
+    for (vtkm::Id chunk = 0; chunk < numChunks; ++chunk)
+    {
+      body(chunk);
+    }
+  }
+
+  template <typename WordType>
+  static void SortKeys(WordType* keys, std::size_t numValues, vtkm::IdComponent)
+  {
+    radix::parallel_radix_sort(keys, numValues, std::less<WordType>());
+  }
+
+  template <typename WordType>
+  static void SortPairs(WordType* keys,
+                        vtkm::Id* values,
+                        std::size_t numValues,
+                        vtkm::IdComponent)
+  {
+    radix::parallel_radix_sort_key_values(keys, values, numValues, std::less<WordType>());
+  }
+};
+
+template <typename T, typename StorageT, class BinaryCompare>
+void parallel_sort(vtkm::cont::ArrayHandle<T, StorageT>& values,
+                   BinaryCompare binary_compare,
+                   vtkm::cont::internal::radix::PackedRadixSortTag)
+{
+  using namespace vtkm::cont::internal::radix;
+  using Sorter = PackedSorter<PackedSortPolicyOpenMP, T>;
+  bool sorted;
+  {
+    vtkm::cont::Token token;
+    auto valuesPortal = values.PrepareForInPlace(vtkm::cont::DeviceAdapterTagOpenMP{}, token);
+    sorted = Sorter::Sort(valuesPortal.GetIteratorBegin(),
+                          values.GetNumberOfValues(),
+                          is_descending_compare<BinaryCompare>::value);
+  }
+  if (!sorted)
+  {
+    parallel_sort(values, binary_compare, PSortTag{});
+  }
+}
+
 // Value sort -- static switch between quicksort & radix sort
 template <typename T, typename Container, class BinaryCompare>
 void parallel_sort(vtkm::cont::ArrayHandle<T, Container>& values, BinaryCompare binary_compare)
@@ -239,6 +290,31 @@ void parallel_sort_bykey(vtkm::cont::ArrayHandle<T, StorageT>& keys,
   }
 }
 
+// Radix sort by key -- integer keys packed into words:
+template <typename T, typename StorageT, typename U, typename StorageU, class BinaryCompare>
+void parallel_sort_bykey(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                         vtkm::cont::ArrayHandle<U, StorageU>& values,
+                         BinaryCompare binary_compare,
+                         vtkm::cont::internal::radix::PackedRadixSortTag)
+{
+  using namespace vtkm::cont::internal::radix;
+  using Sorter = PackedSorter<PackedSortPolicyOpenMP, T>;
+  bool sorted;
+  {
+    vtkm::cont::Token token;
+    auto keysPortal = keys.PrepareForInPlace(vtkm::cont::DeviceAdapterTagOpenMP{}, token);
+    auto valuesPortal = values.PrepareForInPlace(vtkm::cont::DeviceAdapterTagOpenMP{}, token);
+    sorted = Sorter::SortByKey(keysPortal.GetIteratorBegin(),
+                               valuesPortal.GetIteratorBegin(),
+                               keys.GetNumberOfValues(),
+                               is_descending_compare<BinaryCompare>::value);
+  }
+  if (!sorted)
+  {
+    parallel_sort_bykey(keys, values, binary_compare, PSortTag{});
+  }
+}
+
 // Sort by key -- static switch between radix and quick sort:
 template <typename T, typename StorageT, typename U, typename StorageU, class BinaryCompare>
 void parallel_sort_bykey(vtkm::cont::ArrayHandle<T, StorageT>& keys,
@@ -16,6 +16,7 @@
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
 #include <vtkm/cont/ErrorExecution.h>
 #include <vtkm/cont/internal/DeviceAdapterAlgorithmGeneral.h>
+#include <vtkm/cont/internal/ParallelRadixSortPacked.h>
 #include <vtkm/cont/serial/internal/DeviceAdapterTagSerial.h>
 
 #include <vtkm/BinaryOperators.h>
@@ -463,23 +464,12 @@ private:
     Sort(zipHandle, internal::KeyCompare<T, U, BinaryCompare>(binary_compare));
   }
 
-public:
-  template <typename T, typename U, class StorageT, class StorageU>
-  VTKM_CONT static void SortByKey(vtkm::cont::ArrayHandle<T, StorageT>& keys,
-                                  vtkm::cont::ArrayHandle<U, StorageU>& values)
-  {
-    VTKM_LOG_SCOPE_FUNCTION(vtkm::cont::LogLevel::Perf);
-
-    SortByKey(keys, values, std::less<T>());
-  }
-
   template <typename T, typename U, class StorageT, class StorageU, class BinaryCompare>
-  VTKM_CONT static void SortByKey(vtkm::cont::ArrayHandle<T, StorageT>& keys,
-                                  vtkm::cont::ArrayHandle<U, StorageU>& values,
-                                  const BinaryCompare& binary_compare)
+  VTKM_CONT static void SortByKeyImpl(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                      vtkm::cont::ArrayHandle<U, StorageU>& values,
+                                      const BinaryCompare& binary_compare,
+                                      vtkm::cont::internal::radix::PSortTag)
   {
-    VTKM_LOG_SCOPE_FUNCTION(vtkm::cont::LogLevel::Perf);
-
     internal::WrappedBinaryOperator<bool, BinaryCompare> wrappedCompare(binary_compare);
     constexpr bool larger_than_64bits = sizeof(U) > sizeof(vtkm::Int64);
     if (larger_than_64bits)
@@ -500,6 +490,89 @@ public:
     }
   }
 
+  /// Radix sort of integer keys packed into words
+  template <typename T, typename U, class StorageT, class StorageU, class BinaryCompare>
+  VTKM_CONT static void SortByKeyImpl(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                      vtkm::cont::ArrayHandle<U, StorageU>& values,
+                                      const BinaryCompare& binary_compare,
+                                      vtkm::cont::internal::radix::PackedRadixSortTag)
+  {
+    using namespace vtkm::cont::internal::radix;
+    using Sorter = PackedSorter<PackedSortPolicySerial, T>;
+    bool sorted;
+    {
+      vtkm::cont::Token token;
+      auto keysPortal = keys.PrepareForInPlace(Device(), token);
+      auto valuesPortal = values.PrepareForInPlace(Device(), token);
+      sorted = Sorter::SortByKey(keysPortal.GetIteratorBegin(),
+                                 valuesPortal.GetIteratorBegin(),
+                                 keys.GetNumberOfValues(),
+                                 is_descending_compare<BinaryCompare>::value);
+    }
+    if (!sorted)
+    {
+      SortByKeyImpl(keys, values, binary_compare, PSortTag{});
+    }
+  }
+
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static void SortImpl(vtkm::cont::ArrayHandle<T, Storage>& values,
+                                 BinaryCompare binary_compare,
+                                 vtkm::cont::internal::radix::PSortTag)
+  {
+    vtkm::cont::Token token;
+
+    auto arrayPortal = values.PrepareForInPlace(Device(), token);
+    vtkm::cont::ArrayPortalToIterators<decltype(arrayPortal)> iterators(arrayPortal);
+
+    internal::WrappedBinaryOperator<bool, BinaryCompare> wrappedCompare(binary_compare);
+    std::sort(iterators.GetBegin(), iterators.GetEnd(), wrappedCompare);
+  }
+
+  /// Radix sort of integer keys packed into words
+  template <typename T, class Storage, class BinaryCompare>
+  VTKM_CONT static void SortImpl(vtkm::cont::ArrayHandle<T, Storage>& values,
+                                 BinaryCompare binary_compare,
+                                 vtkm::cont::internal::radix::PackedRadixSortTag)
+  {
+    using namespace vtkm::cont::internal::radix;
+    using Sorter = PackedSorter<PackedSortPolicySerial, T>;
+    bool sorted;
+    {
+      vtkm::cont::Token token;
+      auto portal = values.PrepareForInPlace(Device(), token);
+      sorted = Sorter::Sort(portal.GetIteratorBegin(),
+                            values.GetNumberOfValues(),
+                            is_descending_compare<BinaryCompare>::value);
+    }
+    if (!sorted)
+    {
+      SortImpl(values, binary_compare, PSortTag{});
+    }
+  }
+
+public:
+  template <typename T, typename U, class StorageT, class StorageU>
+  VTKM_CONT static void SortByKey(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                  vtkm::cont::ArrayHandle<U, StorageU>& values)
+  {
+    VTKM_LOG_SCOPE_FUNCTION(vtkm::cont::LogLevel::Perf);
+
+    SortByKey(keys, values, std::less<T>());
+  }
+
+  template <typename T, typename U, class StorageT, class StorageU, class BinaryCompare>
+  VTKM_CONT static void SortByKey(vtkm::cont::ArrayHandle<T, StorageT>& keys,
+                                  vtkm::cont::ArrayHandle<U, StorageU>& values,
+                                  const BinaryCompare& binary_compare)
+  {
+    VTKM_LOG_SCOPE_FUNCTION(vtkm::cont::LogLevel::Perf);
+
+    using SortAlgorithmTag = typename vtkm::cont::internal::radix::
+      packed_sortbykey_tag_type<T, U, StorageT, StorageU, BinaryCompare>::type;
+    SortByKeyImpl(keys, values, binary_compare, SortAlgorithmTag{});
+  }
+
   template <typename T, class Storage>
   VTKM_CONT static void Sort(vtkm::cont::ArrayHandle<T, Storage>& values)
   {
@@ -514,13 +587,9 @@ public:
   {
     VTKM_LOG_SCOPE_FUNCTION(vtkm::cont::LogLevel::Perf);
 
-    vtkm::cont::Token token;
-
-    auto arrayPortal = values.PrepareForInPlace(Device(), token);
-    vtkm::cont::ArrayPortalToIterators<decltype(arrayPortal)> iterators(arrayPortal);
-
-    internal::WrappedBinaryOperator<bool, BinaryCompare> wrappedCompare(binary_compare);
-    std::sort(iterators.GetBegin(), iterators.GetEnd(), wrappedCompare);
+    using SortAlgorithmTag =
+      typename vtkm::cont::internal::radix::packed_sort_tag_type<T, Storage, BinaryCompare>::type;
+    SortImpl(values, binary_compare, SortAlgorithmTag{});
   }
 
   template <typename T, class Storage>
@@ -10,6 +10,59 @@
 
 #include <vtkm/cont/tbb/internal/DeviceAdapterAlgorithmTBB.h>
 
+#include <vtkm/cont/internal/ScheduleTuner.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+
+vtkm::cont::internal::ScheduleTuner& GetScheduleTuner()
+{
+  static vtkm::cont::internal::ScheduleTuner tuner;
+  return tuner;
+}
+
+// An affinity_partitioner remembers which thread ran each chunk and hands the chunks back to
+// the same threads on the next launch, so repeated passes over the same arrays find them in the
+// caches (and NUMA domain) they were left in. One is kept per kernel. A partitioner must not be
+// used by two loops at once, so it is taken out of the cache for the duration of a launch.
+class AffinityPartitionerCache
+{
+public:
+  std::unique_ptr<::tbb::affinity_partitioner> Take(std::uintptr_t key)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    auto entry = this->Partitioners.find(key);
+    if ((entry != this->Partitioners.end()) && entry->second)
+    {
+      return std::move(entry->second);
+    }
+    return std::unique_ptr<::tbb::affinity_partitioner>(new ::tbb::affinity_partitioner);
+  }
+
+  void Return(std::uintptr_t key, std::unique_ptr<::tbb::affinity_partitioner>&& partitioner)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Partitioners[key] = std::move(partitioner);
+  }
+
+private:
+  std::mutex Mutex;
+  std::unordered_map<std::uintptr_t, std::unique_ptr<::tbb::affinity_partitioner>> Partitioners;
+};
+
+AffinityPartitionerCache& GetAffinityPartitionerCache()
+{
+  static AffinityPartitionerCache cache;
+  return cache;
+}
+
+} // anonymous namespace
+
 namespace vtkm
 {
 namespace cont
@@ -27,10 +80,39 @@ void DeviceAdapterAlgorithm<vtkm::cont::DeviceAdapterTagTBB>::ScheduleTask(
   vtkm::exec::internal::ErrorMessageBuffer errorMessage(errorString, MESSAGE_SIZE);
   functor.SetErrorMessageBuffer(errorMessage);
 
-  ::tbb::blocked_range<vtkm::Id> range(0, size, tbb::TBB_GRAIN_SIZE);
+  auto body = [&](const ::tbb::blocked_range<vtkm::Id>& r) { functor(r.begin(), r.end()); };
 
-  ::tbb::parallel_for(
-    range, [&](const ::tbb::blocked_range<vtkm::Id>& r) { functor(r.begin(), r.end()); });
+  const std::uintptr_t key = functor.GetTaskKey();
+  vtkm::cont::internal::ScheduleTuner& tuner = GetScheduleTuner();
+  const vtkm::IdComponent tunedOption = tuner.Begin(key, size);
+  if (tunedOption < 0)
+  {
+    ::tbb::blocked_range<vtkm::Id> range(0, size, tbb::TBB_GRAIN_SIZE);
+    ::tbb::parallel_for(range, body);
+  }
+  else
+  {
+    const vtkm::cont::internal::ScheduleOption& option =
+      tuner.GetOptions()[static_cast<std::size_t>(tunedOption)];
+    ::tbb::blocked_range<vtkm::Id> range(0, size, static_cast<std::size_t>(option.GrainSize));
+
+    const auto startTime = std::chrono::steady_clock::now();
+    if (option.Affinity)
+    {
+      std::unique_ptr<::tbb::affinity_partitioner> partitioner =
+        GetAffinityPartitionerCache().Take(key);
+      ::tbb::parallel_for(range, body, *partitioner);
+      GetAffinityPartitionerCache().Return(key, std::move(partitioner));
+    }
+    else
+    {
+      // The simple partitioner splits down to the grain size, which is what is being tuned.
+      ::tbb::parallel_for(range, body, ::tbb::simple_partitioner{});
+    }
+    const std::chrono::duration<vtkm::Float64> elapsed =
+      std::chrono::steady_clock::now() - startTime;
+    tuner.End(key, tunedOption, size, elapsed.count());
+  }
 
   if (errorMessage.IsErrorRaised())
   {
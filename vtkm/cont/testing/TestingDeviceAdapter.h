@@ -39,6 +39,7 @@
 #include <chrono>
 #include <cmath>
 #include <ctime>
+#include <limits>
 #include <random>
 #include <thread>
 #include <utility>
@@ -1125,6 +1126,123 @@ private:
     }
   }
 
+  template <typename KeyType, typename BinaryCompare>
+  static VTKM_CONT void CheckSortIntegerKeys(const std::vector<KeyType>& testKeys,
+                                             BinaryCompare binary_compare)
+  {
+    const vtkm::Id numValues = static_cast<vtkm::Id>(testKeys.size());
+    std::vector<KeyType> expectedKeys(testKeys);
+    std::sort(expectedKeys.begin(), expectedKeys.end(), binary_compare);
+
+    vtkm::cont::ArrayHandle<KeyType> keys;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandle(testKeys, vtkm::CopyFlag::Off), keys);
+    Algorithm::Sort(keys, binary_compare);
+    auto keysPortal = keys.ReadPortal();
+    for (vtkm::Id i = 0; i < numValues; ++i)
+    {
+      VTKM_TEST_ASSERT(keysPortal.Get(i) == expectedKeys[static_cast<std::size_t>(i)],
+                       "Got bad Sort key");
+    }
+
+    // Index values
+    IdArrayHandle indices;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandle(testKeys, vtkm::CopyFlag::Off), keys);
+    Algorithm::Copy(vtkm::cont::ArrayHandleIndex(numValues), indices);
+    Algorithm::SortByKey(keys, indices, binary_compare);
+    keysPortal = keys.ReadPortal();
+    auto indicesPortal = indices.ReadPortal();
+    for (vtkm::Id i = 0; i < numValues; ++i)
+    {
+      VTKM_TEST_ASSERT(keysPortal.Get(i) == expectedKeys[static_cast<std::size_t>(i)],
+                       "Got bad SortByKey key");
+      VTKM_TEST_ASSERT(testKeys[static_cast<std::size_t>(indicesPortal.Get(i))] ==
+                         keysPortal.Get(i),
+                       "Got bad SortByKey index");
+    }
+
+    // Other values
+    vtkm::cont::ArrayHandle<vtkm::Id2> values;
+    Algorithm::Copy(vtkm::cont::make_ArrayHandle(testKeys, vtkm::CopyFlag::Off), keys);
+    values.Allocate(numValues);
+    auto valuesPortal = values.WritePortal();
+    for (vtkm::Id i = 0; i < numValues; ++i)
+    {
+      valuesPortal.Set(i, vtkm::Id2(i, -i));
+    }
+    Algorithm::SortByKey(keys, values, binary_compare);
+    keysPortal = keys.ReadPortal();
+    auto sortedValuesPortal = values.ReadPortal();
+    for (vtkm::Id i = 0; i < numValues; ++i)
+    {
+      const vtkm::Id2 value = sortedValuesPortal.Get(i);
+      VTKM_TEST_ASSERT(value[1] == -value[0], "Got bad SortByKey value");
+      VTKM_TEST_ASSERT(testKeys[static_cast<std::size_t>(value[0])] == keysPortal.Get(i),
+                       "Got bad SortByKey value");
+    }
+  }
+
+  static VTKM_CONT void TestSortIntegerKeys()
+  {
+    std::cout << "-------------------------------------------------" << std::endl;
+    std::cout << "Sort of integer and integer vector keys" << std::endl;
+
+    constexpr std::size_t numValues = 20000;
+    std::mt19937 generator(123);
+
+    // Keys that pack in 32 bits
+    std::uniform_int_distribution<vtkm::Id> smallRange(0, 999);
+    std::vector<vtkm::Id2> edges(numValues);
+    std::vector<vtkm::Id> ids(numValues);
+    for (std::size_t i = 0; i < numValues; ++i)
+    {
+      edges[i] = vtkm::Id2(smallRange(generator), smallRange(generator));
+      ids[i] = smallRange(generator) - 500;
+    }
+    CheckSortIntegerKeys(edges, vtkm::SortLess());
+    CheckSortIntegerKeys(ids, vtkm::SortGreater());
+
+    // Signed keys that pack in 64 bits
+    std::uniform_int_distribution<vtkm::Id> signedRange(-(vtkm::Id(1) << 20), vtkm::Id(1) << 20);
+    std::vector<vtkm::Id3> faces(numValues);
+    std::vector<vtkm::Vec<vtkm::Int16, 2>> shorts(numValues);
+    for (std::size_t i = 0; i < numValues; ++i)
+    {
+      faces[i] =
+        vtkm::Id3(signedRange(generator), signedRange(generator), signedRange(generator) % 16);
+      shorts[i] = vtkm::Vec<vtkm::Int16, 2>(static_cast<vtkm::Int16>(signedRange(generator) % 7),
+                                            static_cast<vtkm::Int16>(signedRange(generator)));
+    }
+    CheckSortIntegerKeys(faces, vtkm::SortGreater());
+    CheckSortIntegerKeys(shorts, std::less<vtkm::Vec<vtkm::Int16, 2>>());
+
+    // Keys that pack in 128 bits
+    std::uniform_int_distribution<vtkm::Id> largeRange(0, vtkm::Id(1) << 40);
+    for (std::size_t i = 0; i < numValues; ++i)
+    {
+      // Repeat some keys and some high words.
+      faces[i] = vtkm::Id3(largeRange(generator) % 64, largeRange(generator), largeRange(generator));
+      if (i % 3 == 1)
+      {
+        faces[i] = faces[i - 1];
+      }
+      else if (i % 3 == 2)
+      {
+        faces[i][2] = largeRange(generator);
+      }
+    }
+    CheckSortIntegerKeys(faces, std::less<vtkm::Id3>());
+    CheckSortIntegerKeys(faces, vtkm::SortGreater());
+
+    // Keys that do not pack
+    std::uniform_int_distribution<vtkm::Id> fullRange(std::numeric_limits<vtkm::Id>::lowest(),
+                                                      std::numeric_limits<vtkm::Id>::max());
+    for (std::size_t i = 0; i < numValues; ++i)
+    {
+      faces[i] = vtkm::Id3(fullRange(generator), fullRange(generator), fullRange(generator));
+    }
+    CheckSortIntegerKeys(faces, vtkm::SortLess());
+  }
+
   static VTKM_CONT void TestLowerBoundsWithComparisonObject()
   {
     std::cout << "-------------------------------------------------" << std::endl;
@@ -2975,6 +3093,7 @@ private:
       TestSortWithComparisonObject();
       TestSortWithFancyArrays();
       TestSortByKey();
+      TestSortIntegerKeys();
 
       TestLowerBoundsWithComparisonObject();
 
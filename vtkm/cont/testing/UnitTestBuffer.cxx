@@ -246,6 +246,29 @@ void DoTest()
     vtkm::cont::Token token;
     CheckPortal(MakePortal(buffer.ReadPointerHost(token), ARRAY_SIZE));
   }
+  std::cout << "Check version stamps" << std::endl;
+  {
+    const vtkm::UInt64 version = buffer.GetVersion();
+    {
+      vtkm::cont::Token token;
+      buffer.ReadPointerHost(token);
+      buffer.ReadPointerDevice(device, token);
+    }
+    VTKM_TEST_ASSERT(buffer.GetVersion() == version, "Reading changed the version");
+    {
+      vtkm::cont::Token token;
+      buffer.WritePointerHost(token);
+    }
+    const vtkm::UInt64 writtenVersion = buffer.GetVersion();
+    VTKM_TEST_ASSERT(writtenVersion != version, "Writing did not change the version");
+
+    vtkm::cont::internal::Buffer copy;
+    VTKM_TEST_ASSERT(copy.GetVersion() != writtenVersion, "Buffers share a version");
+    const vtkm::UInt64 copyVersion = copy.GetVersion();
+    copy.DeepCopyFrom(buffer);
+    VTKM_TEST_ASSERT(copy.GetVersion() != copyVersion, "Copying did not change the version");
+    VTKM_TEST_ASSERT(buffer.GetVersion() == writtenVersion, "Copying changed the source version");
+  }
 }
 
 } // anonymous namespace
@@ -9,6 +9,7 @@
 //============================================================================
 
 #include <vtkm/cont/ArrayPortalToIterators.h>
+#include <vtkm/cont/BoundsCompute.h>
 #include <vtkm/cont/FieldRangeCompute.h>
 #include <vtkm/cont/testing/Testing.h>
 
@@ -138,6 +139,37 @@ void TryRangeComputePDS(const ValueType& min, const ValueType& max)
   Validate(ranges, min, max);
 }
 
+static void TestRangeCache()
+{
+  std::cout << "Testing cached ranges" << std::endl;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> coords =
+    vtkm::cont::make_ArrayHandle<vtkm::Vec3f>({ { 0, 0, 0 }, { 1, 2, 3 } });
+  vtkm::cont::DataSet dataset;
+  dataset.AddCoordinateSystem(vtkm::cont::CoordinateSystem("coords", coords));
+
+  // Each call returns a new copy of the coordinate system, but they share the cached range.
+  auto first = dataset.GetCoordinateSystem().GetRangeAsArrayHandle();
+  auto second = dataset.GetCoordinateSystem().GetRangeAsArrayHandle();
+  VTKM_TEST_ASSERT(first == second, "Range was not cached");
+  VTKM_TEST_ASSERT(vtkm::cont::BoundsCompute(dataset) == vtkm::Bounds(0, 1, 0, 2, 0, 3));
+
+  // Writing to the array through any handle invalidates the cache.
+  coords.WritePortal().Set(1, { 4, 5, 6 });
+  auto third = dataset.GetCoordinateSystem().GetRangeAsArrayHandle();
+  VTKM_TEST_ASSERT(third != first, "Range was not recomputed");
+  VTKM_TEST_ASSERT(vtkm::cont::BoundsCompute(dataset) == vtkm::Bounds(0, 4, 0, 5, 0, 6));
+
+  // Reading does not.
+  coords.ReadPortal();
+  VTKM_TEST_ASSERT(dataset.GetCoordinateSystem().GetRangeAsArrayHandle() == third);
+
+  // Replacing the data of a copy leaves the original alone.
+  vtkm::cont::CoordinateSystem copy = dataset.GetCoordinateSystem();
+  copy.SetData(vtkm::cont::make_ArrayHandle<vtkm::Vec3f>({ { -1, -1, -1 } }));
+  VTKM_TEST_ASSERT(copy.GetBounds() == vtkm::Bounds(-1, -1, -1, -1, -1, -1));
+  VTKM_TEST_ASSERT(vtkm::cont::BoundsCompute(dataset) == vtkm::Bounds(0, 4, 0, 5, 0, 6));
+}
+
 static void TestFieldRangeCompute()
 {
   // init random seed.
@@ -151,6 +183,7 @@ static void TestFieldRangeCompute()
   TryRangeComputePDS<vtkm::Int32>(-1024, 1024);
   TryRangeComputePDS<vtkm::Vec3f_32>(vtkm::make_Vec(1024, 0, -1024),
                                      vtkm::make_Vec(2048, 2048, 2048));
+  TestRangeCache();
 };
 
 int UnitTestFieldRangeCompute(int argc, char* argv[])
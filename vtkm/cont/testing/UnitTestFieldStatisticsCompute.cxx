@@ -0,0 +1,204 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/FieldStatisticsCompute.h>
+#include <vtkm/cont/testing/Testing.h>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// Large enough for several chunks to be combined.
+constexpr vtkm::Id ARRAY_SIZE = 5000;
+
+// Statistics computed the straightforward way.
+vtkm::cont::FieldStatistics Expected(const std::vector<vtkm::Float64>& values)
+{
+  vtkm::cont::FieldStatistics result;
+  vtkm::Float64 sum = 0;
+  for (vtkm::Float64 value : values)
+  {
+    if (vtkm::IsNan(value))
+    {
+      ++result.NumberOfNaNs;
+      continue;
+    }
+    ++result.NumberOfValues;
+    sum += value;
+    result.Range.Include(value);
+  }
+  if (result.NumberOfValues > 0)
+  {
+    result.Mean = sum / static_cast<vtkm::Float64>(result.NumberOfValues);
+    vtkm::Float64 sumSquares = 0;
+    for (vtkm::Float64 value : values)
+    {
+      if (!vtkm::IsNan(value))
+      {
+        sumSquares += (value - result.Mean) * (value - result.Mean);
+      }
+    }
+    result.Variance = sumSquares / static_cast<vtkm::Float64>(result.NumberOfValues);
+  }
+  return result;
+}
+
+void CheckStatistics(const vtkm::cont::FieldStatistics& result,
+                     const vtkm::cont::FieldStatistics& expected)
+{
+  VTKM_TEST_ASSERT(result.NumberOfValues == expected.NumberOfValues, "Wrong number of values");
+  VTKM_TEST_ASSERT(result.NumberOfNaNs == expected.NumberOfNaNs, "Wrong number of NaNs");
+  VTKM_TEST_ASSERT(result.Range == expected.Range, "Wrong range");
+  if (expected.NumberOfValues == 0)
+  {
+    VTKM_TEST_ASSERT(vtkm::IsNan(result.Mean) && vtkm::IsNan(result.Variance));
+    return;
+  }
+  VTKM_TEST_ASSERT(test_equal(result.Mean, expected.Mean), "Wrong mean");
+  VTKM_TEST_ASSERT(test_equal(result.Variance, expected.Variance), "Wrong variance");
+}
+
+struct TestData
+{
+  vtkm::cont::DataSet DataSet;
+  // Values of each component of "scalars", "ints", and "vectors".
+  std::vector<std::vector<vtkm::Float64>> Components;
+};
+
+TestData MakeTestData(unsigned int seed, vtkm::Float64 offset)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<vtkm::Float64> dis(-100.0, 100.0);
+
+  TestData data;
+  data.Components.resize(5);
+
+  std::vector<vtkm::Float64> scalars(ARRAY_SIZE);
+  std::vector<vtkm::Int32> ints(ARRAY_SIZE);
+  std::vector<vtkm::Vec3f_32> vectors(ARRAY_SIZE);
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    // A large offset checks that the variance does not lose precision.
+    scalars[static_cast<std::size_t>(index)] =
+      (index % 97 == 0) ? vtkm::Nan64() : offset + dis(gen);
+    ints[static_cast<std::size_t>(index)] = static_cast<vtkm::Int32>(index % 1000) - 500;
+    vectors[static_cast<std::size_t>(index)] = vtkm::Vec3f_32(static_cast<vtkm::Float32>(dis(gen)),
+                                                              static_cast<vtkm::Float32>(index),
+                                                              -1.0f);
+    data.Components[0].push_back(scalars[static_cast<std::size_t>(index)]);
+    data.Components[1].push_back(ints[static_cast<std::size_t>(index)]);
+    for (vtkm::IdComponent cIndex = 0; cIndex < 3; ++cIndex)
+    {
+      data.Components[static_cast<std::size_t>(2 + cIndex)].push_back(
+        vectors[static_cast<std::size_t>(index)][cIndex]);
+    }
+  }
+
+  data.DataSet.AddPointField("scalars", scalars);
+  data.DataSet.AddPointField("ints", ints);
+  data.DataSet.AddPointField("vectors", vectors);
+  data.DataSet.AddCellField("empty", vtkm::cont::ArrayHandle<vtkm::Float32>{});
+  return data;
+}
+
+void TestDataSet()
+{
+  std::cout << "Testing statistics of a DataSet" << std::endl;
+  TestData data = MakeTestData(1, 1.0e9);
+
+  auto results = vtkm::cont::FieldStatisticsCompute(
+    data.DataSet, { "scalars", "ints", "vectors", "empty", "missing" });
+  VTKM_TEST_ASSERT(results.size() == 5);
+
+  VTKM_TEST_ASSERT(results[0].GetNumberOfValues() == 1);
+  CheckStatistics(results[0].ReadPortal().Get(0), Expected(data.Components[0]));
+  VTKM_TEST_ASSERT(results[1].GetNumberOfValues() == 1);
+  CheckStatistics(results[1].ReadPortal().Get(0), Expected(data.Components[1]));
+  VTKM_TEST_ASSERT(results[2].GetNumberOfValues() == 3);
+  for (vtkm::IdComponent cIndex = 0; cIndex < 3; ++cIndex)
+  {
+    CheckStatistics(results[2].ReadPortal().Get(cIndex),
+                    Expected(data.Components[static_cast<std::size_t>(2 + cIndex)]));
+  }
+  VTKM_TEST_ASSERT(results[3].GetNumberOfValues() == 1);
+  CheckStatistics(results[3].ReadPortal().Get(0), vtkm::cont::FieldStatistics{});
+  VTKM_TEST_ASSERT(results[4].GetNumberOfValues() == 0);
+
+  // The range comes along with the statistics.
+  const vtkm::cont::Field& vectorField = data.DataSet.GetField("vectors");
+  auto ranges = vectorField.GetRange();
+  VTKM_TEST_ASSERT(ranges.GetNumberOfValues() == 3);
+  for (vtkm::IdComponent cIndex = 0; cIndex < 3; ++cIndex)
+  {
+    VTKM_TEST_ASSERT(ranges.ReadPortal().Get(cIndex) ==
+                     results[2].ReadPortal().Get(cIndex).Range);
+  }
+}
+
+void TestCache()
+{
+  std::cout << "Testing cached statistics" << std::endl;
+  TestData data = MakeTestData(2, 0.0);
+
+  vtkm::cont::Field& field = data.DataSet.GetField("scalars");
+  auto first = field.GetStatistics();
+  VTKM_TEST_ASSERT(field.GetStatistics() == first, "Statistics were not cached");
+  VTKM_TEST_ASSERT(vtkm::cont::FieldStatisticsCompute(data.DataSet, { "scalars" })[0] == first,
+                   "Statistics were not cached");
+
+  field.SetData(vtkm::cont::make_ArrayHandle<vtkm::Float64>({ 1, 2, 3, 4 }));
+  auto second = field.GetStatistics();
+  VTKM_TEST_ASSERT(second != first, "Statistics were not recomputed");
+  vtkm::cont::FieldStatistics expected = Expected({ 1, 2, 3, 4 });
+  CheckStatistics(second.ReadPortal().Get(0), expected);
+}
+
+void TestPartitionedDataSet()
+{
+  std::cout << "Testing statistics of a PartitionedDataSet" << std::endl;
+  vtkm::cont::PartitionedDataSet pds;
+  std::vector<std::vector<vtkm::Float64>> allComponents(5);
+  for (unsigned int partition = 0; partition < 3; ++partition)
+  {
+    TestData data = MakeTestData(10 + partition, 10.0 * partition);
+    pds.AppendPartition(data.DataSet);
+    for (std::size_t cIndex = 0; cIndex < allComponents.size(); ++cIndex)
+    {
+      allComponents[cIndex].insert(allComponents[cIndex].end(),
+                                   data.Components[cIndex].begin(),
+                                   data.Components[cIndex].end());
+    }
+  }
+
+  auto results = vtkm::cont::FieldStatisticsCompute(pds, { "scalars", "vectors" });
+  VTKM_TEST_ASSERT(results.size() == 2);
+  CheckStatistics(results[0].ReadPortal().Get(0), Expected(allComponents[0]));
+  for (vtkm::IdComponent cIndex = 0; cIndex < 3; ++cIndex)
+  {
+    CheckStatistics(results[1].ReadPortal().Get(cIndex),
+                    Expected(allComponents[static_cast<std::size_t>(2 + cIndex)]));
+  }
+}
+
+void Run()
+{
+  TestDataSet();
+  TestCache();
+  TestPartitionedDataSet();
+}
+
+} // anonymous namespace
+
+int UnitTestFieldStatisticsCompute(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
@@ -0,0 +1,223 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandleFileMapped.h>
+#include <vtkm/cont/ArrayRangeCompute.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/internal/FileMappedMemory.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+constexpr vtkm::Id ARRAY_SIZE = 100000;
+using ValueType = vtkm::Float32;
+
+const std::string FILE_NAME = "UnitTestFileMappedMemory.bin";
+
+void WriteFile(vtkm::Id numValues)
+{
+  std::vector<ValueType> values(static_cast<std::size_t>(numValues));
+  for (vtkm::Id index = 0; index < numValues; ++index)
+  {
+    values[static_cast<std::size_t>(index)] = TestValue(index, ValueType{});
+  }
+  std::ofstream file(FILE_NAME, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(values.data()),
+             static_cast<std::streamsize>(values.size() * sizeof(ValueType)));
+}
+
+std::vector<ValueType> ReadFile()
+{
+  std::ifstream file(FILE_NAME, std::ios::binary | std::ios::ate);
+  std::vector<ValueType> values(static_cast<std::size_t>(file.tellg()) / sizeof(ValueType));
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(ValueType)));
+  return values;
+}
+
+void FillArray(const vtkm::cont::ArrayHandle<ValueType>& array, vtkm::Id offset = 0)
+{
+  auto portal = array.WritePortal();
+  for (vtkm::Id index = 0; index < portal.GetNumberOfValues(); ++index)
+  {
+    portal.Set(index, TestValue(index + offset, ValueType{}));
+  }
+}
+
+// Checks the first `numValues` values of `array`.
+void CheckArray(const vtkm::cont::ArrayHandle<ValueType>& array,
+                vtkm::Id numValues,
+                vtkm::Id offset = 0)
+{
+  VTKM_TEST_ASSERT(array.GetNumberOfValues() >= numValues);
+  auto portal = array.ReadPortal();
+  for (vtkm::Id index = 0; index < numValues; ++index)
+  {
+    VTKM_TEST_ASSERT(test_equal(portal.Get(index), TestValue(index + offset, ValueType{})));
+  }
+}
+
+void TestRead()
+{
+  std::cout << "Map a file for reading" << std::endl;
+  WriteFile(ARRAY_SIZE);
+  {
+    auto array = vtkm::cont::make_ArrayHandleFileMapped<ValueType>(FILE_NAME);
+    VTKM_TEST_ASSERT(array.GetNumberOfValues() == ARRAY_SIZE);
+    CheckArray(array, ARRAY_SIZE);
+
+    vtkm::Range range = vtkm::cont::ArrayRangeCompute(array).ReadPortal().Get(0);
+    VTKM_TEST_ASSERT(range.Contains(TestValue(0, ValueType{})));
+
+    // Values written to the array do not make it to the file.
+    FillArray(array, 1);
+    CheckArray(array, ARRAY_SIZE, 1);
+    VTKM_TEST_ASSERT(test_equal(ReadFile()[0], TestValue(0, ValueType{})));
+
+    // Resizing moves the data to host memory.
+    array.Allocate(ARRAY_SIZE / 2, vtkm::CopyFlag::On);
+    CheckArray(array, ARRAY_SIZE / 2, 1);
+    VTKM_TEST_ASSERT(ReadFile().size() == static_cast<std::size_t>(ARRAY_SIZE));
+  }
+
+  std::cout << "Map part of a file" << std::endl;
+  {
+    auto array = vtkm::cont::make_ArrayHandleFileMapped<ValueType>(
+      FILE_NAME, vtkm::cont::FileMapMode::Read, 10);
+    VTKM_TEST_ASSERT(array.GetNumberOfValues() == 10);
+    CheckArray(array, 10);
+  }
+
+  std::cout << "Map more than the file holds" << std::endl;
+  bool threw = false;
+  try
+  {
+    vtkm::cont::make_ArrayHandleFileMapped<ValueType>(
+      FILE_NAME, vtkm::cont::FileMapMode::Read, 2 * ARRAY_SIZE);
+  }
+  catch (vtkm::cont::ErrorBadValue& error)
+  {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    threw = true;
+  }
+  VTKM_TEST_ASSERT(threw, "Mapping past the end of the file did not fail");
+}
+
+void TestCreateAndWrite()
+{
+  std::cout << "Create a file" << std::endl;
+  {
+    auto array = vtkm::cont::make_ArrayHandleFileMapped<ValueType>(
+      FILE_NAME, vtkm::cont::FileMapMode::Create, ARRAY_SIZE);
+    FillArray(array);
+
+    // Growing the array grows the file.
+    array.Allocate(2 * ARRAY_SIZE, vtkm::CopyFlag::On);
+    VTKM_TEST_ASSERT(array.GetNumberOfValues() == 2 * ARRAY_SIZE);
+    CheckArray(array, ARRAY_SIZE);
+  }
+  VTKM_TEST_ASSERT(ReadFile().size() == static_cast<std::size_t>(2 * ARRAY_SIZE));
+
+  std::cout << "Update a file" << std::endl;
+  {
+    auto array = vtkm::cont::make_ArrayHandleFileMapped<ValueType>(
+      FILE_NAME, vtkm::cont::FileMapMode::ReadWrite);
+    VTKM_TEST_ASSERT(array.GetNumberOfValues() == 2 * ARRAY_SIZE);
+    array.Allocate(ARRAY_SIZE, vtkm::CopyFlag::On);
+    CheckArray(array, ARRAY_SIZE);
+    FillArray(array, 2);
+  }
+  std::vector<ValueType> values = ReadFile();
+  VTKM_TEST_ASSERT(values.size() == static_cast<std::size_t>(ARRAY_SIZE));
+  VTKM_TEST_ASSERT(test_equal(values[0], TestValue(2, ValueType{})));
+}
+
+void TestEviction()
+{
+  std::cout << "Evict mapped pages" << std::endl;
+  WriteFile(ARRAY_SIZE);
+  auto array = vtkm::cont::make_ArrayHandleFileMapped<ValueType>(
+    FILE_NAME, vtkm::cont::FileMapMode::ReadWrite);
+  FillArray(array, 3);
+  VTKM_TEST_ASSERT(vtkm::cont::internal::GetFileMappedResidentBytes() > 0);
+
+  auto start = vtkm::cont::internal::GetFileMappedMemoryStatistics();
+  vtkm::cont::internal::EvictFileMappedMemory();
+  auto afterEvict = vtkm::cont::internal::GetFileMappedMemoryStatistics();
+  VTKM_TEST_ASSERT(afterEvict.NumberOfEvictions > start.NumberOfEvictions);
+
+  // Evicted pages come back from the file.
+  CheckArray(array, ARRAY_SIZE, 3);
+
+  std::cout << "Evict when over budget" << std::endl;
+  vtkm::cont::internal::SetFileMappedMemoryBudget(0);
+  VTKM_TEST_ASSERT(vtkm::cont::internal::GetFileMappedMemoryStatistics().NumberOfEvictions >
+                   afterEvict.NumberOfEvictions);
+  vtkm::cont::internal::SetFileMappedMemoryBudget(
+    std::numeric_limits<vtkm::BufferSizeType>::max());
+  CheckArray(array, ARRAY_SIZE, 3);
+}
+
+void TestSpill()
+{
+  std::cout << "Spill host allocations" << std::endl;
+  vtkm::cont::internal::SetHostMemorySpillDirectory(".");
+  vtkm::cont::internal::SetHostMemorySpillThreshold(4096);
+
+  auto start = vtkm::cont::internal::GetFileMappedMemoryStatistics();
+  {
+    vtkm::cont::ArrayHandle<ValueType> array;
+    array.Allocate(ARRAY_SIZE);
+    FillArray(array);
+    auto spilled = vtkm::cont::internal::GetFileMappedMemoryStatistics();
+    VTKM_TEST_ASSERT(spilled.NumberOfSpilledAllocations > start.NumberOfSpilledAllocations);
+    VTKM_TEST_ASSERT(spilled.NumberOfMappings > start.NumberOfMappings);
+
+    vtkm::cont::internal::EvictFileMappedMemory();
+    array.Allocate(2 * ARRAY_SIZE, vtkm::CopyFlag::On);
+    CheckArray(array, ARRAY_SIZE);
+
+    // Small allocations are not spilled.
+    vtkm::cont::ArrayHandle<ValueType> small;
+    small.Allocate(10);
+    FillArray(small);
+    VTKM_TEST_ASSERT(vtkm::cont::internal::GetFileMappedMemoryStatistics().NumberOfMappings ==
+                     spilled.NumberOfMappings);
+  }
+  VTKM_TEST_ASSERT(vtkm::cont::internal::GetFileMappedMemoryStatistics().NumberOfMappings ==
+                   start.NumberOfMappings);
+
+  vtkm::cont::internal::SetHostMemorySpillDirectory("");
+  vtkm::cont::internal::SetHostMemorySpillThreshold(vtkm::BufferSizeType{ 64 } << 20);
+}
+
+void Run()
+{
+  TestRead();
+  TestCreateAndWrite();
+  TestEviction();
+  TestSpill();
+  std::remove(FILE_NAME.c_str());
+}
+
+} // anonymous namespace
+
+int UnitTestFileMappedMemory(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
@@ -0,0 +1,136 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/internal/HostMemoryPool.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+constexpr vtkm::Id ARRAY_SIZE = 100000;
+
+void FillArray(vtkm::cont::ArrayHandle<vtkm::FloatDefault>& array, vtkm::Id numValues)
+{
+  array.Allocate(numValues);
+  auto portal = array.WritePortal();
+  for (vtkm::Id index = 0; index < numValues; ++index)
+  {
+    portal.Set(index, TestValue(index, vtkm::FloatDefault{}));
+  }
+}
+
+void CheckArray(const vtkm::cont::ArrayHandle<vtkm::FloatDefault>& array, vtkm::Id numValues)
+{
+  VTKM_TEST_ASSERT(array.GetNumberOfValues() == numValues);
+  auto portal = array.ReadPortal();
+  for (vtkm::Id index = 0; index < numValues; ++index)
+  {
+    VTKM_TEST_ASSERT(test_equal(portal.Get(index), TestValue(index, vtkm::FloatDefault{})));
+  }
+}
+
+void TestReuse()
+{
+  std::cout << "Test reuse of released blocks" << std::endl;
+  auto start = vtkm::cont::internal::GetHostMemoryPoolStatistics();
+  {
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> array;
+    FillArray(array, ARRAY_SIZE);
+    CheckArray(array, ARRAY_SIZE);
+  }
+  auto afterFirst = vtkm::cont::internal::GetHostMemoryPoolStatistics();
+  VTKM_TEST_ASSERT(afterFirst.NumberOfAllocations > start.NumberOfAllocations);
+  VTKM_TEST_ASSERT(afterFirst.BytesCached >=
+                   static_cast<vtkm::BufferSizeType>(ARRAY_SIZE * sizeof(vtkm::FloatDefault)));
+
+  {
+    // A slightly smaller array falls in the same size class and reuses the cached block.
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> array;
+    FillArray(array, ARRAY_SIZE - 10);
+    CheckArray(array, ARRAY_SIZE - 10);
+  }
+  auto afterSecond = vtkm::cont::internal::GetHostMemoryPoolStatistics();
+  VTKM_TEST_ASSERT(afterSecond.NumberOfCacheHits > afterFirst.NumberOfCacheHits);
+  VTKM_TEST_ASSERT(afterSecond.NumberOfCacheMisses == afterFirst.NumberOfCacheMisses);
+  VTKM_TEST_ASSERT(afterSecond.BytesInUse == start.BytesInUse);
+}
+
+void TestReallocate()
+{
+  std::cout << "Test reallocation of pooled blocks" << std::endl;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> array;
+  FillArray(array, ARRAY_SIZE);
+
+  array.Allocate(ARRAY_SIZE / 2, vtkm::CopyFlag::On);
+  CheckArray(array, ARRAY_SIZE / 2);
+
+  array.Allocate(ARRAY_SIZE * 2, vtkm::CopyFlag::On);
+  auto portal = array.ReadPortal();
+  for (vtkm::Id index = 0; index < ARRAY_SIZE / 2; ++index)
+  {
+    VTKM_TEST_ASSERT(test_equal(portal.Get(index), TestValue(index, vtkm::FloatDefault{})));
+  }
+}
+
+void TestHighWaterMark()
+{
+  std::cout << "Test high-water mark" << std::endl;
+  vtkm::cont::internal::TrimHostMemoryPool();
+  VTKM_TEST_ASSERT(vtkm::cont::internal::GetHostMemoryPoolStatistics().BytesCached == 0);
+
+  const vtkm::BufferSizeType arrayBytes = ARRAY_SIZE * sizeof(vtkm::FloatDefault);
+  const vtkm::BufferSizeType inUse =
+    vtkm::cont::internal::GetHostMemoryPoolStatistics().BytesInUse;
+  vtkm::cont::internal::SetHostMemoryPoolHighWaterMark(inUse + 3 * arrayBytes);
+
+  {
+    std::vector<vtkm::cont::ArrayHandle<vtkm::FloatDefault>> arrays(4);
+    for (auto& array : arrays)
+    {
+      FillArray(array, ARRAY_SIZE);
+    }
+  }
+
+  auto stats = vtkm::cont::internal::GetHostMemoryPoolStatistics();
+  VTKM_TEST_ASSERT(stats.BytesInUse + stats.BytesCached <= inUse + 3 * arrayBytes);
+  VTKM_TEST_ASSERT(stats.BytesCached > 0);
+  VTKM_TEST_ASSERT(stats.NumberOfReleasedBlocks > 0);
+
+  vtkm::cont::internal::SetHostMemoryPoolHighWaterMark(
+    std::numeric_limits<vtkm::BufferSizeType>::max());
+}
+
+void DoTest()
+{
+  VTKM_TEST_ASSERT(!vtkm::cont::internal::GetHostMemoryPoolEnabled(), "Pool should be opt-in.");
+  vtkm::cont::internal::SetHostMemoryPoolEnabled(true);
+  VTKM_TEST_ASSERT(vtkm::cont::internal::GetHostMemoryPoolEnabled());
+
+  TestReuse();
+  TestReallocate();
+  TestHighWaterMark();
+
+  vtkm::cont::internal::LogHostMemoryPoolStatistics(vtkm::cont::LogLevel::Info);
+
+  vtkm::cont::internal::SetHostMemoryPoolEnabled(false);
+  VTKM_TEST_ASSERT(vtkm::cont::internal::GetHostMemoryPoolStatistics().BytesCached == 0);
+}
+
+} // anonymous namespace
+
+int UnitTestHostMemoryPool(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(DoTest, argc, argv);
+}
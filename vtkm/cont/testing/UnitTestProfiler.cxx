@@ -0,0 +1,123 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/Profiler.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+#include <sstream>
+
+namespace
+{
+
+constexpr vtkm::Id ARRAY_SIZE = 1000;
+
+struct ProfiledSquare : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = _2(_1);
+
+  VTKM_EXEC vtkm::Float64 operator()(vtkm::Float64 value) const { return value * value; }
+};
+
+struct ProfiledIncrement : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldInOut);
+
+  VTKM_EXEC void operator()(vtkm::Float64& value) const { value += 1; }
+};
+
+void TestLaunchRecords()
+{
+  std::cout << "Testing worklet launch records" << std::endl;
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> input;
+  input.Allocate(ARRAY_SIZE);
+  SetPortal(input.WritePortal());
+  vtkm::cont::ArrayHandle<vtkm::Float64> output;
+
+  // Launches are not recorded when profiling is off.
+  invoke(ProfiledSquare{}, input, output);
+  VTKM_TEST_ASSERT(vtkm::cont::GetProfilerLaunches().empty());
+
+  vtkm::cont::SetProfilingEnabled(true);
+  invoke(ProfiledSquare{}, input, output);
+  invoke(ProfiledIncrement{}, output);
+  invoke(ProfiledIncrement{}, output);
+  // Implicit arrays do not hold memory to read.
+  invoke(
+    ProfiledSquare{}, vtkm::cont::ArrayHandleCounting<vtkm::Float64>(0, 1, ARRAY_SIZE), output);
+  vtkm::cont::SetProfilingEnabled(false);
+  invoke(ProfiledSquare{}, input, output);
+
+  constexpr vtkm::BufferSizeType arrayBytes = ARRAY_SIZE * sizeof(vtkm::Float64);
+  std::vector<vtkm::cont::ProfilerLaunchRecord> launches = vtkm::cont::GetProfilerLaunches();
+  VTKM_TEST_ASSERT(launches.size() == 4, "Wrong number of launches: ", launches.size());
+  for (const vtkm::cont::ProfilerLaunchRecord& launch : launches)
+  {
+    VTKM_TEST_ASSERT(launch.DomainSize == ARRAY_SIZE);
+    VTKM_TEST_ASSERT(launch.Device != vtkm::cont::DeviceAdapterTagUndefined{});
+    VTKM_TEST_ASSERT(launch.ElapsedTime >= 0);
+  }
+  VTKM_TEST_ASSERT(launches[0].WorkletName.find("ProfiledSquare") != std::string::npos,
+                   "Bad worklet name ",
+                   launches[0].WorkletName);
+  VTKM_TEST_ASSERT(launches[0].BytesRead == arrayBytes);
+  VTKM_TEST_ASSERT(launches[0].BytesWritten == arrayBytes);
+  VTKM_TEST_ASSERT(launches[1].WorkletName.find("ProfiledIncrement") != std::string::npos);
+  VTKM_TEST_ASSERT(launches[1].BytesRead == arrayBytes);
+  VTKM_TEST_ASSERT(launches[1].BytesWritten == arrayBytes);
+  VTKM_TEST_ASSERT(launches[3].BytesRead == 0);
+  VTKM_TEST_ASSERT(launches[3].BytesWritten == arrayBytes);
+
+  std::vector<vtkm::cont::ProfilerWorkletSummary> summary = vtkm::cont::GetProfilerSummary();
+  VTKM_TEST_ASSERT(summary.size() == 2);
+  for (const vtkm::cont::ProfilerWorkletSummary& worklet : summary)
+  {
+    VTKM_TEST_ASSERT(worklet.NumberOfLaunches == 2);
+    VTKM_TEST_ASSERT(worklet.DomainSize == 2 * ARRAY_SIZE);
+  }
+  vtkm::cont::PrintProfilerSummary(std::cout);
+}
+
+void TestChromeTrace()
+{
+  std::cout << "Testing Chrome trace output" << std::endl;
+  std::stringstream trace;
+  vtkm::cont::WriteProfilerChromeTrace(trace);
+  const std::string json = trace.str();
+  VTKM_TEST_ASSERT(json.find("{\"traceEvents\":[") == 0, "Bad trace header");
+  VTKM_TEST_ASSERT(json.find("\"cat\":\"worklet\"") != std::string::npos);
+  VTKM_TEST_ASSERT(json.find("ProfiledIncrement") != std::string::npos);
+  VTKM_TEST_ASSERT(json.find("\"bytesWritten\":8000") != std::string::npos);
+  VTKM_TEST_ASSERT(json.rfind("}\n") == json.size() - 2, "Bad trace ending");
+
+  vtkm::cont::ResetProfiling();
+  VTKM_TEST_ASSERT(vtkm::cont::GetProfilerLaunches().empty());
+}
+
+void Run()
+{
+  TestLaunchRecords();
+  TestChromeTrace();
+}
+
+} // anonymous namespace
+
+int UnitTestProfiler(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
@@ -0,0 +1,139 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/internal/ScheduleTuner.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+#include <vector>
+
+namespace
+{
+
+constexpr std::uintptr_t KEY1 = 1;
+constexpr std::uintptr_t KEY2 = 2;
+constexpr vtkm::Id NUM_VALUES = 100000;
+
+std::vector<vtkm::cont::internal::ScheduleOption> MakeOptions()
+{
+  std::vector<vtkm::cont::internal::ScheduleOption> options(3);
+  options[0].GrainSize = 64;
+  options[1].GrainSize = 1024;
+  options[2].GrainSize = 1024;
+  options[2].Affinity = true;
+  return options;
+}
+
+vtkm::Float64 LaunchTime(const std::vector<vtkm::Float64>& timePerValue, vtkm::IdComponent option)
+{
+  return timePerValue[static_cast<std::size_t>(option)] * static_cast<vtkm::Float64>(NUM_VALUES);
+}
+
+// Pretends that the launches with the given option take the given time per value.
+void Launch(vtkm::cont::internal::ScheduleTuner& tuner,
+            std::uintptr_t key,
+            const std::vector<vtkm::Float64>& timePerValue,
+            vtkm::IdComponent expectedOption)
+{
+  vtkm::IdComponent option = tuner.Begin(key, NUM_VALUES);
+  VTKM_TEST_ASSERT(option == expectedOption, "Expected option ", expectedOption, " got ", option);
+  if (option >= 0)
+  {
+    tuner.End(key, option, NUM_VALUES, LaunchTime(timePerValue, option));
+  }
+}
+
+void TestDisabled()
+{
+  std::cout << "Testing disabled tuning" << std::endl;
+  vtkm::cont::internal::ScheduleTuner tuner(MakeOptions());
+  VTKM_TEST_ASSERT(!vtkm::cont::internal::GetScheduleTuningEnabled());
+  VTKM_TEST_ASSERT(tuner.Begin(KEY1, NUM_VALUES) < 0);
+
+  vtkm::cont::internal::SetScheduleTuningEnabled(true);
+  VTKM_TEST_ASSERT(tuner.Begin(KEY1, vtkm::cont::internal::GetScheduleTuningMinimumSize() - 1) <
+                   0);
+  vtkm::cont::internal::SetScheduleTuningEnabled(false);
+}
+
+void TestChooseBest()
+{
+  std::cout << "Testing choice of the fastest option" << std::endl;
+  vtkm::cont::internal::SetScheduleTuningEnabled(true);
+  vtkm::cont::internal::ScheduleTuner tuner(MakeOptions());
+
+  // Every option is measured once, in order.
+  std::vector<vtkm::Float64> times{ 3e-9, 1e-9, 2e-9 };
+  Launch(tuner, KEY1, times, 0);
+  VTKM_TEST_ASSERT(tuner.GetBestOption(KEY1) < 0);
+  Launch(tuner, KEY1, times, 1);
+  Launch(tuner, KEY1, times, 2);
+  VTKM_TEST_ASSERT(tuner.GetBestOption(KEY1) == 1);
+
+  // Kernels are tuned independently.
+  Launch(tuner, KEY2, times, 0);
+  VTKM_TEST_ASSERT(tuner.GetBestOption(KEY2) < 0);
+
+  // The best option is used, with the others probed once in a while.
+  vtkm::Id numProbes = 0;
+  for (int launch = 0; launch < 64; ++launch)
+  {
+    vtkm::IdComponent option = tuner.Begin(KEY1, NUM_VALUES);
+    VTKM_TEST_ASSERT(option >= 0);
+    if (option != 1)
+    {
+      ++numProbes;
+    }
+    tuner.End(KEY1, option, NUM_VALUES, LaunchTime(times, option));
+  }
+  VTKM_TEST_ASSERT(numProbes == 4, "Unexpected number of probes ", numProbes);
+  VTKM_TEST_ASSERT(tuner.GetBestOption(KEY1) == 1);
+
+  // When the kernel gets slower with the chosen option, the choice follows.
+  times = { 3e-9, 5e-9, 2e-9 };
+  for (int launch = 0; (launch < 256) && (tuner.GetBestOption(KEY1) != 2); ++launch)
+  {
+    vtkm::IdComponent option = tuner.Begin(KEY1, NUM_VALUES);
+    tuner.End(KEY1, option, NUM_VALUES, LaunchTime(times, option));
+  }
+  VTKM_TEST_ASSERT(tuner.GetBestOption(KEY1) == 2, "Tuner did not adapt");
+
+  tuner.Reset();
+  VTKM_TEST_ASSERT(tuner.GetBestOption(KEY1) < 0);
+  Launch(tuner, KEY1, times, 0);
+  vtkm::cont::internal::SetScheduleTuningEnabled(false);
+}
+
+void TestDefaultOptions()
+{
+  std::cout << "Testing the default options" << std::endl;
+  vtkm::cont::internal::ScheduleTuner tuner;
+  const auto& options = tuner.GetOptions();
+  VTKM_TEST_ASSERT(options.size() == 8, "Unexpected number of default options");
+  for (std::size_t index = 0; index < options.size(); index += 2)
+  {
+    VTKM_TEST_ASSERT(options[index].GrainSize == options[index + 1].GrainSize);
+    VTKM_TEST_ASSERT(!options[index].Affinity && options[index + 1].Affinity);
+  }
+}
+
+void Run()
+{
+  TestDisabled();
+  TestChooseBest();
+  TestDefaultOptions();
+}
+
+} // anonymous namespace
+
+int UnitTestScheduleTuner(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
@@ -0,0 +1,322 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandleBasic.h>
+#include <vtkm/cont/ArrayHandleSOA.h>
+#include <vtkm/cont/ArrayHandleStride.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/SerializationCodec.h>
+
+#include <vtkm/cont/testing/TestingSerialization.h>
+
+#include <cstring>
+#include <random>
+
+namespace
+{
+
+constexpr vtkm::Id ARRAY_SIZE = 10000;
+
+using Codec = vtkm::cont::SerializationCodec;
+const Codec ALL_CODECS[] = { Codec::None, Codec::LZ, Codec::ShuffleLZ, Codec::DeltaShuffleLZ };
+
+// Point ids of the hexahedra of a structured grid, which is what the connectivity of an
+// explicit cell set usually looks like.
+vtkm::cont::ArrayHandle<vtkm::Id> MakeConnectivity()
+{
+  const vtkm::Id3 pointDims(25, 20, 15);
+  std::vector<vtkm::Id> connectivity;
+  for (vtkm::Id k = 0; k < pointDims[2] - 1; ++k)
+  {
+    for (vtkm::Id j = 0; j < pointDims[1] - 1; ++j)
+    {
+      for (vtkm::Id i = 0; i < pointDims[0] - 1; ++i)
+      {
+        const vtkm::Id p = (k * pointDims[1] + j) * pointDims[0] + i;
+        const vtkm::Id slice = pointDims[0] * pointDims[1];
+        for (vtkm::Id offset : { vtkm::Id(0), vtkm::Id(1), pointDims[0] + 1, pointDims[0] })
+        {
+          connectivity.push_back(p + offset);
+        }
+        for (vtkm::Id offset : { vtkm::Id(0), vtkm::Id(1), pointDims[0] + 1, pointDims[0] })
+        {
+          connectivity.push_back(p + slice + offset);
+        }
+      }
+    }
+  }
+  return vtkm::cont::make_ArrayHandle(connectivity, vtkm::CopyFlag::On);
+}
+
+template <typename T>
+vtkm::cont::ArrayHandle<T> MakeArray()
+{
+  vtkm::cont::ArrayHandle<T> array;
+  array.Allocate(ARRAY_SIZE);
+  SetPortal(array.WritePortal());
+  return array;
+}
+
+template <typename ArrayType>
+ArrayType RoundTrip(const ArrayType& array, Codec codec)
+{
+  vtkm::cont::ScopedSerializationCodec scopedCodec(codec);
+  vtkmdiy::MemoryBuffer bb;
+  vtkmdiy::save(bb, array);
+  bb.reset();
+  ArrayType result;
+  vtkmdiy::load(bb, result);
+  return result;
+}
+
+struct TestRoundTripFunctor
+{
+  template <typename T>
+  void operator()(T) const
+  {
+    auto array = MakeArray<T>();
+    for (Codec codec : ALL_CODECS)
+    {
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(RoundTrip(array, codec), array));
+    }
+  }
+};
+
+void TestRoundTrip()
+{
+  std::cout << "Round trip basic arrays" << std::endl;
+  vtkm::testing::Testing::TryTypes(
+    TestRoundTripFunctor{},
+    vtkm::List<vtkm::UInt8, vtkm::Int16, vtkm::Int32, vtkm::Id, vtkm::Float32, vtkm::Vec3f_64,
+               vtkm::Id3>{});
+
+  std::cout << "Round trip empty and tiny arrays" << std::endl;
+  for (Codec codec : ALL_CODECS)
+  {
+    vtkm::cont::ArrayHandle<vtkm::Id> empty;
+    VTKM_TEST_ASSERT(RoundTrip(empty, codec).GetNumberOfValues() == 0);
+    auto tiny = vtkm::cont::make_ArrayHandle<vtkm::Id>({ 5, 5, 5 });
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(RoundTrip(tiny, codec), tiny));
+  }
+
+  std::cout << "Save without a codec like older versions" << std::endl;
+  {
+    vtkm::cont::ScopedSerializationCodec scopedCodec(Codec::None);
+    auto array = MakeArray<vtkm::Id>();
+    vtkmdiy::MemoryBuffer encodedBuffer;
+    vtkmdiy::save(encodedBuffer, array);
+    vtkmdiy::MemoryBuffer rawBuffer;
+    vtkmdiy::save(rawBuffer, array.GetBuffers()[0]);
+    VTKM_TEST_ASSERT(encodedBuffer.buffer == rawBuffer.buffer);
+    VTKM_TEST_ASSERT(encodedBuffer.nblobs() == rawBuffer.nblobs());
+
+    rawBuffer.reset();
+    vtkm::cont::ArrayHandle<vtkm::Id> result;
+    vtkmdiy::load(rawBuffer, result);
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(result, array));
+  }
+
+  std::cout << "Load with another codec setting than the one used to save" << std::endl;
+  {
+    auto connectivity = MakeConnectivity();
+    auto noise = MakeArray<vtkm::Float64>();
+    for (Codec saveCodec : ALL_CODECS)
+    {
+      for (Codec loadCodec : ALL_CODECS)
+      {
+        vtkmdiy::MemoryBuffer bb;
+        {
+          vtkm::cont::ScopedSerializationCodec scopedCodec(saveCodec);
+          vtkmdiy::save(bb, connectivity);
+          vtkmdiy::save(bb, noise);
+          vtkmdiy::save(bb, 42);
+        }
+        bb.reset();
+        vtkm::cont::ScopedSerializationCodec scopedCodec(loadCodec);
+        vtkm::cont::ArrayHandle<vtkm::Id> connectivityResult;
+        vtkm::cont::ArrayHandle<vtkm::Float64> noiseResult;
+        int trailer;
+        vtkmdiy::load(bb, connectivityResult);
+        vtkmdiy::load(bb, noiseResult);
+        vtkmdiy::load(bb, trailer);
+        VTKM_TEST_ASSERT(test_equal_ArrayHandles(connectivityResult, connectivity));
+        VTKM_TEST_ASSERT(test_equal_ArrayHandles(noiseResult, noise));
+        VTKM_TEST_ASSERT(trailer == 42);
+      }
+    }
+  }
+
+  std::cout << "Raw data starting like an encoded buffer" << std::endl;
+  {
+    const std::vector<vtkm::UInt8> bytes = { 0x89, 'V', 'T', 'K', 'm', 'C', 'd', 'c', 'x' };
+    auto marker = vtkm::cont::make_ArrayHandle(bytes, vtkm::CopyFlag::On);
+    // The first value of this array has the bytes of the marker.
+    auto markerIds = MakeArray<vtkm::Id>();
+    vtkm::Id firstId;
+    std::memcpy(&firstId, bytes.data(), sizeof(firstId));
+    markerIds.WritePortal().Set(0, firstId);
+    for (Codec codec : ALL_CODECS)
+    {
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(RoundTrip(marker, codec), marker));
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(RoundTrip(markerIds, codec), markerIds));
+    }
+  }
+
+  std::cout << "Round trip SOA and stride arrays" << std::endl;
+  auto basic = MakeArray<vtkm::Id>();
+  auto soa = vtkm::cont::make_ArrayHandleSOA(basic, MakeArray<vtkm::Id>(), basic);
+  vtkm::cont::ArrayHandleStride<vtkm::Id> stride(basic, ARRAY_SIZE / 2, 2, 1);
+  for (Codec codec : ALL_CODECS)
+  {
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(RoundTrip(soa, codec), soa));
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(RoundTrip(stride, codec), stride));
+  }
+}
+
+void TestCompressionRatio()
+{
+  std::cout << "Compress connectivity" << std::endl;
+  vtkm::cont::ArrayHandle<vtkm::Id> connectivity = MakeConnectivity();
+  const std::size_t numBytes =
+    static_cast<std::size_t>(connectivity.GetNumberOfValues()) * sizeof(vtkm::Id);
+  const auto layout = vtkm::cont::internal::MakeSerializationCodecLayout<vtkm::Id>();
+  vtkm::cont::Token token;
+  const void* data = connectivity.GetBuffers()[0].ReadPointerHost(token);
+  for (Codec codec : { Codec::LZ, Codec::ShuffleLZ, Codec::DeltaShuffleLZ })
+  {
+    Codec used = codec;
+    std::vector<char> encoded = vtkm::cont::internal::EncodeBytes(data, numBytes, used, layout);
+    VTKM_TEST_ASSERT(used == codec);
+    std::cout << "  codec " << static_cast<int>(codec) << ": " << numBytes << " -> "
+              << encoded.size() << " bytes" << std::endl;
+  }
+
+  Codec used = Codec::DeltaShuffleLZ;
+  std::vector<char> encoded = vtkm::cont::internal::EncodeBytes(data, numBytes, used, layout);
+  VTKM_TEST_ASSERT(encoded.size() * 3 < numBytes, "Connectivity did not shrink 3 times");
+
+  std::vector<vtkm::Id> decoded(static_cast<std::size_t>(connectivity.GetNumberOfValues()));
+  vtkm::cont::internal::DecodeBytes(
+    encoded.data(), encoded.size(), used, layout, decoded.data(), numBytes);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(
+    vtkm::cont::make_ArrayHandle(decoded, vtkm::CopyFlag::Off), connectivity));
+
+  std::cout << "Random bytes are saved raw" << std::endl;
+  std::mt19937 generator(42);
+  std::vector<vtkm::UInt32> noise(ARRAY_SIZE);
+  for (auto& value : noise)
+  {
+    value = static_cast<vtkm::UInt32>(generator());
+  }
+  used = Codec::DeltaShuffleLZ;
+  encoded = vtkm::cont::internal::EncodeBytes(
+    noise.data(),
+    noise.size() * sizeof(vtkm::UInt32),
+    used,
+    vtkm::cont::internal::MakeSerializationCodecLayout<vtkm::UInt32>());
+  VTKM_TEST_ASSERT(used == Codec::None);
+  VTKM_TEST_ASSERT(encoded.empty());
+  auto noiseArray = vtkm::cont::make_ArrayHandle(noise, vtkm::CopyFlag::Off);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(RoundTrip(noiseArray, used), noiseArray));
+}
+
+void TestCodecSelection()
+{
+  std::cout << "Select codecs" << std::endl;
+  VTKM_TEST_ASSERT(vtkm::cont::GetSerializationCodec() == Codec::None);
+  vtkm::cont::SetSerializationCodec(Codec::LZ);
+  VTKM_TEST_ASSERT(vtkm::cont::GetSerializationCodec() == Codec::LZ);
+  {
+    vtkm::cont::ScopedSerializationCodec outer(Codec::ShuffleLZ);
+    VTKM_TEST_ASSERT(vtkm::cont::GetSerializationCodec() == Codec::ShuffleLZ);
+    {
+      vtkm::cont::ScopedSerializationCodec inner(Codec::None);
+      VTKM_TEST_ASSERT(vtkm::cont::GetSerializationCodec() == Codec::None);
+    }
+    VTKM_TEST_ASSERT(vtkm::cont::GetSerializationCodec() == Codec::ShuffleLZ);
+  }
+  VTKM_TEST_ASSERT(vtkm::cont::GetSerializationCodec() == Codec::LZ);
+
+  std::cout << "Exchange with the global codec" << std::endl;
+  vtkm::cont::SetSerializationCodec(Codec::DeltaShuffleLZ);
+  vtkm::cont::testing::serialization::TestSerialization(
+    MakeConnectivity(), [](const auto& array1, const auto& array2) {
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(array1, array2));
+    });
+  vtkm::cont::SetSerializationCodec(Codec::None);
+}
+
+void TestMemoryBuffer()
+{
+  std::cout << "Encode memory buffers" << std::endl;
+  std::vector<vtkm::Id> values(ARRAY_SIZE, 7);
+  for (Codec codec : ALL_CODECS)
+  {
+    vtkm::cont::ScopedSerializationCodec scopedCodec(codec);
+    vtkmdiy::MemoryBuffer bb;
+    vtkmdiy::save(bb, 12);
+    vtkmdiy::save(bb, values);
+    const std::size_t numBytes = bb.size();
+    vtkm::cont::internal::EncodeMemoryBuffer(bb);
+    VTKM_TEST_ASSERT(bb.size() <= numBytes + vtkm::cont::internal::MemoryBufferEncodingOverhead);
+    if (codec != Codec::None)
+    {
+      VTKM_TEST_ASSERT(bb.size() < numBytes / 10);
+    }
+    else
+    {
+      // Only the codec is added, after the data.
+      VTKM_TEST_ASSERT(bb.size() == numBytes + 1);
+    }
+
+    vtkm::cont::internal::DecodeMemoryBuffer(bb);
+    VTKM_TEST_ASSERT(bb.size() == numBytes);
+    int header;
+    std::vector<vtkm::Id> result;
+    vtkmdiy::load(bb, header);
+    vtkmdiy::load(bb, result);
+    VTKM_TEST_ASSERT(header == 12);
+    VTKM_TEST_ASSERT(result == values);
+  }
+
+  std::cout << "Corrupt data" << std::endl;
+  vtkm::cont::ScopedSerializationCodec scopedCodec(Codec::LZ);
+  vtkmdiy::MemoryBuffer bb;
+  vtkmdiy::save(bb, values);
+  vtkm::cont::internal::EncodeMemoryBuffer(bb);
+  // Drop the end of the encoded data, but keep the codec stored in the last byte.
+  bb.buffer.erase(bb.buffer.end() - 5, bb.buffer.end() - 1);
+  bool threw = false;
+  try
+  {
+    vtkm::cont::internal::DecodeMemoryBuffer(bb);
+  }
+  catch (vtkm::cont::ErrorBadValue& error)
+  {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    threw = true;
+  }
+  VTKM_TEST_ASSERT(threw, "Truncated buffer was not detected");
+}
+
+void Run()
+{
+  TestRoundTrip();
+  TestCompressionRatio();
+  TestCodecSelection();
+  TestMemoryBuffer();
+}
+
+} // anonymous namespace
+
+int UnitTestSerializationCodec(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
@@ -0,0 +1,370 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_exec_internal_WorkletInvokeBatched_h
+#define vtk_m_exec_internal_WorkletInvokeBatched_h
+
+#include <vtkm/Tuple.h>
+#include <vtkm/internal/ArrayPortalBasic.h>
+#include <vtkm/internal/FunctionInterface.h>
+#include <vtkm/internal/Invocation.h>
+
+#include <vtkm/exec/arg/AspectTagDefault.h>
+#include <vtkm/exec/arg/FetchTagArrayDirectIn.h>
+#include <vtkm/exec/arg/FetchTagArrayDirectInOut.h>
+#include <vtkm/exec/arg/FetchTagArrayDirectOut.h>
+
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleSOA.h>
+
+#include <vtkmstd/integer_sequence.h>
+#include <vtkmstd/void_t.h>
+
+#include <type_traits>
+
+namespace vtkm
+{
+namespace exec
+{
+namespace internal
+{
+namespace detail
+{
+
+// The batch width of a worklet, 1 if it does not define one.
+template <typename WorkletType, typename = void>
+struct BatchedWidth : std::integral_constant<vtkm::IdComponent, 1>
+{
+};
+
+template <typename WorkletType>
+struct BatchedWidth<WorkletType, vtkmstd::void_t<typename WorkletType::BatchLanes>>
+  : std::integral_constant<vtkm::IdComponent, WorkletType::BatchLanes::value>
+{
+};
+
+// Only fields fetched directly from the array are batched.
+template <typename FetchTag>
+struct BatchedFetchTraits
+{
+  static constexpr bool Supported = false;
+};
+
+template <>
+struct BatchedFetchTraits<vtkm::exec::arg::FetchTagArrayDirectIn>
+{
+  static constexpr bool Supported = true;
+  using Loads = std::true_type;
+  using Stores = std::false_type;
+};
+
+template <>
+struct BatchedFetchTraits<vtkm::exec::arg::FetchTagArrayDirectOut>
+{
+  static constexpr bool Supported = true;
+  using Loads = std::false_type;
+  using Stores = std::true_type;
+};
+
+template <>
+struct BatchedFetchTraits<vtkm::exec::arg::FetchTagArrayDirectInOut>
+{
+  static constexpr bool Supported = true;
+  using Loads = std::true_type;
+  using Stores = std::true_type;
+};
+
+// Only portals to contiguous memory are batched.
+template <typename PortalType>
+struct BatchedPortalSupported : std::false_type
+{
+};
+
+template <typename T>
+struct BatchedPortalSupported<vtkm::internal::ArrayPortalBasicRead<T>> : std::true_type
+{
+};
+
+template <typename T>
+struct BatchedPortalSupported<vtkm::internal::ArrayPortalBasicWrite<T>> : std::true_type
+{
+};
+
+template <typename ValueType, typename ComponentPortalType>
+struct BatchedPortalSupported<vtkm::internal::ArrayPortalSOA<ValueType, ComponentPortalType>>
+  : BatchedPortalSupported<ComponentPortalType>
+{
+};
+
+// The output to input and thread to output maps of the default scatter and mask.
+template <typename MapType>
+struct BatchedIdentityMap : std::false_type
+{
+};
+
+template <>
+struct BatchedIdentityMap<vtkm::internal::ArrayPortalImplicit<vtkm::internal::IndexFunctor>>
+  : std::true_type
+{
+};
+
+// A parameter of the ExecutionSignature. Only control parameters with the default aspect are
+// batched. The others (such as WorkIndex or Device) need the thread indices.
+template <typename Invocation, typename ExecutionSignatureTag, typename = void>
+struct BatchedParameter
+{
+  static constexpr bool Supported = false;
+};
+
+template <typename Invocation, typename ExecutionSignatureTag>
+struct BatchedParameter<
+  Invocation,
+  ExecutionSignatureTag,
+  typename std::enable_if<std::is_same<typename ExecutionSignatureTag::AspectTag,
+                                       vtkm::exec::arg::AspectTagDefault>::value &&
+                          (ExecutionSignatureTag::INDEX > 0)>::type>
+{
+  static constexpr vtkm::IdComponent ControlParameterIndex = ExecutionSignatureTag::INDEX;
+  using ControlSignatureTag = typename Invocation::ControlInterface::template ParameterType<
+    ControlParameterIndex>::type;
+  using FetchTag = typename ControlSignatureTag::FetchTag;
+  using PortalType = typename Invocation::ParameterInterface::template ParameterType<
+    ControlParameterIndex>::type;
+  using FetchTraits = BatchedFetchTraits<FetchTag>;
+
+  static constexpr bool Supported =
+    FetchTraits::Supported && BatchedPortalSupported<PortalType>::value;
+
+  VTKM_EXEC static const PortalType& GetPortal(const Invocation& invocation)
+  {
+    return vtkm::internal::ParameterGet<ControlParameterIndex>(invocation.Parameters);
+  }
+};
+
+// The values of a parameter for all the lanes of a batch.
+template <typename Parameter, vtkm::IdComponent Width>
+struct BatchedLanes
+{
+  using PortalType = typename Parameter::PortalType;
+  using ValueType = typename PortalType::ValueType;
+  using FetchTraits = typename Parameter::FetchTraits;
+
+  ValueType Values[Width];
+
+  template <typename Invocation>
+  VTKM_EXEC void Load(const Invocation& invocation, vtkm::Id start)
+  {
+    this->Load(Parameter::GetPortal(invocation), start, typename FetchTraits::Loads{});
+  }
+
+  template <typename Invocation>
+  VTKM_EXEC void Store(const Invocation& invocation, vtkm::Id start) const
+  {
+    StoreLanes(
+      Parameter::GetPortal(invocation), start, this->Values, typename FetchTraits::Stores{});
+  }
+
+  template <typename T>
+  VTKM_EXEC static void StoreLanes(const PortalType& portal,
+                                   vtkm::Id start,
+                                   const T* values,
+                                   std::true_type)
+  {
+    for (vtkm::IdComponent lane = 0; lane < Width; ++lane)
+    {
+      portal.Set(start + lane, static_cast<ValueType>(values[lane]));
+    }
+  }
+
+  template <typename T>
+  VTKM_EXEC static void StoreLanes(const PortalType&, vtkm::Id, const T*, std::false_type)
+  {
+    // Store is a no-op for this fetch.
+  }
+
+private:
+  VTKM_EXEC void Load(const PortalType& portal, vtkm::Id start, std::true_type)
+  {
+    for (vtkm::IdComponent lane = 0; lane < Width; ++lane)
+    {
+      this->Values[lane] = portal.Get(start + lane);
+    }
+  }
+
+  VTKM_EXEC void Load(const PortalType&, vtkm::Id, std::false_type)
+  {
+    // Load is a no-op for this fetch.
+  }
+};
+
+template <bool... Values>
+struct BatchedBoolPack
+{
+};
+
+template <bool... Values>
+using BatchedAll =
+  std::is_same<BatchedBoolPack<true, Values...>, BatchedBoolPack<Values..., true>>;
+
+template <typename Invocation>
+struct BatchedLoadFunctor
+{
+  const Invocation& Inv;
+  vtkm::Id Start;
+
+  template <typename LanesType>
+  VTKM_EXEC void operator()(LanesType& lanes) const
+  {
+    lanes.Load(this->Inv, this->Start);
+  }
+};
+
+template <typename Invocation>
+struct BatchedStoreFunctor
+{
+  const Invocation& Inv;
+  vtkm::Id Start;
+
+  template <typename LanesType>
+  VTKM_EXEC void operator()(const LanesType& lanes) const
+  {
+    lanes.Store(this->Inv, this->Start);
+  }
+};
+
+template <typename WorkletType, typename Invocation, typename Indices>
+struct WorkletInvokeBatchedImpl;
+
+template <typename WorkletType, typename Invocation, std::size_t... Indices>
+struct WorkletInvokeBatchedImpl<WorkletType, Invocation, vtkmstd::index_sequence<Indices...>>
+{
+  static constexpr vtkm::IdComponent Width = BatchedWidth<WorkletType>::value;
+
+  using ExecutionInterface = typename Invocation::ExecutionInterface;
+
+  template <vtkm::IdComponent Index>
+  using Parameter =
+    BatchedParameter<Invocation,
+                     typename ExecutionInterface::template ParameterType<Index>::type>;
+
+  using ReturnTag = typename ExecutionInterface::template ParameterType<0>::type;
+  using ReturnsVoid = typename std::is_void<ReturnTag>::type;
+
+  template <typename Tag, bool IsVoid = std::is_void<Tag>::value>
+  struct ReturnSupported : std::integral_constant<bool, true>
+  {
+  };
+  template <typename Tag>
+  struct ReturnSupported<Tag, false>
+    : std::integral_constant<bool, BatchedParameter<Invocation, Tag>::Supported>
+  {
+  };
+
+  static constexpr bool Enabled = (Width > 1) &&
+    BatchedIdentityMap<typename Invocation::OutputToInputMapType>::value &&
+    BatchedIdentityMap<typename Invocation::ThreadToOutputMapType>::value &&
+    ReturnSupported<ReturnTag>::value &&
+    BatchedAll<Parameter<static_cast<vtkm::IdComponent>(Indices + 1)>::Supported...>::value;
+
+  using LanesType =
+    vtkm::Tuple<BatchedLanes<Parameter<static_cast<vtkm::IdComponent>(Indices + 1)>, Width>...>;
+
+  VTKM_EXEC static void RunBatch(const WorkletType& worklet,
+                                 const Invocation& invocation,
+                                 vtkm::Id start,
+                                 std::true_type)
+  {
+    LanesType lanes;
+    lanes.ForEach(BatchedLoadFunctor<Invocation>{ invocation, start });
+
+    VTKM_VECTORIZATION_PRE_LOOP
+    for (vtkm::IdComponent lane = 0; lane < Width; ++lane)
+    {
+      VTKM_VECTORIZATION_IN_LOOP
+      worklet(vtkm::Get<Indices>(lanes).Values[lane]...);
+    }
+
+    lanes.ForEach(BatchedStoreFunctor<Invocation>{ invocation, start });
+  }
+
+  VTKM_EXEC static void RunBatch(const WorkletType& worklet,
+                                 const Invocation& invocation,
+                                 vtkm::Id start,
+                                 std::false_type)
+  {
+    LanesType lanes;
+    lanes.ForEach(BatchedLoadFunctor<Invocation>{ invocation, start });
+
+    using ReturnLanes = BatchedLanes<BatchedParameter<Invocation, ReturnTag>, Width>;
+    using ReturnType = typename std::decay<decltype(
+      worklet(vtkm::Get<Indices>(lanes).Values[0]...))>::type;
+    ReturnType results[Width];
+
+    VTKM_VECTORIZATION_PRE_LOOP
+    for (vtkm::IdComponent lane = 0; lane < Width; ++lane)
+    {
+      VTKM_VECTORIZATION_IN_LOOP
+      results[lane] = worklet(vtkm::Get<Indices>(lanes).Values[lane]...);
+    }
+
+    lanes.ForEach(BatchedStoreFunctor<Invocation>{ invocation, start });
+    ReturnLanes::StoreLanes(BatchedParameter<Invocation, ReturnTag>::GetPortal(invocation),
+                            start,
+                            results,
+                            typename ReturnLanes::FetchTraits::Stores{});
+  }
+};
+
+} // namespace detail
+
+/// \brief Calls a worklet on batches of consecutive instances.
+///
+/// `WorkletInvokeBatched` is used by the host tiling tasks. When `Enabled` is true, `Run` calls
+/// the worklet on batches of `BatchLanes` consecutive instances (see
+/// `vtkm::worklet::internal::WorkletBase::BatchLanes`). The values of all the lanes of a batch
+/// are loaded from the arrays, the worklet is called on each lane in a loop without
+/// dependencies between iterations, and the results are stored. `Enabled` is true only when
+/// the worklet asks for batches, the invocation has the identity scatter and mask, and every
+/// argument of the `ExecutionSignature` is directly fetched from a basic or SOA array. This
+/// gives the same results as calling the worklet on one instance at a time.
+///
+template <typename WorkletType, typename Invocation>
+struct WorkletInvokeBatched
+  : detail::WorkletInvokeBatchedImpl<
+      WorkletType,
+      Invocation,
+      vtkmstd::make_index_sequence<static_cast<std::size_t>(Invocation::ExecutionInterface::ARITY)>>
+{
+  using Superclass = detail::WorkletInvokeBatchedImpl<
+    WorkletType,
+    Invocation,
+    vtkmstd::make_index_sequence<static_cast<std::size_t>(Invocation::ExecutionInterface::ARITY)>>;
+
+  /// Calls the worklet on as many whole batches as fit in [`start`, `end`). Returns the index
+  /// of the first instance not processed.
+  VTKM_EXEC static vtkm::Id Run(const WorkletType& worklet,
+                                const Invocation& invocation,
+                                vtkm::Id start,
+                                vtkm::Id end)
+  {
+    constexpr vtkm::IdComponent width = Superclass::Width;
+    vtkm::Id index = start;
+    for (; index + width <= end; index += width)
+    {
+      Superclass::RunBatch(worklet, invocation, index, typename Superclass::ReturnsVoid{});
+    }
+    return index;
+  }
+};
+
+}
+}
+} // namespace vtkm::exec::internal
+
+#endif //vtk_m_exec_internal_WorkletInvokeBatched_h
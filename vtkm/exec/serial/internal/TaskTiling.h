@@ -14,8 +14,11 @@
 #include <vtkm/exec/TaskBase.h>
 
 //Todo: rename this header to TaskInvokeWorkletDetail.h
+#include <vtkm/exec/internal/WorkletInvokeBatched.h>
 #include <vtkm/exec/internal/WorkletInvokeFunctorDetail.h>
 
+#include <cstdint>
+
 namespace vtkm
 {
 namespace exec
@@ -35,6 +38,27 @@ VTKM_NEVER_EXPORT void TaskTilingSetErrorBuffer(
   worklet->SetErrorMessageBuffer(buffer);
 }
 
+template <typename WorkletType, typename InvocationType>
+vtkm::Id TaskTiling1DExecuteBatches(const WorkletType& worklet,
+                                    const InvocationType& invocation,
+                                    vtkm::Id start,
+                                    vtkm::Id end,
+                                    std::true_type)
+{
+  return vtkm::exec::internal::WorkletInvokeBatched<WorkletType, InvocationType>::Run(
+    worklet, invocation, start, end);
+}
+
+template <typename WorkletType, typename InvocationType>
+vtkm::Id TaskTiling1DExecuteBatches(const WorkletType&,
+                                    const InvocationType&,
+                                    vtkm::Id start,
+                                    vtkm::Id,
+                                    std::false_type)
+{
+  return start;
+}
+
 template <typename WType, typename IType>
 VTKM_NEVER_EXPORT void TaskTiling1DExecute(void* w, void* const v, vtkm::Id start, vtkm::Id end)
 {
@@ -44,6 +68,13 @@ VTKM_NEVER_EXPORT void TaskTiling1DExecute(void* w, void* const v, vtkm::Id star
   WorkletType const* const worklet = static_cast<WorkletType*>(w);
   InvocationType const* const invocation = static_cast<InvocationType*>(v);
 
+  // Worklets that ask for it are called on batches of consecutive indices. The indices left
+  // over (or all of them when batches are not possible) are done one at a time.
+  using Batched = std::integral_constant<
+    bool,
+    vtkm::exec::internal::WorkletInvokeBatched<WorkletType, InvocationType>::Enabled>;
+  start = TaskTiling1DExecuteBatches(*worklet, *invocation, start, end, Batched{});
+
   for (vtkm::Id index = start; index < end; ++index)
   {
     //Todo: rename this function to DoTaskInvokeWorklet
@@ -198,6 +229,14 @@ public:
     this->ExecuteFunction(this->Worklet, this->Invocation, start, end);
   }
 
+  /// Returns a value identifying the type of worklet and invocation (or functor) run by this
+  /// task. Tasks running the same kind of kernel have the same key. Schedulers use it to tune
+  /// the schedule of each kernel.
+  std::uintptr_t GetTaskKey() const
+  {
+    return reinterpret_cast<std::uintptr_t>(this->ExecuteFunction);
+  }
+
 protected:
   void* Worklet;
   void* Invocation;
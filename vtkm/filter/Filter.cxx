@@ -14,6 +14,7 @@
 #include <vtkm/filter/Filter.h>
 #include <vtkm/filter/TaskQueue.h>
 
+#include <chrono>
 #include <future>
 
 namespace vtkm
@@ -23,21 +24,31 @@ namespace filter
 
 namespace
 {
-void RunFilter(Filter* self, vtkm::filter::DataSetQueue& input, vtkm::filter::DataSetQueue& output)
+using Clock = std::chrono::steady_clock;
+
+void RunFilter(Filter* self,
+               vtkm::filter::DataSetWorkStealingQueue& input,
+               vtkm::filter::DataSetQueue& output,
+               vtkm::Id worker,
+               Clock::duration& busyTime,
+               Clock::time_point& finishTime)
 {
   auto& tracker = vtkm::cont::GetRuntimeDeviceTracker();
   bool prevVal = tracker.GetThreadFriendlyMemAlloc();
   tracker.SetThreadFriendlyMemAlloc(true);
 
   std::pair<vtkm::Id, vtkm::cont::DataSet> task;
-  while (input.GetTask(task))
+  while (input.GetTask(worker, task))
   {
+    auto start = Clock::now();
     auto outDS = self->Execute(task.second);
     output.Push(std::make_pair(task.first, std::move(outDS)));
+    busyTime += Clock::now() - start;
   }
 
   vtkm::cont::Algorithm::Synchronize();
   tracker.SetThreadFriendlyMemAlloc(prevVal);
+  finishTime = Clock::now();
 }
 
 } // anonymous namespace
@@ -96,25 +107,61 @@ vtkm::cont::PartitionedDataSet Filter::DoExecutePartitions(
 
   if (this->GetRunMultiThreadedFilter())
   {
-    vtkm::filter::DataSetQueue inputQueue(input);
+    vtkm::Id numThreads = this->DetermineNumberOfThreads(input);
+
+    vtkm::filter::DataSetWorkStealingQueue inputQueue(input, numThreads);
     vtkm::filter::DataSetQueue outputQueue;
 
-    vtkm::Id numThreads = this->DetermineNumberOfThreads(input);
+    std::vector<Clock::duration> busyTimes(static_cast<std::size_t>(numThreads),
+                                           Clock::duration::zero());
+    std::vector<Clock::time_point> finishTimes(static_cast<std::size_t>(numThreads));
 
     //Run 'numThreads' filters.
+    auto start = Clock::now();
     std::vector<std::future<void>> futures(static_cast<std::size_t>(numThreads));
     for (std::size_t i = 0; i < static_cast<std::size_t>(numThreads); i++)
     {
-      auto f = std::async(
-        std::launch::async, RunFilter, this, std::ref(inputQueue), std::ref(outputQueue));
+      auto f = std::async(std::launch::async,
+                          RunFilter,
+                          this,
+                          std::ref(inputQueue),
+                          std::ref(outputQueue),
+                          static_cast<vtkm::Id>(i),
+                          std::ref(busyTimes[i]),
+                          std::ref(finishTimes[i]));
       futures[i] = std::move(f);
     }
 
     for (auto& f : futures)
       f.get();
+    auto end = Clock::now();
 
     //Get results from the outputQueue.
     output = outputQueue.Get();
+
+    using Seconds = std::chrono::duration<vtkm::Float64>;
+    PartitionSchedulingStatistics stats;
+    stats.NumberOfPartitions = input.GetNumberOfPartitions();
+    stats.NumberOfThreads = numThreads;
+    stats.NumberOfStolenPartitions = inputQueue.GetNumberOfStolenTasks();
+    stats.ElapsedTime = Seconds(end - start).count();
+    for (std::size_t i = 0; i < static_cast<std::size_t>(numThreads); i++)
+    {
+      stats.BusyTime += Seconds(busyTimes[i]).count();
+      stats.IdleTime += Seconds(end - finishTimes[i]).count();
+    }
+    this->SchedulingStatistics = stats;
+
+    VTKM_LOG_F(vtkm::cont::LogLevel::Perf,
+               "Filter '%s' scheduled %lld partitions on %lld threads (%lld stolen): "
+               "elapsed %f s, busy %f s, idle %f s",
+               vtkm::cont::TypeToString(typeid(*this)).c_str(),
+               static_cast<long long>(stats.NumberOfPartitions),
+               static_cast<long long>(stats.NumberOfThreads),
+               static_cast<long long>(stats.NumberOfStolenPartitions),
+               stats.ElapsedTime,
+               stats.BusyTime,
+               stats.IdleTime);
   }
   else
   {
@@ -138,7 +185,7 @@ vtkm::cont::PartitionedDataSet Filter::Execute(const vtkm::cont::PartitionedData
   VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf,
                  "Filter (%d partitions): '%s'",
                  (int)input.GetNumberOfPartitions(),
-                 vtkm::cont::TypeToString<decltype(*this)>().c_str());
+                 vtkm::cont::TypeToString(typeid(*this)).c_str());
 
   return this->DoExecutePartitions(input);
 }
@@ -207,8 +207,12 @@ namespace filter
 /// `Execute(PartitionedDataSet&)` implementation will fallback to a serial for loop execution.
 ///
 /// \subsection FilterThreadScheduling DoExecute
-/// The default multi-threaded execution of `Execute(PartitionedDataSet&)` uses a simple FIFO queue
-/// of DataSet and pool of *worker* threads. Implementation of Filter subclass can override the
+/// The default multi-threaded execution of `Execute(PartitionedDataSet&)` uses a work stealing
+/// queue of DataSet and pool of *worker* threads. The partitions are ordered by their estimated
+/// cost (number of cells times number of fields) and dealt to the workers, largest first. A worker
+/// that runs out of partitions steals from the other workers. The time each worker spends idle is
+/// reported by `GetPartitionSchedulingStatistics()` after the execution.
+/// Implementation of Filter subclass can override the
 /// `DoExecutePartitions(PartitionedDataSet)` virtual method to provide implementation specific
 /// scheduling policy. The default number of *worker* threads in the pool are determined by the
 /// `DetermineNumberOfThreads()` virtual method using several backend dependent heuristic.
@@ -218,6 +222,21 @@ namespace filter
 class VTKM_FILTER_CORE_EXPORT Filter
 {
 public:
+  /// \brief Timing information of the last multi-threaded execution on a PartitionedDataSet.
+  ///
+  /// All times are in seconds. `BusyTime` and `IdleTime` are summed over all worker threads.
+  /// The idle time of a worker is the time between it finishing its last partition and the
+  /// last worker finishing.
+  struct PartitionSchedulingStatistics
+  {
+    vtkm::Id NumberOfPartitions = 0;
+    vtkm::Id NumberOfThreads = 0;
+    vtkm::Id NumberOfStolenPartitions = 0;
+    vtkm::Float64 ElapsedTime = 0.0;
+    vtkm::Float64 BusyTime = 0.0;
+    vtkm::Float64 IdleTime = 0.0;
+  };
+
   VTKM_CONT
   virtual ~Filter();
 
@@ -234,6 +253,14 @@ public:
   VTKM_CONT
   vtkm::Id GetThreadsPerGPU() const { return this->NumThreadsPerGPU; }
 
+  /// Returns the scheduling statistics of the last call to `Execute(PartitionedDataSet&)` that
+  /// ran with multiple threads.
+  VTKM_CONT
+  const PartitionSchedulingStatistics& GetPartitionSchedulingStatistics() const
+  {
+    return this->SchedulingStatistics;
+  }
+
   VTKM_CONT
   bool GetRunMultiThreadedFilter() const
   {
@@ -545,6 +572,7 @@ private:
   bool RunFilterWithMultipleThreads = false;
   vtkm::Id NumThreadsPerCPU = 4;
   vtkm::Id NumThreadsPerGPU = 8;
+  PartitionSchedulingStatistics SchedulingStatistics;
 };
 }
 } // namespace vtkm::filter
@@ -10,7 +10,15 @@
 #ifndef vtk_m_filter_TaskQueue_h
 #define vtk_m_filter_TaskQueue_h
 
+#include <vtkm/Assert.h>
+#include <vtkm/cont/PartitionedDataSet.h>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <vector>
 
 namespace vtkm
 {
@@ -116,6 +124,166 @@ public:
 private:
 };
 
+/// \brief A set of per-worker task queues that idle workers can steal from.
+///
+/// Each worker owns a double ended queue protected by its own lock. A worker takes tasks
+/// from the front of its own queue. When its queue runs dry, it steals from the back of the
+/// other workers' queues. Compared to `TaskQueue`, there is no single lock that every worker
+/// contends on, and the tail of the work can be rebalanced across workers.
+///
+template <typename T>
+class WorkStealingTaskQueue
+{
+public:
+  explicit WorkStealingTaskQueue(vtkm::Id numWorkers)
+  {
+    numWorkers = std::max<vtkm::Id>(numWorkers, 1);
+    this->Workers.reserve(static_cast<std::size_t>(numWorkers));
+    for (vtkm::Id i = 0; i < numWorkers; i++)
+      this->Workers.emplace_back(new WorkerQueue);
+  }
+
+  vtkm::Id GetNumberOfWorkers() const { return static_cast<vtkm::Id>(this->Workers.size()); }
+
+  //Add a task to the back of the queue owned by `worker`.
+  void Push(vtkm::Id worker, T&& item)
+  {
+    auto& queue = this->GetWorkerQueue(worker);
+    std::unique_lock<std::mutex> lock(queue.Lock);
+    queue.Queue.push_back(std::move(item));
+  }
+
+  bool HasTasks()
+  {
+    for (auto& queue : this->Workers)
+    {
+      std::unique_lock<std::mutex> lock(queue->Lock);
+      if (!queue->Queue.empty())
+        return true;
+    }
+    return false;
+  }
+
+  /// Get the next task for `worker`. The worker's own queue is drained first. After that,
+  /// tasks are stolen from the other workers. Returns false when no task is left anywhere.
+  bool GetTask(vtkm::Id worker, T& item)
+  {
+    {
+      auto& queue = this->GetWorkerQueue(worker);
+      std::unique_lock<std::mutex> lock(queue.Lock);
+      if (!queue.Queue.empty())
+      {
+        item = std::move(queue.Queue.front());
+        queue.Queue.pop_front();
+        return true;
+      }
+    }
+
+    vtkm::Id numWorkers = this->GetNumberOfWorkers();
+    for (vtkm::Id offset = 1; offset < numWorkers; offset++)
+    {
+      auto& victim = this->GetWorkerQueue((worker + offset) % numWorkers);
+      std::unique_lock<std::mutex> lock(victim.Lock);
+      if (!victim.Queue.empty())
+      {
+        item = std::move(victim.Queue.back());
+        victim.Queue.pop_back();
+        victim.NumberOfStolenTasks++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Returns the number of tasks that were taken from a queue by a worker that did not own it.
+  vtkm::Id GetNumberOfStolenTasks()
+  {
+    vtkm::Id numStolen = 0;
+    for (auto& queue : this->Workers)
+    {
+      std::unique_lock<std::mutex> lock(queue->Lock);
+      numStolen += queue->NumberOfStolenTasks;
+    }
+    return numStolen;
+  }
+
+protected:
+  vtkm::Id Length()
+  {
+    vtkm::Id length = 0;
+    for (auto& queue : this->Workers)
+    {
+      std::unique_lock<std::mutex> lock(queue->Lock);
+      length += static_cast<vtkm::Id>(queue->Queue.size());
+    }
+    return length;
+  }
+
+private:
+  struct WorkerQueue
+  {
+    std::mutex Lock;
+    std::deque<T> Queue;
+    vtkm::Id NumberOfStolenTasks = 0;
+  };
+
+  WorkerQueue& GetWorkerQueue(vtkm::Id worker)
+  {
+    VTKM_ASSERT((worker >= 0) && (worker < this->GetNumberOfWorkers()));
+    return *this->Workers[static_cast<std::size_t>(worker)];
+  }
+
+  std::vector<std::unique_ptr<WorkerQueue>> Workers;
+
+  //don't want copies of this
+  WorkStealingTaskQueue(const WorkStealingTaskQueue& rhs) = delete;
+  WorkStealingTaskQueue& operator=(const WorkStealingTaskQueue& rhs) = delete;
+  WorkStealingTaskQueue(WorkStealingTaskQueue&& rhs) = delete;
+  WorkStealingTaskQueue& operator=(WorkStealingTaskQueue&& rhs) = delete;
+};
+
+/// \brief Work stealing queue of the partitions of a `PartitionedDataSet`.
+///
+/// The partitions are ordered by an estimated cost (number of cells times number of fields)
+/// and dealt round robin to the workers, most expensive first. Each worker thus starts on the
+/// largest partitions, and the small ones are left at the end where they fill in the gaps
+/// of the workers that finish early.
+///
+class DataSetWorkStealingQueue
+  : public WorkStealingTaskQueue<std::pair<vtkm::Id, vtkm::cont::DataSet>>
+{
+public:
+  DataSetWorkStealingQueue(const vtkm::cont::PartitionedDataSet& input, vtkm::Id numWorkers)
+    : WorkStealingTaskQueue<std::pair<vtkm::Id, vtkm::cont::DataSet>>(numWorkers)
+  {
+    vtkm::Id numPartitions = input.GetNumberOfPartitions();
+    std::vector<std::pair<vtkm::Id, vtkm::Id>> costs;
+    costs.reserve(static_cast<std::size_t>(numPartitions));
+    for (vtkm::Id idx = 0; idx < numPartitions; idx++)
+      costs.emplace_back(EstimateCost(input.GetPartition(idx)), idx);
+
+    // Most expensive first. Ties keep the input order so that the schedule is deterministic.
+    std::stable_sort(costs.begin(), costs.end(), [](const auto& a, const auto& b) {
+      return a.first > b.first;
+    });
+
+    vtkm::Id worker = 0;
+    for (const auto& cost : costs)
+    {
+      this->Push(worker, std::make_pair(cost.second, input.GetPartition(cost.second)));
+      worker = (worker + 1) % this->GetNumberOfWorkers();
+    }
+  }
+
+  /// Estimated relative cost of running a filter on `dataSet`.
+  static vtkm::Id EstimateCost(const vtkm::cont::DataSet& dataSet)
+  {
+    vtkm::Id numElements = std::max(dataSet.GetNumberOfCells(), dataSet.GetNumberOfPoints());
+    vtkm::Id numFields = static_cast<vtkm::Id>(dataSet.GetNumberOfFields());
+    return std::max<vtkm::Id>(numElements, 1) * std::max<vtkm::Id>(numFields, 1);
+  }
+};
+
 }
 }
 
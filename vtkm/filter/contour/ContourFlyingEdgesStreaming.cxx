@@ -0,0 +1,369 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleGroupVec.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
+#include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
+#include <vtkm/cont/CellSetExplicit.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/ErrorFilterExecution.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/MergePartitionedDataSet.h>
+#include <vtkm/cont/PartitionedDataSet.h>
+#include <vtkm/cont/UnknownCellSet.h>
+
+#include <vtkm/filter/MapFieldPermutation.h>
+#include <vtkm/filter/contour/ContourFlyingEdges.h>
+#include <vtkm/filter/contour/ContourFlyingEdgesStreaming.h>
+
+#include <vtkm/BinaryOperators.h>
+#include <vtkm/CellShape.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace
+{
+
+constexpr const char* EdgeKeyFieldName = "__streaming_edge_key__";
+constexpr const char* OwnedCellFieldName = "__streaming_owned_cell__";
+
+// Converts the interpolation edges of a slab contour from slab point ids to volume point ids and
+// computes a key that identifies the point generated on the edge for the isovalue.
+class GlobalEdgeKeys : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn localEdges, FieldOut globalEdges, FieldOut keys);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  VTKM_CONT GlobalEdgeKeys(vtkm::Id pointOffset,
+                           vtkm::Id pointsPerRow,
+                           vtkm::Id numberOfIsoValues,
+                           vtkm::Id isoIndex)
+    : PointOffset(pointOffset)
+    , PointsPerRow(pointsPerRow)
+    , NumberOfIsoValues(numberOfIsoValues)
+    , IsoIndex(isoIndex)
+  {
+  }
+
+  VTKM_EXEC void operator()(const vtkm::Id2& localEdge, vtkm::Id2& globalEdge, vtkm::Id& key) const
+  {
+    globalEdge = localEdge + vtkm::Id2(this->PointOffset);
+    const vtkm::Id first = vtkm::Min(globalEdge[0], globalEdge[1]);
+    const vtkm::Id delta = vtkm::Max(globalEdge[0], globalEdge[1]) - first;
+    const vtkm::Id axis = (delta == 1) ? 0 : ((delta == this->PointsPerRow) ? 1 : 2);
+    key = ((first * 3) + axis) * this->NumberOfIsoValues + this->IsoIndex;
+  }
+
+private:
+  vtkm::Id PointOffset;
+  vtkm::Id PointsPerRow;
+  vtkm::Id NumberOfIsoValues;
+  vtkm::Id IsoIndex;
+};
+
+vtkm::cont::ArrayHandle<vtkm::Id> MakeRange(vtkm::Id start, vtkm::Id count)
+{
+  vtkm::cont::ArrayHandle<vtkm::Id> range;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleCounting(start, vtkm::Id{ 1 }, count), range);
+  return range;
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace filter
+{
+namespace contour
+{
+//-----------------------------------------------------------------------------
+void ContourFlyingEdgesStreaming::SetNumberOfSlicesPerSlab(vtkm::Id numSlices)
+{
+  if (numSlices < 2)
+  {
+    throw vtkm::cont::ErrorBadValue("A slab needs at least 2 slices.");
+  }
+  this->NumberOfSlicesPerSlab = numSlices;
+}
+
+//-----------------------------------------------------------------------------
+void ContourFlyingEdgesStreaming::SetSlabSource(const vtkm::Id3& pointDimensions,
+                                                const SlabSourceType& source)
+{
+  this->SlabSourceDimensions = pointDimensions;
+  this->SlabSource = source;
+}
+
+//-----------------------------------------------------------------------------
+vtkm::cont::DataSet ContourFlyingEdgesStreaming::ExecuteSlabs()
+{
+  if (!this->SlabSource)
+  {
+    throw vtkm::cont::ErrorFilterExecution("No slab source provided.");
+  }
+  return this->StreamSlabs(
+    this->SlabSourceDimensions, this->SlabSource, this->GetActiveCoordinateSystemIndex());
+}
+
+//-----------------------------------------------------------------------------
+vtkm::cont::DataSet ContourFlyingEdgesStreaming::DoExecute(const vtkm::cont::DataSet& inDataSet)
+{
+  if (!inDataSet.GetCellSet().IsType<vtkm::cont::CellSetStructured<3>>())
+  {
+    throw vtkm::cont::ErrorFilterExecution("This filter is only available for 3-Dimensional "
+                                           "Structured Cell Sets");
+  }
+  const vtkm::cont::CoordinateSystem& inCoords =
+    inDataSet.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex());
+  if (!inCoords.GetData().CanConvert<vtkm::cont::ArrayHandleUniformPointCoordinates>())
+  {
+    throw vtkm::cont::ErrorFilterExecution("Streaming contour requires uniform point coordinates.");
+  }
+
+  vtkm::cont::ArrayHandleUniformPointCoordinates uniformCoords =
+    inCoords.GetData().AsArrayHandle<vtkm::cont::ArrayHandleUniformPointCoordinates>();
+  const vtkm::Id3 pointDims = uniformCoords.GetDimensions();
+  const vtkm::Vec3f origin = uniformCoords.GetOrigin();
+  const vtkm::Vec3f spacing = uniformCoords.GetSpacing();
+  const vtkm::Id pointsPerSlice = pointDims[0] * pointDims[1];
+  const vtkm::Id cellsPerSlice = (pointDims[0] - 1) * (pointDims[1] - 1);
+
+  // Cut the slabs out of the input. Only the fields that will be used are copied.
+  auto cutSlab = [&](vtkm::Id firstSlice, vtkm::Id numSlices) {
+    vtkm::cont::DataSet slab;
+    vtkm::cont::CellSetStructured<3> slabCells;
+    slabCells.SetPointDimensions({ pointDims[0], pointDims[1], numSlices });
+    slab.SetCellSet(slabCells);
+
+    vtkm::Vec3f slabOrigin = origin;
+    slabOrigin[2] += static_cast<vtkm::FloatDefault>(firstSlice) * spacing[2];
+    slab.AddCoordinateSystem(vtkm::cont::CoordinateSystem(
+      inCoords.GetName(),
+      vtkm::cont::ArrayHandleUniformPointCoordinates(
+        { pointDims[0], pointDims[1], numSlices }, slabOrigin, spacing)));
+
+    const vtkm::cont::ArrayHandle<vtkm::Id> pointIds =
+      MakeRange(firstSlice * pointsPerSlice, numSlices * pointsPerSlice);
+    const vtkm::cont::ArrayHandle<vtkm::Id> cellIds =
+      MakeRange(firstSlice * cellsPerSlice, (numSlices - 1) * cellsPerSlice);
+    for (vtkm::IdComponent fieldIndex = 0; fieldIndex < inDataSet.GetNumberOfFields(); ++fieldIndex)
+    {
+      const vtkm::cont::Field& field = inDataSet.GetField(fieldIndex);
+      const bool isActiveField = (field.GetName() == this->GetActiveFieldName());
+      if (inDataSet.HasCoordinateSystem(field.GetName()) ||
+          (!isActiveField && !this->GetFieldsToPass().IsFieldSelected(field)))
+      {
+        continue;
+      }
+      if (field.IsPointField())
+      {
+        vtkm::filter::MapFieldPermutation(field, pointIds, slab);
+      }
+      else if (field.IsCellField())
+      {
+        vtkm::filter::MapFieldPermutation(field, cellIds, slab);
+      }
+      else
+      {
+        slab.AddField(field);
+      }
+    }
+    return slab;
+  };
+
+  return this->StreamSlabs(pointDims, cutSlab, 0);
+}
+
+//-----------------------------------------------------------------------------
+vtkm::cont::DataSet ContourFlyingEdgesStreaming::StreamSlabs(
+  const vtkm::Id3& pointDimensions,
+  const SlabSourceType& source,
+  vtkm::IdComponent coordinateSystemIndex)
+{
+  if (this->IsoValues.empty())
+  {
+    throw vtkm::cont::ErrorFilterExecution("No iso-values provided.");
+  }
+  if ((pointDimensions[0] < 2) || (pointDimensions[1] < 2) || (pointDimensions[2] < 2))
+  {
+    throw vtkm::cont::ErrorFilterExecution("Streaming contour requires a 3D volume.");
+  }
+
+  vtkm::filter::contour::ContourFlyingEdges slabContour;
+  slabContour.SetActiveField(this->GetActiveFieldName(), this->GetActiveFieldAssociation());
+  slabContour.SetActiveCoordinateSystem(coordinateSystemIndex);
+  vtkm::filter::FieldSelection fieldsToPass = this->GetFieldsToPass();
+  fieldsToPass.AddField(OwnedCellFieldName,
+                        vtkm::cont::Field::Association::Cells,
+                        vtkm::filter::FieldSelection::Mode::Select);
+  slabContour.SetFieldsToPass(fieldsToPass);
+  slabContour.SetGenerateNormals(this->GenerateNormals && !this->ComputeFastNormals);
+  slabContour.SetNormalArrayName(this->NormalArrayName);
+  slabContour.SetAddInterpolationEdgeIds(true);
+
+  const vtkm::Id numIsoValues = static_cast<vtkm::Id>(this->IsoValues.size());
+  const vtkm::Id pointsPerSlice = pointDimensions[0] * pointDimensions[1];
+  const vtkm::Id cellsPerSlice = (pointDimensions[0] - 1) * (pointDimensions[1] - 1);
+  // Gradients are computed with central differences inside the volume, so a slab needs the
+  // slices next to it to get the same normals as the whole volume.
+  const vtkm::Id ghostSlices = slabContour.GetGenerateNormals() ? 1 : 0;
+  vtkm::cont::Invoker invoke;
+
+  // Consecutive slabs share a slice so that every cell of the volume is in exactly one slab.
+  // Points generated on edges of the shared slice are merged below.
+  vtkm::cont::PartitionedDataSet pieces;
+  vtkm::cont::DataSet emptyPiece;
+  for (vtkm::Id firstSlice = 0; firstSlice < pointDimensions[2] - 1;
+       firstSlice += this->NumberOfSlicesPerSlab - 1)
+  {
+    const vtkm::Id numSlices =
+      vtkm::Min(this->NumberOfSlicesPerSlab, pointDimensions[2] - firstSlice);
+    const vtkm::Id loadedFirstSlice = vtkm::Max(firstSlice - ghostSlices, vtkm::Id{ 0 });
+    const vtkm::Id loadedEndSlice =
+      vtkm::Min(firstSlice + numSlices + ghostSlices, pointDimensions[2]);
+    vtkm::cont::DataSet slab = source(loadedFirstSlice, loadedEndSlice - loadedFirstSlice);
+
+    // Mark the cells of the slab that are not ghost cells.
+    vtkm::cont::ArrayHandle<vtkm::UInt8> ownedCells;
+    ownedCells.AllocateAndFill(slab.GetNumberOfCells(), 0);
+    ownedCells.Fill(1,
+                    (firstSlice - loadedFirstSlice) * cellsPerSlice,
+                    (firstSlice - loadedFirstSlice + numSlices - 1) * cellsPerSlice);
+    slab.AddCellField(OwnedCellFieldName, ownedCells);
+
+    for (vtkm::Id isoIndex = 0; isoIndex < numIsoValues; ++isoIndex)
+    {
+      slabContour.SetIsoValue(this->IsoValues[static_cast<std::size_t>(isoIndex)]);
+      vtkm::cont::DataSet piece = slabContour.Execute(slab);
+      if (piece.GetNumberOfCells() < 1)
+      {
+        emptyPiece = piece;
+        continue;
+      }
+
+      vtkm::cont::ArrayHandle<vtkm::Id2> localEdges;
+      piece.GetField(this->InterpolationEdgeIdsArrayName, vtkm::cont::Field::Association::Points)
+        .GetData()
+        .AsArrayHandle(localEdges);
+      vtkm::cont::ArrayHandle<vtkm::Id2> globalEdges;
+      vtkm::cont::ArrayHandle<vtkm::Id> keys;
+      GlobalEdgeKeys edgeKeys(
+        loadedFirstSlice * pointsPerSlice, pointDimensions[0], numIsoValues, isoIndex);
+      invoke(edgeKeys, localEdges, globalEdges, keys);
+      piece.AddPointField(this->InterpolationEdgeIdsArrayName, globalEdges);
+      piece.AddPointField(EdgeKeyFieldName, keys);
+      pieces.AppendPartition(piece);
+    }
+  }
+
+  vtkm::cont::DataSet merged;
+  vtkm::cont::ArrayHandle<vtkm::Id> keptPointIds;
+  vtkm::cont::ArrayHandle<vtkm::Id> keptCellIds;
+  vtkm::cont::UnknownCellSet outputCells;
+  if (pieces.GetNumberOfPartitions() > 0)
+  {
+    // Stitch the pieces by dropping the triangles of ghost cells and keeping one point per edge
+    // key.
+    merged = vtkm::cont::MergePartitionedDataSet(pieces);
+    pieces = vtkm::cont::PartitionedDataSet{};
+
+    vtkm::cont::ArrayHandle<vtkm::UInt8> ownedCells;
+    merged.GetCellField(OwnedCellFieldName).GetData().AsArrayHandle(ownedCells);
+    vtkm::cont::Algorithm::CopyIf(
+      vtkm::cont::ArrayHandleIndex(ownedCells.GetNumberOfValues()), ownedCells, keptCellIds);
+    ownedCells.ReleaseResources();
+
+    vtkm::cont::CellSetExplicit<> mergedCells;
+    merged.GetCellSet().AsCellSet(mergedCells);
+    vtkm::cont::ArrayHandle<vtkm::Id> keptConnectivity;
+    auto keptTriangles = vtkm::cont::make_ArrayHandleGroupVec<3>(keptConnectivity);
+    vtkm::cont::ArrayCopy(
+      vtkm::cont::make_ArrayHandlePermutation(
+        keptCellIds,
+        vtkm::cont::make_ArrayHandleGroupVec<3>(mergedCells.GetConnectivityArray(
+          vtkm::TopologyElementTagCell{}, vtkm::TopologyElementTagPoint{}))),
+      keptTriangles);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> keys;
+    merged.GetPointField(EdgeKeyFieldName).GetData().AsArrayHandle(keys);
+    vtkm::cont::ArrayHandle<vtkm::Id> connectivityKeys;
+    vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandlePermutation(keptConnectivity, keys),
+                          connectivityKeys);
+    vtkm::cont::ArrayHandle<vtkm::Id> sortedKeys;
+    vtkm::cont::ArrayCopy(connectivityKeys, sortedKeys);
+    vtkm::cont::ArrayHandle<vtkm::Id> sortedPointIds;
+    vtkm::cont::ArrayCopy(keptConnectivity, sortedPointIds);
+    vtkm::cont::Algorithm::SortByKey(sortedKeys, sortedPointIds);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> uniqueKeys;
+    vtkm::cont::Algorithm::ReduceByKey(
+      sortedKeys, sortedPointIds, uniqueKeys, keptPointIds, vtkm::Minimum());
+    sortedKeys.ReleaseResources();
+    sortedPointIds.ReleaseResources();
+
+    vtkm::cont::ArrayHandle<vtkm::Id> connectivity;
+    vtkm::cont::Algorithm::LowerBounds(uniqueKeys, connectivityKeys, connectivity);
+    vtkm::cont::CellSetSingleType<> stitchedCells;
+    stitchedCells.Fill(uniqueKeys.GetNumberOfValues(), vtkm::CELL_SHAPE_TRIANGLE, 3, connectivity);
+    outputCells = stitchedCells;
+  }
+  else
+  {
+    // The contour does not cross the volume.
+    merged = emptyPiece;
+    outputCells = emptyPiece.GetCellSet();
+  }
+
+  vtkm::cont::DataSet output;
+  output.SetCellSet(outputCells);
+  for (vtkm::IdComponent fieldIndex = 0; fieldIndex < merged.GetNumberOfFields(); ++fieldIndex)
+  {
+    const vtkm::cont::Field& field = merged.GetField(fieldIndex);
+    const bool isEdgeIds = (field.GetName() == this->InterpolationEdgeIdsArrayName);
+    if ((field.GetName() == EdgeKeyFieldName) || (field.GetName() == OwnedCellFieldName) ||
+        (isEdgeIds && !this->AddInterpolationEdgeIds))
+    {
+      continue;
+    }
+    if (field.IsPointField())
+    {
+      vtkm::filter::MapFieldPermutation(field, keptPointIds, output);
+    }
+    else if (field.IsCellField())
+    {
+      vtkm::filter::MapFieldPermutation(field, keptCellIds, output);
+    }
+    else
+    {
+      output.AddField(field);
+    }
+  }
+  for (vtkm::IdComponent coordIndex = 0; coordIndex < merged.GetNumberOfCoordinateSystems();
+       ++coordIndex)
+  {
+    output.AddCoordinateSystem(merged.GetCoordinateSystemName(coordIndex));
+  }
+
+  if (this->GenerateNormals && this->ComputeFastNormals)
+  {
+    this->ExecuteGenerateNormals(output, {});
+  }
+
+  return output;
+}
+
+} // namespace contour
+} // namespace filter
+} // namespace vtkm
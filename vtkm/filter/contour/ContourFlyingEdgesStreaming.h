@@ -0,0 +1,83 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_filter_contour_ContourFlyingEdgesStreaming_h
+#define vtk_m_filter_contour_ContourFlyingEdgesStreaming_h
+
+#include <vtkm/filter/contour/AbstractContour.h>
+#include <vtkm/filter/contour/vtkm_filter_contour_export.h>
+
+#include <functional>
+
+namespace vtkm
+{
+namespace filter
+{
+namespace contour
+{
+
+/// \brief Compute the contour of a uniform volume one slab at a time with Flying Edges.
+///
+/// The volume is processed in slabs of consecutive k-slices. Each slab shares one slice with the
+/// next one so that every cell belongs to exactly one slab. Flying Edges is run on each slab, and
+/// the contours of the slabs are stitched together by merging the points that were generated on
+/// the same edge of the volume. When gradient normals are generated, each slab is loaded with one
+/// ghost slice on each side so that the gradients next to the seams are computed with central
+/// differences, and the triangles generated in the ghost cells are dropped. The result is the same
+/// surface as `ContourFlyingEdges` would produce on the whole volume, but only one slab has to be
+/// in memory at a time (along with the output).
+///
+/// The slabs can come from a `SlabSource`, which is a function that returns the point slices
+/// [`firstSlice`, `firstSlice + numberOfSlices`) of the volume as a uniform data set (for example
+/// by calling `vtkm::io::BOVDataSetReader::ReadSlab`). In this case, call `ExecuteSlabs` to
+/// compute the contour. The filter can also be executed on a data set that is already in memory,
+/// in which case the slabs are cut from that data set. This bounds the temporary memory used by
+/// Flying Edges.
+///
+/// Like `ContourFlyingEdges`, this filter only supports `CellSetStructured<3>` with uniform point
+/// coordinates. Point fields are interpolated onto the output and cell fields are passed to the
+/// triangles generated from the cells. Normals computed with the fast path are computed on the
+/// stitched output.
+class VTKM_FILTER_CONTOUR_EXPORT ContourFlyingEdgesStreaming
+  : public vtkm::filter::contour::AbstractContour
+{
+public:
+  using SlabSourceType =
+    std::function<vtkm::cont::DataSet(vtkm::Id firstSlice, vtkm::Id numberOfSlices)>;
+
+  /// Set/Get the number of point slices contoured in each slab. Must be at least 2. Default is 64.
+  /// Two more ghost slices are loaded per slab when gradient normals are generated.
+  VTKM_CONT void SetNumberOfSlicesPerSlab(vtkm::Id numSlices);
+  VTKM_CONT vtkm::Id GetNumberOfSlicesPerSlab() const { return this->NumberOfSlicesPerSlab; }
+
+  /// Set the function providing the slabs of a volume with `pointDimensions` points.
+  VTKM_CONT void SetSlabSource(const vtkm::Id3& pointDimensions, const SlabSourceType& source);
+
+  /// Compute the contour of the volume given by the slab source.
+  VTKM_CONT vtkm::cont::DataSet ExecuteSlabs();
+
+protected:
+  VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
+
+private:
+  VTKM_CONT vtkm::cont::DataSet StreamSlabs(const vtkm::Id3& pointDimensions,
+                                            const SlabSourceType& source,
+                                            vtkm::IdComponent coordinateSystemIndex);
+
+  vtkm::Id NumberOfSlicesPerSlab = 64;
+  vtkm::Id3 SlabSourceDimensions{ 0, 0, 0 };
+  SlabSourceType SlabSource;
+};
+
+} // namespace contour
+} // namespace filter
+} // namespace vtkm
+
+#endif // vtk_m_filter_contour_ContourFlyingEdgesStreaming_h
@@ -8,12 +8,17 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 #include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/DefaultTypes.h>
 #include <vtkm/cont/ErrorFilterExecution.h>
 #include <vtkm/cont/UnknownCellSet.h>
 
 #include <vtkm/filter/contour/ContourMarchingCells.h>
 #include <vtkm/filter/contour/worklet/ContourMarchingCells.h>
+#include <vtkm/filter/contour/worklet/contour/SpanSpace.h>
 
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
 namespace vtkm
 {
@@ -21,6 +26,129 @@ namespace filter
 {
 namespace contour
 {
+//-----------------------------------------------------------------------------
+// The span space indices of the cell sets the filter was executed on. DoExecute may run on
+// several threads at once for the partitions of a PartitionedDataSet. Only the indices used by
+// the last execution are kept so that the meshes and fields of earlier executions are released.
+struct ContourMarchingCells::SpanSpaceCache
+{
+  struct Entry
+  {
+    std::shared_ptr<vtkm::worklet::contour::SpanSpaceIndex> Index;
+    vtkm::UInt64 LastExecution;
+  };
+
+  std::mutex Mutex;
+  std::vector<Entry> Entries;
+  // Counts the executions. All the partitions of a PartitionedDataSet are one execution.
+  vtkm::UInt64 Execution = 0;
+  bool ExecutingPartitions = false;
+
+  // Returns false when called for a partition, which is part of the execution of the
+  // partitioned data set.
+  bool StartExecution(bool partitions)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->ExecutingPartitions)
+    {
+      return false;
+    }
+    ++this->Execution;
+    this->ExecutingPartitions = partitions;
+    return true;
+  }
+
+  // Drops the indices not used since `StartExecution`.
+  void FinishExecution()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Entries.erase(std::remove_if(this->Entries.begin(),
+                                       this->Entries.end(),
+                                       [&](const Entry& entry) {
+                                         return entry.LastExecution != this->Execution;
+                                       }),
+                        this->Entries.end());
+    this->ExecutingPartitions = false;
+  }
+
+  template <typename FieldType>
+  std::shared_ptr<vtkm::worklet::contour::SpanSpaceIndex> Find(
+    const vtkm::cont::UnknownCellSet& cells,
+    const FieldType& field)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    for (auto& entry : this->Entries)
+    {
+      if (entry.Index->IsBuiltFor(cells, field))
+      {
+        entry.LastExecution = this->Execution;
+        return entry.Index;
+      }
+    }
+    return nullptr;
+  }
+
+  void Insert(const vtkm::cont::UnknownCellSet& cells,
+              const std::shared_ptr<vtkm::worklet::contour::SpanSpaceIndex>& index)
+  {
+    // An index built for another field of the same cell set is replaced.
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    for (auto& entry : this->Entries)
+    {
+      if (entry.Index->IsBuiltFor(cells))
+      {
+        entry = Entry{ index, this->Execution };
+        return;
+      }
+    }
+    this->Entries.push_back(Entry{ index, this->Execution });
+  }
+
+  std::size_t GetNumberOfIndices()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return this->Entries.size();
+  }
+};
+
+//-----------------------------------------------------------------------------
+ContourMarchingCells::ContourMarchingCells()
+  : SpanSpaces(std::make_shared<SpanSpaceCache>())
+{
+}
+
+//-----------------------------------------------------------------------------
+void ContourMarchingCells::ResetSpanSpaceIndex()
+{
+  std::lock_guard<std::mutex> lock(this->SpanSpaces->Mutex);
+  this->SpanSpaces->Entries.clear();
+}
+
+//-----------------------------------------------------------------------------
+vtkm::IdComponent ContourMarchingCells::GetNumberOfSpanSpaceIndices() const
+{
+  return static_cast<vtkm::IdComponent>(this->SpanSpaces->GetNumberOfIndices());
+}
+
+//-----------------------------------------------------------------------------
+vtkm::cont::PartitionedDataSet ContourMarchingCells::DoExecutePartitions(
+  const vtkm::cont::PartitionedDataSet& input)
+{
+  this->SpanSpaces->StartExecution(true);
+  vtkm::cont::PartitionedDataSet output;
+  try
+  {
+    output = this->AbstractContour::DoExecutePartitions(input);
+  }
+  catch (...)
+  {
+    this->SpanSpaces->FinishExecution();
+    throw;
+  }
+  this->SpanSpaces->FinishExecution();
+  return output;
+}
+
 //-----------------------------------------------------------------------------
 vtkm::cont::DataSet ContourMarchingCells::DoExecute(const vtkm::cont::DataSet& inDataSet)
 {
@@ -42,6 +170,15 @@ vtkm::cont::DataSet ContourMarchingCells::DoExecute(const vtkm::cont::DataSet& i
   const vtkm::cont::CoordinateSystem& inputCoords =
     inDataSet.GetCoordinateSystem(this->GetActiveCoordinateSystemIndex());
 
+  // The span space index is only used for unstructured cell sets.
+  bool useSpanSpace = false;
+  if (this->UseSpanSpaceIndex)
+  {
+    vtkm::ListForEach(
+      [&](auto cells) { useSpanSpace |= inputCells.CanConvert<decltype(cells)>(); },
+      VTKM_DEFAULT_CELL_SET_LIST_UNSTRUCTURED{});
+  }
+
   using Vec3HandleType = vtkm::cont::ArrayHandle<vtkm::Vec3f>;
   Vec3HandleType vertices;
   Vec3HandleType normals;
@@ -57,7 +194,31 @@ vtkm::cont::DataSet ContourMarchingCells::DoExecute(const vtkm::cont::DataSet& i
       ivalues[i] = static_cast<T>(this->IsoValues[i]);
     }
 
-    if (this->GenerateNormals && !this->GetComputeFastNormals())
+    const bool generateNormals = this->GenerateNormals && !this->GetComputeFastNormals();
+    if (useSpanSpace)
+    {
+      // The index is built outside of the lock so that partitions build their indices in
+      // parallel.
+      auto spanSpace = this->SpanSpaces->Find(inputCells, concrete);
+      if (!spanSpace)
+      {
+        spanSpace = std::make_shared<vtkm::worklet::contour::SpanSpaceIndex>();
+        inputCells.CastAndCallForTypes<VTKM_DEFAULT_CELL_SET_LIST_UNSTRUCTURED>(
+          [&](const auto& cells) { spanSpace->Build(inputCells, cells, concrete); });
+        this->SpanSpaces->Insert(inputCells, spanSpace);
+      }
+      vtkm::cont::ArrayHandle<vtkm::Id> activeCells = spanSpace->GetActiveCells(ivalues);
+      if (generateNormals)
+      {
+        outputCells =
+          worklet.Run(ivalues, inputCells, activeCells, inputCoords, concrete, vertices, normals);
+      }
+      else
+      {
+        outputCells = worklet.Run(ivalues, inputCells, activeCells, inputCoords, concrete, vertices);
+      }
+    }
+    else if (generateNormals)
     {
       outputCells = worklet.Run(ivalues, inputCells, inputCoords, concrete, vertices, normals);
     }
@@ -67,7 +228,12 @@ vtkm::cont::DataSet ContourMarchingCells::DoExecute(const vtkm::cont::DataSet& i
     }
   };
 
+  const bool ownExecution = this->SpanSpaces->StartExecution(false);
   this->CastAndCallScalarField(this->GetFieldFromDataSet(inDataSet), resolveFieldType);
+  if (ownExecution)
+  {
+    this->SpanSpaces->FinishExecution();
+  }
 
   auto mapper = [&](auto& result, const auto& f) { this->DoMapField(result, f, worklet); };
   vtkm::cont::DataSet output = this->CreateResultCoordinateSystem(
@@ -14,6 +14,8 @@
 #include <vtkm/filter/contour/AbstractContour.h>
 #include <vtkm/filter/contour/vtkm_filter_contour_export.h>
 
+#include <memory>
+
 namespace vtkm
 {
 namespace filter
@@ -32,9 +34,43 @@ namespace contour
 class VTKM_FILTER_CONTOUR_EXPORT ContourMarchingCells
   : public vtkm::filter::contour::AbstractContour
 {
+public:
+  VTKM_CONT ContourMarchingCells();
+
+  /// \brief Set/Get whether to index the cells by the range of the field they contain.
+  ///
+  /// When on, a span space index of the cells of an unstructured mesh is built the first time
+  /// the filter is executed on a field, and kept by the filter. Following executions on the same
+  /// cell set and field array (with any isovalues) only visit the cells crossing the isovalues,
+  /// so their cost depends on the size of the contour instead of the size of the mesh. This
+  /// pays off when the same mesh is contoured many times. One index is kept per cell set, so
+  /// each partition of a `PartitionedDataSet` keeps its own index, and partitions executed
+  /// on several threads share the cache safely. The index of a cell set is rebuilt when the
+  /// field array changes or its values are modified. The indices hold on to the cell sets and
+  /// field arrays, so only the indices used by the last execution (all the partitions of a
+  /// `PartitionedDataSet` counting as one execution) are kept. Off by default. Structured cell
+  /// sets are not indexed.
+  VTKM_CONT void SetUseSpanSpaceIndex(bool on) { this->UseSpanSpaceIndex = on; }
+  VTKM_CONT bool GetUseSpanSpaceIndex() const { return this->UseSpanSpaceIndex; }
+
+  /// Discard the span space indices so that they are rebuilt on the next execution.
+  VTKM_CONT void ResetSpanSpaceIndex();
+
+  /// Returns the number of span space indices kept by the filter.
+  VTKM_CONT vtkm::IdComponent GetNumberOfSpanSpaceIndices() const;
+
 protected:
   VTKM_CONT
   vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& result) override;
+
+  VTKM_CONT vtkm::cont::PartitionedDataSet DoExecutePartitions(
+    const vtkm::cont::PartitionedDataSet& inData) override;
+
+private:
+  struct SpanSpaceCache;
+
+  bool UseSpanSpaceIndex = false;
+  std::shared_ptr<SpanSpaceCache> SpanSpaces;
 };
 } // namespace contour
 } // namespace filter
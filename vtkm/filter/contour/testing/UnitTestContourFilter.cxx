@@ -10,6 +10,7 @@
 
 #include <vtkm/Math.h>
 #include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/DataSet.h>
 #include <vtkm/cont/ErrorFilterExecution.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
@@ -17,11 +18,17 @@
 
 #include <vtkm/filter/contour/Contour.h>
 #include <vtkm/filter/contour/ContourFlyingEdges.h>
+#include <vtkm/filter/contour/ContourFlyingEdgesStreaming.h>
 #include <vtkm/filter/contour/ContourMarchingCells.h>
 #include <vtkm/filter/field_transform/GenerateIds.h>
 
+#include <vtkm/io/BOVDataSetReader.h>
 #include <vtkm/io/VTKDataSetReader.h>
 #include <vtkm/source/Tangle.h>
+#include <vtkm/worklet/CellDeepCopy.h>
+
+#include <cstdio>
+#include <fstream>
 
 namespace
 {
@@ -193,6 +200,381 @@ public:
     }
   }
 
+  void TestMultipleIsoValuesFlyingEdges() const
+  {
+    std::cout << "Testing Flying Edges with multiple isovalues" << std::endl;
+
+    vtkm::source::Tangle tangle;
+    tangle.SetCellDimensions({ 20, 24, 16 });
+    vtkm::cont::DataSet dataSet = tangle.Execute();
+
+    // Include isovalues outside of the field range, repeated ones and decreasing ones to
+    // exercise the rows that switch between entirely below and entirely above.
+    const std::vector<vtkm::Float64> isoValues = { 0.8, -100.0, 0.2, 100.0, 0.2, -0.5, 1.5 };
+
+    vtkm::filter::contour::ContourFlyingEdges filter;
+    filter.SetActiveField("tangle");
+    filter.SetGenerateNormals(true);
+    filter.SetIsoValues(isoValues);
+    vtkm::cont::DataSet result = filter.Execute(dataSet);
+
+    vtkm::Id expectedPoints = 0;
+    vtkm::Id expectedCells = 0;
+    vtkm::cont::ArrayHandle<vtkm::Vec3f> expectedCoords;
+    for (vtkm::Float64 isoValue : isoValues)
+    {
+      filter.SetIsoValues({ isoValue });
+      vtkm::cont::DataSet single = filter.Execute(dataSet);
+      expectedPoints += single.GetNumberOfPoints();
+      expectedCells += single.GetNumberOfCells();
+
+      vtkm::cont::ArrayHandle<vtkm::Vec3f> singleCoords;
+      single.GetCoordinateSystem().GetData().AsArrayHandle(singleCoords);
+      vtkm::Id offset = expectedCoords.GetNumberOfValues();
+      expectedCoords.Allocate(offset + singleCoords.GetNumberOfValues(), vtkm::CopyFlag::On);
+      vtkm::cont::Algorithm::CopySubRange(
+        singleCoords, 0, singleCoords.GetNumberOfValues(), expectedCoords, offset);
+    }
+
+    VTKM_TEST_ASSERT(result.GetNumberOfPoints() == expectedPoints,
+                     "Wrong number of points for multiple isovalues");
+    VTKM_TEST_ASSERT(result.GetNumberOfCells() == expectedCells,
+                     "Wrong number of cells for multiple isovalues");
+    vtkm::cont::ArrayHandle<vtkm::Vec3f> resultCoords;
+    result.GetCoordinateSystem().GetData().AsArrayHandle(resultCoords);
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(resultCoords, expectedCoords),
+                     "Wrong points for multiple isovalues");
+  }
+
+  void TestStreamingFlyingEdges() const
+  {
+    std::cout << "Testing streaming Flying Edges against the in-core filter" << std::endl;
+
+    vtkm::source::Tangle tangle;
+    tangle.SetCellDimensions({ 24, 20, 30 });
+    vtkm::filter::field_transform::GenerateIds genIds;
+    genIds.SetUseFloat(true);
+    genIds.SetGeneratePointIds(false);
+    genIds.SetCellFieldName("cellvar");
+    vtkm::cont::DataSet dataSet = genIds.Execute(tangle.Execute());
+
+    vtkm::filter::contour::ContourFlyingEdges inCore;
+    inCore.SetIsoValues({ 0.2, 0.8 });
+    inCore.SetActiveField("tangle");
+    inCore.SetGenerateNormals(false);
+    vtkm::cont::DataSet expected = inCore.Execute(dataSet);
+
+    auto checkResult = [&](const vtkm::cont::DataSet& result) {
+      VTKM_TEST_ASSERT(result.GetNumberOfPoints() == expected.GetNumberOfPoints(),
+                       "Wrong number of points in streamed contour");
+      VTKM_TEST_ASSERT(result.GetNumberOfCells() == expected.GetNumberOfCells(),
+                       "Wrong number of cells in streamed contour");
+      VTKM_TEST_ASSERT(test_equal(result.GetCoordinateSystem().GetBounds(),
+                                  expected.GetCoordinateSystem().GetBounds()),
+                       "Wrong bounds for streamed contour");
+
+      vtkm::cont::ArrayHandle<vtkm::FloatDefault> resultCellIds;
+      result.GetCellField("cellvar").GetData().AsArrayHandle(resultCellIds);
+      vtkm::cont::ArrayHandle<vtkm::FloatDefault> expectedCellIds;
+      expected.GetCellField("cellvar").GetData().AsArrayHandle(expectedCellIds);
+      vtkm::cont::Algorithm::Sort(resultCellIds);
+      vtkm::cont::Algorithm::Sort(expectedCellIds);
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(resultCellIds, expectedCellIds),
+                       "Wrong cells in streamed contour");
+    };
+
+    vtkm::filter::contour::ContourFlyingEdgesStreaming streaming;
+    streaming.SetIsoValues({ 0.2, 0.8 });
+    streaming.SetActiveField("tangle");
+    streaming.SetGenerateNormals(false);
+    streaming.SetNumberOfSlicesPerSlab(4);
+    checkResult(streaming.Execute(dataSet));
+
+    // Stream the volume from a BOV file one slab at a time.
+    vtkm::cont::ArrayHandleBasic<vtkm::Float32> tangleValues;
+    dataSet.GetPointField("tangle").GetData().AsArrayHandle(tangleValues);
+    {
+      std::ofstream rawFile("UnitTestStreamingFlyingEdges.raw", std::ios::binary);
+      rawFile.write(reinterpret_cast<const char*>(tangleValues.GetReadPointer()),
+                    static_cast<std::streamsize>(tangleValues.GetNumberOfValues() *
+                                                 static_cast<vtkm::Id>(sizeof(vtkm::Float32))));
+      std::ofstream headerFile("UnitTestStreamingFlyingEdges.bov");
+      headerFile << "DATA_FILE: UnitTestStreamingFlyingEdges.raw\n"
+                 << "DATA_SIZE: 25 21 31\n"
+                 << "DATA_FORMAT: FLOAT\n"
+                 << "VARIABLE: tangle\n"
+                 << "BRICK_ORIGIN: 0 0 0\n"
+                 << "BRICK_SIZE: 1 1 1\n";
+    }
+
+    vtkm::io::BOVDataSetReader reader("UnitTestStreamingFlyingEdges.bov");
+    VTKM_TEST_ASSERT(reader.GetPointDimensions() == vtkm::Id3(25, 21, 31), "Wrong BOV dimensions");
+    vtkm::Id numSlabs = 0;
+    streaming.SetNumberOfSlicesPerSlab(7);
+    streaming.SetSlabSource(reader.GetPointDimensions(),
+                            [&](vtkm::Id firstSlice, vtkm::Id numSlices) {
+                              ++numSlabs;
+                              return reader.ReadSlab(firstSlice, numSlices);
+                            });
+    vtkm::cont::DataSet streamed = streaming.ExecuteSlabs();
+    VTKM_TEST_ASSERT(numSlabs == 5, "Wrong number of slabs read");
+    VTKM_TEST_ASSERT(streamed.GetNumberOfPoints() == expected.GetNumberOfPoints(),
+                     "Wrong number of points in contour streamed from file");
+    VTKM_TEST_ASSERT(streamed.GetNumberOfCells() == expected.GetNumberOfCells(),
+                     "Wrong number of cells in contour streamed from file");
+    VTKM_TEST_ASSERT(test_equal(streamed.GetCoordinateSystem().GetBounds(),
+                                expected.GetCoordinateSystem().GetBounds()),
+                     "Wrong bounds for contour streamed from file");
+
+    std::remove("UnitTestStreamingFlyingEdges.raw");
+    std::remove("UnitTestStreamingFlyingEdges.bov");
+  }
+
+  void TestStreamingFlyingEdgesNormals() const
+  {
+    std::cout << "Testing normals of streaming Flying Edges against the in-core filter"
+              << std::endl;
+
+    vtkm::source::Tangle tangle;
+    tangle.SetCellDimensions({ 24, 20, 30 });
+    vtkm::filter::field_transform::GenerateIds genIds;
+    genIds.SetUseFloat(true);
+    genIds.SetGeneratePointIds(false);
+    genIds.SetCellFieldName("cellvar");
+    vtkm::cont::DataSet dataSet = genIds.Execute(tangle.Execute());
+
+    // Sort the normals by the edge they were generated on so that both outputs can be compared.
+    auto sortedNormals = [](const vtkm::cont::DataSet& result) {
+      vtkm::cont::ArrayHandle<vtkm::Id2> edges;
+      result.GetPointField("edgeIds").GetData().AsArrayHandle(edges);
+      vtkm::cont::ArrayHandle<vtkm::Vec3f> normals;
+      vtkm::cont::ArrayCopy(result.GetPointField("normals").GetData(), normals);
+      vtkm::cont::ArrayHandle<vtkm::Id> edgeKeys;
+      edgeKeys.Allocate(edges.GetNumberOfValues());
+      auto edgePortal = edges.ReadPortal();
+      auto keyPortal = edgeKeys.WritePortal();
+      for (vtkm::Id index = 0; index < edges.GetNumberOfValues(); ++index)
+      {
+        const vtkm::Id2 edge = edgePortal.Get(index);
+        const vtkm::Id numPoints = 25 * 21 * 31;
+        keyPortal.Set(index, vtkm::Min(edge[0], edge[1]) * numPoints + vtkm::Max(edge[0], edge[1]));
+      }
+      vtkm::cont::Algorithm::SortByKey(edgeKeys, normals);
+      return normals;
+    };
+
+    vtkm::filter::contour::ContourFlyingEdges inCore;
+    inCore.SetIsoValue(0.2);
+    inCore.SetActiveField("tangle");
+    inCore.SetGenerateNormals(true);
+    inCore.SetAddInterpolationEdgeIds(true);
+    vtkm::cont::DataSet expected = inCore.Execute(dataSet);
+
+    vtkm::filter::contour::ContourFlyingEdgesStreaming streaming;
+    streaming.SetIsoValue(0.2);
+    streaming.SetActiveField("tangle");
+    streaming.SetGenerateNormals(true);
+    streaming.SetAddInterpolationEdgeIds(true);
+    streaming.SetNumberOfSlicesPerSlab(4);
+    vtkm::cont::DataSet result = streaming.Execute(dataSet);
+
+    VTKM_TEST_ASSERT(result.GetNumberOfPoints() == expected.GetNumberOfPoints(),
+                     "Wrong number of points in streamed contour with normals");
+    VTKM_TEST_ASSERT(result.GetNumberOfCells() == expected.GetNumberOfCells(),
+                     "Wrong number of cells in streamed contour with normals");
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(sortedNormals(result), sortedNormals(expected)),
+                     "Streamed normals differ from the in-core normals");
+
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> resultCellIds;
+    result.GetCellField("cellvar").GetData().AsArrayHandle(resultCellIds);
+    vtkm::cont::ArrayHandle<vtkm::FloatDefault> expectedCellIds;
+    expected.GetCellField("cellvar").GetData().AsArrayHandle(expectedCellIds);
+    vtkm::cont::Algorithm::Sort(resultCellIds);
+    vtkm::cont::Algorithm::Sort(expectedCellIds);
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(resultCellIds, expectedCellIds),
+                     "Wrong cells in streamed contour with normals");
+  }
+
+  void TestSpanSpaceIndexMarchingCells() const
+  {
+    std::cout << "Testing marching cells with a span space index" << std::endl;
+    vtkm::source::Tangle tangle;
+    tangle.SetCellDimensions({ 16, 16, 16 });
+    vtkm::cont::DataSet dataSet = tangle.Execute();
+    vtkm::filter::field_transform::GenerateIds genIds;
+    genIds.SetUseFloat(true);
+    genIds.SetGeneratePointIds(false);
+    genIds.SetCellFieldName("cellvar");
+    dataSet = genIds.Execute(dataSet);
+    // The index is only used with unstructured cell sets.
+    dataSet.SetCellSet(vtkm::worklet::CellDeepCopy::Run(
+      dataSet.GetCellSet().AsCellSet<vtkm::cont::CellSetStructured<3>>()));
+
+    vtkm::filter::contour::ContourMarchingCells indexed;
+    indexed.SetUseSpanSpaceIndex(true);
+    indexed.SetMergeDuplicatePoints(true);
+    indexed.SetGenerateNormals(true);
+    indexed.SetActiveField("tangle");
+    indexed.SetFieldsToPass({ "tangle", "cellvar" });
+
+    vtkm::filter::contour::ContourMarchingCells reference;
+    reference.SetMergeDuplicatePoints(true);
+    reference.SetGenerateNormals(true);
+    reference.SetActiveField("tangle");
+    reference.SetFieldsToPass({ "tangle", "cellvar" });
+
+    // The index built on the first execution is reused by the following ones.
+    const std::vector<std::vector<vtkm::Float64>> isoValueSets = {
+      { 0.2 }, { 0.5 }, { -0.4, 0.1, 1.1 }, { 100.0 }, { 0.9, 0.2 }
+    };
+    for (const auto& isoValues : isoValueSets)
+    {
+      indexed.SetIsoValues(isoValues);
+      reference.SetIsoValues(isoValues);
+      vtkm::cont::DataSet result = indexed.Execute(dataSet);
+      vtkm::cont::DataSet expected = reference.Execute(dataSet);
+
+      VTKM_TEST_ASSERT(result.GetNumberOfPoints() == expected.GetNumberOfPoints(),
+                       "Wrong number of points with span space index");
+      VTKM_TEST_ASSERT(result.GetNumberOfCells() == expected.GetNumberOfCells(),
+                       "Wrong number of cells with span space index");
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(result.GetCoordinateSystem().GetData(),
+                                               expected.GetCoordinateSystem().GetData()),
+                       "Wrong coordinates with span space index");
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(result.GetField("normals").GetData(),
+                                               expected.GetField("normals").GetData()),
+                       "Wrong normals with span space index");
+      VTKM_TEST_ASSERT(test_equal_ArrayHandles(result.GetField("cellvar").GetData(),
+                                               expected.GetField("cellvar").GetData()),
+                       "Wrong cell field with span space index");
+    }
+
+    // Contouring another field rebuilds the index.
+    genIds.SetGeneratePointIds(true);
+    genIds.SetGenerateCellIds(false);
+    genIds.SetPointFieldName("pointvar");
+    dataSet = genIds.Execute(dataSet);
+    indexed.SetActiveField("pointvar");
+    reference.SetActiveField("pointvar");
+    indexed.SetIsoValues({ 2000.5 });
+    reference.SetIsoValues({ 2000.5 });
+    vtkm::cont::DataSet result = indexed.Execute(dataSet);
+    vtkm::cont::DataSet expected = reference.Execute(dataSet);
+    VTKM_TEST_ASSERT(result.GetNumberOfCells() > 0, "Empty contour of point ids");
+    VTKM_TEST_ASSERT(result.GetNumberOfCells() == expected.GetNumberOfCells(),
+                     "Wrong number of cells after rebuilding span space index");
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(result.GetCoordinateSystem().GetData(),
+                                             expected.GetCoordinateSystem().GetData()),
+                     "Wrong coordinates after rebuilding span space index");
+  }
+
+  void TestSpanSpaceIndexPartitions() const
+  {
+    std::cout << "Testing marching cells with a span space index on partitions" << std::endl;
+    // Each partition has its own cell set, so each one gets its own index.
+    vtkm::cont::PartitionedDataSet input;
+    for (vtkm::Id size : { 8, 10, 12, 14 })
+    {
+      vtkm::source::Tangle tangle;
+      tangle.SetCellDimensions({ size, size, size });
+      vtkm::cont::DataSet dataSet = tangle.Execute();
+      dataSet.SetCellSet(vtkm::worklet::CellDeepCopy::Run(
+        dataSet.GetCellSet().AsCellSet<vtkm::cont::CellSetStructured<3>>()));
+      input.AppendPartition(dataSet);
+    }
+
+    vtkm::filter::contour::ContourMarchingCells indexed;
+    indexed.SetUseSpanSpaceIndex(true);
+    indexed.SetMergeDuplicatePoints(true);
+    indexed.SetActiveField("tangle");
+    indexed.SetRunMultiThreadedFilter(true);
+    indexed.SetThreadsPerCPU(4);
+
+    vtkm::filter::contour::ContourMarchingCells reference;
+    reference.SetMergeDuplicatePoints(true);
+    reference.SetActiveField("tangle");
+
+    const std::vector<std::vector<vtkm::Float64>> isoValueSets = {
+      { 0.2 }, { 0.5 }, { -0.4, 0.1, 1.1 }, { 0.9, 0.2 }
+    };
+    for (const auto& isoValues : isoValueSets)
+    {
+      indexed.SetIsoValues(isoValues);
+      reference.SetIsoValues(isoValues);
+      vtkm::cont::PartitionedDataSet result = indexed.Execute(input);
+      VTKM_TEST_ASSERT(result.GetNumberOfPartitions() == input.GetNumberOfPartitions(),
+                       "Wrong number of partitions with span space index");
+      VTKM_TEST_ASSERT(indexed.GetNumberOfSpanSpaceIndices() == input.GetNumberOfPartitions(),
+                       "Wrong number of span space indices for partitions");
+      for (vtkm::Id p = 0; p < input.GetNumberOfPartitions(); ++p)
+      {
+        vtkm::cont::DataSet expected = reference.Execute(input.GetPartition(p));
+        const vtkm::cont::DataSet& partition = result.GetPartition(p);
+        VTKM_TEST_ASSERT(partition.GetNumberOfCells() == expected.GetNumberOfCells(),
+                         "Wrong number of cells in partition with span space index");
+        VTKM_TEST_ASSERT(test_equal_ArrayHandles(partition.GetCoordinateSystem().GetData(),
+                                                 expected.GetCoordinateSystem().GetData()),
+                         "Wrong coordinates in partition with span space index");
+      }
+    }
+
+    // Modifying the field in place rebuilds the index of that partition.
+    vtkm::cont::DataSet first = input.GetPartition(0);
+    vtkm::cont::ArrayHandle<vtkm::Float32> values;
+    first.GetField("tangle").GetData().AsArrayHandle(values);
+    {
+      auto portal = values.WritePortal();
+      for (vtkm::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+      {
+        portal.Set(i, -portal.Get(i));
+      }
+    }
+    indexed.SetIsoValues({ -0.2 });
+    reference.SetIsoValues({ -0.2 });
+    vtkm::cont::PartitionedDataSet result = indexed.Execute(input);
+    vtkm::cont::DataSet expected = reference.Execute(first);
+    VTKM_TEST_ASSERT(expected.GetNumberOfCells() > 0, "Empty contour of modified field");
+    VTKM_TEST_ASSERT(result.GetPartition(0).GetNumberOfCells() == expected.GetNumberOfCells(),
+                     "Span space index not rebuilt after modifying the field");
+  }
+
+  void TestSpanSpaceIndexBounded() const
+  {
+    std::cout << "Testing that span space indices of old data sets are dropped" << std::endl;
+    vtkm::filter::contour::ContourMarchingCells indexed;
+    indexed.SetUseSpanSpaceIndex(true);
+    indexed.SetActiveField("tangle");
+    indexed.SetIsoValues({ 0.2 });
+
+    // Like the steps of a time series, every data set has its own cell set.
+    vtkm::cont::PartitionedDataSet partitions;
+    for (vtkm::Id size : { 8, 10, 12, 14, 16 })
+    {
+      vtkm::source::Tangle tangle;
+      tangle.SetCellDimensions({ size, size, size });
+      vtkm::cont::DataSet dataSet = tangle.Execute();
+      dataSet.SetCellSet(vtkm::worklet::CellDeepCopy::Run(
+        dataSet.GetCellSet().AsCellSet<vtkm::cont::CellSetStructured<3>>()));
+      partitions.AppendPartition(dataSet);
+
+      vtkm::cont::DataSet result = indexed.Execute(dataSet);
+      VTKM_TEST_ASSERT(result.GetNumberOfCells() > 0, "Empty contour with span space index");
+      VTKM_TEST_ASSERT(indexed.GetNumberOfSpanSpaceIndices() == 1,
+                       "Span space indices of previous data sets kept");
+    }
+
+    indexed.Execute(partitions);
+    VTKM_TEST_ASSERT(indexed.GetNumberOfSpanSpaceIndices() == partitions.GetNumberOfPartitions(),
+                     "Wrong number of span space indices for partitions");
+
+    indexed.Execute(partitions.GetPartition(0));
+    VTKM_TEST_ASSERT(indexed.GetNumberOfSpanSpaceIndices() == 1,
+                     "Span space indices of previous partitions kept");
+
+    indexed.ResetSpanSpaceIndex();
+    VTKM_TEST_ASSERT(indexed.GetNumberOfSpanSpaceIndices() == 0, "Span space indices not reset");
+  }
+
   template <typename ContourFilterType>
   void TestNonUniformStructured() const
   {
@@ -265,6 +647,16 @@ public:
     this->TestNonUniformStructured<vtkm::filter::contour::ContourMarchingCells>();
 
     this->TestUnsupportedFlyingEdges();
+    this->TestMultipleIsoValuesFlyingEdges();
+
+    this->TestContourUniformGrid<vtkm::filter::contour::ContourFlyingEdgesStreaming>(72);
+    this->Test3DUniformDataSet0<vtkm::filter::contour::ContourFlyingEdgesStreaming>();
+    this->TestStreamingFlyingEdges();
+    this->TestStreamingFlyingEdgesNormals();
+
+    this->TestSpanSpaceIndexMarchingCells();
+    this->TestSpanSpaceIndexPartitions();
+    this->TestSpanSpaceIndexBounded();
   }
 
 }; // class TestContourFilter
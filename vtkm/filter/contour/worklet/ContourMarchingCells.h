@@ -16,7 +16,10 @@
 #include <vtkm/filter/contour/worklet/contour/FieldPropagation.h>
 #include <vtkm/filter/contour/worklet/contour/MarchingCells.h>
 
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
 #include <vtkm/cont/CellSetExplicit.h>
+#include <vtkm/cont/CellSetPermutation.h>
 #include <vtkm/cont/CellSetSingleType.h>
 #include <vtkm/cont/CellSetStructured.h>
 #include <vtkm/cont/CoordinateSystem.h>
@@ -174,8 +177,87 @@ public:
     return outputCells;
   }
 
+  // Filter restricted to the cells in `activeCellIds`, which must contain every cell that
+  // crosses one of the isovalues (for example from a `SpanSpaceIndex`). Only unstructured cell
+  // sets are supported.
+  template <typename ValueType, typename StorageTagField>
+  VTKM_CONT vtkm::cont::CellSetSingleType<> Run(
+    const std::vector<ValueType>& isovalues,
+    const vtkm::cont::UnknownCellSet& cells,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& activeCellIds,
+    const vtkm::cont::CoordinateSystem& coordinateSystem,
+    const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& input,
+    vtkm::cont::ArrayHandle<vtkm::Vec3f>& vertices)
+  {
+    this->SharedState.GenerateNormals = false;
+    vtkm::cont::ArrayHandle<vtkm::Vec3f> normals;
+    return this->RunActiveCells(
+      isovalues, cells, activeCellIds, coordinateSystem, input, vertices, normals);
+  }
+
+  template <typename ValueType, typename StorageTagField>
+  VTKM_CONT vtkm::cont::CellSetSingleType<> Run(
+    const std::vector<ValueType>& isovalues,
+    const vtkm::cont::UnknownCellSet& cells,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& activeCellIds,
+    const vtkm::cont::CoordinateSystem& coordinateSystem,
+    const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& input,
+    vtkm::cont::ArrayHandle<vtkm::Vec3f>& vertices,
+    vtkm::cont::ArrayHandle<vtkm::Vec3f>& normals)
+  {
+    this->SharedState.GenerateNormals = true;
+    return this->RunActiveCells(
+      isovalues, cells, activeCellIds, coordinateSystem, input, vertices, normals);
+  }
 
 private:
+  template <typename ValueType, typename StorageTagField>
+  VTKM_CONT vtkm::cont::CellSetSingleType<> RunActiveCells(
+    const std::vector<ValueType>& isovalues,
+    const vtkm::cont::UnknownCellSet& cells,
+    const vtkm::cont::ArrayHandle<vtkm::Id>& activeCellIds,
+    const vtkm::cont::CoordinateSystem& coordinateSystem,
+    const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& input,
+    vtkm::cont::ArrayHandle<vtkm::Vec3f>& vertices,
+    vtkm::cont::ArrayHandle<vtkm::Vec3f>& normals)
+  {
+    vtkm::cont::CellSetSingleType<> outputCells;
+    if (activeCellIds.GetNumberOfValues() < 1)
+    {
+      this->SharedState.InterpolationEdgeIds.Allocate(0);
+      this->SharedState.InterpolationWeights.Allocate(0);
+      this->SharedState.CellIdMap.Allocate(0);
+      vertices.Allocate(0);
+      normals.Allocate(0);
+      outputCells.Fill(
+        0, vtkm::CELL_SHAPE_TRIANGLE, 3, vtkm::cont::ArrayHandle<vtkm::Id>{});
+      return outputCells;
+    }
+
+    auto coords = coordinateSystem.GetDataAsMultiplexer();
+    cells.CastAndCallForTypes<VTKM_DEFAULT_CELL_SET_LIST_UNSTRUCTURED>(
+      [&](const auto& concreteCells) {
+        using CellSetType = std::decay_t<decltype(concreteCells)>;
+        vtkm::cont::CellSetPermutation<CellSetType> activeCells(activeCellIds, concreteCells);
+        outputCells = marching_cells::execute(activeCells,
+                                              concreteCells,
+                                              coords,
+                                              isovalues,
+                                              input,
+                                              vertices,
+                                              normals,
+                                              this->SharedState);
+      });
+
+    // The output cells were generated from the active cells. Map them back to the input cells.
+    vtkm::cont::ArrayHandle<vtkm::Id> cellIdMap;
+    vtkm::cont::ArrayCopy(
+      vtkm::cont::make_ArrayHandlePermutation(this->SharedState.CellIdMap, activeCellIds),
+      cellIdMap);
+    this->SharedState.CellIdMap = cellIdMap;
+    return outputCells;
+  }
+
   vtkm::worklet::contour::CommonState SharedState;
 };
 
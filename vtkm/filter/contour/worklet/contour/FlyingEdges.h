@@ -70,6 +70,13 @@ vtkm::cont::CellSetSingleType<> execute(
 
   auto metaDataSums = vtkm::cont::make_ArrayHandleGroupVec<3>(metaDataLinearSums);
 
+  // With several isovalues, the range of the field along each row is recorded in
+  // the first Pass1 so that the following ones can skip rows that the isovalue
+  // does not cross.
+  const bool useRowRanges = isovalues.size() > 1;
+  vtkm::cont::ArrayHandle<vtkm::Vec<ValueType, 2>> rowRanges; //per point of metaDataMesh
+  vtkm::cont::ArrayHandle<vtkm::UInt8> rowClasses;            //per point of metaDataMesh
+
   // Since sharedState can be re-used between invocations of contour,
   // we need to make sure we reset the size of the Interpolation
   // arrays so we don't execute Pass5 over an array that is too large
@@ -100,16 +107,34 @@ vtkm::cont::CellSetSingleType<> execute(
       // Additionally GPU's does significantly better when you do an initial fill
       // and write only non-below values
       //
-      ComputePass1<ValueType> worklet1(isoval, pdims);
-      vtkm::cont::TryExecuteOnDevice(invoke.GetDevice(),
-                                     launchComputePass1{},
-                                     worklet1,
-                                     inputField,
-                                     edgeCases,
-                                     metaDataMesh2D,
-                                     metaDataSums,
-                                     metaDataMin,
-                                     metaDataMax);
+      if (useRowRanges)
+      {
+        ComputePass1Ranged<ValueType> worklet1(isoval, pdims);
+        vtkm::cont::TryExecuteOnDevice(invoke.GetDevice(),
+                                       launchComputePass1{},
+                                       worklet1,
+                                       inputField,
+                                       edgeCases,
+                                       metaDataMesh2D,
+                                       rowRanges,
+                                       rowClasses,
+                                       metaDataSums,
+                                       metaDataMin,
+                                       metaDataMax);
+      }
+      else
+      {
+        ComputePass1<ValueType> worklet1(isoval, pdims);
+        vtkm::cont::TryExecuteOnDevice(invoke.GetDevice(),
+                                       launchComputePass1{},
+                                       worklet1,
+                                       inputField,
+                                       edgeCases,
+                                       metaDataMesh2D,
+                                       metaDataSums,
+                                       metaDataMin,
+                                       metaDataMax);
+      }
     }
 
     //----------------------------------------------------------------------------
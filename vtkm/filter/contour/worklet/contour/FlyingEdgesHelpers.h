@@ -46,6 +46,14 @@ public:
     MinBoundary = 1,
     MaxBoundary = 2
   };
+  // Classification of a whole row of edges, used when contouring multiple isovalues.
+  enum RowClass
+  {
+    UnknownRow = 0, // row has not been visited yet
+    MixedRow = 1,   // edge cases were computed from the field
+    BelowRow = 2,   // every edge is below the isovalue
+    AboveRow = 3    // every edge is above the isovalue
+  };
 };
 
 struct SumXAxis
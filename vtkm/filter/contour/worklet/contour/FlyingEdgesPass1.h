@@ -145,6 +145,139 @@ struct ComputePass1 : public vtkm::worklet::WorkletVisitPointsWithCells
   }
 };
 
+/*
+* ComputePass1Ranged is used when several isovalues are contoured one after the
+* other. The first time a row is visited, the range of the field along the row is
+* recorded with the regular edge classification. For the following isovalues,
+* a row whose range does not contain the isovalue is entirely below or above it,
+* so its edge cases are known without reading the field. They are only written
+* when the class of the row changes from the previous isovalue.
+*/
+template <typename T>
+struct ComputePass1Ranged : public vtkm::worklet::WorkletVisitPointsWithCells
+{
+  vtkm::Id3 PointDims;
+  T IsoValue;
+
+  ComputePass1Ranged() {}
+  ComputePass1Ranged(T value, const vtkm::Id3& pdims)
+    : PointDims(pdims)
+    , IsoValue(value)
+  {
+  }
+
+  using ControlSignature = void(CellSetIn,
+                                FieldInOut row_range,
+                                FieldInOut row_class,
+                                FieldOut axis_sum,
+                                FieldOut axis_min,
+                                FieldOut axis_max,
+                                WholeArrayInOut edgeData,
+                                WholeArrayIn data);
+  using ExecutionSignature = void(ThreadIndices, _2, _3, _4, _5, _6, _7, _8, Device);
+  using InputDomain = _1;
+
+  template <typename ThreadIndices,
+            typename WholeEdgeField,
+            typename WholeDataField,
+            typename Device>
+  VTKM_EXEC void operator()(const ThreadIndices& threadIndices,
+                            vtkm::Vec<T, 2>& row_range,
+                            vtkm::UInt8& row_class,
+                            vtkm::Id3& axis_sum,
+                            vtkm::Id& axis_min,
+                            vtkm::Id& axis_max,
+                            WholeEdgeField& edges,
+                            const WholeDataField& field,
+                            Device) const
+  {
+    using AxisToSum = typename select_AxisToSum<Device>::type;
+
+    const vtkm::Id3 ijk = compute_ijk(AxisToSum{}, threadIndices.GetInputIndex3D());
+    const vtkm::Id3 dims = this->PointDims;
+    const vtkm::Id startPos = compute_start(AxisToSum{}, ijk, dims);
+    const vtkm::Id offset = compute_inc(AxisToSum{}, dims);
+
+    const T value = this->IsoValue;
+    const vtkm::Id end = this->PointDims[AxisToSum::xindex] - 1;
+    axis_min = this->PointDims[AxisToSum::xindex];
+    axis_max = 0;
+    axis_sum = { 0, 0, 0 };
+
+    if (row_class != FlyingEdges3D::UnknownRow)
+    {
+      vtkm::UInt8 newClass = FlyingEdges3D::MixedRow;
+      if (row_range[1] < value)
+      {
+        newClass = FlyingEdges3D::BelowRow;
+      }
+      else if (row_range[0] >= value)
+      {
+        newClass = FlyingEdges3D::AboveRow;
+      }
+
+      if (newClass != FlyingEdges3D::MixedRow)
+      {
+        if (newClass != row_class)
+        {
+          const vtkm::UInt8 edgeCase = (newClass == FlyingEdges3D::AboveRow)
+            ? static_cast<vtkm::UInt8>(FlyingEdges3D::BothAbove)
+            : static_cast<vtkm::UInt8>(FlyingEdges3D::Below);
+          for (vtkm::Id i = 0; i < end; ++i)
+          {
+            edges.Set(startPos + (offset * i), edgeCase);
+          }
+          edges.Set(startPos + (offset * end), FlyingEdges3D::Below);
+          row_class = newClass;
+        }
+        return;
+      }
+    }
+
+    T s1 = field.Get(startPos);
+    T s0 = s1;
+    T rowMin = s1;
+    T rowMax = s1;
+    for (vtkm::Id i = 0; i < end; ++i)
+    {
+      s0 = s1;
+      s1 = field.Get(startPos + (offset * (i + 1)));
+      rowMin = vtkm::Min(rowMin, s1);
+      rowMax = vtkm::Max(rowMax, s1);
+
+      vtkm::UInt8 edgeCase = FlyingEdges3D::Below;
+      if (s0 >= value)
+      {
+        edgeCase = FlyingEdges3D::LeftAbove;
+      }
+      if (s1 >= value)
+      {
+        edgeCase |= FlyingEdges3D::RightAbove;
+      }
+
+      // Rows skipped later on are not written again, so always write the edge case.
+      edges.Set(startPos + (offset * i), edgeCase);
+
+      if (edgeCase == FlyingEdges3D::LeftAbove || edgeCase == FlyingEdges3D::RightAbove)
+      {
+        axis_sum[AxisToSum::xindex] += 1; // increment number of intersections along axis
+        axis_max = i + 1;
+        if (axis_min == (end + 1))
+        {
+          axis_min = i;
+        }
+      }
+    }
+    edges.Set(startPos + (offset * end), FlyingEdges3D::Below);
+
+    if (row_class == FlyingEdges3D::UnknownRow)
+    {
+      row_range = { rowMin, rowMax };
+    }
+    row_class = FlyingEdges3D::MixedRow;
+  }
+};
+
 struct launchComputePass1
 {
   template <typename DeviceAdapterTag, typename T, typename StorageTagField, typename... Args>
@@ -178,6 +311,77 @@ struct launchComputePass1
     return true;
   }
 
+  template <typename DeviceAdapterTag,
+            typename T,
+            typename StorageTagField,
+            typename RangeArrayType,
+            typename... Args>
+  VTKM_CONT bool LaunchXAxis(DeviceAdapterTag device,
+                             const ComputePass1Ranged<T>& worklet,
+                             const vtkm::cont::ArrayHandle<T, StorageTagField>& inputField,
+                             vtkm::cont::ArrayHandle<vtkm::UInt8>& edgeCases,
+                             vtkm::cont::CellSetStructured<2>& metaDataMesh2D,
+                             RangeArrayType& rowRanges,
+                             vtkm::cont::ArrayHandle<vtkm::UInt8>& rowClasses,
+                             Args&&... args) const
+  {
+    vtkm::cont::Invoker invoke(device);
+    metaDataMesh2D = make_metaDataMesh2D(SumXAxis{}, worklet.PointDims);
+    prepareRowClasses(metaDataMesh2D, rowRanges, rowClasses);
+
+    invoke(worklet,
+           metaDataMesh2D,
+           rowRanges,
+           rowClasses,
+           std::forward<Args>(args)...,
+           edgeCases,
+           inputField);
+    return true;
+  }
+
+  // The ranged worklet writes every edge of a row on the first visit, so the edge cases
+  // do not need to be cleared first.
+  template <typename DeviceAdapterTag,
+            typename T,
+            typename StorageTagField,
+            typename RangeArrayType,
+            typename... Args>
+  VTKM_CONT bool LaunchYAxis(DeviceAdapterTag device,
+                             const ComputePass1Ranged<T>& worklet,
+                             const vtkm::cont::ArrayHandle<T, StorageTagField>& inputField,
+                             vtkm::cont::ArrayHandle<vtkm::UInt8>& edgeCases,
+                             vtkm::cont::CellSetStructured<2>& metaDataMesh2D,
+                             RangeArrayType& rowRanges,
+                             vtkm::cont::ArrayHandle<vtkm::UInt8>& rowClasses,
+                             Args&&... args) const
+  {
+    vtkm::cont::Invoker invoke(device);
+    metaDataMesh2D = make_metaDataMesh2D(SumYAxis{}, worklet.PointDims);
+    prepareRowClasses(metaDataMesh2D, rowRanges, rowClasses);
+
+    invoke(worklet,
+           metaDataMesh2D,
+           rowRanges,
+           rowClasses,
+           std::forward<Args>(args)...,
+           edgeCases,
+           inputField);
+    return true;
+  }
+
+  template <typename RangeArrayType>
+  VTKM_CONT static void prepareRowClasses(const vtkm::cont::CellSetStructured<2>& metaDataMesh2D,
+                                          RangeArrayType& rowRanges,
+                                          vtkm::cont::ArrayHandle<vtkm::UInt8>& rowClasses)
+  {
+    const vtkm::Id numRows = metaDataMesh2D.GetNumberOfPoints();
+    if (rowClasses.GetNumberOfValues() != numRows)
+    {
+      rowClasses.AllocateAndFill(numRows, static_cast<vtkm::UInt8>(FlyingEdges3D::UnknownRow));
+      rowRanges.Allocate(numRows);
+    }
+  }
+
   template <typename DeviceAdapterTag, typename... Args>
   VTKM_CONT bool operator()(DeviceAdapterTag device, Args&&... args) const
   {
@@ -592,12 +592,17 @@ struct GenerateNormals
 };
 
 //----------------------------------------------------------------------------
+// Contours the cells of `cells`. The normals are computed from the gradient of the field over
+// `normalCells`, which is the whole mesh when `cells` is only the subset of the cells that cross
+// the isovalues.
 template <typename CellSetType,
+          typename NormalCellSetType,
           typename CoordinateSystem,
           typename ValueType,
           typename StorageTagField>
 vtkm::cont::CellSetSingleType<> execute(
   const CellSetType& cells,
+  const NormalCellSetType& normalCells,
   const CoordinateSystem& coordinateSystem,
   const std::vector<ValueType>& isovalues,
   const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
@@ -714,13 +719,31 @@ vtkm::cont::CellSetSingleType<> execute(
              invoker,
              normals,
              inputField,
-             cells,
+             normalCells,
              sharedState.InterpolationEdgeIds,
              sharedState.InterpolationWeights);
   }
 
   return outputCells;
 }
+
+//----------------------------------------------------------------------------
+template <typename CellSetType,
+          typename CoordinateSystem,
+          typename ValueType,
+          typename StorageTagField>
+vtkm::cont::CellSetSingleType<> execute(
+  const CellSetType& cells,
+  const CoordinateSystem& coordinateSystem,
+  const std::vector<ValueType>& isovalues,
+  const vtkm::cont::ArrayHandle<ValueType, StorageTagField>& inputField,
+  vtkm::cont::ArrayHandle<vtkm::Vec3f>& vertices,
+  vtkm::cont::ArrayHandle<vtkm::Vec3f>& normals,
+  vtkm::worklet::contour::CommonState& sharedState)
+{
+  return execute(
+    cells, cells, coordinateSystem, isovalues, inputField, vertices, normals, sharedState);
+}
 }
 }
 } // namespace vtkm::worklet::marching_cells
@@ -0,0 +1,302 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#ifndef vtk_m_worklet_contour_SpanSpace_h
+#define vtk_m_worklet_contour_SpanSpace_h
+
+#include <vtkm/BinaryOperators.h>
+#include <vtkm/Math.h>
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandlePermutation.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/UnknownArrayHandle.h>
+#include <vtkm/cont/UnknownCellSet.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/WorkletMapTopology.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace vtkm
+{
+namespace worklet
+{
+namespace contour
+{
+
+namespace span_space
+{
+
+// ---------------------------------------------------------------------------
+class CellRange : public vtkm::worklet::WorkletVisitCellsWithPoints
+{
+public:
+  using ControlSignature = void(CellSetIn cellSet, FieldInPoint fieldIn, FieldOutCell range);
+  using ExecutionSignature = void(PointCount, _2, _3);
+
+  template <typename FieldInType>
+  VTKM_EXEC void operator()(vtkm::IdComponent numPoints,
+                            const FieldInType& fieldIn,
+                            vtkm::Vec2f_64& range) const
+  {
+    range[0] = range[1] = static_cast<vtkm::Float64>(fieldIn[0]);
+    for (vtkm::IdComponent i = 1; i < numPoints; ++i)
+    {
+      const vtkm::Float64 value = static_cast<vtkm::Float64>(fieldIn[i]);
+      range[0] = vtkm::Min(range[0], value);
+      range[1] = vtkm::Max(range[1], value);
+    }
+  }
+};
+
+// ---------------------------------------------------------------------------
+class BucketKey : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn range, FieldOut key);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_CONT BucketKey(vtkm::Float64 low, vtkm::Float64 bucketWidth, vtkm::Id numBuckets)
+    : Low(low)
+    , BucketWidth(bucketWidth)
+    , NumberOfBuckets(numBuckets)
+  {
+  }
+
+  VTKM_EXEC vtkm::Id Bucket(vtkm::Float64 value) const
+  {
+    const vtkm::Id bucket = static_cast<vtkm::Id>((value - this->Low) / this->BucketWidth);
+    return vtkm::Max(vtkm::Id{ 0 }, vtkm::Min(bucket, this->NumberOfBuckets - 1));
+  }
+
+  VTKM_EXEC void operator()(const vtkm::Vec2f_64& range, vtkm::Id& key) const
+  {
+    key = this->Bucket(range[0]) * this->NumberOfBuckets + this->Bucket(range[1]);
+  }
+
+private:
+  vtkm::Float64 Low;
+  vtkm::Float64 BucketWidth;
+  vtkm::Id NumberOfBuckets;
+};
+
+// ---------------------------------------------------------------------------
+// A cell generates triangles for an isovalue if one of its points is above the isovalue and
+// another is not (see ClassifyCell).
+class CrossesIsoValue : public vtkm::worklet::WorkletMapField
+{
+public:
+  using ControlSignature = void(FieldIn range, WholeArrayIn isoValues, FieldOut crosses);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename IsoValuesType>
+  VTKM_EXEC void operator()(const vtkm::Vec2f_64& range,
+                            const IsoValuesType& isoValues,
+                            bool& crosses) const
+  {
+    crosses = false;
+    for (vtkm::Id i = 0; i < isoValues.GetNumberOfValues(); ++i)
+    {
+      const vtkm::Float64 isoValue = isoValues.Get(i);
+      crosses |= (range[0] <= isoValue) && (isoValue < range[1]);
+    }
+  }
+};
+
+} // namespace span_space
+
+/// \brief Span space index of the cells of a mesh for repeated contouring.
+///
+/// The (min, max) range of the field in every cell is a point in span space. The span space is
+/// divided in a grid of buckets and the cells are sorted by bucket. The cells crossing an
+/// isovalue are the ones with `min <= isovalue < max`, which are all in the buckets of the
+/// upper left corner of the span space delimited by the isovalue. Only the cells of the buckets
+/// on the boundary of that corner need to be checked, so finding the active cells costs time
+/// proportional to the number of active cells (plus the cells in a row and column of buckets)
+/// instead of the number of cells in the mesh.
+class SpanSpaceIndex
+{
+public:
+  /// Returns true if the index was built for this cell set.
+  VTKM_CONT bool IsBuiltFor(const vtkm::cont::UnknownCellSet& cells) const
+  {
+    return (this->CellSet.GetCellSetBase() != nullptr) &&
+      (this->CellSet.GetCellSetBase() == cells.GetCellSetBase());
+  }
+
+  /// Returns true if the index was built for this cell set and field array, and the values of
+  /// the field array were not modified since.
+  template <typename ValueType, typename StorageTag>
+  VTKM_CONT bool IsBuiltFor(const vtkm::cont::UnknownCellSet& cells,
+                            const vtkm::cont::ArrayHandle<ValueType, StorageTag>& field) const
+  {
+    using FieldArrayType = vtkm::cont::ArrayHandle<ValueType, StorageTag>;
+    return this->IsBuiltFor(cells) && this->Field.IsType<FieldArrayType>() &&
+      (this->Field.AsArrayHandle<FieldArrayType>() == field) &&
+      (this->Field.GetBufferVersions() == this->FieldVersions);
+  }
+
+  template <typename CellSetType, typename ValueType, typename StorageTag>
+  VTKM_CONT void Build(const vtkm::cont::UnknownCellSet& unknownCells,
+                       const CellSetType& cells,
+                       const vtkm::cont::ArrayHandle<ValueType, StorageTag>& field)
+  {
+    vtkm::cont::Invoker invoke;
+
+    vtkm::cont::ArrayHandle<vtkm::Vec2f_64> ranges;
+    invoke(span_space::CellRange{}, cells, field, ranges);
+    const vtkm::Id numCells = ranges.GetNumberOfValues();
+
+    const vtkm::Vec2f_64 fieldRange = vtkm::cont::Algorithm::Reduce(
+      ranges,
+      vtkm::Vec2f_64(vtkm::Infinity64(), vtkm::NegativeInfinity64()),
+      vtkm::MinAndMax<vtkm::Float64>());
+
+    // About sqrt(numCells) / 4 buckets per axis keeps the bucket offsets small compared to the
+    // mesh while leaving few cells in each bucket.
+    this->NumberOfBuckets = vtkm::Max(
+      vtkm::Id{ 1 },
+      vtkm::Min(vtkm::Id{ 256 },
+                static_cast<vtkm::Id>(vtkm::Sqrt(static_cast<vtkm::Float64>(numCells)) / 4)));
+    this->Low = fieldRange[0];
+    this->High = fieldRange[1];
+    this->BucketWidth = (this->High > this->Low)
+      ? (this->High - this->Low) / static_cast<vtkm::Float64>(this->NumberOfBuckets)
+      : 1.0;
+
+    vtkm::cont::ArrayHandle<vtkm::Id> keys;
+    invoke(span_space::BucketKey{ this->Low, this->BucketWidth, this->NumberOfBuckets },
+           ranges,
+           keys);
+    vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(numCells), this->SortedCellIds);
+    vtkm::cont::Algorithm::SortByKey(keys, this->SortedCellIds);
+    vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandlePermutation(this->SortedCellIds, ranges),
+                          this->SortedRanges);
+
+    const vtkm::Id numKeys = this->NumberOfBuckets * this->NumberOfBuckets;
+    vtkm::cont::ArrayHandle<vtkm::Id> offsets;
+    vtkm::cont::Algorithm::LowerBounds(
+      keys, vtkm::cont::make_ArrayHandleCounting(vtkm::Id{ 0 }, vtkm::Id{ 1 }, numKeys + 1), offsets);
+    this->BucketOffsets.resize(static_cast<std::size_t>(numKeys + 1));
+    auto offsetsPortal = offsets.ReadPortal();
+    for (vtkm::Id i = 0; i <= numKeys; ++i)
+    {
+      this->BucketOffsets[static_cast<std::size_t>(i)] = offsetsPortal.Get(i);
+    }
+
+    this->CellSet = unknownCells;
+    this->Field = field;
+    this->FieldVersions = this->Field.GetBufferVersions();
+  }
+
+  /// Returns the ids, in increasing order, of the cells that generate triangles for at least
+  /// one of the isovalues.
+  template <typename ValueType>
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Id> GetActiveCells(
+    const std::vector<ValueType>& isoValues) const
+  {
+    // Collect the ranges of sorted cells in the buckets that can cross an isovalue.
+    std::vector<std::pair<vtkm::Id, vtkm::Id>> candidates;
+    const std::size_t numBuckets = static_cast<std::size_t>(this->NumberOfBuckets);
+    for (ValueType value : isoValues)
+    {
+      const vtkm::Float64 isoValue = static_cast<vtkm::Float64>(value);
+      if ((isoValue < this->Low) || (isoValue >= this->High))
+      {
+        continue;
+      }
+      const std::size_t isoBucket = static_cast<std::size_t>(vtkm::Min(
+        static_cast<vtkm::Id>((isoValue - this->Low) / this->BucketWidth), this->NumberOfBuckets - 1));
+      // Cells with a min bucket at or before the isovalue and a max bucket at or after it. For a
+      // given min bucket, these are contiguous in the sorted cells.
+      for (std::size_t minBucket = 0; minBucket <= isoBucket; ++minBucket)
+      {
+        const vtkm::Id begin = this->BucketOffsets[minBucket * numBuckets + isoBucket];
+        const vtkm::Id end = this->BucketOffsets[(minBucket + 1) * numBuckets];
+        if (begin < end)
+        {
+          candidates.emplace_back(begin, end);
+        }
+      }
+    }
+
+    // Merge the ranges so that no cell is visited twice with several isovalues.
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<std::pair<vtkm::Id, vtkm::Id>> merged;
+    vtkm::Id numCandidates = 0;
+    for (const auto& candidate : candidates)
+    {
+      if (!merged.empty() && (candidate.first <= merged.back().second))
+      {
+        numCandidates += vtkm::Max(vtkm::Id{ 0 }, candidate.second - merged.back().second);
+        merged.back().second = vtkm::Max(merged.back().second, candidate.second);
+      }
+      else
+      {
+        numCandidates += candidate.second - candidate.first;
+        merged.push_back(candidate);
+      }
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::Id> candidateIds;
+    vtkm::cont::ArrayHandle<vtkm::Vec2f_64> candidateRanges;
+    candidateIds.Allocate(numCandidates);
+    candidateRanges.Allocate(numCandidates);
+    vtkm::Id outIndex = 0;
+    for (const auto& range : merged)
+    {
+      const vtkm::Id count = range.second - range.first;
+      vtkm::cont::Algorithm::CopySubRange(
+        this->SortedCellIds, range.first, count, candidateIds, outIndex);
+      vtkm::cont::Algorithm::CopySubRange(
+        this->SortedRanges, range.first, count, candidateRanges, outIndex);
+      outIndex += count;
+    }
+
+    std::vector<vtkm::Float64> isoValues64(isoValues.begin(), isoValues.end());
+    vtkm::cont::ArrayHandle<bool> crosses;
+    vtkm::cont::Invoker invoke;
+    invoke(span_space::CrossesIsoValue{},
+           candidateRanges,
+           vtkm::cont::make_ArrayHandle(isoValues64, vtkm::CopyFlag::Off),
+           crosses);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> activeCellIds;
+    vtkm::cont::Algorithm::CopyIf(candidateIds, crosses, activeCellIds);
+    vtkm::cont::Algorithm::Sort(activeCellIds);
+    return activeCellIds;
+  }
+
+private:
+  vtkm::cont::UnknownCellSet CellSet;
+  vtkm::cont::UnknownArrayHandle Field;
+  std::vector<vtkm::UInt64> FieldVersions;
+
+  vtkm::Float64 Low = 0;
+  vtkm::Float64 High = 0;
+  vtkm::Float64 BucketWidth = 1;
+  vtkm::Id NumberOfBuckets = 0;
+  std::vector<vtkm::Id> BucketOffsets;
+  vtkm::cont::ArrayHandle<vtkm::Id> SortedCellIds;
+  vtkm::cont::ArrayHandle<vtkm::Vec2f_64> SortedRanges;
+};
+
+}
+}
+} // namespace vtkm::worklet::contour
+
+#endif // vtk_m_worklet_contour_SpanSpace_h
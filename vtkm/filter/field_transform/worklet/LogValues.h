@@ -34,6 +34,7 @@ public:
 
   typedef void ControlSignature(FieldIn, FieldOut);
   typedef void ExecutionSignature(_1, _2);
+  using BatchLanes = vtkm::worklet::BatchWidth<8>;
 
   template <typename T>
   VTKM_EXEC void operator()(const T& value, vtkm::FloatDefault& log_value) const
@@ -26,6 +26,7 @@ class PointTransform : public vtkm::worklet::WorkletMapField
 public:
   using ControlSignature = void(FieldIn, FieldOut);
   using ExecutionSignature = _2(_1);
+  using BatchLanes = vtkm::worklet::BatchWidth<8>;
 
   VTKM_CONT
   explicit PointTransform(const vtkm::Matrix<vtkm::FloatDefault, 4, 4>& m)
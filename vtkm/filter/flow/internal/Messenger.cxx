@@ -12,6 +12,7 @@ int R = 1;
 
 #include <vtkm/Math.h>
 #include <vtkm/cont/ErrorFilterExecution.h>
+#include <vtkm/cont/SerializationCodec.h>
 #include <vtkm/filter/flow/internal/Messenger.h>
 
 #include <iostream>
@@ -55,6 +56,8 @@ void Messenger::RegisterTag(int tag, std::size_t num_recvs, std::size_t size)
     msg << "Invalid message tag: " << tag << std::endl;
     throw vtkm::cont::ErrorFilterExecution(msg.str());
   }
+  // Leave room for the header added by the codec.
+  size += vtkm::cont::internal::MemoryBufferEncodingOverhead;
   this->MessageTagInfo[tag] = std::pair<std::size_t, std::size_t>(num_recvs, size);
 }
 
@@ -248,6 +251,30 @@ void Messenger::PrepareForSend(int tag,
   }
 }
 
+void Messenger::SendData(int dst, int tag, vtkmdiy::MemoryBuffer& buff)
+{
+  vtkm::cont::internal::EncodeMemoryBuffer(buff);
+  if (this->UseAsynchronousCommunication)
+    this->SendDataAsync(dst, tag, buff);
+  else
+    this->SendDataSync(dst, tag, buff);
+}
+
+bool Messenger::RecvData(const std::set<int>& tags,
+                         std::vector<std::pair<int, vtkmdiy::MemoryBuffer>>& buffers,
+                         bool blockAndWait)
+{
+  bool received;
+  if (this->UseAsynchronousCommunication)
+    received = this->RecvDataAsync(tags, buffers, blockAndWait);
+  else
+    received = this->RecvDataSync(tags, buffers, blockAndWait);
+
+  for (auto& buff : buffers)
+    vtkm::cont::internal::DecodeMemoryBuffer(buff.second);
+  return received;
+}
+
 void Messenger::SendDataAsync(int dst, int tag, const vtkmdiy::MemoryBuffer& buff)
 {
   std::vector<char*> bufferList;
@@ -378,9 +405,12 @@ bool Messenger::RecvDataSync(const std::set<int>& tags,
             throw vtkm::cont::ErrorFilterExecution(
               "Error in MPI_Recv inside Messenger::RecvDataSync");
 
+          // The codec of the message is its last byte, so drop the rest of the receive buffer.
+          int count;
+          MPI_Get_count(&status, MPI_BYTE, &count);
           std::pair<int, vtkmdiy::MemoryBuffer> entry;
           entry.first = tag;
-          entry.second.buffer = recvBuff;
+          entry.second.buffer.assign(recvBuff.begin(), recvBuff.begin() + count);
           buffers.emplace_back(std::move(entry));
         }
       }
@@ -59,22 +59,11 @@ protected:
   void InitializeBuffers();
   void CheckPendingSendRequests();
   void CleanupRequests(int tag = TAG_ANY);
-  void SendData(int dst, int tag, vtkmdiy::MemoryBuffer& buff)
-  {
-    if (this->UseAsynchronousCommunication)
-      this->SendDataAsync(dst, tag, buff);
-    else
-      this->SendDataSync(dst, tag, buff);
-  }
+  // The buffers are encoded with the codec returned by vtkm::cont::GetSerializationCodec.
+  void SendData(int dst, int tag, vtkmdiy::MemoryBuffer& buff);
   bool RecvData(const std::set<int>& tags,
                 std::vector<std::pair<int, vtkmdiy::MemoryBuffer>>& buffers,
-                bool blockAndWait = false)
-  {
-    if (this->UseAsynchronousCommunication)
-      return this->RecvDataAsync(tags, buffers, blockAndWait);
-    else
-      return this->RecvDataSync(tags, buffers, blockAndWait);
-  }
+                bool blockAndWait = false);
 
 private:
   void SendDataAsync(int dst, int tag, const vtkmdiy::MemoryBuffer& buff);
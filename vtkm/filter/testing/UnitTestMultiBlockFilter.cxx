@@ -13,6 +13,7 @@
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 
+#include <vtkm/filter/TaskQueue.h>
 #include <vtkm/filter/clean_grid/CleanGrid.h>
 #include <vtkm/filter/contour/ClipWithField.h>
 #include <vtkm/filter/contour/Contour.h>
@@ -83,6 +84,34 @@ void ValidateResults(const vtkm::cont::PartitionedDataSet& truth,
     }
   }
 }
+
+void TestWorkStealingQueue(const vtkm::cont::PartitionedDataSet& pds)
+{
+  std::cout << "Work stealing queue" << std::endl;
+  const vtkm::Id numPartitions = pds.GetNumberOfPartitions();
+  vtkm::filter::DataSetWorkStealingQueue queue(pds, 3);
+  VTKM_TEST_ASSERT(queue.GetNumberOfWorkers() == 3);
+  VTKM_TEST_ASSERT(queue.HasTasks());
+
+  // The partitions grow with their index, so the most expensive one is dealt to worker 0 first.
+  std::pair<vtkm::Id, vtkm::cont::DataSet> task;
+  VTKM_TEST_ASSERT(queue.GetTask(0, task));
+  VTKM_TEST_ASSERT(task.first == numPartitions - 1, "Largest partition not scheduled first");
+
+  // Worker 1 drains its own queue and then steals everything left over.
+  std::vector<bool> seen(static_cast<std::size_t>(numPartitions), false);
+  seen[static_cast<std::size_t>(task.first)] = true;
+  vtkm::Id count = 1;
+  while (queue.GetTask(1, task))
+  {
+    VTKM_TEST_ASSERT(!seen[static_cast<std::size_t>(task.first)], "Partition scheduled twice");
+    seen[static_cast<std::size_t>(task.first)] = true;
+    count++;
+  }
+  VTKM_TEST_ASSERT(count == numPartitions, "Partitions lost by the queue");
+  VTKM_TEST_ASSERT(!queue.HasTasks());
+  VTKM_TEST_ASSERT(queue.GetNumberOfStolenTasks() > 0, "Expected worker 1 to steal");
+}
 } //namespace
 
 
@@ -98,6 +127,8 @@ void TestMultiBlockFilter()
     pds.AppendPartition(tangle.Execute());
   }
 
+  TestWorkStealingQueue(pds);
+
   std::cout << "ClipWithField" << std::endl;
   std::vector<vtkm::cont::PartitionedDataSet> results;
   std::vector<bool> flags = { false, true };
@@ -110,6 +141,14 @@ void TestMultiBlockFilter()
     clip.SetFieldsToPass("tangle", vtkm::cont::Field::Association::Points);
     auto result = clip.Execute(pds);
     VTKM_TEST_ASSERT(result.GetNumberOfPartitions() == pds.GetNumberOfPartitions());
+    if (doThreading)
+    {
+      const auto& stats = clip.GetPartitionSchedulingStatistics();
+      VTKM_TEST_ASSERT(stats.NumberOfPartitions == pds.GetNumberOfPartitions());
+      VTKM_TEST_ASSERT(stats.NumberOfThreads >= 1);
+      VTKM_TEST_ASSERT(stats.BusyTime >= 0 && stats.IdleTime >= 0);
+      VTKM_TEST_ASSERT(stats.BusyTime <= stats.ElapsedTime * stats.NumberOfThreads);
+    }
     results.push_back(result);
   }
   ValidateResults(results[0], results[1], "tangle");
@@ -23,6 +23,7 @@ class Magnitude : public vtkm::worklet::WorkletMapField
 {
 public:
   using ControlSignature = void(FieldIn, FieldOut);
+  using BatchLanes = vtkm::worklet::BatchWidth<8>;
 
   template <typename T, typename T2>
   VTKM_EXEC void operator()(const T& inValue, T2& outValue) const
@@ -0,0 +1,323 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_filter_zfp_ArrayHandleZFP_h
+#define vtk_m_filter_zfp_ArrayHandleZFP_h
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ErrorBadValue.h>
+
+#include <vtkm/filter/zfp/worklet/zfp/ZFPDecode.h>
+#include <vtkm/filter/zfp/worklet/zfp/ZFPStructs.h>
+
+#include <type_traits>
+
+// Devices that cannot hold thread-local state decode the block on every access.
+#if !defined(VTKM_CUDA_DEVICE_PASS) && !defined(__HIP_DEVICE_COMPILE__) && \
+  !defined(__SYCL_DEVICE_ONLY__)
+#define VTKM_ZFP_BLOCK_CACHE
+#endif
+
+namespace vtkm
+{
+namespace cont
+{
+
+struct VTKM_ALWAYS_EXPORT StorageTagZFP
+{
+};
+
+namespace internal
+{
+
+/// Layout of a 3D fixed-rate ZFP stream, kept as the metadata of an `ArrayHandleZFP`.
+struct VTKM_ALWAYS_EXPORT ZFPArrayInfo
+{
+  vtkm::Id3 Dimensions = { 0, 0, 0 };
+  vtkm::UInt32 MaxBits = 0;
+};
+
+/// \brief The most recently decoded blocks of a thread.
+///
+/// Blocks are identified by the version of the buffer holding the stream, which changes
+/// whenever the stream is modified, so entries never have to be invalidated.
+///
+template <typename T>
+struct ZFPBlockCache
+{
+  static constexpr vtkm::IdComponent NumberOfEntries = 8;
+
+  struct Entry
+  {
+    vtkm::UInt64 Version = 0;
+    vtkm::UInt32 MaxBits = 0;
+    vtkm::Id BlockIndex = -1;
+    T Values[64];
+  };
+
+  Entry Entries[NumberOfEntries];
+  vtkm::IdComponent LastUsed = 0;
+  vtkm::IdComponent NextToReplace = 0;
+};
+
+/// \brief A read-only portal that decodes the 4x4x4 block containing a value on access.
+///
+template <typename T, typename WordsPortalType>
+class VTKM_ALWAYS_EXPORT ArrayPortalZFP
+{
+public:
+  using ValueType = T;
+
+  VTKM_EXEC_CONT ArrayPortalZFP() = default;
+
+  VTKM_EXEC_CONT ArrayPortalZFP(const WordsPortalType& words,
+                                const vtkm::Id3& dimensions,
+                                vtkm::UInt32 maxBits,
+                                vtkm::UInt64 version)
+    : Words(words)
+    , Dimensions(dimensions)
+    , BlockDimensions((dimensions + vtkm::Id3(3)) / vtkm::Id3(4))
+    , MaxBits(maxBits)
+    , Version(version)
+  {
+  }
+
+  VTKM_EXEC_CONT vtkm::Id GetNumberOfValues() const
+  {
+    return this->Dimensions[0] * this->Dimensions[1] * this->Dimensions[2];
+  }
+
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT ValueType Get(vtkm::Id index) const
+  {
+    const vtkm::Id x = index % this->Dimensions[0];
+    const vtkm::Id y = (index / this->Dimensions[0]) % this->Dimensions[1];
+    const vtkm::Id z = index / (this->Dimensions[0] * this->Dimensions[1]);
+    const vtkm::Id blockIndex =
+      ((z / 4) * this->BlockDimensions[1] + y / 4) * this->BlockDimensions[0] + x / 4;
+    const vtkm::Id offset = ((z % 4) * 4 + y % 4) * 4 + x % 4;
+
+#ifdef VTKM_ZFP_BLOCK_CACHE
+    return this->GetCachedBlock(blockIndex)[offset];
+#else
+    ValueType block[64];
+    this->DecodeBlock(blockIndex, block);
+    return block[offset];
+#endif
+  }
+
+  VTKM_EXEC_CONT const vtkm::Id3& GetDimensions() const { return this->Dimensions; }
+
+private:
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT void DecodeBlock(vtkm::Id blockIndex, ValueType* block) const
+  {
+    for (vtkm::IdComponent i = 0; i < 64; ++i)
+    {
+      block[i] = ValueType(0);
+    }
+    vtkm::worklet::zfp::zfp_decode<64>(block,
+                                       static_cast<vtkm::Int32>(this->MaxBits),
+                                       static_cast<vtkm::UInt32>(blockIndex),
+                                       this->Words);
+  }
+
+#ifdef VTKM_ZFP_BLOCK_CACHE
+  VTKM_SUPPRESS_EXEC_WARNINGS
+  VTKM_EXEC_CONT const ValueType* GetCachedBlock(vtkm::Id blockIndex) const
+  {
+    using CacheType = ZFPBlockCache<ValueType>;
+    thread_local CacheType cache;
+
+    auto matches = [&](const typename CacheType::Entry& entry) {
+      return (entry.BlockIndex == blockIndex) && (entry.Version == this->Version) &&
+        (entry.MaxBits == this->MaxBits);
+    };
+
+    // Neighboring values almost always fall in the block of the previous access.
+    if (matches(cache.Entries[cache.LastUsed]))
+    {
+      return cache.Entries[cache.LastUsed].Values;
+    }
+    for (vtkm::IdComponent i = 0; i < CacheType::NumberOfEntries; ++i)
+    {
+      if (matches(cache.Entries[i]))
+      {
+        cache.LastUsed = i;
+        return cache.Entries[i].Values;
+      }
+    }
+
+    cache.LastUsed = cache.NextToReplace;
+    cache.NextToReplace = (cache.NextToReplace + 1) % CacheType::NumberOfEntries;
+    typename CacheType::Entry& entry = cache.Entries[cache.LastUsed];
+    this->DecodeBlock(blockIndex, entry.Values);
+    entry.Version = this->Version;
+    entry.MaxBits = this->MaxBits;
+    entry.BlockIndex = blockIndex;
+    return entry.Values;
+  }
+#endif
+
+  WordsPortalType Words;
+  vtkm::Id3 Dimensions = { 0, 0, 0 };
+  vtkm::Id3 BlockDimensions = { 0, 0, 0 };
+  vtkm::UInt32 MaxBits = 0;
+  vtkm::UInt64 Version = 0;
+};
+
+template <typename T>
+class Storage<T, vtkm::cont::StorageTagZFP>
+{
+  VTKM_STATIC_ASSERT_MSG((std::is_same<T, vtkm::Float32>::value ||
+                          std::is_same<T, vtkm::Float64>::value),
+                         "ArrayHandleZFP only supports Float32 and Float64 values.");
+
+  using WordsArrayType = vtkm::cont::ArrayHandle<vtkm::Int64>;
+  using WordsStorage = Storage<vtkm::Int64, vtkm::cont::StorageTagBasic>;
+
+  static std::vector<vtkm::cont::internal::Buffer> WordsBuffers(
+    const std::vector<vtkm::cont::internal::Buffer>& buffers)
+  {
+    return std::vector<vtkm::cont::internal::Buffer>(buffers.begin() + 1, buffers.end());
+  }
+
+public:
+  VTKM_STORAGE_NO_RESIZE;
+  VTKM_STORAGE_NO_WRITE_PORTAL;
+
+  using ReadPortalType = ArrayPortalZFP<T, typename WordsArrayType::ReadPortalType>;
+
+  VTKM_CONT static std::vector<vtkm::cont::internal::Buffer> CreateBuffers(
+    const vtkm::cont::internal::ZFPArrayInfo& info = {},
+    const WordsArrayType& words = WordsArrayType{})
+  {
+    return vtkm::cont::internal::CreateBuffers(info, words);
+  }
+
+  VTKM_CONT static vtkm::Id GetNumberOfValues(
+    const std::vector<vtkm::cont::internal::Buffer>& buffers)
+  {
+    const vtkm::Id3 dims = GetInfo(buffers).Dimensions;
+    return dims[0] * dims[1] * dims[2];
+  }
+
+  VTKM_CONT static ReadPortalType CreateReadPortal(
+    const std::vector<vtkm::cont::internal::Buffer>& buffers,
+    vtkm::cont::DeviceAdapterId device,
+    vtkm::cont::Token& token)
+  {
+    const vtkm::cont::internal::ZFPArrayInfo& info = GetInfo(buffers);
+    return ReadPortalType(WordsStorage::CreateReadPortal(WordsBuffers(buffers), device, token),
+                          info.Dimensions,
+                          info.MaxBits,
+                          buffers[1].GetVersion());
+  }
+
+  VTKM_CONT static const vtkm::cont::internal::ZFPArrayInfo& GetInfo(
+    const std::vector<vtkm::cont::internal::Buffer>& buffers)
+  {
+    return buffers[0].GetMetaData<vtkm::cont::internal::ZFPArrayInfo>();
+  }
+
+  VTKM_CONT static WordsArrayType GetCompressedArray(
+    const std::vector<vtkm::cont::internal::Buffer>& buffers)
+  {
+    return WordsArrayType(WordsBuffers(buffers));
+  }
+};
+
+} // namespace internal
+
+/// \brief A read-only array of values decompressed on the fly from a 3D ZFP stream.
+///
+/// `ArrayHandleZFP` takes the fixed-rate stream written by `vtkm::worklet::ZFPCompressor` (the
+/// "compressed" field of `vtkm::filter::zfp::ZFPCompressor3D`) along with the rate and point
+/// dimensions it was compressed with. The values are not decompressed up front. Instead, getting
+/// a value decodes the 4x4x4 block holding it. Each thread keeps its last few decoded blocks, so
+/// neighboring accesses (such as the points of a cell) decode each block once. An archived field
+/// can thus stay in memory at its compressed size and still be read like any other array.
+///
+/// The value type must match the type of the values that were compressed (`vtkm::Float32` or
+/// `vtkm::Float64`). The values are ordered like the points of a structured cell set with the
+/// given dimensions.
+///
+/// Filters only operate directly on the storage types in `VTKM_DEFAULT_STORAGE_LIST`. Other
+/// filters decompress the array into a basic array the first time they use it.
+///
+template <typename T>
+class VTKM_ALWAYS_EXPORT ArrayHandleZFP
+  : public vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagZFP>
+{
+public:
+  VTKM_ARRAY_HANDLE_SUBCLASS(ArrayHandleZFP,
+                             (ArrayHandleZFP<T>),
+                             (vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagZFP>));
+
+  /// Creates an array of the values of the stream `compressed`, which holds `dimensions`
+  /// values compressed at `rate` bits per value.
+  VTKM_CONT ArrayHandleZFP(const vtkm::cont::ArrayHandle<vtkm::Int64>& compressed,
+                           vtkm::Float64 rate,
+                           const vtkm::Id3& dimensions)
+    : Superclass(StorageType::CreateBuffers(MakeInfo(compressed, rate, dimensions), compressed))
+  {
+  }
+
+  VTKM_CONT vtkm::Id3 GetDimensions() const
+  {
+    return StorageType::GetInfo(this->GetBuffers()).Dimensions;
+  }
+
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::Int64> GetCompressedArray() const
+  {
+    return StorageType::GetCompressedArray(this->GetBuffers());
+  }
+
+private:
+  VTKM_CONT static vtkm::cont::internal::ZFPArrayInfo MakeInfo(
+    const vtkm::cont::ArrayHandle<vtkm::Int64>& compressed,
+    vtkm::Float64 rate,
+    const vtkm::Id3& dimensions)
+  {
+    // Use the same block size as ZFPCompressor.
+    vtkm::worklet::zfp::ZFPStream stream;
+    stream.SetRate(rate, 3, vtkm::Float64());
+
+    vtkm::cont::internal::ZFPArrayInfo info;
+    info.Dimensions = dimensions;
+    info.MaxBits = stream.maxbits;
+
+    const vtkm::Id3 blockDims = (dimensions + vtkm::Id3(3)) / vtkm::Id3(4);
+    const vtkm::Id numBlocks = blockDims[0] * blockDims[1] * blockDims[2];
+    const vtkm::Id numWords = (numBlocks * static_cast<vtkm::Id>(info.MaxBits)) / 64;
+    if (compressed.GetNumberOfValues() < numWords)
+    {
+      throw vtkm::cont::ErrorBadValue("ZFP stream has " +
+                                      std::to_string(compressed.GetNumberOfValues()) +
+                                      " words, but " + std::to_string(numWords) +
+                                      " are needed for the given rate and dimensions.");
+    }
+    return info;
+  }
+};
+
+/// Creates an `ArrayHandleZFP` of the values compressed in `compressed`.
+template <typename T>
+VTKM_CONT vtkm::cont::ArrayHandleZFP<T> make_ArrayHandleZFP(
+  const vtkm::cont::ArrayHandle<vtkm::Int64>& compressed,
+  vtkm::Float64 rate,
+  const vtkm::Id3& dimensions)
+{
+  return vtkm::cont::ArrayHandleZFP<T>(compressed, rate, dimensions);
+}
+
+}
+} // namespace vtkm::cont
+
+#endif //vtk_m_filter_zfp_ArrayHandleZFP_h
@@ -27,6 +27,33 @@ VTKM_CONT vtkm::cont::DataSet ZFPCompressor3D::DoExecute(const vtkm::cont::DataS
   vtkm::cont::ArrayHandle<vtkm::Int64> compressed;
 
   vtkm::worklet::ZFPCompressor compressor;
+  if (precision > 0 || accuracy > 0)
+  {
+    vtkm::worklet::zfp::ZFPStream stream;
+    if (accuracy > 0)
+    {
+      stream.SetAccuracy(accuracy);
+    }
+    else
+    {
+      stream.SetPrecision(precision);
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::Id> blockOffsets;
+    this->GetFieldFromDataSet(input)
+      .GetData()
+      .CastAndCallForTypesWithFloatFallback<vtkm::List<vtkm::Float64>, VTKM_DEFAULT_STORAGE_LIST>(
+        [&](const auto& concrete) {
+          compressed = compressor.Compress(concrete, stream, pointDimensions, blockOffsets);
+        });
+
+    vtkm::cont::DataSet result = this->CreateResultField(
+      input, "compressed", vtkm::cont::Field::Association::WholeDataSet, compressed);
+    result.AddField(vtkm::cont::Field(
+      "compressed_block_offsets", vtkm::cont::Field::Association::WholeDataSet, blockOffsets));
+    return result;
+  }
+
   using SupportedTypes = vtkm::List<vtkm::Int32, vtkm::Float32, vtkm::Float64>;
   this->GetFieldFromDataSet(input)
     .GetData()
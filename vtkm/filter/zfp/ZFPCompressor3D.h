@@ -26,16 +26,44 @@ namespace zfp
 /// output of compressed data.
 /// @warning
 /// This filter is currently only supports 1D volumes.
+///
+/// In the fixed-precision and fixed-accuracy modes, blocks use different numbers of bits. The
+/// bit offset of each block is written to the "compressed_block_offsets" field, which
+/// `ZFPDecompressor3D` needs. These modes compress the values as `vtkm::Float64`.
 class VTKM_FILTER_ZFP_EXPORT ZFPCompressor3D : public vtkm::filter::FilterField
 {
 public:
-  void SetRate(vtkm::Float64 _rate) { rate = _rate; }
+  /// Fixed-rate mode: each block uses `rate` bits per value.
+  void SetRate(vtkm::Float64 _rate)
+  {
+    rate = _rate;
+    precision = 0;
+    accuracy = 0;
+  }
   vtkm::Float64 GetRate() { return rate; }
 
+  /// Fixed-precision mode: each block keeps `precision` bit planes.
+  void SetPrecision(vtkm::UInt32 _precision)
+  {
+    precision = _precision;
+    accuracy = 0;
+  }
+  vtkm::UInt32 GetPrecision() { return precision; }
+
+  /// Fixed-accuracy mode: the absolute error of each value is at most `accuracy`.
+  void SetAccuracy(vtkm::Float64 _accuracy)
+  {
+    accuracy = _accuracy;
+    precision = 0;
+  }
+  vtkm::Float64 GetAccuracy() { return accuracy; }
+
 private:
   VTKM_CONT vtkm::cont::DataSet DoExecute(const vtkm::cont::DataSet& input) override;
 
   vtkm::Float64 rate = 0;
+  vtkm::UInt32 precision = 0;
+  vtkm::Float64 accuracy = 0;
 };
 } // namespace zfp
 } // namespace filter
@@ -32,7 +32,28 @@ VTKM_CONT vtkm::cont::DataSet ZFPDecompressor3D::DoExecute(const vtkm::cont::Dat
 
   vtkm::cont::ArrayHandle<vtkm::Float64> decompressed;
   vtkm::worklet::ZFPDecompressor decompressor;
-  decompressor.Decompress(compressed, decompressed, this->rate, pointDimensions);
+  if (precision > 0 || accuracy > 0)
+  {
+    vtkm::worklet::zfp::ZFPStream stream;
+    if (accuracy > 0)
+    {
+      stream.SetAccuracy(accuracy);
+    }
+    else
+    {
+      stream.SetPrecision(precision);
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::Id> blockOffsets;
+    vtkm::cont::ArrayCopyShallowIfPossible(
+      input.GetField(this->GetFieldFromDataSet(input).GetName() + "_block_offsets").GetData(),
+      blockOffsets);
+    decompressor.Decompress(compressed, blockOffsets, decompressed, stream, pointDimensions);
+  }
+  else
+  {
+    decompressor.Decompress(compressed, decompressed, this->rate, pointDimensions);
+  }
 
   return this->CreateResultFieldPoint(input, "decompressed", decompressed);
 }
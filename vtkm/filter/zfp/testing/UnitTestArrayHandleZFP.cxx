@@ -0,0 +1,147 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayCopyDevice.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/testing/MakeTestDataSet.h>
+#include <vtkm/cont/testing/Testing.h>
+
+#include <vtkm/filter/contour/Contour.h>
+#include <vtkm/filter/zfp/ArrayHandleZFP.h>
+#include <vtkm/filter/zfp/worklet/ZFPCompressor.h>
+#include <vtkm/filter/zfp/worklet/ZFPDecompress.h>
+
+namespace
+{
+
+constexpr vtkm::Float64 RATE = 8;
+const vtkm::Id3 DIMENSIONS(13, 10, 7);
+
+template <typename T>
+void CheckValues(const vtkm::cont::ArrayHandle<T>& expected,
+                 const vtkm::cont::ArrayHandle<T, vtkm::cont::StorageTagZFP>& array)
+{
+  VTKM_TEST_ASSERT(array.GetNumberOfValues() == expected.GetNumberOfValues());
+  auto expectedPortal = expected.ReadPortal();
+  auto portal = array.ReadPortal();
+  // Read backward so that the blocks are not decoded in stream order.
+  for (vtkm::Id index = portal.GetNumberOfValues() - 1; index >= 0; --index)
+  {
+    VTKM_TEST_ASSERT(portal.Get(index) == expectedPortal.Get(index), "Bad value at ", index);
+  }
+}
+
+void TestArrayHandleZFP()
+{
+  vtkm::cont::DataSet dataset = vtkm::cont::testing::MakeTestDataSet{}.Make3DUniformDataSet3(
+    DIMENSIONS);
+  vtkm::cont::ArrayHandle<vtkm::Float64> original;
+  dataset.GetField("pointvar").GetData().AsArrayHandle(original);
+
+  vtkm::worklet::ZFPCompressor compressor;
+  vtkm::cont::ArrayHandle<vtkm::Int64> compressed =
+    compressor.Compress(original, RATE, DIMENSIONS);
+  vtkm::cont::ArrayHandle<vtkm::Float64> decompressed;
+  vtkm::worklet::ZFPDecompressor decompressor;
+  decompressor.Decompress(compressed, decompressed, RATE, DIMENSIONS);
+
+  std::cout << "Read values in the control environment" << std::endl;
+  auto array = vtkm::cont::make_ArrayHandleZFP<vtkm::Float64>(compressed, RATE, DIMENSIONS);
+  VTKM_TEST_ASSERT(array.GetDimensions() == DIMENSIONS);
+  VTKM_TEST_ASSERT(array.GetCompressedArray() == compressed);
+  VTKM_TEST_ASSERT(array.GetNumberOfValues() == original.GetNumberOfValues());
+  CheckValues(decompressed, array);
+  auto originalPortal = original.ReadPortal();
+  auto portal = array.ReadPortal();
+  for (vtkm::Id index = 0; index < portal.GetNumberOfValues(); ++index)
+  {
+    VTKM_TEST_ASSERT(test_equal(portal.Get(index), originalPortal.Get(index), 0.1),
+                     "Value too far from the original at ",
+                     index);
+  }
+
+  std::cout << "Read values in a worklet" << std::endl;
+  vtkm::cont::ArrayHandle<vtkm::Float64> copy;
+  vtkm::cont::ArrayCopyDevice(array, copy);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(copy, decompressed));
+
+  std::cout << "Contour the compressed field" << std::endl;
+  dataset.AddPointField("zfp", array);
+  dataset.AddPointField("decompressed", decompressed);
+  vtkm::Range range = dataset.GetField("decompressed").GetRange().ReadPortal().Get(0);
+  vtkm::filter::contour::Contour contour;
+  contour.SetIsoValue(range.Center());
+  contour.SetActiveField("zfp");
+  vtkm::cont::DataSet fromCompressed = contour.Execute(dataset);
+  contour.SetActiveField("decompressed");
+  vtkm::cont::DataSet fromDecompressed = contour.Execute(dataset);
+  VTKM_TEST_ASSERT(fromCompressed.GetNumberOfCells() > 0);
+  VTKM_TEST_ASSERT(fromCompressed.GetNumberOfCells() == fromDecompressed.GetNumberOfCells());
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(fromCompressed.GetCoordinateSystem().GetData(),
+                                           fromDecompressed.GetCoordinateSystem().GetData()));
+
+  std::cout << "Modify the stream" << std::endl;
+  compressed.Fill(0);
+  decompressor.Decompress(compressed, decompressed, RATE, DIMENSIONS);
+  CheckValues(decompressed, array);
+  VTKM_TEST_ASSERT(array.ReadPortal().Get(0) == 0);
+}
+
+void TestFloat32()
+{
+  std::cout << "Compress Float32 values" << std::endl;
+  vtkm::cont::DataSet dataset = vtkm::cont::testing::MakeTestDataSet{}.Make3DUniformDataSet3(
+    DIMENSIONS);
+  vtkm::cont::ArrayHandle<vtkm::Float32> original;
+  vtkm::cont::ArrayCopy(dataset.GetField("pointvar").GetData(), original);
+
+  vtkm::worklet::ZFPCompressor compressor;
+  auto compressed = compressor.Compress(original, RATE, DIMENSIONS);
+  vtkm::cont::ArrayHandle<vtkm::Float32> decompressed;
+  vtkm::worklet::ZFPDecompressor decompressor;
+  decompressor.Decompress(compressed, decompressed, RATE, DIMENSIONS);
+
+  auto array = vtkm::cont::make_ArrayHandleZFP<vtkm::Float32>(compressed, RATE, DIMENSIONS);
+  CheckValues(decompressed, array);
+}
+
+void TestShortStream()
+{
+  std::cout << "Stream too short for the dimensions" << std::endl;
+  vtkm::cont::ArrayHandle<vtkm::Int64> compressed;
+  compressed.AllocateAndFill(10, 0);
+  bool threw = false;
+  try
+  {
+    vtkm::cont::make_ArrayHandleZFP<vtkm::Float64>(compressed, RATE, DIMENSIONS);
+  }
+  catch (vtkm::cont::ErrorBadValue& error)
+  {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    threw = true;
+  }
+  VTKM_TEST_ASSERT(threw, "Short stream did not fail");
+}
+
+void Run()
+{
+  TestArrayHandleZFP();
+  TestFloat32();
+  TestShortStream();
+}
+
+} // anonymous namespace
+
+int UnitTestArrayHandleZFP(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
@@ -114,11 +114,52 @@ void TestZFP3DFilter(vtkm::Float64 rate)
   }
 }
 
+void TestZFP3DFilterModes()
+{
+  const vtkm::Id3 dims(10, 9, 7);
+  vtkm::cont::testing::MakeTestDataSet testDataSet;
+  vtkm::cont::DataSet dataset = testDataSet.Make3DUniformDataSet3(dims);
+  vtkm::cont::ArrayHandle<vtkm::Float64> field;
+  dataset.GetField("pointvar").GetData().AsArrayHandle(field);
+
+  auto check = [&](vtkm::filter::zfp::ZFPCompressor3D& compressor,
+                   vtkm::filter::zfp::ZFPDecompressor3D& decompressor,
+                   vtkm::Float64 tolerance) {
+    compressor.SetActiveField("pointvar");
+    auto compressed = compressor.Execute(dataset);
+    VTKM_TEST_ASSERT(compressed.HasField("compressed_block_offsets"));
+
+    decompressor.SetActiveField("compressed");
+    auto decompress = decompressor.Execute(compressed);
+    vtkm::cont::ArrayHandle<vtkm::Float64> result;
+    decompress.GetField("decompressed").GetData().AsArrayHandle(result);
+
+    auto oport = field.ReadPortal();
+    auto port = result.ReadPortal();
+    VTKM_TEST_ASSERT(port.GetNumberOfValues() == oport.GetNumberOfValues());
+    for (vtkm::Id i = 0; i < port.GetNumberOfValues(); i++)
+    {
+      VTKM_TEST_ASSERT(vtkm::Abs(oport.Get(i) - port.Get(i)) <= tolerance);
+    }
+  };
+
+  vtkm::filter::zfp::ZFPCompressor3D compressor;
+  vtkm::filter::zfp::ZFPDecompressor3D decompressor;
+  compressor.SetAccuracy(1e-3);
+  decompressor.SetAccuracy(1e-3);
+  check(compressor, decompressor, 1e-3);
+
+  compressor.SetPrecision(32);
+  decompressor.SetPrecision(32);
+  check(compressor, decompressor, 1e-3);
+}
+
 void TestZFPFilter()
 {
   TestZFP1DFilter(4);
   TestZFP2DFilter(4);
   TestZFP2DFilter(4);
+  TestZFP3DFilterModes();
 }
 } // anonymous namespace
 
@@ -0,0 +1,235 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/testing/MakeTestDataSet.h>
+#include <vtkm/cont/testing/Testing.h>
+
+#include <vtkm/filter/zfp/worklet/ZFPCompressor.h>
+#include <vtkm/filter/zfp/worklet/ZFPDecompress.h>
+
+namespace
+{
+
+const vtkm::Id3 DIMENSIONS(13, 10, 7);
+
+template <typename T>
+vtkm::cont::ArrayHandle<T> MakeField()
+{
+  vtkm::cont::DataSet dataset = vtkm::cont::testing::MakeTestDataSet{}.Make3DUniformDataSet3(
+    DIMENSIONS);
+  vtkm::cont::ArrayHandle<T> field;
+  vtkm::cont::ArrayCopy(dataset.GetField("pointvar").GetData(), field);
+  return field;
+}
+
+template <typename T>
+vtkm::Float64 MaxError(const vtkm::cont::ArrayHandle<T>& expected,
+                       const vtkm::cont::ArrayHandle<T>& actual)
+{
+  VTKM_TEST_ASSERT(expected.GetNumberOfValues() == actual.GetNumberOfValues());
+  auto expectedPortal = expected.ReadPortal();
+  auto actualPortal = actual.ReadPortal();
+  vtkm::Float64 maxError = 0;
+  for (vtkm::Id index = 0; index < expected.GetNumberOfValues(); ++index)
+  {
+    maxError = vtkm::Max(
+      maxError, vtkm::Abs(vtkm::Float64(expectedPortal.Get(index) - actualPortal.Get(index))));
+  }
+  return maxError;
+}
+
+template <typename T>
+vtkm::cont::ArrayHandle<T> RoundTrip(const vtkm::cont::ArrayHandle<T>& field,
+                                     const vtkm::worklet::zfp::ZFPStream& stream,
+                                     vtkm::Id& numWords)
+{
+  vtkm::cont::ArrayHandle<vtkm::Id> blockOffsets;
+  vtkm::cont::ArrayHandle<vtkm::Int64> compressed =
+    vtkm::worklet::ZFPCompressor{}.Compress(field, stream, DIMENSIONS, blockOffsets);
+  numWords = compressed.GetNumberOfValues();
+
+  const vtkm::Id3 blockDims = (DIMENSIONS + vtkm::Id3(3)) / vtkm::Id3(4);
+  VTKM_TEST_ASSERT(blockOffsets.GetNumberOfValues() == blockDims[0] * blockDims[1] * blockDims[2]);
+  VTKM_TEST_ASSERT(blockOffsets.ReadPortal().Get(0) == 0);
+
+  vtkm::cont::ArrayHandle<T> decompressed;
+  vtkm::worklet::ZFPDecompressor{}.Decompress(
+    compressed, blockOffsets, decompressed, stream, DIMENSIONS);
+  return decompressed;
+}
+
+template <typename T>
+void TestAccuracy()
+{
+  std::cout << "Fixed accuracy with " << vtkm::cont::TypeToString<T>() << std::endl;
+  vtkm::cont::ArrayHandle<T> field = MakeField<T>();
+  vtkm::Id previousWords = 0;
+  for (vtkm::Float64 tolerance : { 1.0, 1e-2, 1e-4 })
+  {
+    vtkm::worklet::zfp::ZFPStream stream;
+    vtkm::Float64 used = stream.SetAccuracy(tolerance);
+    VTKM_TEST_ASSERT(used <= tolerance && used > tolerance / 2);
+
+    vtkm::Id numWords;
+    vtkm::Float64 error = MaxError(field, RoundTrip(field, stream, numWords));
+    std::cout << "  tolerance " << tolerance << ": error " << error << ", " << numWords
+              << " words" << std::endl;
+    VTKM_TEST_ASSERT(error <= tolerance, "Error above the tolerance");
+    VTKM_TEST_ASSERT(numWords > previousWords, "Smaller tolerance did not use more bits");
+    previousWords = numWords;
+  }
+}
+
+template <typename T>
+void TestPrecision()
+{
+  std::cout << "Fixed precision with " << vtkm::cont::TypeToString<T>() << std::endl;
+  vtkm::cont::ArrayHandle<T> field = MakeField<T>();
+  vtkm::Float64 previousError = vtkm::Infinity64();
+  vtkm::Id previousWords = 0;
+  for (vtkm::UInt32 precision : { 8u, 16u, 24u })
+  {
+    vtkm::worklet::zfp::ZFPStream stream;
+    VTKM_TEST_ASSERT(stream.SetPrecision(precision) == precision);
+
+    vtkm::Id numWords;
+    vtkm::Float64 error = MaxError(field, RoundTrip(field, stream, numWords));
+    std::cout << "  precision " << precision << ": error " << error << ", " << numWords
+              << " words" << std::endl;
+    VTKM_TEST_ASSERT(error < previousError, "Higher precision did not reduce the error");
+    VTKM_TEST_ASSERT(numWords > previousWords, "Higher precision did not use more bits");
+    previousError = error;
+    previousWords = numWords;
+  }
+  VTKM_TEST_ASSERT(previousError < 1e-2);
+}
+
+void TestEmptyBlocks()
+{
+  std::cout << "Blocks of zeros" << std::endl;
+  vtkm::cont::ArrayHandle<vtkm::Float64> field;
+  field.AllocateAndFill(DIMENSIONS[0] * DIMENSIONS[1] * DIMENSIONS[2], 0);
+  vtkm::worklet::zfp::ZFPStream stream;
+  stream.SetAccuracy(1e-3);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> blockOffsets;
+  auto compressed =
+    vtkm::worklet::ZFPCompressor{}.Compress(field, stream, DIMENSIONS, blockOffsets);
+  // each block is a single bit
+  vtkm::cont::ArrayHandleCounting<vtkm::Id> expectedOffsets(
+    0, 1, blockOffsets.GetNumberOfValues());
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(blockOffsets, expectedOffsets));
+  VTKM_TEST_ASSERT(compressed.GetNumberOfValues() == 1);
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> decompressed;
+  vtkm::worklet::ZFPDecompressor{}.Decompress(
+    compressed, blockOffsets, decompressed, stream, DIMENSIONS);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(decompressed, field));
+}
+
+void TestRegion()
+{
+  std::cout << "Decode a region" << std::endl;
+  vtkm::cont::ArrayHandle<vtkm::Float64> field = MakeField<vtkm::Float64>();
+  vtkm::worklet::zfp::ZFPStream stream;
+  stream.SetAccuracy(1e-3);
+
+  vtkm::cont::ArrayHandle<vtkm::Id> blockOffsets;
+  auto compressed =
+    vtkm::worklet::ZFPCompressor{}.Compress(field, stream, DIMENSIONS, blockOffsets);
+  vtkm::worklet::ZFPDecompressor decompressor;
+  vtkm::cont::ArrayHandle<vtkm::Float64> full;
+  decompressor.Decompress(compressed, blockOffsets, full, stream, DIMENSIONS);
+
+  const vtkm::Id3 regionStart(3, 2, 5);
+  const vtkm::Id3 regionDims(7, 5, 2);
+  vtkm::cont::ArrayHandle<vtkm::Float64> region;
+  decompressor.DecompressRegion(
+    compressed, blockOffsets, region, stream, DIMENSIONS, regionStart, regionDims);
+  VTKM_TEST_ASSERT(region.GetNumberOfValues() == regionDims[0] * regionDims[1] * regionDims[2]);
+
+  auto fullPortal = full.ReadPortal();
+  auto regionPortal = region.ReadPortal();
+  vtkm::Id regionIndex = 0;
+  for (vtkm::Id z = regionStart[2]; z < regionStart[2] + regionDims[2]; ++z)
+  {
+    for (vtkm::Id y = regionStart[1]; y < regionStart[1] + regionDims[1]; ++y)
+    {
+      for (vtkm::Id x = regionStart[0]; x < regionStart[0] + regionDims[0]; ++x)
+      {
+        vtkm::Id fullIndex = (z * DIMENSIONS[1] + y) * DIMENSIONS[0] + x;
+        VTKM_TEST_ASSERT(regionPortal.Get(regionIndex) == fullPortal.Get(fullIndex));
+        ++regionIndex;
+      }
+    }
+  }
+
+  bool threw = false;
+  try
+  {
+    decompressor.DecompressRegion(
+      compressed, blockOffsets, region, stream, DIMENSIONS, regionStart, DIMENSIONS);
+  }
+  catch (vtkm::cont::ErrorBadValue& error)
+  {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    threw = true;
+  }
+  VTKM_TEST_ASSERT(threw, "Region outside of the field did not fail");
+}
+
+void TestFixedRate()
+{
+  std::cout << "Random access to a fixed-rate stream" << std::endl;
+  constexpr vtkm::Float64 rate = 8;
+  vtkm::cont::ArrayHandle<vtkm::Float64> field = MakeField<vtkm::Float64>();
+  auto compressed = vtkm::worklet::ZFPCompressor{}.Compress(field, rate, DIMENSIONS);
+  vtkm::cont::ArrayHandle<vtkm::Float64> expected;
+  vtkm::worklet::ZFPDecompressor{}.Decompress(compressed, expected, rate, DIMENSIONS);
+
+  vtkm::worklet::zfp::ZFPStream stream;
+  stream.SetRate(rate, 3, vtkm::Float64());
+  VTKM_TEST_ASSERT(stream.IsFixedRate());
+  const vtkm::Id3 blockDims = (DIMENSIONS + vtkm::Id3(3)) / vtkm::Id3(4);
+  vtkm::cont::ArrayHandleCounting<vtkm::Id> blockOffsets(
+    0, stream.maxbits, blockDims[0] * blockDims[1] * blockDims[2]);
+  vtkm::cont::ArrayHandle<vtkm::Float64> decompressed;
+  vtkm::worklet::ZFPDecompressor{}.Decompress(
+    compressed, blockOffsets, decompressed, stream, DIMENSIONS);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(decompressed, expected));
+
+  std::cout << "Fixed rate through the variable-size path" << std::endl;
+  vtkm::Id numWords;
+  decompressed = RoundTrip(field, stream, numWords);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(decompressed, expected));
+  VTKM_TEST_ASSERT(numWords >= compressed.GetNumberOfValues());
+}
+
+void Run()
+{
+  TestAccuracy<vtkm::Float64>();
+  TestAccuracy<vtkm::Float32>();
+  TestPrecision<vtkm::Float64>();
+  TestPrecision<vtkm::Float32>();
+  TestEmptyBlocks();
+  TestRegion();
+  TestFixedRate();
+}
+
+} // anonymous namespace
+
+int UnitTestZFPModes(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
@@ -90,6 +90,50 @@ public:
 
     return output;
   }
+
+  /// Compresses `data` with the mode set in `stream`. Unlike fixed-rate streams, the blocks of
+  /// fixed-precision and fixed-accuracy streams use different numbers of bits, so the bit offset
+  /// of each block is written to `blockOffsets`. Blocks are encoded in parallel into scratch
+  /// slots large enough for any block, then packed into the stream at the offsets given by a
+  /// scan of their sizes. The scratch memory is about the size of the uncompressed data.
+  template <typename Scalar, typename Storage>
+  vtkm::cont::ArrayHandle<vtkm::Int64> Compress(
+    const vtkm::cont::ArrayHandle<Scalar, Storage>& data,
+    const zfp::ZFPStream& stream,
+    const vtkm::Id3 dims,
+    vtkm::cont::ArrayHandle<vtkm::Id>& blockOffsets)
+  {
+    const vtkm::Id3 zfpDims = (dims + vtkm::Id3(3)) / vtkm::Id3(4);
+    const vtkm::Id totalBlocks = zfpDims[0] * zfpDims[1] * zfpDims[2];
+    const vtkm::UInt32 slotBits = zfp::detail::CalcSlotBits3d<Scalar>(stream);
+    const vtkm::Id slotWords = vtkm::Id(slotBits / (sizeof(ZFPWord) * 8));
+
+    // encode each block into its own slot
+    vtkm::cont::ArrayHandle<vtkm::Int64> slots;
+    slots.AllocateAndFill(totalBlocks * slotWords, 0);
+    vtkm::cont::ArrayHandle<vtkm::Id> blockBits;
+    vtkm::cont::ArrayHandleCounting<vtkm::Id> blockCounter(0, 1, totalBlocks);
+    vtkm::worklet::DispatcherMapField<zfp::EncodeVariable3> encodeDispatcher(
+      zfp::EncodeVariable3(dims, stream, slotBits));
+    encodeDispatcher.Invoke(blockCounter, data, slots, blockBits);
+
+    // each block starts after the blocks before it
+    const vtkm::Id totalBits = vtkm::cont::Algorithm::ScanExclusive(blockBits, blockOffsets);
+
+    // each word of the stream gathers the bits of the blocks overlapping it
+    const vtkm::Id wbits = sizeof(ZFPWord) * 8;
+    const vtkm::Id outsize = (totalBits + wbits - 1) / wbits;
+    vtkm::cont::ArrayHandle<vtkm::Id> blocksAfterWordStart;
+    vtkm::cont::Algorithm::UpperBounds(blockOffsets,
+                                       vtkm::cont::ArrayHandleCounting<vtkm::Id>(0, wbits, outsize),
+                                       blocksAfterWordStart);
+    vtkm::cont::ArrayHandle<vtkm::Int64> output;
+    vtkm::worklet::DispatcherMapField<zfp::detail::PackBlocks> packDispatcher(
+      zfp::detail::PackBlocks(slotWords, totalBlocks));
+    packDispatcher.Invoke(blocksAfterWordStart, blockOffsets, blockBits, slots, output);
+
+    return output;
+  }
 };
 } // namespace worklet
 } // namespace vtkm
@@ -16,6 +16,7 @@
 #include <vtkm/cont/ArrayHandleConstant.h>
 #include <vtkm/cont/ArrayHandleCounting.h>
 #include <vtkm/cont/AtomicArray.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/Timer.h>
 #include <vtkm/filter/zfp/worklet/zfp/ZFPDecode3.h>
 #include <vtkm/filter/zfp/worklet/zfp/ZFPTools.h>
@@ -84,6 +85,55 @@ public:
     //    std::cout<<"Decompress rate "<<rate<<" GB / sec\n";
     //    DataDump(output, "decompressed");
   }
+
+  /// Decompresses a stream written by the `Compress` overload that takes a `ZFPStream`.
+  /// `blockOffsets` holds the bit offset of each block. The offsets of a fixed-rate stream are
+  /// `ArrayHandleCounting<vtkm::Id>(0, stream.maxbits, numBlocks)`.
+  template <typename Scalar, typename StorageIn, typename StorageOffsets, typename StorageOut>
+  void Decompress(const vtkm::cont::ArrayHandle<vtkm::Int64, StorageIn>& encodedData,
+                  const vtkm::cont::ArrayHandle<vtkm::Id, StorageOffsets>& blockOffsets,
+                  vtkm::cont::ArrayHandle<Scalar, StorageOut>& output,
+                  const zfp::ZFPStream& stream,
+                  const vtkm::Id3 dims)
+  {
+    this->DecompressRegion(encodedData, blockOffsets, output, stream, dims, vtkm::Id3(0), dims);
+  }
+
+  /// Decompresses the `regionDims` values starting at point `regionStart`. Only the blocks
+  /// overlapping the region are decoded, each at the offset given by `blockOffsets`.
+  template <typename Scalar, typename StorageIn, typename StorageOffsets, typename StorageOut>
+  void DecompressRegion(const vtkm::cont::ArrayHandle<vtkm::Int64, StorageIn>& encodedData,
+                        const vtkm::cont::ArrayHandle<vtkm::Id, StorageOffsets>& blockOffsets,
+                        vtkm::cont::ArrayHandle<Scalar, StorageOut>& output,
+                        const zfp::ZFPStream& stream,
+                        const vtkm::Id3 dims,
+                        const vtkm::Id3 regionStart,
+                        const vtkm::Id3 regionDims)
+  {
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      if (regionStart[i] < 0 || regionDims[i] < 0 || regionStart[i] + regionDims[i] > dims[i])
+      {
+        throw vtkm::cont::ErrorBadValue("ZFP region is outside of the compressed field.");
+      }
+    }
+    const vtkm::Id3 zfpDims = (dims + vtkm::Id3(3)) / vtkm::Id3(4);
+    if (blockOffsets.GetNumberOfValues() != zfpDims[0] * zfpDims[1] * zfpDims[2])
+    {
+      throw vtkm::cont::ErrorBadValue("ZFP block offsets do not match the field dimensions.");
+    }
+
+    output.Allocate(regionDims[0] * regionDims[1] * regionDims[2]);
+
+    // launch 1 thread per zfp block overlapping the region
+    const vtkm::Id3 regionBlocks =
+      (regionStart + regionDims + vtkm::Id3(3)) / vtkm::Id3(4) - regionStart / vtkm::Id3(4);
+    vtkm::cont::ArrayHandleCounting<vtkm::Id> blockCounter(
+      0, 1, regionBlocks[0] * regionBlocks[1] * regionBlocks[2]);
+    vtkm::worklet::DispatcherMapField<zfp::DecodeVariable3> decompressDispatcher(
+      zfp::DecodeVariable3(dims, regionStart, regionDims, stream));
+    decompressDispatcher.Invoke(blockCounter, blockOffsets, output, encodedData);
+  }
 };
 } // namespace worklet
 } // namespace vtkm
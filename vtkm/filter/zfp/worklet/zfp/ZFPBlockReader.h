@@ -25,8 +25,6 @@ template <vtkm::Int32 block_size, typename WordsPortalType>
 struct BlockReader
 {
   const WordsPortalType& Words;
-  const vtkm::Int32 m_maxbits;
-  int m_block_idx;
 
   vtkm::Int32 m_current_bit;
   vtkm::Id Index;
@@ -34,18 +32,24 @@ struct BlockReader
   Word m_buffer;
   const vtkm::Id MaxIndex;
 
+  // reads the block at block_idx of a fixed-rate stream
   VTKM_EXEC
   BlockReader(const WordsPortalType& words, const int& maxbits, const int& block_idx)
+    : BlockReader(words, vtkm::Id(block_idx) * maxbits)
+  {
+  }
+
+  // reads the block starting at bit_offset of the stream
+  VTKM_EXEC
+  BlockReader(const WordsPortalType& words, const vtkm::Id& bit_offset)
     : Words(words)
-    , m_maxbits(maxbits)
     , MaxIndex(words.GetNumberOfValues() - 1)
   {
-    Index = vtkm::Id(static_cast<size_t>(block_idx * maxbits) / (sizeof(Word) * 8));
+    Index = bit_offset / vtkm::Id(sizeof(Word) * 8);
     m_buffer = static_cast<Word>(Words.Get(Index));
-    m_current_bit = (block_idx * maxbits) % vtkm::Int32((sizeof(Word) * 8));
+    m_current_bit = vtkm::Int32(bit_offset % vtkm::Id(sizeof(Word) * 8));
 
     m_buffer >>= m_current_bit;
-    m_block_idx = block_idx;
   }
 
   inline VTKM_EXEC unsigned int read_bit()
@@ -75,9 +79,9 @@ struct BlockReader
 
     vtkm::Int32 first_read = vtkm::Min(rem_bits, n_bits);
     // first mask
-    Word mask = ((Word)1 << ((first_read))) - 1;
+    Word mask = LowBits(first_read);
     bits = m_buffer & mask;
-    m_buffer >>= n_bits;
+    m_buffer = (n_bits < rem_bits) ? m_buffer >> n_bits : 0;
     m_current_bit += first_read;
     vtkm::Int32 next_read = 0;
     if (n_bits >= rem_bits)
@@ -93,14 +97,22 @@ struct BlockReader
     // this is basically a no-op when first read constained
     // all the bits. TODO: if we have aligned reads, this could
     // be a conditional without divergence
-    mask = ((Word)1 << ((next_read))) - 1;
-    bits += (m_buffer & mask) << first_read;
-    m_buffer >>= next_read;
-    m_current_bit += next_read;
+    if (next_read > 0)
+    {
+      bits += (m_buffer & LowBits(next_read)) << first_read;
+      m_buffer >>= next_read;
+      m_current_bit += next_read;
+    }
     return bits;
   }
 
 private:
+  // shifting a word by its full width is undefined
+  static inline VTKM_EXEC Word LowBits(const vtkm::Int32& n_bits)
+  {
+    return (n_bits < vtkm::Int32(sizeof(Word) * 8)) ? ((Word)1 << n_bits) - 1 : ~Word(0);
+  }
+
   VTKM_EXEC BlockReader() {}
 
 }; // block reader
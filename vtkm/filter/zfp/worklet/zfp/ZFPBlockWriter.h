@@ -56,6 +56,10 @@ struct BlockWriter
   inline VTKM_EXEC vtkm::UInt64 write_bits(const vtkm::UInt64& bits, const unsigned int& n_bits)
   {
     const int wbits = sizeof(Word) * 8;
+    if (n_bits == 0)
+    {
+      return bits;
+    }
     unsigned int seg_start = (m_start_bit + m_current_bit) % wbits;
     vtkm::Id write_index = m_word_index;
     write_index += vtkm::Id((m_start_bit + m_current_bit) / wbits);
@@ -67,7 +71,8 @@ struct BlockWriter
     // If this does not happen, then we may write into a zfp
     // block not at the specified index
     // uint zero_shift = sizeof(Word) * 8 - n_bits;
-    Word left = (bits >> n_bits) << n_bits;
+    // (shifting a word by its full width is undefined, so a full word is taken as is)
+    Word left = (n_bits < sizeof(Word) * 8) ? (bits >> n_bits) << n_bits : 0;
 
     Word b = bits - left;
     Word add = b << shift;
@@ -81,7 +86,7 @@ struct BlockWriter
       Add(write_index + 1, rem);
     }
     m_current_bit += n_bits;
-    return bits >> (Word)n_bits;
+    return (n_bits < sizeof(Word) * 8) ? bits >> (Word)n_bits : 0;
   }
 
   // TODO: optimize
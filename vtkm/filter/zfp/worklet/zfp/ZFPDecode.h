@@ -173,7 +173,8 @@ template <vtkm::Int32 BlockSize,
 VTKM_EXEC void decode_ints(ReaderType<BlockSize, PortalType>& reader,
                            vtkm::Int32& maxbits,
                            UInt* data,
-                           const vtkm::Int32 intprec)
+                           const vtkm::Int32 intprec,
+                           const vtkm::Int32 maxprec)
 {
   for (vtkm::Int32 i = 0; i < BlockSize; ++i)
   {
@@ -181,7 +182,8 @@ VTKM_EXEC void decode_ints(ReaderType<BlockSize, PortalType>& reader,
   }
 
   vtkm::UInt64 x;
-  const vtkm::UInt32 kmin = 0;
+  const vtkm::UInt32 kmin =
+    intprec > maxprec ? static_cast<vtkm::UInt32>(intprec - maxprec) : vtkm::UInt32(0);
   vtkm::Int32 bits = maxbits;
   for (vtkm::UInt32 k = static_cast<vtkm::UInt32>(intprec), n = 0; bits && k-- > kmin;)
   {
@@ -201,13 +203,14 @@ VTKM_EXEC void decode_ints(ReaderType<BlockSize, PortalType>& reader,
   }
 }
 
-template <vtkm::Int32 BlockSize, typename Scalar, typename PortalType>
-VTKM_EXEC void zfp_decode(Scalar* fblock,
-                          vtkm::Int32 maxbits,
-                          vtkm::UInt32 blockIdx,
-                          PortalType stream)
+// decodes a block with the given reader; maxprec and minexp must match the encoder
+template <vtkm::Int32 BlockSize, typename Scalar, typename ReaderType>
+VTKM_EXEC void zfp_decode_block(Scalar* fblock,
+                                vtkm::Int32 maxbits,
+                                vtkm::Int32 maxprec,
+                                vtkm::Int32 minexp,
+                                ReaderType& reader)
 {
-  zfp::BlockReader<BlockSize, PortalType> reader(stream, maxbits, vtkm::Int32(blockIdx));
   using Int = typename zfp::zfp_traits<Scalar>::Int;
   using UInt = typename zfp::zfp_traits<Scalar>::UInt;
 
@@ -223,10 +226,13 @@ VTKM_EXEC void zfp_decode(Scalar* fblock,
     vtkm::UInt32 ebits = static_cast<vtkm::UInt32>(zfp::get_ebits<Scalar>()) + 1;
 
     vtkm::UInt32 emax;
+    vtkm::Int32 blockprec = maxprec;
     if (!zfp::is_int<Scalar>())
     {
       emax = vtkm::UInt32(reader.read_bits(static_cast<vtkm::Int32>(ebits) - 1));
       emax -= static_cast<vtkm::UInt32>(zfp::get_ebias<Scalar>());
+      // same number of bit planes as the encoder
+      blockprec = vtkm::Min(maxprec, vtkm::Max(0, static_cast<vtkm::Int32>(emax) - minexp + 8));
     }
     else
     {
@@ -236,7 +242,7 @@ VTKM_EXEC void zfp_decode(Scalar* fblock,
 
     maxbits -= ebits;
     UInt ublock[BlockSize];
-    decode_ints<BlockSize>(reader, maxbits, ublock, zfp::get_precision<Scalar>());
+    decode_ints<BlockSize>(reader, maxbits, ublock, zfp::get_precision<Scalar>(), blockprec);
 
     Int iblock[BlockSize];
     const zfp::ZFPCodec<BlockSize> codec;
@@ -257,6 +263,17 @@ VTKM_EXEC void zfp_decode(Scalar* fblock,
     }
   }
 }
+
+template <vtkm::Int32 BlockSize, typename Scalar, typename PortalType>
+VTKM_EXEC void zfp_decode(Scalar* fblock,
+                          vtkm::Int32 maxbits,
+                          vtkm::UInt32 blockIdx,
+                          PortalType stream)
+{
+  zfp::BlockReader<BlockSize, PortalType> reader(stream, maxbits, vtkm::Int32(blockIdx));
+  zfp_decode_block<BlockSize>(
+    fblock, maxbits, zfp::get_precision<Scalar>(), zfp::get_min_exp<Scalar>(), reader);
+}
 }
 }
 } // namespace vtkm::worklet::zfp
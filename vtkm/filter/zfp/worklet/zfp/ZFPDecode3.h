@@ -135,6 +135,85 @@ public:
     }
   }
 };
+
+// Decodes the blocks that overlap a region of the field. The blocks are read at the bit
+// offsets of the block offset index, so any block can be decoded without the ones before it.
+struct DecodeVariable3 : public vtkm::worklet::WorkletMapField
+{
+protected:
+  vtkm::Id3 ZFPDims;      // zfp block dims
+  vtkm::Id3 RegionStart;  // first point of the region
+  vtkm::Id3 RegionDims;   // point dims of the region
+  vtkm::Id3 RegionBlocks; // zfp block dims of the region
+  vtkm::Int32 MaxBits;    // maximum bits per block
+  vtkm::Int32 MaxPrec;    // maximum bit planes per block
+  vtkm::Int32 MinExp;     // smallest bit plane kept
+public:
+  DecodeVariable3(const vtkm::Id3 dims,
+                  const vtkm::Id3 regionStart,
+                  const vtkm::Id3 regionDims,
+                  const ZFPStream& stream)
+    : ZFPDims((dims + vtkm::Id3(3)) / vtkm::Id3(4))
+    , RegionStart(regionStart)
+    , RegionDims(regionDims)
+    , RegionBlocks((regionStart + regionDims + vtkm::Id3(3)) / vtkm::Id3(4) -
+                   regionStart / vtkm::Id3(4))
+    , MaxBits(vtkm::Int32(stream.maxbits))
+    , MaxPrec(vtkm::Int32(stream.maxprec))
+    , MinExp(stream.minexp)
+  {
+  }
+  using ControlSignature = void(FieldIn,
+                                WholeArrayIn blockOffsets,
+                                WholeArrayOut,
+                                WholeArrayIn bitstream);
+
+  template <typename OffsetsPortal, typename ScalarPortal, typename BitstreamPortal>
+  VTKM_EXEC void operator()(const vtkm::Id regionBlockIdx,
+                            const OffsetsPortal& offsets,
+                            ScalarPortal& scalars,
+                            const BitstreamPortal& stream) const
+  {
+    using Scalar = typename ScalarPortal::ValueType;
+    constexpr vtkm::Int32 BlockSize = 64;
+
+    vtkm::Id3 zfpBlock;
+    zfpBlock[0] = regionBlockIdx % RegionBlocks[0];
+    zfpBlock[1] = (regionBlockIdx / RegionBlocks[0]) % RegionBlocks[1];
+    zfpBlock[2] = regionBlockIdx / (RegionBlocks[0] * RegionBlocks[1]);
+    zfpBlock = zfpBlock + RegionStart / vtkm::Id3(4);
+    const vtkm::Id blockIdx = (zfpBlock[2] * ZFPDims[1] + zfpBlock[1]) * ZFPDims[0] + zfpBlock[0];
+
+    Scalar fblock[BlockSize];
+    for (vtkm::Int32 i = 0; i < BlockSize; ++i)
+    {
+      fblock[i] = static_cast<Scalar>(0);
+    }
+    zfp::BlockReader<BlockSize, BitstreamPortal> reader(stream, offsets.Get(blockIdx));
+    zfp::zfp_decode_block<BlockSize>(fblock, MaxBits, MaxPrec, MinExp, reader);
+
+    // keep the values of the block that are inside the region
+    const vtkm::Id3 logicalStart = zfpBlock * vtkm::Id(4);
+    for (vtkm::Id z = 0; z < 4; ++z)
+    {
+      const vtkm::Id rz = logicalStart[2] + z - RegionStart[2];
+      for (vtkm::Id y = 0; y < 4; ++y)
+      {
+        const vtkm::Id ry = logicalStart[1] + y - RegionStart[1];
+        for (vtkm::Id x = 0; x < 4; ++x)
+        {
+          const vtkm::Id rx = logicalStart[0] + x - RegionStart[0];
+          if (rx >= 0 && ry >= 0 && rz >= 0 && rx < RegionDims[0] && ry < RegionDims[1] &&
+              rz < RegionDims[2])
+          {
+            scalars.Set((rz * RegionDims[1] + ry) * RegionDims[0] + rx,
+                        fblock[(z * 4 + y) * 4 + x]);
+          }
+        }
+      }
+    }
+  }
+};
 }
 }
 } // namespace vtkm::worklet::zfp
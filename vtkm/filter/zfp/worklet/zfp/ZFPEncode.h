@@ -281,19 +281,19 @@ VTKM_EXEC void encode_block(BlockWriter<BlockSize, PortalType>& stream,
 }
 
 
-template <vtkm::Int32 BlockSize, typename Scalar, typename PortalType>
-inline VTKM_EXEC void zfp_encodef(Scalar* fblock,
-                                  vtkm::Int32 maxbits,
-                                  vtkm::UInt32 blockIdx,
-                                  PortalType& stream)
+// encodes a block with the given writer and returns the number of bits written
+template <vtkm::Int32 BlockSize, typename Scalar, typename WriterType>
+inline VTKM_EXEC vtkm::UInt32 zfp_encode_block(Scalar* fblock,
+                                               vtkm::Int32 maxbits,
+                                               vtkm::Int32 maxprec,
+                                               vtkm::Int32 minexp,
+                                               WriterType& blockWriter)
 {
   using Int = typename zfp::zfp_traits<Scalar>::Int;
-  zfp::BlockWriter<BlockSize, PortalType> blockWriter(stream, maxbits, vtkm::Id(blockIdx));
   vtkm::Int32 emax = zfp::MaxExponent<BlockSize, Scalar>(fblock);
   //  std::cout<<"EMAX "<<emax<<"\n";
-  vtkm::Int32 maxprec =
-    zfp::precision(emax, zfp::get_precision<Scalar>(), zfp::get_min_exp<Scalar>());
-  vtkm::UInt32 e = vtkm::UInt32(maxprec ? emax + zfp::get_ebias<Scalar>() : 0);
+  vtkm::Int32 blockprec = zfp::precision(emax, maxprec, minexp);
+  vtkm::UInt32 e = vtkm::UInt32(blockprec ? emax + zfp::get_ebias<Scalar>() : 0);
   /* encode block only if biased exponent is nonzero */
   if (e)
   {
@@ -304,8 +304,25 @@ inline VTKM_EXEC void zfp_encodef(Scalar* fblock,
     Int iblock[BlockSize];
     zfp::fwd_cast<Int, Scalar, BlockSize>(iblock, fblock, emax);
 
-    encode_block<BlockSize>(blockWriter, maxbits - vtkm::Int32(ebits), maxprec, iblock);
+    encode_block<BlockSize>(blockWriter, maxbits - vtkm::Int32(ebits), blockprec, iblock);
+  }
+  else
+  {
+    // a single zero bit marks an empty block
+    blockWriter.write_bit(0);
   }
+  return static_cast<vtkm::UInt32>(blockWriter.m_current_bit);
+}
+
+template <vtkm::Int32 BlockSize, typename Scalar, typename PortalType>
+inline VTKM_EXEC void zfp_encodef(Scalar* fblock,
+                                  vtkm::Int32 maxbits,
+                                  vtkm::UInt32 blockIdx,
+                                  PortalType& stream)
+{
+  zfp::BlockWriter<BlockSize, PortalType> blockWriter(stream, maxbits, vtkm::Id(blockIdx));
+  zfp_encode_block<BlockSize>(
+    fblock, maxbits, zfp::get_precision<Scalar>(), zfp::get_min_exp<Scalar>(), blockWriter);
 }
 
 // helpers so we can do partial template instantiation since
@@ -85,6 +85,48 @@ VTKM_EXEC inline void Gather3(Scalar* fblock,
   }     // z
 }
 
+// gathers the values of zfp block blockIdx, padding the blocks that cross the boundary
+template <typename Scalar, typename PortalType>
+VTKM_EXEC inline void GatherBlock3(Scalar* fblock,
+                                   const PortalType& scalars,
+                                   const vtkm::Id3 dims,
+                                   const vtkm::Id3 zfpDims,
+                                   const vtkm::Id blockIdx)
+{
+  vtkm::Id3 zfpBlock;
+  zfpBlock[0] = blockIdx % zfpDims[0];
+  zfpBlock[1] = (blockIdx / zfpDims[0]) % zfpDims[1];
+  zfpBlock[2] = blockIdx / (zfpDims[0] * zfpDims[1]);
+  vtkm::Id3 logicalStart = zfpBlock * vtkm::Id(4);
+
+  // get the offset into the field
+  //vtkm::Id offset = (zfpBlock[2]*4*ZFPDims[1] + zfpBlock[1] * 4)*ZFPDims[0] * 4 + zfpBlock[0] * 4;
+  vtkm::Id offset = (logicalStart[2] * dims[1] + logicalStart[1]) * dims[0] + logicalStart[0];
+
+  bool partial = false;
+  if (logicalStart[0] + 4 > dims[0])
+    partial = true;
+  if (logicalStart[1] + 4 > dims[1])
+    partial = true;
+  if (logicalStart[2] + 4 > dims[2])
+    partial = true;
+  if (partial)
+  {
+    const vtkm::Int32 nx =
+      logicalStart[0] + 4 > dims[0] ? vtkm::Int32(dims[0] - logicalStart[0]) : vtkm::Int32(4);
+    const vtkm::Int32 ny =
+      logicalStart[1] + 4 > dims[1] ? vtkm::Int32(dims[1] - logicalStart[1]) : vtkm::Int32(4);
+    const vtkm::Int32 nz =
+      logicalStart[2] + 4 > dims[2] ? vtkm::Int32(dims[2] - logicalStart[2]) : vtkm::Int32(4);
+
+    GatherPartial3(fblock, scalars, dims, offset, nx, ny, nz);
+  }
+  else
+  {
+    Gather3(fblock, scalars, dims, offset);
+  }
+}
+
 struct Encode3 : public vtkm::worklet::WorkletMapField
 {
 protected:
@@ -113,44 +155,72 @@ public:
     constexpr vtkm::Int32 BlockSize = 64;
     Scalar fblock[BlockSize];
 
-    vtkm::Id3 zfpBlock;
-    zfpBlock[0] = blockIdx % ZFPDims[0];
-    zfpBlock[1] = (blockIdx / ZFPDims[0]) % ZFPDims[1];
-    zfpBlock[2] = blockIdx / (ZFPDims[0] * ZFPDims[1]);
-    vtkm::Id3 logicalStart = zfpBlock * vtkm::Id(4);
-
-    // get the offset into the field
-    //vtkm::Id offset = (zfpBlock[2]*4*ZFPDims[1] + zfpBlock[1] * 4)*ZFPDims[0] * 4 + zfpBlock[0] * 4;
-    vtkm::Id offset = (logicalStart[2] * Dims[1] + logicalStart[1]) * Dims[0] + logicalStart[0];
-
-    bool partial = false;
-    if (logicalStart[0] + 4 > Dims[0])
-      partial = true;
-    if (logicalStart[1] + 4 > Dims[1])
-      partial = true;
-    if (logicalStart[2] + 4 > Dims[2])
-      partial = true;
-    if (partial)
-    {
-      const vtkm::Int32 nx =
-        logicalStart[0] + 4 > Dims[0] ? vtkm::Int32(Dims[0] - logicalStart[0]) : vtkm::Int32(4);
-      const vtkm::Int32 ny =
-        logicalStart[1] + 4 > Dims[1] ? vtkm::Int32(Dims[1] - logicalStart[1]) : vtkm::Int32(4);
-      const vtkm::Int32 nz =
-        logicalStart[2] + 4 > Dims[2] ? vtkm::Int32(Dims[2] - logicalStart[2]) : vtkm::Int32(4);
-
-      GatherPartial3(fblock, scalars, Dims, offset, nx, ny, nz);
-    }
-    else
-    {
-      Gather3(fblock, scalars, Dims, offset);
-    }
+    GatherBlock3(fblock, scalars, Dims, ZFPDims, blockIdx);
 
     zfp::ZFPBlockEncoder<BlockSize, Scalar, BitstreamPortal> encoder;
 
     encoder.encode(fblock, vtkm::Int32(MaxBits), vtkm::UInt32(blockIdx), stream);
   }
 };
+
+// lets a BlockWriter add to the words of a block it owns without atomics
+template <typename PortalType>
+struct ExclusiveBlockPortal
+{
+  PortalType Portal;
+
+  VTKM_EXEC void Add(const vtkm::Id index, const vtkm::Int64 value) const
+  {
+    this->Portal.Set(index, this->Portal.Get(index) + value);
+  }
+};
+
+// Encodes each block into its own slot of the scratch array and outputs the number of bits
+// used. The slots are later packed into a contiguous stream.
+struct EncodeVariable3 : public vtkm::worklet::WorkletMapField
+{
+protected:
+  vtkm::Id3 Dims;       // field dims
+  vtkm::Id3 ZFPDims;    // zfp block dims
+  vtkm::Int32 SlotBits; // bits reserved per block (a multiple of the word size)
+  vtkm::Int32 MinBits;  // minimum bits per block
+  vtkm::Int32 MaxBits;  // maximum bits per block
+  vtkm::Int32 MaxPrec;  // maximum bit planes per block
+  vtkm::Int32 MinExp;   // smallest bit plane kept
+public:
+  EncodeVariable3(const vtkm::Id3 dims, const ZFPStream& stream, const vtkm::UInt32 slotBits)
+    : Dims(dims)
+    , ZFPDims((dims + vtkm::Id3(3)) / vtkm::Id3(4))
+    , SlotBits(vtkm::Int32(slotBits))
+    , MinBits(vtkm::Int32(stream.minbits))
+    , MaxBits(vtkm::Int32(stream.maxbits))
+    , MaxPrec(vtkm::Int32(stream.maxprec))
+    , MinExp(stream.minexp)
+  {
+  }
+  using ControlSignature = void(FieldIn, WholeArrayIn, WholeArrayInOut slots, FieldOut bits);
+
+  template <typename InputScalarPortal, typename SlotsPortal>
+  VTKM_EXEC void operator()(const vtkm::Id blockIdx,
+                            const InputScalarPortal& scalars,
+                            const SlotsPortal& slots,
+                            vtkm::Id& bits) const
+  {
+    using Scalar = typename InputScalarPortal::ValueType;
+    constexpr vtkm::Int32 BlockSize = 64;
+    Scalar fblock[BlockSize];
+
+    GatherBlock3(fblock, scalars, Dims, ZFPDims, blockIdx);
+
+    using WriterPortal = ExclusiveBlockPortal<SlotsPortal>;
+    WriterPortal portal{ slots };
+    zfp::BlockWriter<BlockSize, WriterPortal> writer(portal, SlotBits, blockIdx);
+    const vtkm::UInt32 used = zfp::zfp_encode_block<BlockSize>(
+      fblock, vtkm::Min(MaxBits, SlotBits), MaxPrec, MinExp, writer);
+    // blocks are padded with zeros up to the minimum size
+    bits = vtkm::Max(vtkm::Id(used), vtkm::Id(MinBits));
+  }
+};
 }
 }
 } // namespace vtkm::worklet::zfp
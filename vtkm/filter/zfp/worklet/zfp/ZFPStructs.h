@@ -49,6 +49,38 @@ struct ZFPStream
     minexp = ZFP_MIN_EXP;
     return (double)bits / n;
   }
+
+  // Each block keeps the given number of bit planes. Blocks have a variable number of bits.
+  vtkm::UInt32 SetPrecision(const vtkm::UInt32 precision)
+  {
+    minbits = ZFP_MIN_BITS;
+    maxbits = ZFP_MAX_BITS;
+    maxprec = vtkm::Min(vtkm::Max(precision, 1u), vtkm::UInt32(ZFP_MAX_PREC));
+    minexp = ZFP_MIN_EXP;
+    return maxprec;
+  }
+
+  // Each block keeps the bit planes above the tolerance, so the absolute error stays within
+  // the tolerance. Blocks have a variable number of bits. Returns the tolerance that is used,
+  // which is the largest power of two not above the requested one.
+  vtkm::Float64 SetAccuracy(const vtkm::Float64 tolerance)
+  {
+    vtkm::Int32 emin = ZFP_MIN_EXP;
+    if (tolerance > 0)
+    {
+      // tolerance = x * 2^emin, with 0.5 <= x < 1
+      frexp(tolerance, &emin);
+      emin--;
+    }
+    minbits = ZFP_MIN_BITS;
+    maxbits = ZFP_MAX_BITS;
+    maxprec = ZFP_MAX_PREC;
+    minexp = emin;
+    return tolerance > 0 ? ldexp(1.0, emin) : 0;
+  }
+
+  // fixed-rate streams give each block the same number of bits
+  bool IsFixedRate() const { return minbits == maxbits; }
 };
 }
 }
@@ -84,6 +84,96 @@ inline size_t CalcMem1d(const vtkm::Id dims, const vtkm::UInt32 bits_per_block)
 }
 
 
+// Bits to reserve for each 3D block when the blocks have a variable size. Besides the
+// exponent, each bit plane holds at most one bit per value plus one group test, and each value
+// becomes significant once, which costs at most two more group tests.
+template <typename Scalar>
+inline vtkm::UInt32 CalcSlotBits3d(const ZFPStream& stream)
+{
+  const vtkm::UInt32 vals_per_block = 64;
+  const vtkm::UInt32 bits_per_word = sizeof(ZFPWord) * 8;
+  const vtkm::UInt32 planes = vtkm::Min(stream.maxprec, vtkm::UInt32(CHAR_BIT * sizeof(Scalar)));
+  // MinBits is the size of the exponent
+  vtkm::UInt32 bits = MinBits<Scalar>(0) + planes * (vals_per_block + 1) + 2 * vals_per_block;
+  bits = vtkm::Max(stream.minbits, vtkm::Min(stream.maxbits, bits));
+  return (bits + bits_per_word - 1) / bits_per_word * bits_per_word;
+}
+
+// Packs blocks encoded in slots of SlotWords words into a contiguous stream. Each word of the
+// stream gathers the bits of the blocks that overlap it, so no atomics are needed.
+class PackBlocks : public vtkm::worklet::WorkletMapField
+{
+protected:
+  vtkm::Id SlotWords;
+  vtkm::Id NumBlocks;
+
+public:
+  VTKM_CONT
+  PackBlocks(const vtkm::Id slotWords, const vtkm::Id numBlocks)
+    : SlotWords(slotWords)
+    , NumBlocks(numBlocks)
+  {
+  }
+  using ControlSignature = void(FieldIn blocksAfterWordStart,
+                                WholeArrayIn blockOffsets,
+                                WholeArrayIn blockBits,
+                                WholeArrayIn slots,
+                                FieldOut word);
+  using ExecutionSignature = void(WorkIndex, _1, _2, _3, _4, _5);
+
+  template <typename OffsetsPortal, typename BitsPortal, typename SlotsPortal>
+  VTKM_EXEC void operator()(const vtkm::Id wordIdx,
+                            const vtkm::Id blocksAfterWordStart,
+                            const OffsetsPortal& offsets,
+                            const BitsPortal& blockBits,
+                            const SlotsPortal& slots,
+                            vtkm::Int64& word) const
+  {
+    constexpr vtkm::Id wbits = sizeof(ZFPWord) * 8;
+    const vtkm::Id wordStart = wordIdx * wbits;
+    const vtkm::Id wordEnd = wordStart + wbits;
+    ZFPWord value = 0;
+    // the last block starting at or before the word
+    for (vtkm::Id block = blocksAfterWordStart - 1;
+         block < NumBlocks && offsets.Get(block) < wordEnd;
+         ++block)
+    {
+      const vtkm::Id blockStart = offsets.Get(block);
+      const vtkm::Id begin = vtkm::Max(blockStart, wordStart);
+      const vtkm::Id end = vtkm::Min(blockStart + blockBits.Get(block), wordEnd);
+      if (end > begin)
+      {
+        value |= ReadBits(slots, block * SlotWords, begin - blockStart, end - begin)
+          << (begin - wordStart);
+      }
+    }
+    word = static_cast<vtkm::Int64>(value);
+  }
+
+private:
+  // reads n_bits (at most a word) starting at bit of the slot starting at word slotStart
+  template <typename SlotsPortal>
+  VTKM_EXEC static ZFPWord ReadBits(const SlotsPortal& slots,
+                                    const vtkm::Id slotStart,
+                                    const vtkm::Id bit,
+                                    const vtkm::Id n_bits)
+  {
+    constexpr vtkm::Id wbits = sizeof(ZFPWord) * 8;
+    const vtkm::Id index = slotStart + bit / wbits;
+    const vtkm::Id shift = bit % wbits;
+    ZFPWord value = static_cast<ZFPWord>(slots.Get(index)) >> shift;
+    if (shift > 0 && shift + n_bits > wbits)
+    {
+      value |= static_cast<ZFPWord>(slots.Get(index + 1)) << (wbits - shift);
+    }
+    if (n_bits < wbits)
+    {
+      value &= (ZFPWord(1) << n_bits) - 1;
+    }
+    return value;
+  }
+};
+
 template <typename T>
 T* GetVTKMPointer(vtkm::cont::ArrayHandle<T>& handle)
 {
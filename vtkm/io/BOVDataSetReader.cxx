@@ -19,38 +19,35 @@
 namespace
 {
 
-enum class DataFormat
-{
-  ByteData,
-  ShortData,
-  IntegerData,
-  FloatData,
-  DoubleData
-};
-
 template <typename T>
-void ReadBuffer(const std::string& fName, const vtkm::Id& sz, std::vector<T>& buff)
+void ReadBuffer(const std::string& fName,
+                const vtkm::Id& offset,
+                const vtkm::Id& sz,
+                std::vector<T>& buff)
 {
-  FILE* fp = fopen(fName.c_str(), "rb");
-  size_t readSize = static_cast<size_t>(sz);
-  if (fp == nullptr)
+  std::ifstream stream(fName, std::ios_base::in | std::ios_base::binary);
+  if (!stream.is_open())
   {
     throw vtkm::io::ErrorIO("Unable to open data file: " + fName);
   }
-  buff.resize(readSize);
-  size_t nread = fread(&buff[0], sizeof(T), readSize, fp);
-  if (nread != readSize)
+  buff.resize(static_cast<size_t>(sz));
+  stream.seekg(static_cast<std::streamoff>(offset) * static_cast<std::streamoff>(sizeof(T)));
+  stream.read(reinterpret_cast<char*>(buff.data()),
+              static_cast<std::streamsize>(sz) * static_cast<std::streamsize>(sizeof(T)));
+  if (!stream)
   {
     throw vtkm::io::ErrorIO("Data file read failed: " + fName);
   }
-  fclose(fp);
 }
 
 template <typename T>
-void ReadScalar(const std::string& fName, const vtkm::Id& nTuples, vtkm::cont::ArrayHandle<T>& var)
+void ReadScalar(const std::string& fName,
+                const vtkm::Id& firstTuple,
+                const vtkm::Id& nTuples,
+                vtkm::cont::ArrayHandle<T>& var)
 {
   std::vector<T> buff;
-  ReadBuffer(fName, nTuples, buff);
+  ReadBuffer(fName, firstTuple, nTuples, buff);
   var.Allocate(nTuples);
   auto writePortal = var.WritePortal();
   for (vtkm::Id i = 0; i < nTuples; i++)
@@ -61,11 +58,12 @@ void ReadScalar(const std::string& fName, const vtkm::Id& nTuples, vtkm::cont::A
 
 template <typename T>
 void ReadVector(const std::string& fName,
+                const vtkm::Id& firstTuple,
                 const vtkm::Id& nTuples,
                 vtkm::cont::ArrayHandle<vtkm::Vec<T, 3>>& var)
 {
   std::vector<T> buff;
-  ReadBuffer(fName, nTuples * 3, buff);
+  ReadBuffer(fName, firstTuple * 3, nTuples * 3, buff);
 
   var.Allocate(nTuples);
   vtkm::Vec<T, 3> v;
@@ -114,11 +112,37 @@ const vtkm::cont::DataSet& BOVDataSetReader::ReadDataSet()
   return this->DataSet;
 }
 
+vtkm::Id3 BOVDataSetReader::GetPointDimensions()
+{
+  this->ReadHeader();
+  return this->Dimensions;
+}
+
+vtkm::cont::DataSet BOVDataSetReader::ReadSlab(vtkm::Id firstSlice, vtkm::Id numSlices)
+{
+  this->ReadHeader();
+  if ((firstSlice < 0) || (numSlices < 1) || (firstSlice + numSlices > this->Dimensions[2]))
+  {
+    throw vtkm::io::ErrorIO("Requested slices are outside of the volume in " + this->FileName);
+  }
+  return this->LoadSlices(firstSlice, numSlices);
+}
+
 void BOVDataSetReader::LoadFile()
 {
   if (this->Loaded)
     return;
 
+  this->ReadHeader();
+  this->DataSet = this->LoadSlices(0, this->Dimensions[2]);
+  this->Loaded = true;
+}
+
+void BOVDataSetReader::ReadHeader()
+{
+  if (this->HeaderRead)
+    return;
+
   std::ifstream stream(this->FileName);
   if (stream.fail())
     throw vtkm::io::ErrorIO("Failed to open file: " + this->FileName);
@@ -211,43 +235,61 @@ void BOVDataSetReader::LoadFile()
   else
     fullPathDataFile = bovFile;
 
+  this->DataFileName = fullPathDataFile;
+  this->Format = dataFormat;
+  this->NumberOfComponents = numComponents;
+  this->Dimensions = dim;
+  this->Origin = origin;
+  this->Spacing = spacing;
+  this->VariableName = variableName;
+  this->HeaderRead = true;
+}
+
+vtkm::cont::DataSet BOVDataSetReader::LoadSlices(vtkm::Id firstSlice, vtkm::Id numSlices)
+{
+  const vtkm::Id3 dim(this->Dimensions[0], this->Dimensions[1], numSlices);
+  vtkm::Vec3f origin = this->Origin;
+  origin[2] += static_cast<vtkm::FloatDefault>(firstSlice) * this->Spacing[2];
 
   vtkm::cont::DataSetBuilderUniform dataSetBuilder;
-  this->DataSet = dataSetBuilder.Create(dim, origin, spacing);
+  vtkm::cont::DataSet dataSet = dataSetBuilder.Create(dim, origin, this->Spacing);
 
+  const std::string& fullPathDataFile = this->DataFileName;
+  const std::string& variableName = this->VariableName;
+  const vtkm::Id firstTuple = firstSlice * dim[0] * dim[1];
   vtkm::Id numTuples = dim[0] * dim[1] * dim[2];
-  if (numComponents == 1)
+  if (this->NumberOfComponents == 1)
   {
-    if (dataFormat == DataFormat::FloatData)
+    if (this->Format == DataFormat::FloatData)
     {
       vtkm::cont::ArrayHandle<vtkm::Float32> var;
-      ReadScalar(fullPathDataFile, numTuples, var);
-      this->DataSet.AddPointField(variableName, var);
+      ReadScalar(fullPathDataFile, firstTuple, numTuples, var);
+      dataSet.AddPointField(variableName, var);
     }
-    else if (dataFormat == DataFormat::DoubleData)
+    else if (this->Format == DataFormat::DoubleData)
     {
       vtkm::cont::ArrayHandle<vtkm::Float64> var;
-      ReadScalar(fullPathDataFile, numTuples, var);
-      this->DataSet.AddPointField(variableName, var);
+      ReadScalar(fullPathDataFile, firstTuple, numTuples, var);
+      dataSet.AddPointField(variableName, var);
     }
   }
-  else if (numComponents == 3)
+  else if (this->NumberOfComponents == 3)
   {
-    if (dataFormat == DataFormat::FloatData)
+    if (this->Format == DataFormat::FloatData)
     {
       vtkm::cont::ArrayHandle<vtkm::Vec3f_32> var;
-      ReadVector(fullPathDataFile, numTuples, var);
-      this->DataSet.AddPointField(variableName, var);
+      ReadVector(fullPathDataFile, firstTuple, numTuples, var);
+      dataSet.AddPointField(variableName, var);
     }
-    else if (dataFormat == DataFormat::DoubleData)
+    else if (this->Format == DataFormat::DoubleData)
     {
       vtkm::cont::ArrayHandle<vtkm::Vec3f_64> var;
-      ReadVector(fullPathDataFile, numTuples, var);
-      this->DataSet.AddPointField(variableName, var);
+      ReadVector(fullPathDataFile, firstTuple, numTuples, var);
+      dataSet.AddPointField(variableName, var);
     }
   }
 
-  this->Loaded = true;
+  return dataSet;
 }
 }
 } // namespace vtkm::io
@@ -27,12 +27,42 @@ public:
 
   VTKM_CONT const vtkm::cont::DataSet& ReadDataSet();
 
+  /// Returns the number of points along each axis of the volume. Only the header is read.
+  VTKM_CONT vtkm::Id3 GetPointDimensions();
+
+  /// \brief Reads the k-slices [`firstSlice`, `firstSlice + numSlices`) of the volume.
+  ///
+  /// Only the requested slices are read from the data file. The returned data set is a uniform
+  /// grid placed where the slices are in the whole volume. This makes it possible to process
+  /// volumes that do not fit in memory one slab at a time.
+  VTKM_CONT vtkm::cont::DataSet ReadSlab(vtkm::Id firstSlice, vtkm::Id numSlices);
+
 private:
+  enum class DataFormat
+  {
+    ByteData,
+    ShortData,
+    IntegerData,
+    FloatData,
+    DoubleData
+  };
+
+  VTKM_CONT void ReadHeader();
   VTKM_CONT void LoadFile();
+  VTKM_CONT vtkm::cont::DataSet LoadSlices(vtkm::Id firstSlice, vtkm::Id numSlices);
 
   std::string FileName;
   bool Loaded;
   vtkm::cont::DataSet DataSet;
+
+  bool HeaderRead = false;
+  std::string DataFileName;
+  DataFormat Format = DataFormat::ByteData;
+  vtkm::Id NumberOfComponents = 1;
+  vtkm::Id3 Dimensions;
+  vtkm::Vec3f Origin;
+  vtkm::Vec3f Spacing;
+  std::string VariableName;
 };
 }
 } // vtkm::io
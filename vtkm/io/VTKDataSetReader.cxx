@@ -47,6 +47,31 @@ void VTKDataSetReader::PrintSummary(std::ostream& out) const
   }
 }
 
+std::vector<std::string> VTKDataSetReader::GetLazyFieldNames() const
+{
+  if (this->Reader)
+  {
+    return this->Reader->GetLazyFieldNames();
+  }
+  else
+  {
+    return VTKDataSetReaderBase::GetLazyFieldNames();
+  }
+}
+
+const vtkm::cont::Field& VTKDataSetReader::LoadField(const std::string& name,
+                                                     vtkm::cont::Field::Association association)
+{
+  if (!this->Reader)
+  {
+    return VTKDataSetReaderBase::LoadField(name, association);
+  }
+
+  const vtkm::cont::Field& field = this->Reader->LoadField(name, association);
+  this->DataSet.AddField(field);
+  return this->DataSet.GetField(field.GetName(), field.GetAssociation());
+}
+
 void VTKDataSetReader::CloseFile()
 {
   if (this->Reader)
@@ -29,6 +29,12 @@ public:
 
   VTKM_CONT void PrintSummary(std::ostream& out) const override;
 
+  VTKM_CONT std::vector<std::string> GetLazyFieldNames() const override;
+
+  VTKM_CONT const vtkm::cont::Field& LoadField(
+    const std::string& name,
+    vtkm::cont::Field::Association association = vtkm::cont::Field::Association::Any) override;
+
 private:
   VTKM_CONT void CloseFile() override;
   VTKM_CONT void Read() override;
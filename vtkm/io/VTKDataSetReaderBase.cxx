@@ -10,16 +10,21 @@
 
 #include <vtkm/io/VTKDataSetReaderBase.h>
 
+#include <vtkm/Math.h>
 #include <vtkm/VecTraits.h>
 #include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleFileMapped.h>
 #include <vtkm/cont/ArrayHandleOffsetsToNumComponents.h>
 #include <vtkm/cont/ArrayHandleRuntimeVec.h>
 #include <vtkm/cont/ArrayPortalToIterators.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/Logging.h>
 #include <vtkm/cont/UnknownArrayHandle.h>
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -36,12 +41,55 @@ inline void PrintVTKDataFileSummary(const vtkm::io::internal::VTKDataSetFile& df
       << std::endl;
 }
 
+struct MappedFileContainer
+{
+  std::shared_ptr<vtkm::cont::internal::BufferInfo> File;
+  // Set once the array has been reallocated out of the mapped file.
+  void* HostMemory = nullptr;
+};
+
 } // anonymous namespace
 
 namespace vtkm
 {
 namespace io
 {
+namespace internal
+{
+
+void* NewMappedFileContainer(const std::shared_ptr<vtkm::cont::internal::BufferInfo>& file)
+{
+  return new MappedFileContainer{ file, nullptr };
+}
+
+void MappedFileDeleter(void* container)
+{
+  MappedFileContainer* mapped = reinterpret_cast<MappedFileContainer*>(container);
+  vtkm::cont::internal::HostDeleter(mapped->HostMemory);
+  delete mapped;
+}
+
+void MappedFileReallocater(void*& memory,
+                           void*& container,
+                           vtkm::BufferSizeType oldSize,
+                           vtkm::BufferSizeType newSize)
+{
+  MappedFileContainer* mapped = reinterpret_cast<MappedFileContainer*>(container);
+
+  void* newMemory = vtkm::cont::internal::HostAllocate(newSize);
+  if ((memory != nullptr) && (newMemory != nullptr))
+  {
+    std::memcpy(newMemory, memory, static_cast<std::size_t>(vtkm::Min(oldSize, newSize)));
+  }
+
+  vtkm::cont::internal::HostDeleter(mapped->HostMemory);
+  mapped->HostMemory = newMemory;
+  mapped->File.reset();
+
+  memory = newMemory;
+}
+
+} // namespace internal
 
 VTKDataSetReaderBase::VTKDataSetReaderBase(const char* fileName)
   : DataFile(new internal::VTKDataSetFile)
@@ -90,6 +138,55 @@ void VTKDataSetReaderBase::PrintSummary(std::ostream& out) const
   this->DataSet.PrintSummary(out);
 }
 
+std::vector<std::string> VTKDataSetReaderBase::GetLazyFieldNames() const
+{
+  std::vector<std::string> names;
+  if (this->DataFile)
+  {
+    for (const internal::VTKLazyField& field : this->DataFile->LazyFields)
+    {
+      names.push_back(field.Name);
+    }
+  }
+  return names;
+}
+
+const vtkm::cont::Field& VTKDataSetReaderBase::LoadField(const std::string& name,
+                                                         vtkm::cont::Field::Association association)
+{
+  if (this->DataFile)
+  {
+    std::vector<internal::VTKLazyField>& lazyFields = this->DataFile->LazyFields;
+    auto field = std::find_if(
+      lazyFields.begin(), lazyFields.end(), [&](const internal::VTKLazyField& candidate) {
+        return (candidate.Name == name) &&
+          ((association == vtkm::cont::Field::Association::Any) ||
+           (candidate.Association == association));
+      });
+    if (field != lazyFields.end())
+    {
+      vtkm::cont::UnknownArrayHandle data =
+        this->DoReadMappedArrayVariant(field->Association,
+                                       field->DataType,
+                                       field->Offset,
+                                       field->NumElements,
+                                       field->NumComponents);
+      vtkm::cont::Field::Association fieldAssociation = field->Association;
+      lazyFields.erase(field);
+      if (lazyFields.empty())
+      {
+        // Arrays using the mapping directly keep it alive on their own.
+        this->DataFile->MappedFile.reset();
+      }
+
+      this->AddField(name, fieldAssociation, data);
+      return this->DataSet.GetField(name, fieldAssociation);
+    }
+  }
+
+  throw vtkm::io::ErrorIO("No field named '" + name + "' is waiting to be loaded.");
+}
+
 void VTKDataSetReaderBase::ReadPoints()
 {
   std::string dataType;
@@ -261,6 +358,10 @@ void VTKDataSetReaderBase::ReadAttributes()
 void VTKDataSetReaderBase::CloseFile()
 {
   this->DataFile->Stream.close();
+  if (this->DataFile->LazyFields.empty())
+  {
+    this->DataFile->MappedFile.reset();
+  }
 }
 
 void VTKDataSetReaderBase::OpenFile()
@@ -332,6 +433,26 @@ void VTKDataSetReaderBase::ReadHeader()
   {
     throw vtkm::io::ErrorIO("Unsupported DataSet type.");
   }
+
+  if (this->UseMemoryMapping)
+  {
+    try
+    {
+      // The mapping is private, so arrays using it can be modified without changing the file.
+      auto mappedFile = std::make_shared<vtkm::cont::internal::BufferInfo>(
+        vtkm::cont::internal::MapFile(this->DataFile->FileName, vtkm::cont::FileMapMode::Read, -1));
+      if (mappedFile->GetPointer() != nullptr)
+      {
+        this->DataFile->MappedFile = mappedFile;
+      }
+    }
+    catch (vtkm::cont::ErrorBadValue& error)
+    {
+      VTKM_LOG_S(vtkm::cont::LogLevel::Info,
+                 "Could not memory map " << this->DataFile->FileName
+                                         << ". Using stream reads: " << error.GetMessage());
+    }
+  }
 }
 
 
@@ -358,6 +479,31 @@ void VTKDataSetReaderBase::AddField(const std::string& name,
   }
 }
 
+void VTKDataSetReaderBase::ReadFieldArray(const std::string& name,
+                                          vtkm::cont::Field::Association association,
+                                          const std::string& dataType,
+                                          std::size_t numElements,
+                                          vtkm::IdComponent numComponents)
+{
+  vtkm::io::internal::DataType typeId = vtkm::io::internal::DataTypeId(dataType);
+  if (this->LazyFieldLoading && this->DataFile->IsBinary && this->DataFile->MappedFile &&
+      ((association == vtkm::cont::Field::Association::Points) ||
+       (association == vtkm::cont::Field::Association::Cells)) &&
+      (typeId != vtkm::io::internal::DTYPE_UNKNOWN) && (typeId != vtkm::io::internal::DTYPE_BIT))
+  {
+    std::size_t offset = static_cast<std::size_t>(this->DataFile->Stream.tellg());
+    this->DataFile->LazyFields.push_back(
+      { name, association, dataType, offset, numElements, numComponents });
+    this->DoSkipArrayVariant(dataType, numElements, numComponents);
+  }
+  else
+  {
+    vtkm::cont::UnknownArrayHandle data =
+      this->DoReadArrayVariant(association, dataType, numElements, numComponents);
+    this->AddField(name, association, data);
+  }
+}
+
 void VTKDataSetReaderBase::ReadScalars(vtkm::cont::Field::Association association,
                                        std::size_t numElements)
 {
@@ -382,9 +528,7 @@ void VTKDataSetReaderBase::ReadScalars(vtkm::cont::Field::Association associatio
   internal::parseAssert(tag == "LOOKUP_TABLE");
   this->DataFile->Stream >> lookupTableName >> std::ws;
 
-  vtkm::cont::UnknownArrayHandle data =
-    this->DoReadArrayVariant(association, dataType, numElements, numComponents);
-  this->AddField(dataName, association, data);
+  this->ReadFieldArray(dataName, association, dataType, numElements, numComponents);
 }
 
 void VTKDataSetReaderBase::ReadColorScalars(vtkm::cont::Field::Association association,
@@ -396,9 +540,7 @@ void VTKDataSetReaderBase::ReadColorScalars(vtkm::cont::Field::Association assoc
   vtkm::IdComponent numComponents;
   this->DataFile->Stream >> dataName >> numComponents >> std::ws;
   std::string dataType = this->DataFile->IsBinary ? "unsigned_char" : "float";
-  vtkm::cont::UnknownArrayHandle data =
-    this->DoReadArrayVariant(association, dataType, numElements, numComponents);
-  this->AddField(dataName, association, data);
+  this->ReadFieldArray(dataName, association, dataType, numElements, numComponents);
 }
 
 void VTKDataSetReaderBase::ReadLookupTable()
@@ -419,9 +561,7 @@ void VTKDataSetReaderBase::ReadTextureCoordinates(vtkm::cont::Field::Association
   std::string dataType;
   this->DataFile->Stream >> dataName >> numComponents >> dataType >> std::ws;
 
-  vtkm::cont::UnknownArrayHandle data =
-    this->DoReadArrayVariant(association, dataType, numElements, numComponents);
-  this->AddField(dataName, association, data);
+  this->ReadFieldArray(dataName, association, dataType, numElements, numComponents);
 }
 
 void VTKDataSetReaderBase::ReadVectors(vtkm::cont::Field::Association association,
@@ -431,9 +571,7 @@ void VTKDataSetReaderBase::ReadVectors(vtkm::cont::Field::Association associatio
   std::string dataType;
   this->DataFile->Stream >> dataName >> dataType >> std::ws;
 
-  vtkm::cont::UnknownArrayHandle data =
-    this->DoReadArrayVariant(association, dataType, numElements, 3);
-  this->AddField(dataName, association, data);
+  this->ReadFieldArray(dataName, association, dataType, numElements, 3);
 }
 
 void VTKDataSetReaderBase::ReadTensors(vtkm::cont::Field::Association association,
@@ -443,9 +581,7 @@ void VTKDataSetReaderBase::ReadTensors(vtkm::cont::Field::Association associatio
   std::string dataType;
   this->DataFile->Stream >> dataName >> dataType >> std::ws;
 
-  vtkm::cont::UnknownArrayHandle data =
-    this->DoReadArrayVariant(association, dataType, numElements, 9);
-  this->AddField(dataName, association, data);
+  this->ReadFieldArray(dataName, association, dataType, numElements, 9);
 }
 
 void VTKDataSetReaderBase::ReadFields(vtkm::cont::Field::Association association,
@@ -462,9 +598,7 @@ void VTKDataSetReaderBase::ReadFields(vtkm::cont::Field::Association association
     this->DataFile->Stream >> arrayName >> numComponents >> numTuples >> dataType >> std::ws;
     if (numTuples == expectedNumElements)
     {
-      vtkm::cont::UnknownArrayHandle data =
-        this->DoReadArrayVariant(association, dataType, numTuples, numComponents);
-      this->AddField(arrayName, association, data);
+      this->ReadFieldArray(arrayName, association, dataType, numTuples, numComponents);
     }
     else
     {
@@ -547,24 +681,27 @@ public:
                    vtkm::cont::Field::Association association,
                    std::size_t numElements,
                    vtkm::IdComponent numComponents,
-                   vtkm::cont::UnknownArrayHandle& data)
+                   vtkm::cont::UnknownArrayHandle& data,
+                   std::size_t mappedOffset = NotMapped)
     : SkipArrayVariant(reader, numElements, numComponents)
     , Association(association)
     , NumComponents(numComponents)
     , Data(&data)
+    , MappedOffset(mappedOffset)
   {
   }
 
   template <typename T>
   void operator()(T) const
   {
-    std::vector<T> buffer(this->TotalSize);
-    this->Reader->ReadArray(buffer);
+    vtkm::cont::ArrayHandle<T> array = (this->MappedOffset == NotMapped)
+      ? this->Reader->ReadArrayHandle(this->TotalSize, T())
+      : this->Reader->ReadMappedArray<T>(this->MappedOffset, this->TotalSize);
     if ((this->Association != vtkm::cont::Field::Association::Cells) ||
-        (this->Reader->GetCellsPermutation().GetNumberOfValues() < 1))
+        (this->Reader->GetCellsPermutation().GetNumberOfValues() < 1) ||
+        (array.GetNumberOfValues() < 1))
     {
-      *this->Data =
-        vtkm::cont::make_ArrayHandleRuntimeVecMove(this->NumComponents, std::move(buffer));
+      *this->Data = vtkm::cont::make_ArrayHandleRuntimeVec(this->NumComponents, array);
     }
     else
     {
@@ -572,23 +709,34 @@ public:
       // data due to differences between VTK and VTK-m cell shapes.
       auto permutation = this->Reader->GetCellsPermutation().ReadPortal();
       vtkm::Id outSize = permutation.GetNumberOfValues();
-      std::vector<T> permutedBuffer(static_cast<std::size_t>(outSize));
+      vtkm::cont::ArrayHandle<T> permutedArray;
+      permutedArray.Allocate(outSize * this->NumComponents);
+      auto inPortal = array.ReadPortal();
+      auto outPortal = permutedArray.WritePortal();
       for (vtkm::Id outIndex = 0; outIndex < outSize; outIndex++)
       {
-        std::size_t inIndex = static_cast<std::size_t>(permutation.Get(outIndex));
-        permutedBuffer[static_cast<std::size_t>(outIndex)] = buffer[inIndex];
+        vtkm::Id inIndex = permutation.Get(outIndex);
+        for (vtkm::IdComponent component = 0; component < this->NumComponents; ++component)
+        {
+          outPortal.Set(outIndex * this->NumComponents + component,
+                        inPortal.Get(inIndex * this->NumComponents + component));
+        }
       }
-      *this->Data =
-        vtkm::cont::make_ArrayHandleRuntimeVecMove(this->NumComponents, std::move(permutedBuffer));
+      *this->Data = vtkm::cont::make_ArrayHandleRuntimeVec(this->NumComponents, permutedArray);
     }
   }
 
+  static constexpr std::size_t NotMapped = std::numeric_limits<std::size_t>::max();
+
 private:
   vtkm::cont::Field::Association Association;
   vtkm::IdComponent NumComponents;
   vtkm::cont::UnknownArrayHandle* Data;
+  std::size_t MappedOffset;
 };
 
+constexpr std::size_t VTKDataSetReaderBase::ReadArrayVariant::NotMapped;
+
 void VTKDataSetReaderBase::DoSkipArrayVariant(std::string dataType,
                                               std::size_t numElements,
                                               vtkm::IdComponent numComponents)
@@ -635,6 +783,30 @@ vtkm::cont::UnknownArrayHandle VTKDataSetReaderBase::DoReadArrayVariant(
   return data;
 }
 
+vtkm::cont::UnknownArrayHandle VTKDataSetReaderBase::DoReadMappedArrayVariant(
+  vtkm::cont::Field::Association association,
+  std::string dataType,
+  std::size_t offset,
+  std::size_t numElements,
+  vtkm::IdComponent numComponents)
+{
+  VTKM_ASSERT(this->DataFile->MappedFile);
+  vtkm::cont::UnknownArrayHandle data;
+  vtkm::io::internal::DataType typeId = vtkm::io::internal::DataTypeId(dataType);
+  vtkm::io::internal::SelectTypeAndCall(
+    typeId, ReadArrayVariant(this, association, numElements, numComponents, data, offset));
+  return data;
+}
+
+vtkm::cont::ArrayHandle<vtkm::io::internal::DummyBitType> VTKDataSetReaderBase::ReadArrayHandle(
+  std::size_t numElements,
+  vtkm::io::internal::DummyBitType)
+{
+  std::vector<vtkm::io::internal::DummyBitType> buffer(numElements);
+  this->ReadArray(buffer);
+  return vtkm::cont::make_ArrayHandleMove(std::move(buffer));
+}
+
 void VTKDataSetReaderBase::ReadArray(std::vector<vtkm::io::internal::DummyBitType>& buffer)
 {
   VTKM_LOG_S(vtkm::cont::LogLevel::Warn,
@@ -11,16 +11,24 @@
 #define vtk_m_io_VTKDataSetReaderBase_h
 
 #include <vtkm/Types.h>
+#include <vtkm/VecTraits.h>
+#include <vtkm/cont/ArrayHandleBasic.h>
 #include <vtkm/cont/DataSet.h>
+#include <vtkm/cont/internal/DeviceAdapterMemoryManager.h>
 #include <vtkm/io/ErrorIO.h>
 #include <vtkm/io/vtkm_io_export.h>
 
 #include <vtkm/io/internal/Endian.h>
+#include <vtkm/io/internal/ParseASCII.h>
 #include <vtkm/io/internal/VTKDataSetStructures.h>
 #include <vtkm/io/internal/VTKDataSetTypes.h>
 
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <sstream>
+#include <type_traits>
+#include <vector>
 
 namespace vtkm
 {
@@ -30,6 +38,17 @@ namespace io
 namespace internal
 {
 
+/// Location of a field array in a binary file that has not been read yet.
+struct VTKLazyField
+{
+  std::string Name;
+  vtkm::cont::Field::Association Association;
+  std::string DataType;
+  std::size_t Offset;
+  std::size_t NumElements;
+  vtkm::IdComponent NumComponents;
+};
+
 struct VTKDataSetFile
 {
   std::string FileName;
@@ -38,8 +57,43 @@ struct VTKDataSetFile
   bool IsBinary;
   vtkm::io::internal::DataSetStructure Structure;
   std::ifstream Stream;
+  std::shared_ptr<vtkm::cont::internal::BufferInfo> MappedFile;
+  std::vector<VTKLazyField> LazyFields;
 };
 
+/// Returns a container for `MakeArrayFromMappedFile` that keeps `file` mapped.
+VTKM_IO_EXPORT void* NewMappedFileContainer(
+  const std::shared_ptr<vtkm::cont::internal::BufferInfo>& file);
+/// Deleter of the containers returned by `NewMappedFileContainer`.
+VTKM_IO_EXPORT void MappedFileDeleter(void* container);
+/// Reallocater of arrays created by `MakeArrayFromMappedFile`. The data are copied to regular
+/// host memory and the mapping is released by the array.
+VTKM_IO_EXPORT void MappedFileReallocater(void*& memory,
+                                          void*& container,
+                                          vtkm::BufferSizeType oldSize,
+                                          vtkm::BufferSizeType newSize);
+
+/// \brief Creates an array that directly uses the memory of a file mapped with
+/// `vtkm::cont::internal::MapFile`.
+///
+/// The array holds `numValues` values of type `T` starting `offset` bytes into the file. No data
+/// are copied, and the array keeps the file mapped for as long as it exists. The caller is
+/// responsible for making sure that the data are properly aligned for `T` and in native byte
+/// order.
+///
+template <typename T>
+vtkm::cont::ArrayHandleBasic<T> MakeArrayFromMappedFile(
+  const std::shared_ptr<vtkm::cont::internal::BufferInfo>& file,
+  std::size_t offset,
+  vtkm::Id numValues)
+{
+  VTKM_ASSERT(offset + static_cast<std::size_t>(numValues) * sizeof(T) <=
+              static_cast<std::size_t>(file->GetSize()));
+  T* array = reinterpret_cast<T*>(static_cast<vtkm::UInt8*>(file->GetPointer()) + offset);
+  return vtkm::cont::ArrayHandleBasic<T>(
+    array, NewMappedFileContainer(file), numValues, MappedFileDeleter, MappedFileReallocater);
+}
+
 inline void parseAssert(bool condition)
 {
   if (!condition)
@@ -102,6 +156,8 @@ protected:
 
 private:
   bool Loaded;
+  bool UseMemoryMapping = true;
+  bool LazyFieldLoading = false;
   vtkm::cont::ArrayHandle<vtkm::Id> CellsPermutation;
 
   friend class VTKDataSetReader;
@@ -122,6 +178,37 @@ public:
 
   virtual VTKM_CONT void PrintSummary(std::ostream& out) const;
 
+  /// \brief Read files through a memory mapping of the file.
+  ///
+  /// When on (the default), arrays are read directly from a memory mapping of the file instead of
+  /// being extracted through the stream. For `BINARY` files, arrays that do not need a byte swap
+  /// (single byte types, or all types on big-endian hosts) and are suitably aligned use the mapped
+  /// pages without any copy. Other arrays are byte swapped in parallel. For `ASCII` files, the
+  /// text of each array is split into chunks that are parsed on multiple threads. If the file
+  /// cannot be mapped, the reader falls back to stream reads.
+  VTKM_CONT void SetUseMemoryMapping(bool flag) { this->UseMemoryMapping = flag; }
+  VTKM_CONT bool GetUseMemoryMapping() const { return this->UseMemoryMapping; }
+
+  /// \brief Defer reading point and cell fields until they are requested.
+  ///
+  /// When on, the point and cell fields of a memory mapped `BINARY` file are not read by
+  /// `ReadDataSet`. Instead, their location in the file is recorded and the field can be loaded
+  /// later with `LoadField`. The file stays mapped while there are fields left to load. This
+  /// option has no effect if the file is ASCII or cannot be mapped. Off by default.
+  VTKM_CONT void SetLazyFieldLoading(bool flag) { this->LazyFieldLoading = flag; }
+  VTKM_CONT bool GetLazyFieldLoading() const { return this->LazyFieldLoading; }
+
+  /// Returns the names of the fields that were deferred by lazy field loading and not yet loaded.
+  virtual VTKM_CONT std::vector<std::string> GetLazyFieldNames() const;
+
+  /// \brief Loads a field deferred by lazy field loading.
+  ///
+  /// The field is added to the data set returned by `GetDataSet` and returned. An `ErrorIO` is
+  /// thrown if there is no deferred field with the given name and association.
+  virtual VTKM_CONT const vtkm::cont::Field& LoadField(
+    const std::string& name,
+    vtkm::cont::Field::Association association = vtkm::cont::Field::Association::Any);
+
 protected:
   VTKM_CONT void ReadPoints();
 
@@ -146,6 +233,8 @@ protected:
   {
     reader.DataFile.swap(this->DataFile);
     this->DataFile.reset(nullptr);
+    reader.UseMemoryMapping = this->UseMemoryMapping;
+    reader.LazyFieldLoading = this->LazyFieldLoading;
   }
 
   VTKM_CONT virtual void CloseFile();
@@ -158,6 +247,11 @@ private:
   VTKM_CONT void AddField(const std::string& name,
                           vtkm::cont::Field::Association association,
                           vtkm::cont::UnknownArrayHandle& data);
+  VTKM_CONT void ReadFieldArray(const std::string& name,
+                                vtkm::cont::Field::Association association,
+                                const std::string& dataType,
+                                std::size_t numElements,
+                                vtkm::IdComponent numComponents);
   VTKM_CONT void ReadScalars(vtkm::cont::Field::Association association, std::size_t numElements);
   VTKM_CONT void ReadColorScalars(vtkm::cont::Field::Association association,
                                   std::size_t numElements);
@@ -189,6 +283,12 @@ protected:
     std::string dataType,
     std::size_t numElements,
     vtkm::IdComponent numComponents);
+  VTKM_CONT vtkm::cont::UnknownArrayHandle DoReadMappedArrayVariant(
+    vtkm::cont::Field::Association association,
+    std::string dataType,
+    std::size_t offset,
+    std::size_t numElements,
+    vtkm::IdComponent numComponents);
 
   template <typename T>
   VTKM_CONT void ReadArray(std::vector<T>& buffer)
@@ -206,6 +306,10 @@ protected:
         vtkm::io::internal::FlipEndianness(buffer);
       }
     }
+    else if (this->DataFile->MappedFile && std::is_arithmetic<ComponentType>::value)
+    {
+      this->ParseMappedArray(buffer.data(), numElements);
+    }
     else
     {
       for (std::size_t i = 0; i < numElements; ++i)
@@ -222,6 +326,97 @@ protected:
     this->SkipArrayMetaData(numComponents);
   }
 
+  /// Reads `numElements` values of type `T` into a new array. Binary files that are memory mapped
+  /// are read directly from the mapping.
+  template <typename T>
+  VTKM_CONT vtkm::cont::ArrayHandle<T> ReadArrayHandle(std::size_t numElements, T)
+  {
+    if (this->DataFile->IsBinary && this->DataFile->MappedFile)
+    {
+      std::size_t offset = static_cast<std::size_t>(this->DataFile->Stream.tellg());
+      vtkm::cont::ArrayHandle<T> array = this->ReadMappedArray<T>(offset, numElements);
+      this->DataFile->Stream.seekg(static_cast<std::streamoff>(numElements * sizeof(T)),
+                                   std::ios_base::cur);
+      this->DataFile->Stream >> std::ws;
+      this->SkipArrayMetaData(vtkm::VecTraits<T>::NUM_COMPONENTS);
+      return array;
+    }
+
+    if (!this->DataFile->IsBinary && this->DataFile->MappedFile &&
+        std::is_arithmetic<typename vtkm::VecTraits<T>::ComponentType>::value)
+    {
+      // Parse the text straight into the memory of the array.
+      vtkm::cont::ArrayHandle<T> array;
+      array.Allocate(static_cast<vtkm::Id>(numElements));
+      {
+        vtkm::cont::Token token;
+        this->ParseMappedArray(array.WritePortal(token).GetArray(), numElements);
+      }
+      this->DataFile->Stream >> std::ws;
+      this->SkipArrayMetaData(vtkm::VecTraits<T>::NUM_COMPONENTS);
+      return array;
+    }
+
+    std::vector<T> buffer(numElements);
+    this->ReadArray(buffer);
+    return vtkm::cont::make_ArrayHandleMove(std::move(buffer));
+  }
+
+  /// Parses `numElements` values of type `T` in parallel from the text of the mapped file at the
+  /// position of the stream, and moves the stream past them.
+  template <typename T>
+  VTKM_CONT void ParseMappedArray(T* values, std::size_t numElements)
+  {
+    using ComponentType = typename vtkm::VecTraits<T>::ComponentType;
+    const std::size_t offset = static_cast<std::size_t>(this->DataFile->Stream.tellg());
+    const std::size_t numCharacters = vtkm::io::internal::ParseASCIIValues(
+      static_cast<const char*>(this->DataFile->MappedFile->GetPointer()) + offset,
+      static_cast<std::size_t>(this->DataFile->MappedFile->GetSize()) - offset,
+      reinterpret_cast<ComponentType*>(values),
+      numElements * static_cast<std::size_t>(vtkm::VecTraits<T>::NUM_COMPONENTS));
+    this->DataFile->Stream.seekg(static_cast<std::streamoff>(offset + numCharacters));
+  }
+
+  VTKM_CONT vtkm::cont::ArrayHandle<vtkm::io::internal::DummyBitType> ReadArrayHandle(
+    std::size_t numElements,
+    vtkm::io::internal::DummyBitType);
+
+  /// Creates an array of `numElements` values of type `T` found `offset` bytes into the mapped
+  /// file. The stream is not touched.
+  template <typename T>
+  VTKM_CONT vtkm::cont::ArrayHandle<T> ReadMappedArray(std::size_t offset, std::size_t numElements)
+  {
+    const std::shared_ptr<vtkm::cont::internal::BufferInfo>& file = this->DataFile->MappedFile;
+    const vtkm::UInt8* data = static_cast<const vtkm::UInt8*>(file->GetPointer());
+    const std::size_t numBytes = numElements * sizeof(T);
+    internal::parseAssert(offset + numBytes <= static_cast<std::size_t>(file->GetSize()));
+
+    const bool flipBytes = (sizeof(T) > 1) && vtkm::io::internal::IsLittleEndian();
+    if (!flipBytes && ((offset % alignof(T)) == 0))
+    {
+      return vtkm::io::internal::MakeArrayFromMappedFile<T>(
+        file, offset, static_cast<vtkm::Id>(numElements));
+    }
+
+    vtkm::cont::ArrayHandle<vtkm::UInt8> bytes;
+    if (flipBytes)
+    {
+      vtkm::io::internal::FlipEndianness(
+        vtkm::cont::make_ArrayHandle(
+          data + offset, static_cast<vtkm::Id>(numBytes), vtkm::CopyFlag::Off),
+        static_cast<vtkm::IdComponent>(sizeof(T)),
+        bytes);
+    }
+    else
+    {
+      // Unaligned data cannot be used in place.
+      bytes.Allocate(static_cast<vtkm::Id>(numBytes));
+      std::memcpy(bytes.WritePortal().GetArray(), data + offset, numBytes);
+    }
+    // Reinterpret the bytes as values of type T.
+    return vtkm::cont::ArrayHandle<T>(bytes.GetBuffers());
+  }
+
   template <vtkm::IdComponent NumComponents>
   VTKM_CONT void ReadArray(
     std::vector<vtkm::Vec<vtkm::io::internal::DummyBitType, NumComponents>>& buffer)
@@ -0,0 +1,74 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/io/internal/Endian.h>
+
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+namespace
+{
+
+struct FlipEndiannessWorklet : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn valueIndex, WholeArrayIn source, WholeArrayOut dest);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  vtkm::IdComponent ValueSize;
+
+  VTKM_CONT explicit FlipEndiannessWorklet(vtkm::IdComponent valueSize)
+    : ValueSize(valueSize)
+  {
+  }
+
+  template <typename InPortalType, typename OutPortalType>
+  VTKM_EXEC void operator()(vtkm::Id valueIndex,
+                            const InPortalType& source,
+                            const OutPortalType& dest) const
+  {
+    const vtkm::Id first = valueIndex * this->ValueSize;
+    const vtkm::Id last = first + this->ValueSize - 1;
+    for (vtkm::IdComponent byte = 0; byte < this->ValueSize; ++byte)
+    {
+      dest.Set(first + byte, source.Get(last - byte));
+    }
+  }
+};
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace io
+{
+namespace internal
+{
+
+void FlipEndianness(const vtkm::cont::ArrayHandle<vtkm::UInt8>& source,
+                    vtkm::IdComponent valueSize,
+                    vtkm::cont::ArrayHandle<vtkm::UInt8>& destination)
+{
+  VTKM_ASSERT(valueSize > 0);
+  VTKM_ASSERT((source.GetNumberOfValues() % valueSize) == 0);
+
+  const vtkm::Id numValues = source.GetNumberOfValues() / valueSize;
+  destination.Allocate(source.GetNumberOfValues());
+
+  vtkm::cont::Invoker invoke;
+  invoke(FlipEndiannessWorklet{ valueSize },
+         vtkm::cont::ArrayHandleIndex(numValues),
+         source,
+         destination);
+}
+
+}
+}
+} // vtkm::io::internal
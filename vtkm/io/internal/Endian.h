@@ -11,6 +11,8 @@
 #define vtk_m_io_internal_Endian_h
 
 #include <vtkm/Types.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/io/vtkm_io_export.h>
 
 #include <algorithm>
 #include <vector>
@@ -55,6 +57,15 @@ inline void FlipEndianness(std::vector<vtkm::Vec<T, N>>& buffer)
     }
   }
 }
+
+/// \brief Copies an array of bytes while reversing the byte order of every value.
+///
+/// `source` holds a packed array of values that are `valueSize` bytes wide. The result is placed
+/// in `destination`, which is reallocated to the size of `source`. The byte swap runs in
+/// parallel on the available devices.
+VTKM_IO_EXPORT void FlipEndianness(const vtkm::cont::ArrayHandle<vtkm::UInt8>& source,
+                                   vtkm::IdComponent valueSize,
+                                   vtkm::cont::ArrayHandle<vtkm::UInt8>& destination);
 }
 }
 } // vtkm::io::internal
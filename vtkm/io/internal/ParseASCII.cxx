@@ -0,0 +1,341 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/io/internal/ParseASCII.h>
+
+#include <vtkm/io/ErrorIO.h>
+
+#include <vtkm/cont/DeviceAdapter.h>
+#include <vtkm/cont/RuntimeDeviceTracker.h>
+#include <vtkm/cont/TryExecute.h>
+#include <vtkm/exec/FunctorBase.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+#include <locale.h>
+#include <stdlib.h>
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h>
+#endif
+
+namespace
+{
+
+// Arrays with fewer tokens per chunk than this are parsed on the calling thread.
+constexpr std::size_t MinTokensPerChunk = 16384;
+
+// The text is cut in at most this many chunks, which leaves enough chunks for the schedulers of
+// the host devices to balance the load.
+constexpr std::size_t MaxNumberOfChunks = 256;
+
+// Longest token that can be converted. Longer tokens are not numbers VTK writes.
+constexpr std::size_t MaxTokenLength = 127;
+
+// Chunks are scheduled on the host devices enabled in the runtime device tracker, so forcing a
+// device or limiting the threads of TBB or OpenMP also applies to parsing.
+using HostDeviceList = vtkm::List<vtkm::cont::DeviceAdapterTagTBB,
+                                  vtkm::cont::DeviceAdapterTagOpenMP,
+                                  vtkm::cont::DeviceAdapterTagSerial>;
+
+struct TextChunk
+{
+  std::size_t Begin;
+  std::size_t End;
+  std::size_t NumTokens;
+};
+
+// Moves `position` forward to the next whitespace so that it does not split a token.
+std::size_t NextTokenBoundary(const char* text, std::size_t textSize, std::size_t position)
+{
+  while ((position < textSize) && !vtkm::io::internal::IsASCIIWhitespace(text[position]))
+  {
+    ++position;
+  }
+  return position;
+}
+
+std::size_t CountTokens(const char* begin, const char* end)
+{
+  std::size_t numTokens = 0;
+  bool inToken = false;
+  for (const char* c = begin; c < end; ++c)
+  {
+    const bool isSpace = vtkm::io::internal::IsASCIIWhitespace(*c);
+    numTokens += (!isSpace && !inToken) ? 1 : 0;
+    inToken = !isSpace;
+  }
+  return numTokens;
+}
+
+// Returns true if a host device that runs work on several threads can be used.
+bool CanParseInParallel()
+{
+  vtkm::cont::RuntimeDeviceTracker& tracker = vtkm::cont::GetRuntimeDeviceTracker();
+  return tracker.CanRunOn(vtkm::cont::DeviceAdapterTagTBB{}) ||
+    tracker.CanRunOn(vtkm::cont::DeviceAdapterTagOpenMP{});
+}
+
+// Calls a function on each chunk. Exceptions are kept so that they are rethrown on the calling
+// thread instead of escaping the scheduler.
+template <typename ChunkFunction>
+struct ChunkFunctor : vtkm::exec::FunctorBase
+{
+  const TextChunk* Chunks;
+  std::exception_ptr* Errors;
+  ChunkFunction Function;
+
+  ChunkFunctor(const TextChunk* chunks, std::exception_ptr* errors, const ChunkFunction& function)
+    : Chunks(chunks)
+    , Errors(errors)
+    , Function(function)
+  {
+  }
+
+  VTKM_EXEC void operator()(vtkm::Id index) const
+  {
+    try
+    {
+      this->Function(static_cast<std::size_t>(index), this->Chunks[index]);
+    }
+    catch (...)
+    {
+      this->Errors[index] = std::current_exception();
+    }
+  }
+};
+
+struct ScheduleChunks
+{
+  template <typename Device, typename Functor>
+  bool operator()(Device, const Functor& functor, vtkm::Id numChunks) const
+  {
+    vtkm::cont::DeviceAdapterAlgorithm<Device>::Schedule(functor, numChunks);
+    return true;
+  }
+};
+
+// Runs `function(chunkIndex, chunk)` on every chunk on the first host device allowed by the
+// runtime device tracker, and waits for all of them before rethrowing the first exception.
+template <typename ChunkFunction>
+void ForEachChunk(const std::vector<TextChunk>& chunks, const ChunkFunction& function)
+{
+  std::vector<std::exception_ptr> errors(chunks.size());
+  ChunkFunctor<ChunkFunction> functor(chunks.data(), errors.data(), function);
+  const vtkm::Id numChunks = static_cast<vtkm::Id>(chunks.size());
+  if (!vtkm::cont::TryExecute(ScheduleChunks{}, HostDeviceList{}, functor, numChunks))
+  {
+    for (vtkm::Id index = 0; index < numChunks; ++index)
+    {
+      functor(index);
+    }
+  }
+  for (const std::exception_ptr& error : errors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+// Splits [begin, end) into `numChunks` chunks and counts their tokens concurrently.
+void AppendCountedChunks(const char* text,
+                         std::size_t begin,
+                         std::size_t end,
+                         std::size_t numChunks,
+                         std::vector<TextChunk>& chunks)
+{
+  std::vector<TextChunk> newChunks;
+  const std::size_t chunkSize = std::max((end - begin) / numChunks, std::size_t{ 1 });
+  std::size_t chunkBegin = begin;
+  while (chunkBegin < end)
+  {
+    std::size_t chunkEnd = NextTokenBoundary(text, end, std::min(chunkBegin + chunkSize, end));
+    newChunks.push_back({ chunkBegin, chunkEnd, 0 });
+    chunkBegin = chunkEnd;
+  }
+
+  std::vector<std::size_t> counts(newChunks.size());
+  std::size_t* countsData = counts.data();
+  ForEachChunk(newChunks, [text, countsData](std::size_t index, const TextChunk& chunk) {
+    countsData[index] = CountTokens(text + chunk.Begin, text + chunk.End);
+  });
+  for (std::size_t index = 0; index < newChunks.size(); ++index)
+  {
+    newChunks[index].NumTokens = counts[index];
+    chunks.push_back(newChunks[index]);
+  }
+}
+
+// `strtod` reads numbers with the decimal point of the current C locale, but VTK files always
+// use '.'. Floating point tokens are therefore converted in the "C" locale, which is created once
+// and never freed.
+#ifdef _WIN32
+using NumericLocaleType = _locale_t;
+
+NumericLocaleType GetClassicNumericLocale()
+{
+  static const NumericLocaleType locale = _create_locale(LC_NUMERIC, "C");
+  return locale;
+}
+
+double ClassicStrToD(const char* token, char** tokenEnd)
+{
+  return _strtod_l(token, tokenEnd, GetClassicNumericLocale());
+}
+#else
+using NumericLocaleType = locale_t;
+
+NumericLocaleType GetClassicNumericLocale()
+{
+  static const NumericLocaleType locale = newlocale(LC_NUMERIC_MASK, "C", NumericLocaleType{});
+  return locale;
+}
+
+double ClassicStrToD(const char* token, char** tokenEnd)
+{
+  return strtod_l(token, tokenEnd, GetClassicNumericLocale());
+}
+#endif
+
+template <typename T, typename ConvertFunction>
+void ConvertToken(const char* begin, const char* end, T& value, ConvertFunction convert)
+{
+  const std::size_t length = static_cast<std::size_t>(end - begin);
+  if ((length < 1) || (length > MaxTokenLength))
+  {
+    throw vtkm::io::ErrorIO("Parse Error");
+  }
+
+  // The token is not null terminated in the text (and the text might end right after it).
+  char token[MaxTokenLength + 1];
+  std::memcpy(token, begin, length);
+  token[length] = '\0';
+
+  char* tokenEnd;
+  value = static_cast<T>(convert(token, &tokenEnd));
+  if (tokenEnd != token + length)
+  {
+    throw vtkm::io::ErrorIO("Parse Error");
+  }
+}
+
+} // anonymous namespace
+
+namespace vtkm
+{
+namespace io
+{
+namespace internal
+{
+
+std::size_t ParseASCIIChunks(const char* text,
+                             std::size_t textSize,
+                             std::size_t numTokens,
+                             const ParseASCIIChunkFunction& parseChunk)
+{
+  if (numTokens < 1)
+  {
+    return 0;
+  }
+
+  const std::size_t numChunks = std::min(MaxNumberOfChunks, numTokens / MinTokensPerChunk);
+  if ((numChunks < 2) || !CanParseInParallel())
+  {
+    return static_cast<std::size_t>(parseChunk(text, text + textSize, 0, numTokens) - text);
+  }
+
+  // The text after the array is not part of it, so only look at a window that is big enough to
+  // hold the tokens. Start with a guess of 8 characters per token and grow it as needed.
+  std::vector<TextChunk> chunks;
+  std::size_t numTokensFound = 0;
+  std::size_t windowEnd = 0;
+  std::size_t windowGrowth = numTokens * 8;
+  while ((numTokensFound < numTokens) && (windowEnd < textSize))
+  {
+    const std::size_t newWindowEnd =
+      NextTokenBoundary(text, textSize, std::min(windowEnd + windowGrowth, textSize));
+    const std::size_t firstNewChunk = chunks.size();
+    AppendCountedChunks(text, windowEnd, newWindowEnd, numChunks, chunks);
+    for (std::size_t chunkIndex = firstNewChunk; chunkIndex < chunks.size(); ++chunkIndex)
+    {
+      numTokensFound += chunks[chunkIndex].NumTokens;
+    }
+    windowEnd = newWindowEnd;
+    windowGrowth *= 2;
+  }
+  if (numTokensFound < numTokens)
+  {
+    throw vtkm::io::ErrorIO("Parse Error: expected " + std::to_string(numTokens) +
+                            " values but found " + std::to_string(numTokensFound));
+  }
+
+  // Give each chunk the index of its first token, and drop the chunks past the last token.
+  std::vector<TextChunk> parseChunks;
+  std::vector<std::size_t> firstIndices;
+  std::size_t firstIndex = 0;
+  for (const TextChunk& chunk : chunks)
+  {
+    if (firstIndex >= numTokens)
+    {
+      break;
+    }
+    const std::size_t numChunkTokens = std::min(chunk.NumTokens, numTokens - firstIndex);
+    if (numChunkTokens > 0)
+    {
+      parseChunks.push_back({ chunk.Begin, chunk.End, numChunkTokens });
+      firstIndices.push_back(firstIndex);
+    }
+    firstIndex += numChunkTokens;
+  }
+
+  const std::size_t* firstIndicesData = firstIndices.data();
+  const char* lastTokenEnd = text;
+  const std::size_t lastChunk = parseChunks.size() - 1;
+  ForEachChunk(parseChunks,
+               [&parseChunk, text, firstIndicesData, lastChunk, &lastTokenEnd](
+                 std::size_t index, const TextChunk& chunk) {
+                 const char* tokenEnd = parseChunk(
+                   text + chunk.Begin, text + chunk.End, firstIndicesData[index], chunk.NumTokens);
+                 if (index == lastChunk)
+                 {
+                   lastTokenEnd = tokenEnd;
+                 }
+               });
+
+  return static_cast<std::size_t>(lastTokenEnd - text);
+}
+
+void ParseASCIIToken(const char* begin, const char* end, vtkm::Float64& value)
+{
+  ConvertToken(begin, end, value, ClassicStrToD);
+}
+
+void ParseASCIIToken(const char* begin, const char* end, vtkm::Int64& value)
+{
+  ConvertToken(begin, end, value, [](const char* token, char** tokenEnd) {
+    return std::strtoll(token, tokenEnd, 10);
+  });
+}
+
+void ParseASCIIToken(const char* begin, const char* end, vtkm::UInt64& value)
+{
+  ConvertToken(begin, end, value, [](const char* token, char** tokenEnd) {
+    return std::strtoull(token, tokenEnd, 10);
+  });
+}
+
+}
+}
+} // vtkm::io::internal
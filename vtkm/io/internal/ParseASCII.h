@@ -0,0 +1,105 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_io_internal_ParseASCII_h
+#define vtk_m_io_internal_ParseASCII_h
+
+#include <vtkm/Types.h>
+#include <vtkm/io/vtkm_io_export.h>
+
+#include <functional>
+#include <type_traits>
+
+namespace vtkm
+{
+namespace io
+{
+namespace internal
+{
+
+inline bool IsASCIIWhitespace(char c)
+{
+  return (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\v') || (c == '\f');
+}
+
+/// Parses `numTokens` whitespace separated tokens that start at `begin` (possibly after
+/// whitespace) and do not go past `end`. The tokens are the values `firstIndex` to
+/// `firstIndex + numTokens - 1` of the array being parsed. Returns a pointer just past the last
+/// token parsed.
+using ParseASCIIChunkFunction = std::function<
+  const char*(const char* begin, const char* end, std::size_t firstIndex, std::size_t numTokens)>;
+
+/// \brief Splits text holding whitespace separated tokens into chunks parsed in parallel.
+///
+/// The first `numTokens` tokens of `text` are divided into chunks that each start and end on
+/// whitespace, and `parseChunk` is called on the chunks concurrently. The chunks are scheduled
+/// on the TBB or OpenMP device when the runtime device tracker allows it, using the threads
+/// configured for that device. Otherwise, the text is parsed on the calling thread. Text past the last token
+/// requested is never parsed (but may be scanned to find token boundaries). Returns the number of
+/// characters from `text` to the end of the last token. Throws `vtkm::io::ErrorIO` if there are
+/// fewer than `numTokens` tokens in the text. Exceptions thrown by `parseChunk` are passed on to
+/// the caller.
+VTKM_IO_EXPORT std::size_t ParseASCIIChunks(const char* text,
+                                            std::size_t textSize,
+                                            std::size_t numTokens,
+                                            const ParseASCIIChunkFunction& parseChunk);
+
+/// Converts the token in [`begin`, `end`) to a number. Throws `vtkm::io::ErrorIO` if the token is
+/// not a number of the requested type.
+VTKM_IO_EXPORT void ParseASCIIToken(const char* begin, const char* end, vtkm::Float64& value);
+VTKM_IO_EXPORT void ParseASCIIToken(const char* begin, const char* end, vtkm::Int64& value);
+VTKM_IO_EXPORT void ParseASCIIToken(const char* begin, const char* end, vtkm::UInt64& value);
+
+/// \brief Parses whitespace separated numbers in parallel.
+///
+/// Reads `numValues` numbers from `text` into `values`. Returns the number of characters from
+/// `text` to the end of the last number.
+template <typename T>
+std::size_t ParseASCIIValues(const char* text,
+                             std::size_t textSize,
+                             T* values,
+                             std::size_t numValues)
+{
+  using ParseType = typename std::conditional<
+    std::is_floating_point<T>::value,
+    vtkm::Float64,
+    typename std::conditional<std::is_signed<T>::value, vtkm::Int64, vtkm::UInt64>::type>::type;
+
+  return ParseASCIIChunks(
+    text,
+    textSize,
+    numValues,
+    [values](const char* begin, const char* end, std::size_t firstIndex, std::size_t numTokens) {
+      const char* token = begin;
+      for (std::size_t index = firstIndex; index < firstIndex + numTokens; ++index)
+      {
+        while ((token < end) && IsASCIIWhitespace(*token))
+        {
+          ++token;
+        }
+        const char* tokenEnd = token;
+        while ((tokenEnd < end) && !IsASCIIWhitespace(*tokenEnd))
+        {
+          ++tokenEnd;
+        }
+
+        ParseType value;
+        ParseASCIIToken(token, tokenEnd, value);
+        values[index] = static_cast<T>(value);
+        token = tokenEnd;
+      }
+      return token;
+    });
+}
+
+}
+}
+} // vtkm::io::internal
+
+#endif //vtk_m_io_internal_ParseASCII_h
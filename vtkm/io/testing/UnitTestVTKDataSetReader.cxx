@@ -8,9 +8,14 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 
+#include <vtkm/cont/RuntimeDeviceTracker.h>
+#include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/io/VTKDataSetReader.h>
+#include <vtkm/io/VTKDataSetWriter.h>
 
+#include <clocale>
+#include <cstdio>
 #include <string>
 
 namespace
@@ -496,6 +501,140 @@ void TestSkppingStringFields(Format format)
                    "Incorrect cellset type");
 }
 
+void CheckSameFields(const vtkm::cont::DataSet& expected, const vtkm::cont::DataSet& actual)
+{
+  VTKM_TEST_ASSERT(expected.GetNumberOfFields() == actual.GetNumberOfFields(),
+                   "Incorrect number of fields");
+  for (vtkm::IdComponent fieldId = 0; fieldId < expected.GetNumberOfFields(); ++fieldId)
+  {
+    const vtkm::cont::Field& expectedField = expected.GetField(fieldId);
+    VTKM_TEST_ASSERT(actual.HasField(expectedField.GetName(), expectedField.GetAssociation()),
+                     "Missing field ",
+                     expectedField.GetName());
+    VTKM_TEST_ASSERT(test_equal_ArrayHandles(
+      expectedField.GetData(),
+      actual.GetField(expectedField.GetName(), expectedField.GetAssociation()).GetData()));
+  }
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(expected.GetCoordinateSystem().GetData(),
+                                           actual.GetCoordinateSystem().GetData()));
+}
+
+void TestReadingMemoryMapped(const vtkm::cont::DataSet& data, const std::string& baseName)
+{
+  const std::string fileName = vtkm::cont::testing::Testing::WriteDirPath(baseName);
+  vtkm::io::VTKDataSetWriter writer(fileName);
+  writer.SetFileTypeToBinary();
+  writer.WriteDataSet(data);
+
+  vtkm::io::VTKDataSetReader streamReader(fileName);
+  streamReader.SetUseMemoryMapping(false);
+  vtkm::cont::DataSet streamData = streamReader.ReadDataSet();
+  VTKM_TEST_ASSERT(streamData.GetNumberOfCells() == data.GetNumberOfCells());
+
+  vtkm::io::VTKDataSetReader mappedReader(fileName);
+  VTKM_TEST_ASSERT(mappedReader.GetUseMemoryMapping(), "Memory mapping should be on by default");
+  CheckSameFields(streamData, mappedReader.ReadDataSet());
+  VTKM_TEST_ASSERT(mappedReader.GetLazyFieldNames().empty());
+
+  vtkm::io::VTKDataSetReader lazyReader(fileName);
+  lazyReader.SetLazyFieldLoading(true);
+  vtkm::cont::DataSet lazyData = lazyReader.ReadDataSet();
+  std::vector<std::string> lazyNames = lazyReader.GetLazyFieldNames();
+  VTKM_TEST_ASSERT(!lazyNames.empty(), "Expected fields to be deferred");
+  const vtkm::IdComponent numLazyFields = static_cast<vtkm::IdComponent>(lazyNames.size());
+  VTKM_TEST_ASSERT(lazyData.GetNumberOfFields() + numLazyFields == streamData.GetNumberOfFields());
+  for (const std::string& name : lazyNames)
+  {
+    const vtkm::cont::Field& field = lazyReader.LoadField(name);
+    VTKM_TEST_ASSERT(field.GetName() == name);
+  }
+  VTKM_TEST_ASSERT(lazyReader.GetLazyFieldNames().empty());
+  CheckSameFields(streamData, lazyReader.GetDataSet());
+
+  try
+  {
+    lazyReader.LoadField("no-such-field");
+    VTKM_TEST_FAIL("Loading an unknown field should throw.");
+  }
+  catch (vtkm::io::ErrorIO&)
+  {
+    // Expected
+  }
+
+  std::remove(fileName.c_str());
+}
+
+void TestReadingParallelASCII(const vtkm::cont::DataSet& data, const std::string& baseName)
+{
+  const std::string fileName = vtkm::cont::testing::Testing::WriteDirPath(baseName);
+  vtkm::io::VTKDataSetWriter writer(fileName);
+  writer.SetFileTypeToAscii();
+  writer.WriteDataSet(data);
+
+  vtkm::io::VTKDataSetReader streamReader(fileName);
+  streamReader.SetUseMemoryMapping(false);
+  vtkm::cont::DataSet streamData = streamReader.ReadDataSet();
+  VTKM_TEST_ASSERT(streamData.GetNumberOfPoints() == data.GetNumberOfPoints());
+
+  vtkm::io::VTKDataSetReader parallelReader(fileName);
+  CheckSameFields(streamData, parallelReader.ReadDataSet());
+
+  // Parsing follows the devices allowed by the runtime device tracker.
+  vtkm::cont::ScopedRuntimeDeviceTracker serialTracker(vtkm::cont::DeviceAdapterTagSerial{});
+  vtkm::io::VTKDataSetReader serialReader(fileName);
+  CheckSameFields(streamData, serialReader.ReadDataSet());
+
+  std::remove(fileName.c_str());
+}
+
+void TestReadingASCIIWithCommaDecimalLocale(const vtkm::cont::DataSet& data,
+                                            const std::string& baseName)
+{
+  const std::string fileName = vtkm::cont::testing::Testing::WriteDirPath(baseName);
+  vtkm::io::VTKDataSetWriter writer(fileName);
+  writer.SetFileTypeToAscii();
+  writer.WriteDataSet(data);
+
+  vtkm::io::VTKDataSetReader streamReader(fileName);
+  streamReader.SetUseMemoryMapping(false);
+  vtkm::cont::DataSet streamData = streamReader.ReadDataSet();
+
+  const std::string oldLocale = setlocale(LC_NUMERIC, nullptr);
+  bool haveCommaLocale = false;
+  for (const char* name :
+       { "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR", "German" })
+  {
+    if ((setlocale(LC_NUMERIC, name) != nullptr) && (localeconv()->decimal_point[0] == ','))
+    {
+      haveCommaLocale = true;
+      break;
+    }
+  }
+  if (!haveCommaLocale)
+  {
+    std::cout << "No locale with a comma decimal point is installed. Skipping." << std::endl;
+    setlocale(LC_NUMERIC, oldLocale.c_str());
+    std::remove(fileName.c_str());
+    return;
+  }
+
+  vtkm::cont::DataSet parsedData;
+  try
+  {
+    vtkm::io::VTKDataSetReader parallelReader(fileName);
+    parsedData = parallelReader.ReadDataSet();
+  }
+  catch (...)
+  {
+    setlocale(LC_NUMERIC, oldLocale.c_str());
+    std::remove(fileName.c_str());
+    throw;
+  }
+  setlocale(LC_NUMERIC, oldLocale.c_str());
+  std::remove(fileName.c_str());
+  CheckSameFields(streamData, parsedData);
+}
+
 void TestReadingVTKDataSet()
 {
   std::cout << "Test reading VTK Polydata file in ASCII" << std::endl;
@@ -547,6 +686,19 @@ void TestReadingVTKDataSet()
   TestReadingV5Format(FORMAT_ASCII);
   std::cout << "Test reading v5 file format in BINARY" << std::endl;
   TestReadingV5Format(FORMAT_BINARY);
+
+  std::cout << "Test reading BINARY files through a memory mapping" << std::endl;
+  vtkm::cont::testing::MakeTestDataSet tds;
+  TestReadingMemoryMapped(tds.Make3DExplicitDataSet5(), "memory-mapped-explicit.vtk");
+  TestReadingMemoryMapped(tds.Make3DUniformDataSet0(), "memory-mapped-uniform.vtk");
+
+  std::cout << "Test parsing ASCII files in parallel" << std::endl;
+  TestReadingParallelASCII(tds.Make3DExplicitDataSet5(), "parallel-ascii-explicit.vtk");
+  TestReadingParallelASCII(tds.Make3DUniformDataSet3(vtkm::Id3(64)), "parallel-ascii-uniform.vtk");
+
+  std::cout << "Test parsing ASCII files with a comma decimal point locale" << std::endl;
+  TestReadingASCIIWithCommaDecimalLocale(tds.Make3DUniformDataSet3(vtkm::Id3(64)),
+                                         "comma-locale-ascii-uniform.vtk");
 }
 
 int UnitTestVTKDataSetReader(int argc, char* argv[])
@@ -378,6 +378,24 @@ void Camera::Dolly(vtkm::Float32 value)
   this->SetPosition(this->GetLookAt() + (1.0f / value) * lookAtToPos);
 }
 
+bool Camera::operator==(const Camera& other) const
+{
+  return this->ModeType == other.ModeType && this->Camera3D.LookAt == other.Camera3D.LookAt &&
+    this->Camera3D.Position == other.Camera3D.Position &&
+    this->Camera3D.ViewUp == other.Camera3D.ViewUp &&
+    this->Camera3D.FieldOfView == other.Camera3D.FieldOfView &&
+    this->Camera3D.XPan == other.Camera3D.XPan && this->Camera3D.YPan == other.Camera3D.YPan &&
+    this->Camera3D.Zoom == other.Camera3D.Zoom && this->Camera2D.Left == other.Camera2D.Left &&
+    this->Camera2D.Right == other.Camera2D.Right &&
+    this->Camera2D.Bottom == other.Camera2D.Bottom && this->Camera2D.Top == other.Camera2D.Top &&
+    this->Camera2D.XScale == other.Camera2D.XScale &&
+    this->Camera2D.XPan == other.Camera2D.XPan && this->Camera2D.YPan == other.Camera2D.YPan &&
+    this->Camera2D.Zoom == other.Camera2D.Zoom && this->NearPlane == other.NearPlane &&
+    this->FarPlane == other.FarPlane && this->ViewportLeft == other.ViewportLeft &&
+    this->ViewportRight == other.ViewportRight && this->ViewportBottom == other.ViewportBottom &&
+    this->ViewportTop == other.ViewportTop;
+}
+
 void Camera::Print() const
 {
   if (this->ModeType == Camera::Mode::ThreeD)
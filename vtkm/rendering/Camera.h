@@ -541,6 +541,10 @@ public:
   VTKM_CONT
   void Print() const;
 
+  /// Cameras are equal when all their parameters are, so they show the same view.
+  VTKM_CONT bool operator==(const Camera& other) const;
+  VTKM_CONT bool operator!=(const Camera& other) const { return !(*this == other); }
+
 private:
   Mode ModeType;
   Camera3DStruct Camera3D;
@@ -12,6 +12,7 @@
 
 #include <vtkm/cont/ArrayHandleCounting.h>
 #include <vtkm/cont/DataSetBuilderUniform.h>
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/TryExecute.h>
 #include <vtkm/io/DecodePNG.h>
 #include <vtkm/io/EncodePNG.h>
@@ -82,6 +83,47 @@ struct BlendBackground : public vtkm::worklet::WorkletMapField
   }
 }; // struct BlendBackground
 
+struct DrawScaledImage : public vtkm::worklet::WorkletMapField
+{
+  vtkm::Id Width;
+  vtkm::Id Height;
+  vtkm::Id ImageWidth;
+  vtkm::Id ImageHeight;
+
+  VTKM_CONT
+  DrawScaledImage(vtkm::Id width, vtkm::Id height, vtkm::Id imageWidth, vtkm::Id imageHeight)
+    : Width(width)
+    , Height(height)
+    , ImageWidth(imageWidth)
+    , ImageHeight(imageHeight)
+  {
+  }
+
+  using ControlSignature = void(FieldInOut, FieldInOut, WholeArrayIn, WholeArrayIn);
+  using ExecutionSignature = void(InputIndex, _1, _2, _3, _4);
+
+  template <typename ColorPortalType, typename DepthPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& index,
+                            vtkm::Vec4f_32& color,
+                            vtkm::Float32& depth,
+                            const ColorPortalType& imageColors,
+                            const DepthPortalType& imageDepths) const
+  {
+    const vtkm::Id x = index % this->Width;
+    const vtkm::Id y = index / this->Width;
+    const vtkm::Id imageX = x * this->ImageWidth / this->Width;
+    const vtkm::Id imageY = y * this->ImageHeight / this->Height;
+    const vtkm::Id imageIndex = imageY * this->ImageWidth + imageX;
+    // Pixels where the image is empty are copied too, as they hold its background.
+    const vtkm::Float32 imageDepth = imageDepths.Get(imageIndex);
+    if (imageDepth <= depth)
+    {
+      color = imageColors.Get(imageIndex);
+      depth = imageDepth;
+    }
+  }
+}; // struct DrawScaledImage
+
 struct DrawColorSwatch : public vtkm::worklet::WorkletMapField
 {
   using ControlSignature = void(FieldIn, WholeArrayInOut);
@@ -330,6 +372,19 @@ void Canvas::BlendBackground()
   dispatcher.Invoke(this->GetColorBuffer());
 }
 
+void Canvas::AddScaledImage(const vtkm::rendering::Canvas& image)
+{
+  if (image.GetWidth() <= 0 || image.GetHeight() <= 0)
+  {
+    throw vtkm::cont::ErrorBadValue("Cannot scale an empty image.");
+  }
+  internal::DrawScaledImage worklet(
+    this->GetWidth(), this->GetHeight(), image.GetWidth(), image.GetHeight());
+  vtkm::worklet::DispatcherMapField<internal::DrawScaledImage> dispatcher(worklet);
+  dispatcher.Invoke(
+    this->GetColorBuffer(), this->GetDepthBuffer(), image.GetColorBuffer(), image.GetDepthBuffer());
+}
+
 void Canvas::ResizeBuffers(vtkm::Id width, vtkm::Id height)
 {
   VTKM_ASSERT(width >= 0);
@@ -47,6 +47,12 @@ public:
 
   virtual void BlendBackground();
 
+  /// \brief Draws `image`, a rendering of the same view at a lower resolution, over this canvas.
+  ///
+  /// The image is stretched to the size of this canvas, so each of its pixels covers a tile of
+  /// pixels. Tiles are depth tested against the depth buffer of this canvas.
+  VTKM_CONT void AddScaledImage(const vtkm::rendering::Canvas& image);
+
   VTKM_CONT
   vtkm::Id GetWidth() const;
 
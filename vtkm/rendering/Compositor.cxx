@@ -0,0 +1,458 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/rendering/Compositor.h>
+#include <vtkm/rendering/internal/ImageCompositing.h>
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Serialization.h>
+#include <vtkm/worklet/DispatcherMapField.h>
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <vtkm/thirdparty/diy/diy.h>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace vtkm
+{
+namespace rendering
+{
+namespace
+{
+
+using ImageBlock = vtkm::rendering::internal::ImageBlock;
+
+// Blends another image into an image. The other image is either in front of or behind the
+// image in visibility order.
+class BlendImages : public vtkm::worklet::WorkletMapField
+{
+public:
+  VTKM_CONT
+  BlendImages(bool visibilityOrder, bool otherInFront)
+    : VisibilityOrder(visibilityOrder)
+    , OtherInFront(otherInFront)
+  {
+  }
+
+  using ControlSignature = void(FieldInOut, FieldInOut, FieldIn, FieldIn);
+  using ExecutionSignature = void(_1, _2, _3, _4);
+
+  VTKM_EXEC void operator()(vtkm::Vec4f_32& color,
+                            vtkm::Float32& depth,
+                            const vtkm::Vec4f_32& otherColor,
+                            const vtkm::Float32& otherDepth) const
+  {
+    if (this->VisibilityOrder)
+    {
+      // colors have premultiplied alpha
+      if (this->OtherInFront)
+      {
+        color = otherColor + color * (1.f - otherColor[3]);
+      }
+      else
+      {
+        color = color + otherColor * (1.f - color[3]);
+      }
+      depth = vtkm::Min(depth, otherDepth);
+    }
+    else if (otherDepth < depth || (otherDepth == depth && this->OtherInFront))
+    {
+      // equal depths go to the first image, so the result does not depend on the ranks
+      color = otherColor;
+      depth = otherDepth;
+    }
+  }
+
+private:
+  bool VisibilityOrder;
+  bool OtherInFront;
+};
+
+void Blend(ImageBlock& block, const ImageBlock& other, bool visibilityOrder, bool otherInFront)
+{
+  vtkm::worklet::DispatcherMapField<BlendImages> dispatcher(
+    BlendImages(visibilityOrder, otherInFront));
+  dispatcher.Invoke(block.Colors, block.Depths, other.Colors, other.Depths);
+}
+
+// Assigns each block to the rank holding its images.
+class BlockAssigner : public vtkmdiy::StaticAssigner
+{
+public:
+  BlockAssigner(int size, const std::vector<int>& blockRanks)
+    : vtkmdiy::StaticAssigner(size, static_cast<int>(blockRanks.size()))
+    , BlockRanks(blockRanks)
+  {
+  }
+
+  int rank(int gid) const override { return this->BlockRanks[static_cast<std::size_t>(gid)]; }
+
+  void local_gids(int rank, std::vector<int>& gids) const override
+  {
+    for (std::size_t gid = 0; gid < this->BlockRanks.size(); ++gid)
+    {
+      if (this->BlockRanks[gid] == rank)
+      {
+        gids.push_back(static_cast<int>(gid));
+      }
+    }
+  }
+
+private:
+  std::vector<int> BlockRanks;
+};
+
+// One round of radix-k. The blocks of a group hold the same region of the image. Each block
+// first blends the parts of its region it received in the previous round, then splits the
+// region in as many parts as there are blocks in its group, keeps one and sends the others.
+// Groups are formed by consecutive block ids, so the blocks in front of a block have lower ids.
+struct RadixK
+{
+  bool VisibilityOrder;
+
+  void operator()(ImageBlock* block,
+                  const vtkmdiy::ReduceProxy& proxy,
+                  const vtkmdiy::RegularSwapPartners&) const
+  {
+    const int selfGid = proxy.gid();
+
+    std::vector<int> gids;
+    for (int i = 0; i < proxy.in_link().size(); ++i)
+    {
+      gids.push_back(proxy.in_link().target(i).gid);
+    }
+    std::sort(gids.begin(), gids.end());
+    const auto self = std::find(gids.begin(), gids.end(), selfGid);
+    // the closest blocks are blended first, because blending is not commutative
+    for (auto gid = std::make_reverse_iterator(self); gid != gids.rend(); ++gid)
+    {
+      this->Receive(*block, proxy, *gid, true);
+    }
+    for (auto gid = (self == gids.end()) ? self : self + 1; gid != gids.end(); ++gid)
+    {
+      this->Receive(*block, proxy, *gid, false);
+    }
+
+    const int numParts = proxy.out_link().size();
+    if (numParts == 0)
+    {
+      return;
+    }
+    const vtkm::Id numPixels = block->Colors.GetNumberOfValues();
+    ImageBlock kept;
+    for (int i = 0; i < numParts; ++i)
+    {
+      const vtkm::Id begin = (numPixels * i) / numParts;
+      const vtkm::Id end = (numPixels * (i + 1)) / numParts;
+      ImageBlock part;
+      part.Begin = block->Begin + begin;
+      vtkm::cont::Algorithm::CopySubRange(block->Colors, begin, end - begin, part.Colors);
+      vtkm::cont::Algorithm::CopySubRange(block->Depths, begin, end - begin, part.Depths);
+
+      const vtkmdiy::BlockID target = proxy.out_link().target(i);
+      if (target.gid == selfGid)
+      {
+        kept = part;
+      }
+      else
+      {
+        proxy.enqueue(target, part.Begin);
+        proxy.enqueue(target, part.Colors);
+        proxy.enqueue(target, part.Depths);
+      }
+    }
+    *block = kept;
+  }
+
+  void Receive(ImageBlock& block,
+               const vtkmdiy::ReduceProxy& proxy,
+               int gid,
+               bool otherInFront) const
+  {
+    ImageBlock part;
+    proxy.dequeue(gid, part.Begin);
+    proxy.dequeue(gid, part.Colors);
+    proxy.dequeue(gid, part.Depths);
+    VTKM_ASSERT(part.Begin == block.Begin);
+    Blend(block, part, this->VisibilityOrder, otherInFront);
+  }
+};
+
+} // anonymous namespace
+
+namespace internal
+{
+
+std::vector<ImageBlock> CompositeImageBlocks(const std::vector<ImageBlock>& localBlocks,
+                                             const std::vector<int>& blockRanks,
+                                             vtkm::IdComponent radix,
+                                             bool visibilityOrder)
+{
+  if (radix < 2)
+  {
+    throw vtkm::cont::ErrorBadValue("The compositing radix must be at least 2.");
+  }
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+  const int numBlocks = static_cast<int>(blockRanks.size());
+  if (static_cast<std::size_t>(std::count(blockRanks.begin(), blockRanks.end(), comm.rank())) !=
+      localBlocks.size())
+  {
+    throw vtkm::cont::ErrorBadValue("Wrong number of image blocks on this rank.");
+  }
+  if (numBlocks == 0)
+  {
+    return {};
+  }
+
+  vtkmdiy::Master master(
+    comm,
+    /*threads*/ 1,
+    /*limit*/ -1,
+    []() -> void* { return new ImageBlock(); },
+    [](void* ptr) { delete static_cast<ImageBlock*>(ptr); });
+  BlockAssigner assigner(comm.size(), blockRanks);
+  vtkmdiy::RegularDecomposer<vtkmdiy::DiscreteBounds> decomposer(
+    /*dims*/ 1, vtkmdiy::interval(0, numBlocks - 1), numBlocks);
+  decomposer.decompose(comm.rank(), assigner, master);
+  const int numLocalBlocks = static_cast<int>(master.size());
+
+  // local gids are increasing, like the local blocks
+  for (int lid = 0; lid < numLocalBlocks; ++lid)
+  {
+    *master.block<ImageBlock>(lid) = localBlocks[static_cast<std::size_t>(lid)];
+  }
+
+  vtkmdiy::RegularSwapPartners partners(decomposer, radix, /*contiguous*/ true);
+  vtkmdiy::reduce(master, assigner, partners, RadixK{ visibilityOrder });
+
+  // Gather the composited regions on rank 0.
+  std::vector<ImageBlock> regions;
+  if (comm.size() == 1)
+  {
+    for (int lid = 0; lid < numLocalBlocks; ++lid)
+    {
+      regions.push_back(*master.block<ImageBlock>(lid));
+    }
+    return regions;
+  }
+
+  // array serialization hands the data to DIY as blobs, so the regions are flattened
+  std::vector<vtkm::Id> extents;
+  std::vector<vtkm::Float32> values;
+  for (int lid = 0; lid < numLocalBlocks; ++lid)
+  {
+    const ImageBlock* block = master.block<ImageBlock>(lid);
+    extents.push_back(block->Begin);
+    extents.push_back(block->Colors.GetNumberOfValues());
+    auto colors = block->Colors.ReadPortal();
+    auto depths = block->Depths.ReadPortal();
+    for (vtkm::Id i = 0; i < colors.GetNumberOfValues(); ++i)
+    {
+      const vtkm::Vec4f_32 color = colors.Get(i);
+      values.insert(values.end(), { color[0], color[1], color[2], color[3], depths.Get(i) });
+    }
+  }
+  if (comm.rank() != 0)
+  {
+    vtkmdiy::mpi::gather(comm, extents, 0);
+    vtkmdiy::mpi::gather(comm, values, 0);
+    return regions;
+  }
+  std::vector<std::vector<vtkm::Id>> allExtents;
+  std::vector<std::vector<vtkm::Float32>> allValues;
+  vtkmdiy::mpi::gather(comm, extents, allExtents, 0);
+  vtkmdiy::mpi::gather(comm, values, allValues, 0);
+  for (std::size_t rank = 0; rank < allExtents.size(); ++rank)
+  {
+    const vtkm::Float32* value = allValues[rank].data();
+    for (std::size_t i = 0; i < allExtents[rank].size(); i += 2)
+    {
+      ImageBlock region;
+      region.Begin = allExtents[rank][i];
+      const vtkm::Id count = allExtents[rank][i + 1];
+      region.Colors.Allocate(count);
+      region.Depths.Allocate(count);
+      auto colors = region.Colors.WritePortal();
+      auto depths = region.Depths.WritePortal();
+      for (vtkm::Id pixel = 0; pixel < count; ++pixel, value += 5)
+      {
+        colors.Set(pixel, vtkm::Vec4f_32(value[0], value[1], value[2], value[3]));
+        depths.Set(pixel, value[4]);
+      }
+      regions.push_back(region);
+    }
+  }
+  return regions;
+}
+
+} // namespace internal
+
+struct Compositor::InternalsType
+{
+  CompositeMode Mode;
+  vtkm::IdComponent Radix = 4;
+  std::vector<ImageBlock> Images;
+  std::vector<vtkm::Float32> VisibilityDistances;
+};
+
+Compositor::Compositor(CompositeMode mode)
+  : Internals(new InternalsType)
+{
+  this->Internals->Mode = mode;
+}
+
+void Compositor::SetCompositeMode(CompositeMode mode)
+{
+  this->Internals->Mode = mode;
+}
+
+Compositor::CompositeMode Compositor::GetCompositeMode() const
+{
+  return this->Internals->Mode;
+}
+
+void Compositor::SetRadix(vtkm::IdComponent radix)
+{
+  if (radix < 2)
+  {
+    throw vtkm::cont::ErrorBadValue("The compositing radix must be at least 2.");
+  }
+  this->Internals->Radix = radix;
+}
+
+vtkm::IdComponent Compositor::GetRadix() const
+{
+  return this->Internals->Radix;
+}
+
+void Compositor::AddImage(const vtkm::rendering::Canvas& canvas,
+                          vtkm::Float32 visibilityDistance)
+{
+  ImageBlock image;
+  image.Colors.DeepCopyFrom(canvas.GetColorBuffer());
+  image.Depths.DeepCopyFrom(canvas.GetDepthBuffer());
+  this->Internals->Images.push_back(image);
+  this->Internals->VisibilityDistances.push_back(visibilityDistance);
+}
+
+vtkm::IdComponent Compositor::GetNumberOfImages() const
+{
+  return static_cast<vtkm::IdComponent>(this->Internals->Images.size());
+}
+
+void Compositor::ClearImages()
+{
+  this->Internals->Images.clear();
+  this->Internals->VisibilityDistances.clear();
+}
+
+void Compositor::Composite(vtkm::rendering::Canvas& canvas)
+{
+  const vtkm::Id numPixels = canvas.GetWidth() * canvas.GetHeight();
+  for (const ImageBlock& image : this->Internals->Images)
+  {
+    if (image.Colors.GetNumberOfValues() != numPixels)
+    {
+      throw vtkm::cont::ErrorBadValue("Composited images must have the size of the canvas.");
+    }
+  }
+  const bool visibilityOrder = this->Internals->Mode == CompositeMode::VisibilityOrder;
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+
+  // Order the images of all ranks front to back. Depth compositing does not depend on the
+  // order, so the images of a rank are kept together.
+  std::vector<std::vector<vtkm::Float32>> distances;
+  if (visibilityOrder)
+  {
+    vtkmdiy::mpi::all_gather(comm, this->Internals->VisibilityDistances, distances);
+  }
+  else
+  {
+    std::vector<vtkm::Float32> numImages(
+      1, static_cast<vtkm::Float32>(this->Internals->Images.size()));
+    std::vector<std::vector<vtkm::Float32>> counts;
+    vtkmdiy::mpi::all_gather(comm, numImages, counts);
+    for (const auto& count : counts)
+    {
+      distances.emplace_back(static_cast<std::size_t>(count[0]), 0.f);
+    }
+  }
+  std::vector<std::tuple<vtkm::Float32, int, std::size_t>> order;
+  for (std::size_t rank = 0; rank < distances.size(); ++rank)
+  {
+    for (std::size_t index = 0; index < distances[rank].size(); ++index)
+    {
+      order.emplace_back(distances[rank][index], static_cast<int>(rank), index);
+    }
+  }
+  std::sort(order.begin(), order.end());
+
+  // Consecutive images of the same rank are composited locally into one block.
+  std::vector<int> blockRanks;
+  std::vector<std::vector<std::size_t>> localRuns;
+  for (const auto& entry : order)
+  {
+    const int rank = std::get<1>(entry);
+    if (blockRanks.empty() || blockRanks.back() != rank)
+    {
+      blockRanks.push_back(rank);
+      if (rank == comm.rank())
+      {
+        localRuns.emplace_back();
+      }
+    }
+    if (rank == comm.rank())
+    {
+      localRuns.back().push_back(std::get<2>(entry));
+    }
+  }
+  if (blockRanks.empty())
+  {
+    return;
+  }
+
+  std::vector<ImageBlock> localBlocks;
+  for (const std::vector<std::size_t>& run : localRuns)
+  {
+    ImageBlock block;
+    block.Colors.DeepCopyFrom(this->Internals->Images[run[0]].Colors);
+    block.Depths.DeepCopyFrom(this->Internals->Images[run[0]].Depths);
+    for (std::size_t i = 1; i < run.size(); ++i)
+    {
+      Blend(block, this->Internals->Images[run[i]], visibilityOrder, false);
+    }
+    localBlocks.push_back(block);
+  }
+  this->ClearImages();
+
+  const std::vector<ImageBlock> regions = vtkm::rendering::internal::CompositeImageBlocks(
+    localBlocks, blockRanks, this->Internals->Radix, visibilityOrder);
+  for (const ImageBlock& region : regions)
+  {
+    const vtkm::Id count = region.Colors.GetNumberOfValues();
+    vtkm::cont::Algorithm::CopySubRange(
+      region.Colors, 0, count, canvas.GetColorBuffer(), region.Begin);
+    vtkm::cont::Algorithm::CopySubRange(
+      region.Depths, 0, count, canvas.GetDepthBuffer(), region.Begin);
+  }
+}
+
+vtkm::Float32 Compositor::GetVisibilityDistance(const vtkm::Bounds& bounds,
+                                                const vtkm::rendering::Camera& camera)
+{
+  const vtkm::Vec3f_32 center(bounds.Center());
+  return vtkm::Magnitude(center - camera.GetPosition());
+}
+}
+} // namespace vtkm::rendering
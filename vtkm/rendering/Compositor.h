@@ -0,0 +1,84 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_rendering_Compositor_h
+#define vtk_m_rendering_Compositor_h
+
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
+#include <vtkm/Bounds.h>
+#include <vtkm/rendering/Camera.h>
+#include <vtkm/rendering/Canvas.h>
+
+#include <memory>
+
+namespace vtkm
+{
+namespace rendering
+{
+
+/// \brief Sort-last compositing of images rendered on several ranks.
+///
+/// Each rank adds the images it rendered, for example one per partition of a
+/// `vtkm::cont::PartitionedDataSet`, and `Composite` merges the images of all ranks into a
+/// single image on rank 0. Images of consecutive partitions that live on the same rank are
+/// first composited locally, then the ranks exchange parts of their images with radix-k over
+/// DIY, so each rank only composites a fraction of the pixels. A radix of 2 is binary swap.
+///
+class VTKM_RENDERING_EXPORT Compositor
+{
+public:
+  enum struct CompositeMode
+  {
+    /// Keep the closest fragment of each pixel. For opaque surfaces.
+    Depth,
+    /// Blend the images front to back in the order of their visibility distance. For volumes
+    /// and other translucent images, whose colors have premultiplied alpha.
+    VisibilityOrder
+  };
+
+  Compositor(CompositeMode mode = CompositeMode::Depth);
+
+  VTKM_CONT void SetCompositeMode(CompositeMode mode);
+  VTKM_CONT CompositeMode GetCompositeMode() const;
+
+  /// Sets the largest number of ranks exchanging image parts in each round. The default is 4.
+  VTKM_CONT void SetRadix(vtkm::IdComponent radix);
+  VTKM_CONT vtkm::IdComponent GetRadix() const;
+
+  /// \brief Adds the color and depth buffers of `canvas` to the images of this rank.
+  ///
+  /// The buffers are copied, so the canvas can be reused for the next image. In
+  /// `CompositeMode::VisibilityOrder`, `visibilityDistance` orders the images of all ranks
+  /// front to back; see `GetVisibilityDistance`.
+  VTKM_CONT void AddImage(const vtkm::rendering::Canvas& canvas,
+                          vtkm::Float32 visibilityDistance = 0.f);
+
+  VTKM_CONT vtkm::IdComponent GetNumberOfImages() const;
+
+  VTKM_CONT void ClearImages();
+
+  /// \brief Composites the images added on all ranks into the buffers of `canvas` on rank 0.
+  ///
+  /// This must be called on all ranks, with canvases of the same size as the images. The
+  /// canvases of the other ranks are left unchanged. The images are cleared afterwards.
+  VTKM_CONT void Composite(vtkm::rendering::Canvas& canvas);
+
+  /// Distance used to order the image of data with the given bounds.
+  VTKM_CONT static vtkm::Float32 GetVisibilityDistance(const vtkm::Bounds& bounds,
+                                                       const vtkm::rendering::Camera& camera);
+
+private:
+  struct InternalsType;
+  std::shared_ptr<InternalsType> Internals;
+};
+}
+} //namespace vtkm::rendering
+
+#endif //vtk_m_rendering_Compositor_h
@@ -37,6 +37,9 @@ struct MapperPoint::InternalsType
   bool UseNodes;
   vtkm::Float32 PointDelta;
   bool UseVariableRadius;
+  // kept between renders so moving points refit the BVH instead of building a new one
+  std::shared_ptr<vtkm::rendering::raytracing::SphereIntersector> SphereIntersector;
+  bool SpheresFromNodes = false;
 
   VTKM_CONT
   InternalsType()
@@ -46,6 +49,7 @@ struct MapperPoint::InternalsType
     , UseNodes(true)
     , PointDelta(0.5f)
     , UseVariableRadius(false)
+    , SphereIntersector(std::make_shared<vtkm::rendering::raytracing::SphereIntersector>())
   {
   }
 };
@@ -170,8 +174,16 @@ void MapperPoint::RenderCells(const vtkm::cont::UnknownCellSet& cellset,
 
   if (sphereExtractor.GetNumberOfSpheres() > 0)
   {
-    auto sphereIntersector = std::make_shared<raytracing::SphereIntersector>();
-    sphereIntersector->SetData(coords, sphereExtractor.GetPointIds(), sphereExtractor.GetRadii());
+    auto sphereIntersector = this->Internals->SphereIntersector;
+    vtkm::cont::ArrayHandle<vtkm::Id> pointIds = sphereExtractor.GetPointIds();
+    if (this->Internals->UseNodes && this->Internals->SpheresFromNodes &&
+        sphereIntersector->GetPointIds().GetNumberOfValues() == pointIds.GetNumberOfValues())
+    {
+      // every point is a sphere, so the spheres are the same as the last render
+      pointIds = sphereIntersector->GetPointIds();
+    }
+    sphereIntersector->SetData(coords, pointIds, sphereExtractor.GetRadii());
+    this->Internals->SpheresFromNodes = this->Internals->UseNodes;
     this->Internals->Tracer.AddShapeIntersector(sphereIntersector);
     shapeBounds.Include(sphereIntersector->GetShapeBounds());
   }
@@ -214,6 +226,11 @@ void MapperPoint::SetCompositeBackground(bool on)
   this->Internals->CompositeBackground = on;
 }
 
+void MapperPoint::SetBVHBuildMode(vtkm::rendering::raytracing::LinearBVH::BuildMode mode)
+{
+  this->Internals->SphereIntersector->SetBVHBuildMode(mode);
+}
+
 vtkm::rendering::Mapper* MapperPoint::NewCopy() const
 {
   return new vtkm::rendering::MapperPoint(*this);
@@ -13,6 +13,7 @@
 #include <vtkm/cont/ColorTable.h>
 #include <vtkm/rendering/Camera.h>
 #include <vtkm/rendering/Mapper.h>
+#include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
 
 #include <memory>
 
@@ -82,6 +83,10 @@ public:
   void SetCompositeBackground(bool on);
   vtkm::rendering::Mapper* NewCopy() const override;
 
+  /// Selects how the BVH over the spheres is built. The default is
+  /// `LinearBVH::BuildMode::Morton`.
+  void SetBVHBuildMode(vtkm::rendering::raytracing::LinearBVH::BuildMode mode);
+
 private:
   struct InternalsType;
   std::shared_ptr<InternalsType> Internals;
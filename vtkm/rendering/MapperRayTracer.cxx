@@ -10,8 +10,15 @@
 
 #include <vtkm/rendering/MapperRayTracer.h>
 
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/CellSetExplicit.h>
+#include <vtkm/cont/CellSetSingleType.h>
+#include <vtkm/cont/CellSetStructured.h>
+#include <vtkm/cont/Invoker.h>
 #include <vtkm/cont/Timer.h>
 #include <vtkm/cont/TryExecute.h>
+#include <vtkm/worklet/WorkletMapField.h>
 
 #include <vtkm/rendering/CanvasRayTracer.h>
 #include <vtkm/rendering/internal/RunTriangulator.h>
@@ -22,12 +29,75 @@
 #include <vtkm/rendering/raytracing/SphereExtractor.h>
 #include <vtkm/rendering/raytracing/SphereIntersector.h>
 #include <vtkm/rendering/raytracing/TriangleExtractor.h>
+#include <vtkm/rendering/raytracing/TriangleIntersector.h>
 
 namespace vtkm
 {
 namespace rendering
 {
 
+namespace
+{
+
+template <typename CellSetType>
+void AppendExplicitKey(const CellSetType& cells, std::vector<vtkm::UInt64>& key)
+{
+  vtkm::TopologyElementTagCell visit;
+  vtkm::TopologyElementTagPoint incident;
+  for (const vtkm::cont::UnknownArrayHandle& array :
+       { vtkm::cont::UnknownArrayHandle(cells.GetShapesArray(visit, incident)),
+         vtkm::cont::UnknownArrayHandle(cells.GetConnectivityArray(visit, incident)),
+         vtkm::cont::UnknownArrayHandle(cells.GetOffsetsArray(visit, incident)) })
+  {
+    std::vector<vtkm::UInt64> versions = array.GetBufferVersions();
+    key.insert(key.end(), versions.begin(), versions.end());
+  }
+}
+
+// Identifies the cells of a cell set, so the triangles are only extracted again when the cells
+// change. Returns an empty key for cell sets that are not recognized.
+std::vector<vtkm::UInt64> CellSetKey(const vtkm::cont::UnknownCellSet& cellset)
+{
+  std::vector<vtkm::UInt64> key;
+  if (cellset.CanConvert<vtkm::cont::CellSetStructured<3>>())
+  {
+    vtkm::Id3 dims =
+      cellset.AsCellSet<vtkm::cont::CellSetStructured<3>>().GetSchedulingRange(
+        vtkm::TopologyElementTagPoint());
+    key = { 3, vtkm::UInt64(dims[0]), vtkm::UInt64(dims[1]), vtkm::UInt64(dims[2]) };
+  }
+  else if (cellset.CanConvert<vtkm::cont::CellSetStructured<2>>())
+  {
+    vtkm::Id2 dims =
+      cellset.AsCellSet<vtkm::cont::CellSetStructured<2>>().GetSchedulingRange(
+        vtkm::TopologyElementTagPoint());
+    key = { 2, vtkm::UInt64(dims[0]), vtkm::UInt64(dims[1]) };
+  }
+  else if (cellset.CanConvert<vtkm::cont::CellSetSingleType<>>())
+  {
+    AppendExplicitKey(cellset.AsCellSet<vtkm::cont::CellSetSingleType<>>(), key);
+  }
+  else if (cellset.CanConvert<vtkm::cont::CellSetExplicit<>>())
+  {
+    AppendExplicitKey(cellset.AsCellSet<vtkm::cont::CellSetExplicit<>>(), key);
+  }
+  return key;
+}
+
+// Counts the rays whose maximum distance, set by what is already drawn in the canvas, changed.
+struct DistanceChanged : public vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldIn, FieldOut);
+  using ExecutionSignature = _3(_1, _2);
+
+  VTKM_EXEC vtkm::Id operator()(vtkm::Float32 previous, vtkm::Float32 current) const
+  {
+    return (previous != current) ? 1 : 0;
+  }
+};
+
+} // anonymous namespace
+
 struct MapperRayTracer::InternalsType
 {
   vtkm::rendering::CanvasRayTracer* Canvas;
@@ -36,11 +106,24 @@ struct MapperRayTracer::InternalsType
   vtkm::rendering::raytracing::Ray<vtkm::Float32> Rays;
   bool CompositeBackground;
   bool Shade;
+  // kept between renders so the BVH of unchanged cells is reused, or refit if the points moved
+  std::shared_ptr<vtkm::rendering::raytracing::TriangleIntersector> TriIntersector;
+  vtkm::cont::ArrayHandle<vtkm::Id4> Triangles;
+  std::vector<vtkm::UInt64> CellSetKey;
+  // the rays of the last render, reused while the camera and the shapes stay the same
+  bool RaysValid;
+  vtkm::rendering::Camera RaysCamera;
+  vtkm::Id2 RaysCanvasSize;
+  std::vector<vtkm::UInt64> RaysShapesKey;
+  // tracing moves the maximum distances to the hits, so the ones set by the canvas are copied
+  vtkm::cont::ArrayHandle<vtkm::Float32> RaysClipDistances;
   VTKM_CONT
   InternalsType()
     : Canvas(nullptr)
     , CompositeBackground(true)
     , Shade(true)
+    , TriIntersector(std::make_shared<vtkm::rendering::raytracing::TriangleIntersector>())
+    , RaysValid(false)
   {
   }
 };
@@ -92,12 +175,18 @@ void MapperRayTracer::RenderCells(const vtkm::cont::UnknownCellSet& cellset,
   // Add supported shapes
   //
   vtkm::Bounds shapeBounds;
-  raytracing::TriangleExtractor triExtractor;
-  triExtractor.ExtractCells(cellset);
-  if (triExtractor.GetNumberOfTriangles() > 0)
+  std::vector<vtkm::UInt64> cellSetKey = CellSetKey(cellset);
+  if (cellSetKey.empty() || cellSetKey != this->Internals->CellSetKey)
+  {
+    raytracing::TriangleExtractor triExtractor;
+    triExtractor.ExtractCells(cellset);
+    this->Internals->Triangles = triExtractor.GetTriangles();
+    this->Internals->CellSetKey = std::move(cellSetKey);
+  }
+  if (this->Internals->Triangles.GetNumberOfValues() > 0)
   {
-    auto triIntersector = std::make_shared<raytracing::TriangleIntersector>();
-    triIntersector->SetData(coords, triExtractor.GetTriangles());
+    auto triIntersector = this->Internals->TriIntersector;
+    triIntersector->SetData(coords, this->Internals->Triangles);
     this->Internals->Tracer.AddShapeIntersector(triIntersector);
     shapeBounds.Include(triIntersector->GetShapeBounds());
   }
@@ -108,21 +197,61 @@ void MapperRayTracer::RenderCells(const vtkm::cont::UnknownCellSet& cellset,
   vtkm::Int32 width = (vtkm::Int32)this->Internals->Canvas->GetWidth();
   vtkm::Int32 height = (vtkm::Int32)this->Internals->Canvas->GetHeight();
 
-  this->Internals->RayCamera.SetParameters(camera, width, height);
+  // The rays of the last render are reused when the camera, the canvas size and the shapes did
+  // not change, such as when only the color map or the annotations are updated.
+  std::vector<vtkm::UInt64> shapesKey = this->Internals->CellSetKey;
+  if (!shapesKey.empty())
+  {
+    std::vector<vtkm::UInt64> versions = coords.GetData().GetBufferVersions();
+    shapesKey.insert(shapesKey.end(), versions.begin(), versions.end());
+  }
+  const bool sameRays = this->Internals->RaysValid && !shapesKey.empty() &&
+    this->Internals->RaysCamera == camera &&
+    this->Internals->RaysCanvasSize == vtkm::Id2(width, height) &&
+    this->Internals->RaysShapesKey == shapesKey;
+
+  if (!sameRays)
+  {
+    this->Internals->RayCamera.SetParameters(camera, width, height);
+    this->Internals->RayCamera.CreateRays(this->Internals->Rays, shapeBounds);
+    this->Internals->Tracer.GetCamera() = this->Internals->RayCamera;
+  }
 
-  this->Internals->RayCamera.CreateRays(this->Internals->Rays, shapeBounds);
-  this->Internals->Tracer.GetCamera() = this->Internals->RayCamera;
   this->Internals->Rays.Buffers.at(0).InitConst(0.f);
   raytracing::RayOperations::MapCanvasToRays(
     this->Internals->Rays, camera, *this->Internals->Canvas);
 
-
-
   this->Internals->Tracer.SetField(scalarField, scalarRange);
 
   this->Internals->Tracer.SetColorMap(this->ColorMap);
   this->Internals->Tracer.SetShadingOn(this->Internals->Shade);
-  this->Internals->Tracer.Render(this->Internals->Rays);
+
+  // The hits can only be kept if the rays are clipped by the same depths as before.
+  bool sameHits = false;
+  if (sameRays)
+  {
+    vtkm::cont::ArrayHandle<vtkm::Id> changed;
+    vtkm::cont::Invoker invoke;
+    invoke(DistanceChanged{},
+           this->Internals->RaysClipDistances,
+           this->Internals->Rays.MaxDistance,
+           changed);
+    sameHits = vtkm::cont::Algorithm::Reduce(changed, vtkm::Id(0)) == 0;
+  }
+  vtkm::cont::ArrayCopy(this->Internals->Rays.MaxDistance, this->Internals->RaysClipDistances);
+  if (sameHits)
+  {
+    this->Internals->Tracer.ShadeRays(this->Internals->Rays);
+  }
+  else
+  {
+    this->Internals->Tracer.Render(this->Internals->Rays);
+  }
+  this->Internals->RaysValid = true;
+  this->Internals->RaysCamera = camera;
+  this->Internals->RaysCanvasSize = vtkm::Id2(width, height);
+  this->Internals->RaysShapesKey = std::move(shapesKey);
+  logger->AddLogData("reused_hits", sameHits);
 
   timer.Start();
   this->Internals->Canvas->WriteToCanvas(
@@ -149,6 +278,16 @@ void MapperRayTracer::SetShadingOn(bool on)
   this->Internals->Shade = on;
 }
 
+void MapperRayTracer::SetBVHBuildMode(vtkm::rendering::raytracing::LinearBVH::BuildMode mode)
+{
+  this->Internals->TriIntersector->SetBVHBuildMode(mode);
+}
+
+void MapperRayTracer::SetPacketTraversal(bool on)
+{
+  this->Internals->TriIntersector->SetPacketTraversal(on);
+}
+
 vtkm::rendering::Mapper* MapperRayTracer::NewCopy() const
 {
   return new vtkm::rendering::MapperRayTracer(*this);
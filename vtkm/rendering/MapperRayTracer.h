@@ -13,6 +13,7 @@
 #include <vtkm/cont/ColorTable.h>
 #include <vtkm/rendering/Camera.h>
 #include <vtkm/rendering/Mapper.h>
+#include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
 
 #include <memory>
 
@@ -42,6 +43,13 @@ public:
   vtkm::rendering::Mapper* NewCopy() const override;
   void SetShadingOn(bool on);
 
+  /// Selects how the BVH over the triangles is built. The default is
+  /// `LinearBVH::BuildMode::Morton`.
+  void SetBVHBuildMode(vtkm::rendering::raytracing::LinearBVH::BuildMode mode);
+
+  /// Traces the camera rays through the BVH in packets on host devices. Off by default.
+  void SetPacketTraversal(bool on);
+
 private:
   struct InternalsType;
   std::shared_ptr<InternalsType> Internals;
@@ -33,12 +33,18 @@ struct MapperVolume::InternalsType
   vtkm::rendering::CanvasRayTracer* Canvas;
   vtkm::Float32 SampleDistance;
   bool CompositeBackground;
+  vtkm::Float32 OpacityThreshold;
+  vtkm::Id MacroCellSize;
+  // kept between renders so the macro cells of an unchanged field are reused
+  vtkm::rendering::raytracing::VolumeRendererStructured Tracer;
 
   VTKM_CONT
   InternalsType()
     : Canvas(nullptr)
     , SampleDistance(DEFAULT_SAMPLE_DISTANCE)
     , CompositeBackground(true)
+    , OpacityThreshold(1.f)
+    , MacroCellSize(8)
   {
   }
 };
@@ -95,7 +101,7 @@ void MapperVolume::RenderCells(const vtkm::cont::UnknownCellSet& cellset,
     tot_timer.Start();
     vtkm::cont::Timer timer;
 
-    vtkm::rendering::raytracing::VolumeRendererStructured tracer;
+    vtkm::rendering::raytracing::VolumeRendererStructured& tracer = this->Internals->Tracer;
 
     vtkm::rendering::raytracing::Camera rayCamera;
     vtkm::Int32 width = (vtkm::Int32)this->Internals->Canvas->GetWidth();
@@ -141,11 +147,41 @@ vtkm::rendering::Mapper* MapperVolume::NewCopy() const
 void MapperVolume::SetSampleDistance(const vtkm::Float32 sampleDistance)
 {
   this->Internals->SampleDistance = sampleDistance;
+  if (sampleDistance == DEFAULT_SAMPLE_DISTANCE)
+  {
+    // the tracer has no way back to its automatic sample distance
+    vtkm::rendering::raytracing::VolumeRendererStructured tracer;
+    tracer.SetOpacityThreshold(this->Internals->OpacityThreshold);
+    tracer.SetMacroCellSize(this->Internals->MacroCellSize);
+    this->Internals->Tracer = tracer;
+  }
 }
 
 void MapperVolume::SetCompositeBackground(const bool compositeBackground)
 {
   this->Internals->CompositeBackground = compositeBackground;
 }
+
+void MapperVolume::SetOpacityThreshold(const vtkm::Float32 threshold)
+{
+  this->Internals->Tracer.SetOpacityThreshold(threshold);
+  this->Internals->OpacityThreshold = threshold;
+}
+
+void MapperVolume::SetMacroCellSize(const vtkm::Id size)
+{
+  this->Internals->Tracer.SetMacroCellSize(size);
+  this->Internals->MacroCellSize = size;
+}
+
+vtkm::Id MapperVolume::GetNumberOfMacroCells() const
+{
+  return this->Internals->Tracer.GetNumberOfMacroCells();
+}
+
+vtkm::Id MapperVolume::GetNumberOfEmptyMacroCells() const
+{
+  return this->Internals->Tracer.GetNumberOfEmptyMacroCells();
+}
 }
 } // namespace vtkm::rendering
@@ -40,6 +40,17 @@ public:
   void SetSampleDistance(const vtkm::Float32 distance);
   void SetCompositeBackground(const bool compositeBackground);
 
+  /// Rays stop once their opacity reaches this value, which must be in (0, 1]. Default is 1.
+  void SetOpacityThreshold(const vtkm::Float32 threshold);
+
+  /// Number of cells along each axis of the macro cells used to skip transparent regions.
+  /// 0 disables empty space skipping. Default is 8.
+  void SetMacroCellSize(const vtkm::Id size);
+
+  /// Number of macro cells of the last render, and how many of them were skipped as empty.
+  vtkm::Id GetNumberOfMacroCells() const;
+  vtkm::Id GetNumberOfEmptyMacroCells() const;
+
 private:
   struct InternalsType;
   std::shared_ptr<InternalsType> Internals;
@@ -10,6 +10,8 @@
 
 #include <vtkm/rendering/Scene.h>
 
+#include <vtkm/cont/EnvironmentTracker.h>
+
 #include <vector>
 
 namespace vtkm
@@ -52,6 +54,39 @@ void Scene::Render(vtkm::rendering::Mapper& mapper,
   }
 }
 
+void Scene::Render(vtkm::rendering::Mapper& mapper,
+                   vtkm::rendering::Canvas& canvas,
+                   const vtkm::rendering::Camera& camera,
+                   vtkm::rendering::Compositor& compositor) const
+{
+  if (compositor.GetCompositeMode() == Compositor::CompositeMode::Depth)
+  {
+    this->Render(mapper, canvas, camera);
+    compositor.AddImage(canvas);
+    compositor.Composite(canvas);
+    return;
+  }
+
+  // mappers blend the background into their image, which must stay transparent until the
+  // images of all actors are blended
+  const vtkm::rendering::Color background = canvas.GetBackgroundColor();
+  canvas.SetBackgroundColor(vtkm::rendering::Color(0.f, 0.f, 0.f, 0.f));
+  for (const auto& actor : this->Internals->Actors)
+  {
+    canvas.Clear();
+    actor.Render(mapper, canvas, camera);
+    compositor.AddImage(canvas,
+                        Compositor::GetVisibilityDistance(actor.GetSpatialBounds(), camera));
+  }
+  canvas.SetBackgroundColor(background);
+  canvas.Clear();
+  compositor.Composite(canvas);
+  if (vtkm::cont::EnvironmentTracker::GetCommunicator().rank() == 0)
+  {
+    canvas.BlendBackground();
+  }
+}
+
 vtkm::Bounds Scene::GetSpatialBounds() const
 {
   vtkm::Bounds bounds;
@@ -15,6 +15,7 @@
 #include <vtkm/rendering/Actor.h>
 #include <vtkm/rendering/Camera.h>
 #include <vtkm/rendering/Canvas.h>
+#include <vtkm/rendering/Compositor.h>
 #include <vtkm/rendering/Mapper.h>
 
 #include <memory>
@@ -39,6 +40,16 @@ public:
               vtkm::rendering::Canvas& canvas,
               const vtkm::rendering::Camera& camera) const;
 
+  /// \brief Renders the actors of all ranks and composites them into `canvas` on rank 0.
+  ///
+  /// With `Compositor::CompositeMode::VisibilityOrder`, each actor is rendered into its own
+  /// image on a transparent background, the images are blended in the order of the distance
+  /// of the actors from the camera, and the background of the canvas is blended last.
+  void Render(vtkm::rendering::Mapper& mapper,
+              vtkm::rendering::Canvas& canvas,
+              const vtkm::rendering::Camera& camera,
+              vtkm::rendering::Compositor& compositor) const;
+
   vtkm::Bounds GetSpatialBounds() const;
 
 private:
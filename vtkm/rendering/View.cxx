@@ -30,6 +30,7 @@ struct View::InternalData
   std::vector<std::unique_ptr<vtkm::rendering::TextAnnotation>> TextAnnotations;
   std::vector<std::function<void(void)>> AdditionalAnnotations;
   vtkm::rendering::Camera Camera;
+  std::unique_ptr<vtkm::rendering::Compositor> Compositor;
 };
 
 View::View(const vtkm::rendering::Scene& scene,
@@ -119,6 +120,16 @@ const vtkm::rendering::WorldAnnotator& View::GetWorldAnnotator() const
   return *this->Internal->WorldAnnotatorPointer;
 }
 
+void View::SetCompositor(const vtkm::rendering::Compositor& compositor)
+{
+  this->Internal->Compositor = std::make_unique<vtkm::rendering::Compositor>(compositor);
+}
+
+vtkm::rendering::Compositor* View::GetCompositor()
+{
+  return this->Internal->Compositor.get();
+}
+
 const vtkm::rendering::Camera& View::GetCamera() const
 {
   return this->Internal->Camera;
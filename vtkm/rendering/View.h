@@ -67,6 +67,12 @@ public:
   VTKM_CONT
   const vtkm::rendering::WorldAnnotator& GetWorldAnnotator() const;
 
+  /// \brief Composites the images of all ranks with `compositor` when painting.
+  ///
+  /// The composited image is on rank 0.
+  VTKM_CONT
+  void SetCompositor(const vtkm::rendering::Compositor& compositor);
+
   VTKM_CONT
   const vtkm::rendering::Camera& GetCamera() const;
   VTKM_CONT
@@ -116,6 +122,9 @@ public:
   void AddAdditionalAnnotation(std::function<void(void)> ann);
 
 protected:
+  // The compositor set with SetCompositor, or null.
+  vtkm::rendering::Compositor* GetCompositor();
+
   void SetupForWorldSpace(bool viewportClip = true);
 
   void SetupForScreenSpace(bool viewportClip = false);
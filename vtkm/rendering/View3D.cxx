@@ -10,6 +10,12 @@
 
 #include <vtkm/rendering/View3D.h>
 
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/Timer.h>
+
+#include <cmath>
+
 namespace vtkm
 {
 namespace rendering
@@ -37,8 +43,85 @@ View3D::View3D(const vtkm::rendering::Scene& scene,
 void View3D::Paint()
 {
   this->GetCanvas().Clear();
+  if (vtkm::rendering::Compositor* compositor = this->GetCompositor())
+  {
+    // Annotations are drawn once, over the composited image.
+    this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera(), *compositor);
+    if (vtkm::cont::EnvironmentTracker::GetCommunicator().rank() == 0)
+    {
+      this->RenderAnnotations();
+    }
+    return;
+  }
   this->RenderAnnotations();
-  this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera());
+
+  const vtkm::Id2 size(this->GetCanvas().GetWidth(), this->GetCanvas().GetHeight());
+  vtkm::IdComponent level = this->PaintedLevel - 1;
+  if (this->PaintedCamera != this->GetCamera() || this->PaintedSize != size)
+  {
+    // Start over at the coarsest level, or at the finest one expected to fit in the budget.
+    level = this->ProgressiveLevels - 1;
+    const vtkm::Float64 fullFrameSeconds =
+      this->SecondsPerPixel * static_cast<vtkm::Float64>(size[0] * size[1]);
+    while (level > 0 && this->ProgressiveTimeBudget > 0 && fullFrameSeconds > 0 &&
+           fullFrameSeconds <= this->ProgressiveTimeBudget * std::ldexp(1.0, 2 * (level - 1)))
+    {
+      --level;
+    }
+  }
+  level = vtkm::Max(level, 0);
+  this->RenderSceneAtLevel(level);
+  this->PaintedLevel = level;
+  this->PaintedCamera = this->GetCamera();
+  this->PaintedSize = size;
+}
+
+void View3D::SetProgressiveLevels(vtkm::IdComponent levels)
+{
+  if (levels < 1)
+  {
+    throw vtkm::cont::ErrorBadValue("View3D needs at least one progressive level.");
+  }
+  this->ProgressiveLevels = levels;
+  // restart the progression on the next Paint
+  this->PaintedSize = vtkm::Id2(0, 0);
+}
+
+void View3D::SetProgressiveTimeBudget(vtkm::Float64 seconds)
+{
+  this->ProgressiveTimeBudget = seconds;
+}
+
+void View3D::RenderSceneAtLevel(vtkm::IdComponent level)
+{
+  if (level == 0 && this->ProgressiveLevels == 1)
+  {
+    this->GetScene().Render(this->GetMapper(), this->GetCanvas(), this->GetCamera());
+    return;
+  }
+
+  vtkm::cont::Timer timer;
+  timer.Start();
+  vtkm::rendering::Canvas& canvas = this->GetCanvas();
+  vtkm::Id numPixels = canvas.GetWidth() * canvas.GetHeight();
+  if (level == 0)
+  {
+    this->GetScene().Render(this->GetMapper(), canvas, this->GetCamera());
+  }
+  else
+  {
+    const vtkm::Id tileSize = vtkm::Id(1) << level;
+    vtkm::rendering::CanvasRayTracer& preview = this->PreviewCanvas;
+    preview.ResizeBuffers((canvas.GetWidth() + tileSize - 1) / tileSize,
+                          (canvas.GetHeight() + tileSize - 1) / tileSize);
+    preview.SetBackgroundColor(canvas.GetBackgroundColor());
+    preview.SetForegroundColor(canvas.GetForegroundColor());
+    preview.Clear();
+    this->GetScene().Render(this->GetMapper(), preview, this->GetCamera());
+    canvas.AddScaledImage(preview);
+    numPixels = preview.GetWidth() * preview.GetHeight();
+  }
+  this->SecondsPerPixel = timer.GetElapsedTime() / static_cast<vtkm::Float64>(numPixels);
 }
 
 void View3D::RenderScreenAnnotations()
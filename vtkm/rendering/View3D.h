@@ -14,6 +14,7 @@
 
 #include <vtkm/rendering/AxisAnnotation3D.h>
 #include <vtkm/rendering/BoundingBoxAnnotation.h>
+#include <vtkm/rendering/CanvasRayTracer.h>
 #include <vtkm/rendering/ColorBarAnnotation.h>
 
 namespace vtkm
@@ -43,7 +44,30 @@ public:
 
   void RenderWorldAnnotations() override;
 
+  /// \brief Renders the scene progressively over several calls to `Paint`.
+  ///
+  /// With more than one level, the first `Paint` after the camera or the canvas size changes
+  /// renders the scene at 1/2^(levels-1) of the canvas resolution, so each rendered pixel fills a
+  /// tile of the canvas, and each later `Paint` doubles the resolution until the full resolution
+  /// is reached. Annotations are always drawn at full resolution. The default of 1 renders every
+  /// frame at full resolution. Progressive rendering is not used with a `Compositor`.
+  void SetProgressiveLevels(vtkm::IdComponent levels);
+  vtkm::IdComponent GetProgressiveLevels() const { return this->ProgressiveLevels; }
+
+  /// \brief Time in seconds the first progressive frame after a camera change should take.
+  ///
+  /// When set, the first `Paint` after a camera change starts at the finest level that is
+  /// expected to render within the budget, as estimated from the time of the previous frames,
+  /// instead of the coarsest level. The default of 0 always starts at the coarsest level.
+  void SetProgressiveTimeBudget(vtkm::Float64 seconds);
+  vtkm::Float64 GetProgressiveTimeBudget() const { return this->ProgressiveTimeBudget; }
+
+  /// Whether the last `Paint` rendered the scene at the full resolution of the canvas.
+  bool IsFrameComplete() const { return this->PaintedLevel == 0; }
+
 private:
+  void RenderSceneAtLevel(vtkm::IdComponent level);
+
   // 3D-specific annotations
   vtkm::rendering::LineRendererBatcher LineBatcher;
   vtkm::rendering::BoundingBoxAnnotation BoxAnnotation;
@@ -51,6 +75,14 @@ private:
   vtkm::rendering::AxisAnnotation3D YAxisAnnotation;
   vtkm::rendering::AxisAnnotation3D ZAxisAnnotation;
   vtkm::rendering::ColorBarAnnotation ColorBarAnnotation;
+
+  vtkm::IdComponent ProgressiveLevels = 1;
+  vtkm::Float64 ProgressiveTimeBudget = 0.0;
+  vtkm::IdComponent PaintedLevel = 0;
+  vtkm::rendering::Camera PaintedCamera;
+  vtkm::Id2 PaintedSize = vtkm::Id2(0, 0);
+  vtkm::Float64 SecondsPerPixel = 0.0;
+  vtkm::rendering::CanvasRayTracer PreviewCanvas{ 0, 0 };
 };
 }
 } // namespace vtkm::rendering
@@ -0,0 +1,50 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_rendering_internal_ImageCompositing_h
+#define vtk_m_rendering_internal_ImageCompositing_h
+
+#include <vtkm/rendering/vtkm_rendering_export.h>
+
+#include <vtkm/cont/ArrayHandle.h>
+
+#include <vector>
+
+namespace vtkm
+{
+namespace rendering
+{
+namespace internal
+{
+
+/// The pixels [Begin, Begin + number of colors) of an image.
+struct ImageBlock
+{
+  vtkm::Id Begin = 0;
+  vtkm::cont::ArrayHandle<vtkm::Vec4f_32> Colors;
+  vtkm::cont::ArrayHandle<vtkm::Float32> Depths;
+};
+
+/// \brief Composites image blocks with radix-k and gathers the result on rank 0.
+///
+/// This is the exchange used by `Compositor::Composite`. Block `gid` lives on rank
+/// `blockRanks[gid]`, and blocks are ordered front to back by their gid. `localBlocks` holds the
+/// full images of the blocks of this rank in increasing gid order. On rank 0, the composited
+/// regions covering the whole image are returned. Other ranks get an empty vector.
+///
+VTKM_RENDERING_EXPORT
+std::vector<ImageBlock> CompositeImageBlocks(const std::vector<ImageBlock>& localBlocks,
+                                             const std::vector<int>& blockRanks,
+                                             vtkm::IdComponent radix,
+                                             bool visibilityOrder);
+}
+}
+} // namespace vtkm::rendering::internal
+
+#endif //vtk_m_rendering_internal_ImageCompositing_h
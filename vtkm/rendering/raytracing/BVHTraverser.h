@@ -10,6 +10,10 @@
 #ifndef vtk_m_rendering_raytracing_BVH_Traverser_h
 #define vtk_m_rendering_raytracing_BVH_Traverser_h
 
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/RuntimeDeviceTracker.h>
+#include <vtkm/cont/cuda/internal/DeviceAdapterTagCuda.h>
+#include <vtkm/cont/kokkos/internal/DeviceAdapterTagKokkos.h>
 #include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
 #include <vtkm/rendering/raytracing/Ray.h>
 #include <vtkm/rendering/raytracing/RayTracingTypeDefs.h>
@@ -218,12 +222,410 @@ public:
   };
 
 
+  // Traverses packets of consecutive rays with a shared stack. A child is visited when a ray
+  // of the packet hits it, and each stack entry records which rays hit the node. While the
+  // directions of the packet point into the same octant, as for the primary rays of a camera,
+  // the bounds of the packet's origins and directions are first tested against the children of
+  // the root, which culls packets that miss the scene with one test. Leaves are intersected
+  // ray by ray.
+  class PacketIntersector : public vtkm::worklet::WorkletMapField
+  {
+  public:
+    static constexpr vtkm::IdComponent PacketSize = 8;
+
+  private:
+    using LaneMask = vtkm::UInt8;
+
+    VTKM_EXEC
+    inline vtkm::Float32 rcp_safe(vtkm::Float32 f) const
+    {
+      return 1.0f / ((vtkm::Abs(f) < 1e-8f) ? 1e-8f : f);
+    }
+    VTKM_EXEC
+    inline vtkm::Float64 rcp_safe(vtkm::Float64 f) const
+    {
+      return 1.0 / ((vtkm::Abs(f) < 1e-8f) ? 1e-8f : f);
+    }
+
+    // Unlike vtkm::Min and vtkm::Max, which call fmin and fmax on host devices, these compile
+    // to single and SIMD instructions.
+    template <typename Precision>
+    VTKM_EXEC static inline Precision LaneMin(Precision a, Precision b)
+    {
+      return (a < b) ? a : b;
+    }
+    template <typename Precision>
+    VTKM_EXEC static inline Precision LaneMax(Precision a, Precision b)
+    {
+      return (a > b) ? a : b;
+    }
+
+    // Smallest and largest products of the values in [lo0, hi0] and [lo1, hi1].
+    template <typename Precision>
+    VTKM_EXEC static inline Precision ProductLo(Precision lo0,
+                                                Precision hi0,
+                                                Precision lo1,
+                                                Precision hi1)
+    {
+      return LaneMin(LaneMin(lo0 * lo1, lo0 * hi1), LaneMin(hi0 * lo1, hi0 * hi1));
+    }
+    template <typename Precision>
+    VTKM_EXEC static inline Precision ProductHi(Precision lo0,
+                                                Precision hi0,
+                                                Precision lo1,
+                                                Precision hi1)
+    {
+      return LaneMax(LaneMax(lo0 * lo1, lo0 * hi1), LaneMax(hi0 * lo1, hi0 * hi1));
+    }
+
+    // True when no ray of the packet can hit the box within [nearest, farthest].
+    template <typename Precision>
+    VTKM_EXEC inline bool PacketMisses(const Precision boxMin[3],
+                                       const Precision boxMax[3],
+                                       const Precision originLo[3],
+                                       const Precision originHi[3],
+                                       const Precision invDirLo[3],
+                                       const Precision invDirHi[3],
+                                       const Precision nearest,
+                                       const Precision farthest) const
+    {
+      Precision entry = nearest;
+      Precision exit = farthest;
+      for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+      {
+        const bool positive = invDirLo[axis] > 0;
+        const Precision nearPlane = positive ? boxMin[axis] : boxMax[axis];
+        const Precision farPlane = positive ? boxMax[axis] : boxMin[axis];
+        entry = LaneMax(entry,
+                        ProductLo(nearPlane - originHi[axis],
+                                  nearPlane - originLo[axis],
+                                  invDirLo[axis],
+                                  invDirHi[axis]));
+        exit = LaneMin(exit,
+                       ProductHi(farPlane - originHi[axis],
+                                 farPlane - originLo[axis],
+                                 invDirLo[axis],
+                                 invDirHi[axis]));
+      }
+      return entry > exit;
+    }
+
+    // Entry and exit distances of all lanes into a box. Every lane is computed, so that the
+    // loop vectorizes, and the lanes outside of the mask are discarded by HitMask.
+    template <typename Precision>
+    VTKM_EXEC inline void IntersectBox(const Precision boxMin[3],
+                                       const Precision boxMax[3],
+                                       const Precision invDir[3][PacketSize],
+                                       const Precision originDir[3][PacketSize],
+                                       const Precision minDistance[PacketSize],
+                                       const Precision closestDistance[PacketSize],
+                                       Precision entry[PacketSize],
+                                       Precision exit[PacketSize]) const
+    {
+      for (vtkm::IdComponent lane = 0; lane < PacketSize; ++lane)
+      {
+        const Precision x0 = boxMin[0] * invDir[0][lane] - originDir[0][lane];
+        const Precision y0 = boxMin[1] * invDir[1][lane] - originDir[1][lane];
+        const Precision z0 = boxMin[2] * invDir[2][lane] - originDir[2][lane];
+        const Precision x1 = boxMax[0] * invDir[0][lane] - originDir[0][lane];
+        const Precision y1 = boxMax[1] * invDir[1][lane] - originDir[1][lane];
+        const Precision z1 = boxMax[2] * invDir[2][lane] - originDir[2][lane];
+        entry[lane] = LaneMax(LaneMax(LaneMin(x0, x1), LaneMin(y0, y1)),
+                              LaneMax(LaneMin(z0, z1), minDistance[lane]));
+        exit[lane] = LaneMin(LaneMin(LaneMax(x0, x1), LaneMax(y0, y1)),
+                             LaneMin(LaneMax(z0, z1), closestDistance[lane]));
+      }
+    }
+
+    // The lanes of `mask` that hit the box, and the smallest entry distance among them.
+    template <typename Precision>
+    VTKM_EXEC inline void HitMask(LaneMask mask,
+                                  const Precision entry[PacketSize],
+                                  const Precision exit[PacketSize],
+                                  LaneMask& hitMask,
+                                  Precision& nearestEntry) const
+    {
+      // branch free, since the lanes hit and miss at random
+      vtkm::UInt32 hits = 0;
+      for (vtkm::IdComponent lane = 0; lane < PacketSize; ++lane)
+      {
+        hits |= static_cast<vtkm::UInt32>(exit[lane] >= entry[lane]) << lane;
+      }
+      hitMask = static_cast<LaneMask>(hits & mask);
+      for (vtkm::IdComponent lane = 0; lane < PacketSize; ++lane)
+      {
+        const bool hit = (hitMask >> lane) & 1;
+        nearestEntry = LaneMin(nearestEntry, hit ? entry[lane] : nearestEntry);
+      }
+    }
+
+  public:
+    VTKM_CONT
+    PacketIntersector() {}
+    using ControlSignature = void(FieldIn packetIndex,
+                                  WholeArrayIn dirs,
+                                  WholeArrayIn origins,
+                                  WholeArrayOut distances,
+                                  WholeArrayIn minDistances,
+                                  WholeArrayIn maxDistances,
+                                  WholeArrayOut us,
+                                  WholeArrayOut vs,
+                                  WholeArrayOut hitIndices,
+                                  WholeArrayIn points,
+                                  ExecObject leafIntersector,
+                                  WholeArrayIn flatBVH,
+                                  WholeArrayIn leafs);
+    using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13);
+
+    template <typename DirPortalType,
+              typename OriginPortalType,
+              typename DistancePortalType,
+              typename MinDistancePortalType,
+              typename MaxDistancePortalType,
+              typename UVPortalType,
+              typename HitIndexPortalType,
+              typename PointPortalType,
+              typename LeafType,
+              typename InnerNodePortalType,
+              typename LeafPortalType>
+    VTKM_EXEC void operator()(const vtkm::Id packet,
+                              const DirPortalType& dirs,
+                              const OriginPortalType& origins,
+                              const DistancePortalType& distances,
+                              const MinDistancePortalType& minDistances,
+                              const MaxDistancePortalType& maxDistances,
+                              const UVPortalType& us,
+                              const UVPortalType& vs,
+                              const HitIndexPortalType& hitIndices,
+                              const PointPortalType& points,
+                              LeafType& leafIntersector,
+                              const InnerNodePortalType& flatBVH,
+                              const LeafPortalType& leafs) const
+    {
+      using Precision = typename MinDistancePortalType::ValueType;
+
+      const vtkm::Id firstRay = packet * PacketSize;
+      const vtkm::IdComponent numRays = static_cast<vtkm::IdComponent>(
+        vtkm::Min(dirs.GetNumberOfValues() - firstRay, vtkm::Id(PacketSize)));
+
+      // The unused lanes of the last packet repeat its first ray and stay out of the mask.
+      vtkm::Vec<Precision, 3> origin[PacketSize];
+      vtkm::Vec<Precision, 3> dir[PacketSize];
+      Precision invDir[3][PacketSize];
+      Precision originDir[3][PacketSize];
+      Precision minDistance[PacketSize];
+      Precision closestDistance[PacketSize];
+      Precision minU[PacketSize];
+      Precision minV[PacketSize];
+      vtkm::Id hitIndex[PacketSize];
+      LaneMask activeMask = 0;
+      for (vtkm::IdComponent lane = 0; lane < PacketSize; ++lane)
+      {
+        const vtkm::Id ray = firstRay + ((lane < numRays) ? lane : 0);
+        origin[lane] = origins.Get(ray);
+        dir[lane] = dirs.Get(ray);
+        minDistance[lane] = minDistances.Get(ray);
+        closestDistance[lane] = maxDistances.Get(ray);
+        minU[lane] = 0;
+        minV[lane] = 0;
+        hitIndex[lane] = -1;
+        for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+        {
+          invDir[axis][lane] = rcp_safe(dir[lane][axis]);
+          originDir[axis][lane] = origin[lane][axis] * invDir[axis][lane];
+        }
+        if (lane < numRays)
+        {
+          activeMask = static_cast<LaneMask>(activeMask | (1 << lane));
+        }
+      }
+
+      Precision originLo[3], originHi[3], invDirLo[3], invDirHi[3];
+      bool coherent = true;
+      for (vtkm::IdComponent axis = 0; axis < 3; ++axis)
+      {
+        originLo[axis] = originHi[axis] = origin[0][axis];
+        invDirLo[axis] = invDirHi[axis] = invDir[axis][0];
+        for (vtkm::IdComponent lane = 1; lane < PacketSize; ++lane)
+        {
+          originLo[axis] = LaneMin(originLo[axis], origin[lane][axis]);
+          originHi[axis] = LaneMax(originHi[axis], origin[lane][axis]);
+          invDirLo[axis] = LaneMin(invDirLo[axis], invDir[axis][lane]);
+          invDirHi[axis] = LaneMax(invDirHi[axis], invDir[axis][lane]);
+        }
+        coherent = coherent && (invDirLo[axis] > 0 || invDirHi[axis] < 0);
+      }
+      Precision nearest = minDistance[0];
+      for (vtkm::IdComponent lane = 1; lane < PacketSize; ++lane)
+      {
+        nearest = LaneMin(nearest, minDistance[lane]);
+      }
+
+      vtkm::Int32 todo[64];
+      LaneMask todoMask[64];
+      vtkm::Int32 stackptr = 0;
+      todo[stackptr] = END_FLAG;
+      todoMask[stackptr] = 0;
+      vtkm::Int32 currentNode = 0;
+      LaneMask currentMask = activeMask;
+
+      while (currentNode != END_FLAG)
+      {
+        if (currentNode > -1)
+        {
+          const vtkm::Vec4f_32 first4 = flatBVH.Get(currentNode);
+          const vtkm::Vec4f_32 second4 = flatBVH.Get(currentNode + 1);
+          const vtkm::Vec4f_32 third4 = flatBVH.Get(currentNode + 2);
+          const Precision leftMin[3] = { first4[0], first4[1], first4[2] };
+          const Precision leftMax[3] = { first4[3], second4[0], second4[1] };
+          const Precision rightMin[3] = { second4[2], second4[3], third4[0] };
+          const Precision rightMax[3] = { third4[1], third4[2], third4[3] };
+
+          // The frustum of the packet is only tested against the top of the tree, where it
+          // rejects packets that miss the scene. Deeper down, testing all lanes of a box is
+          // cheaper than the interval arithmetic.
+          bool testLeft = true;
+          bool testRight = true;
+          if (coherent && currentNode == 0)
+          {
+            Precision farthest = closestDistance[0];
+            for (vtkm::IdComponent lane = 1; lane < PacketSize; ++lane)
+            {
+              farthest = LaneMax(farthest, closestDistance[lane]);
+            }
+            testLeft = !PacketMisses(
+              leftMin, leftMax, originLo, originHi, invDirLo, invDirHi, nearest, farthest);
+            testRight = !PacketMisses(
+              rightMin, rightMax, originLo, originHi, invDirLo, invDirHi, nearest, farthest);
+          }
+
+          LaneMask leftMask = 0;
+          LaneMask rightMask = 0;
+          Precision leftEntry = vtkm::Infinity<Precision>();
+          Precision rightEntry = vtkm::Infinity<Precision>();
+          Precision entry[PacketSize];
+          Precision exit[PacketSize];
+          if (testLeft)
+          {
+            IntersectBox(
+              leftMin, leftMax, invDir, originDir, minDistance, closestDistance, entry, exit);
+            HitMask(currentMask, entry, exit, leftMask, leftEntry);
+          }
+          if (testRight)
+          {
+            IntersectBox(
+              rightMin, rightMax, invDir, originDir, minDistance, closestDistance, entry, exit);
+            HitMask(currentMask, entry, exit, rightMask, rightEntry);
+          }
+
+          if (leftMask == 0 && rightMask == 0)
+          {
+            currentNode = todo[stackptr];
+            currentMask = todoMask[stackptr];
+            stackptr--;
+          }
+          else
+          {
+            vtkm::Vec4f_32 children = flatBVH.Get(currentNode + 3);
+            vtkm::Int32 leftChild;
+            memcpy(&leftChild, &children[0], 4);
+            vtkm::Int32 rightChild;
+            memcpy(&rightChild, &children[1], 4);
+            if (leftMask != 0 && rightMask != 0)
+            {
+              // visit the child the packet enters first
+              const bool rightCloser = rightEntry < leftEntry;
+              stackptr++;
+              todo[stackptr] = rightCloser ? leftChild : rightChild;
+              todoMask[stackptr] = rightCloser ? leftMask : rightMask;
+              currentNode = rightCloser ? rightChild : leftChild;
+              currentMask = rightCloser ? rightMask : leftMask;
+            }
+            else
+            {
+              currentNode = (leftMask != 0) ? leftChild : rightChild;
+              currentMask = (leftMask != 0) ? leftMask : rightMask;
+            }
+          }
+        } // if inner node
+
+        if (currentNode < 0 && currentNode != END_FLAG)
+        {
+          const vtkm::Int32 leaf = -currentNode - 1;
+          for (vtkm::IdComponent lane = 0; lane < PacketSize; ++lane)
+          {
+            if ((currentMask >> lane) & 1)
+            {
+              leafIntersector.IntersectLeaf(leaf,
+                                            origin[lane],
+                                            dir[lane],
+                                            points,
+                                            hitIndex[lane],
+                                            closestDistance[lane],
+                                            minU[lane],
+                                            minV[lane],
+                                            leafs,
+                                            minDistance[lane]);
+            }
+          }
+          currentNode = todo[stackptr];
+          currentMask = todoMask[stackptr];
+          stackptr--;
+        } // if leaf node
+      }   //while
+
+      for (vtkm::IdComponent lane = 0; lane < numRays; ++lane)
+      {
+        const vtkm::Id ray = firstRay + lane;
+        distances.Set(ray, closestDistance[lane]);
+        us.Set(ray, minU[lane]);
+        vs.Set(ray, minV[lane]);
+        hitIndices.Set(ray, hitIndex[lane]);
+      }
+    } // ()
+  };
+
+  VTKM_CONT
+  BVHTraverser(bool usePackets = false)
+    : UsePackets(usePackets)
+  {
+  }
+
   template <typename Precision, typename LeafIntersectorType>
   VTKM_CONT void IntersectRays(Ray<Precision>& rays,
                                LinearBVH& bvh,
                                LeafIntersectorType& leafIntersector,
                                vtkm::cont::CoordinateSystem& coordsHandle)
   {
+    // Packets only pay off on devices that run one thread per core.
+    const vtkm::cont::RuntimeDeviceTracker& tracker = vtkm::cont::GetRuntimeDeviceTracker();
+    if (this->UsePackets && !tracker.CanRunOn(vtkm::cont::DeviceAdapterTagCuda{}) &&
+        !tracker.CanRunOn(vtkm::cont::DeviceAdapterTagKokkos{}))
+    {
+      const vtkm::Id numPackets =
+        (rays.NumRays + PacketIntersector::PacketSize - 1) / PacketIntersector::PacketSize;
+      // whole arrays are not sized by the dispatcher
+      rays.Distance.Allocate(rays.NumRays);
+      rays.U.Allocate(rays.NumRays);
+      rays.V.Allocate(rays.NumRays);
+      rays.HitIdx.Allocate(rays.NumRays);
+      vtkm::worklet::DispatcherMapField<PacketIntersector> packetDispatch;
+      packetDispatch.Invoke(vtkm::cont::ArrayHandleIndex(numPackets),
+                            rays.Dir,
+                            rays.Origin,
+                            rays.Distance,
+                            rays.MinDistance,
+                            rays.MaxDistance,
+                            rays.U,
+                            rays.V,
+                            rays.HitIdx,
+                            coordsHandle,
+                            leafIntersector,
+                            bvh.FlatBVH,
+                            bvh.Leafs);
+      return;
+    }
+
     vtkm::worklet::DispatcherMapField<Intersector> intersectDispatch;
     intersectDispatch.Invoke(rays.Dir,
                              rays.Origin,
@@ -238,6 +640,9 @@ public:
                              bvh.FlatBVH,
                              bvh.Leafs);
   }
+
+private:
+  bool UsePackets;
 }; // BVHTraverser
 #undef END_FLAG
 }
@@ -14,6 +14,9 @@
 #include <vtkm/VectorAnalysis.h>
 
 #include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayHandleCompositeVector.h>
+#include <vtkm/cont/ArrayHandleConcatenate.h>
+#include <vtkm/cont/ArrayHandleStride.h>
 #include <vtkm/cont/DeviceAdapter.h>
 #include <vtkm/cont/DeviceAdapterAlgorithm.h>
 #include <vtkm/cont/Invoker.h>
@@ -55,6 +58,8 @@ public:
 
   class TreeBuilder;
 
+  class SAHSplit;
+
   VTKM_CONT
   LinearBVHBuilder() {}
 
@@ -63,6 +68,15 @@ public:
   VTKM_CONT void BuildHierarchy(BVHData& bvh);
 
   VTKM_CONT void Build(LinearBVH& linearBVH);
+
+  VTKM_CONT void Refit(LinearBVH& linearBVH, AABBs& aabbs);
+
+private:
+  VTKM_CONT void ComputeTotalBounds(LinearBVH& linearBVH,
+                                    vtkm::Vec3f_32& minExtent,
+                                    vtkm::Vec3f_32& maxExtent);
+
+  VTKM_CONT void PropagateBounds(LinearBVH& linearBVH);
 }; // class LinearBVHBuilder
 
 class LinearBVHBuilder::CountingIterator : public vtkm::worklet::WorkletMapField
@@ -474,6 +488,238 @@ public:
   }
 }; // class TreeBuilder
 
+// Splits the primitives of an inner node with a binned surface area heuristic. The centroids
+// are binned along each axis and the range of the node is partitioned in place, so the boxes and
+// the leaves stay in the order of the tree. Nodes deeper than MaxSAHDepth, or whose centroids
+// all fall in one bin, are split in the middle of their range, which keeps the tree shallow
+// enough for the traversal stack. Inner nodes are numbered like in TreeBuilder: a left child is
+// named after the last primitive of its range and a right child after the first one, which keeps
+// the numbering unique for any choice of splits.
+class LinearBVHBuilder::SAHSplit : public vtkm::worklet::WorkletMapField
+{
+private:
+  static constexpr vtkm::IdComponent NumBins = 16;
+  static constexpr vtkm::Id MaxSAHDepth = 32;
+  vtkm::Id InnerCount;
+
+  VTKM_EXEC
+  inline vtkm::Float32 HalfArea(const vtkm::Vec3f_32& low, const vtkm::Vec3f_32& high) const
+  {
+    const vtkm::Vec3f_32 d = high - low;
+    return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+  }
+
+  template <typename PointPortalType>
+  VTKM_EXEC inline vtkm::IdComponent Bin(const PointPortalType& mins,
+                                         const PointPortalType& maxs,
+                                         const vtkm::Id& index,
+                                         const vtkm::IdComponent& axis,
+                                         const vtkm::Float32& low,
+                                         const vtkm::Float32& scale) const
+  {
+    const vtkm::Float32 centroid = mins.Get(index)[axis] + maxs.Get(index)[axis];
+    const vtkm::IdComponent bin = static_cast<vtkm::IdComponent>((centroid - low) * scale);
+    return vtkm::Min(vtkm::Max(bin, 0), NumBins - 1);
+  }
+
+public:
+  VTKM_CONT
+  SAHSplit(const vtkm::Id& leafCount)
+    : InnerCount(leafCount - 1)
+  {
+  }
+
+  // The children and parents are written one level at a time, so they are in-out to keep the
+  // levels written before.
+  using ControlSignature = void(FieldIn,         // range: first, last, node, depth
+                                WholeArrayInOut, // mins
+                                WholeArrayInOut, // maxs
+                                WholeArrayInOut, // leafs
+                                WholeArrayInOut, // left children
+                                WholeArrayInOut, // right children
+                                WholeArrayInOut, // parents
+                                FieldOut,        // left range
+                                FieldOut,        // right range
+                                FieldOut,        // left is inner
+                                FieldOut);       // right is inner
+  using ExecutionSignature = void(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11);
+
+  template <typename PointPortalType, typename IdPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id4& range,
+                            PointPortalType& mins,
+                            PointPortalType& maxs,
+                            IdPortalType& leafs,
+                            IdPortalType& leftChildren,
+                            IdPortalType& rightChildren,
+                            IdPortalType& parents,
+                            vtkm::Id4& leftRange,
+                            vtkm::Id4& rightRange,
+                            vtkm::UInt8& leftIsInner,
+                            vtkm::UInt8& rightIsInner) const
+  {
+    const vtkm::Id first = range[0];
+    const vtkm::Id last = range[1];
+    const vtkm::Id node = range[2];
+    const vtkm::Id depth = range[3];
+    const vtkm::Vec3f_32 empty(vtkm::Infinity32());
+
+    // bounds of the centroids (scaled by two)
+    vtkm::Vec3f_32 centroidLow = empty;
+    vtkm::Vec3f_32 centroidHigh = -empty;
+    for (vtkm::Id i = first; i <= last && depth < MaxSAHDepth; ++i)
+    {
+      const vtkm::Vec3f_32 centroid = mins.Get(i) + maxs.Get(i);
+      centroidLow = vtkm::Min(centroidLow, centroid);
+      centroidHigh = vtkm::Max(centroidHigh, centroid);
+    }
+
+    vtkm::IdComponent bestAxis = -1;
+    vtkm::IdComponent bestBin = 0;
+    vtkm::Float32 bestCost = vtkm::Infinity32();
+    for (vtkm::IdComponent axis = 0; axis < 3 && depth < MaxSAHDepth; ++axis)
+    {
+      const vtkm::Float32 extent = centroidHigh[axis] - centroidLow[axis];
+      if (!(extent > 0.f))
+      {
+        continue;
+      }
+      const vtkm::Float32 scale = vtkm::Float32(NumBins) / extent;
+
+      vtkm::Id binCount[NumBins];
+      vtkm::Vec3f_32 binLow[NumBins];
+      vtkm::Vec3f_32 binHigh[NumBins];
+      for (vtkm::IdComponent bin = 0; bin < NumBins; ++bin)
+      {
+        binCount[bin] = 0;
+        binLow[bin] = empty;
+        binHigh[bin] = -empty;
+      }
+      for (vtkm::Id i = first; i <= last; ++i)
+      {
+        const vtkm::IdComponent bin = this->Bin(mins, maxs, i, axis, centroidLow[axis], scale);
+        binCount[bin]++;
+        binLow[bin] = vtkm::Min(binLow[bin], vtkm::Vec3f_32(mins.Get(i)));
+        binHigh[bin] = vtkm::Max(binHigh[bin], vtkm::Vec3f_32(maxs.Get(i)));
+      }
+
+      // sweep from the right to get the cost of the right children, then from the left
+      vtkm::Float32 rightCost[NumBins];
+      vtkm::Vec3f_32 low = empty;
+      vtkm::Vec3f_32 high = -empty;
+      vtkm::Id count = 0;
+      for (vtkm::IdComponent bin = NumBins - 1; bin > 0; --bin)
+      {
+        low = vtkm::Min(low, binLow[bin]);
+        high = vtkm::Max(high, binHigh[bin]);
+        count += binCount[bin];
+        rightCost[bin] = (count > 0) ? this->HalfArea(low, high) * vtkm::Float32(count) : -1.f;
+      }
+      low = empty;
+      high = -empty;
+      count = 0;
+      for (vtkm::IdComponent bin = 0; bin < NumBins - 1; ++bin)
+      {
+        low = vtkm::Min(low, binLow[bin]);
+        high = vtkm::Max(high, binHigh[bin]);
+        count += binCount[bin];
+        if (count > 0 && rightCost[bin + 1] >= 0.f)
+        {
+          const vtkm::Float32 cost =
+            this->HalfArea(low, high) * vtkm::Float32(count) + rightCost[bin + 1];
+          if (cost < bestCost)
+          {
+            bestCost = cost;
+            bestAxis = axis;
+            bestBin = bin;
+          }
+        }
+      }
+    }
+
+    vtkm::Id split = first + (last - first + 1) / 2 - 1;
+    if (bestAxis != -1)
+    {
+      // move the primitives of the bins left of the split to the front of the range
+      const vtkm::Float32 low = centroidLow[bestAxis];
+      const vtkm::Float32 scale =
+        vtkm::Float32(NumBins) / (centroidHigh[bestAxis] - centroidLow[bestAxis]);
+      vtkm::Id left = first;
+      vtkm::Id right = last;
+      while (left <= right)
+      {
+        if (this->Bin(mins, maxs, left, bestAxis, low, scale) <= bestBin)
+        {
+          ++left;
+        }
+        else
+        {
+          const auto swapMin = mins.Get(left);
+          const auto swapMax = maxs.Get(left);
+          const vtkm::Id swapLeaf = leafs.Get(2 * left + 1);
+          mins.Set(left, mins.Get(right));
+          maxs.Set(left, maxs.Get(right));
+          leafs.Set(2 * left + 1, leafs.Get(2 * right + 1));
+          mins.Set(right, swapMin);
+          maxs.Set(right, swapMax);
+          leafs.Set(2 * right + 1, swapLeaf);
+          --right;
+        }
+      }
+      split = left - 1;
+    }
+
+    const vtkm::Id leftChild = (split == first) ? split + this->InnerCount : split;
+    const vtkm::Id rightChild = (split + 1 == last) ? split + 1 + this->InnerCount : split + 1;
+    leftChildren.Set(node, leftChild);
+    rightChildren.Set(node, rightChild);
+    parents.Set(leftChild, node);
+    parents.Set(rightChild, node);
+    leftRange = vtkm::Id4(first, split, leftChild, depth + 1);
+    rightRange = vtkm::Id4(split + 1, last, rightChild, depth + 1);
+    leftIsInner = (split == first) ? 0 : 1;
+    rightIsInner = (split + 1 == last) ? 0 : 1;
+  }
+}; // class SAHSplit
+
+VTKM_CONT void LinearBVHBuilder::BuildHierarchy(BVHData& bvh)
+{
+  // Split the nodes of the tree one level at a time, starting with the root.
+  vtkm::cont::ArrayHandle<vtkm::Id4> ranges;
+  ranges.Allocate(1);
+  ranges.WritePortal().Set(0, vtkm::Id4(0, bvh.GetNumberOfPrimitives() - 1, 0, 0));
+
+  auto mins = vtkm::cont::make_ArrayHandleCompositeVector(
+    bvh.AABB.xmins, bvh.AABB.ymins, bvh.AABB.zmins);
+  auto maxs = vtkm::cont::make_ArrayHandleCompositeVector(
+    bvh.AABB.xmaxs, bvh.AABB.ymaxs, bvh.AABB.zmaxs);
+
+  vtkm::cont::Invoker invoke;
+  SAHSplit splitter(bvh.GetNumberOfPrimitives());
+  vtkm::cont::ArrayHandle<vtkm::Id4> leftRanges;
+  vtkm::cont::ArrayHandle<vtkm::Id4> rightRanges;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> leftIsInner;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> rightIsInner;
+  while (ranges.GetNumberOfValues() > 0)
+  {
+    invoke(splitter,
+           ranges,
+           mins,
+           maxs,
+           bvh.leafs,
+           bvh.leftChild,
+           bvh.rightChild,
+           bvh.parent,
+           leftRanges,
+           rightRanges,
+           leftIsInner,
+           rightIsInner);
+    // the children that are inner nodes are split next
+    auto childRanges = vtkm::cont::make_ArrayHandleConcatenate(leftRanges, rightRanges);
+    auto childIsInner = vtkm::cont::make_ArrayHandleConcatenate(leftIsInner, rightIsInner);
+    vtkm::cont::Algorithm::CopyIf(childRanges, childIsInner, ranges);
+  }
+}
+
 VTKM_CONT void LinearBVHBuilder::SortAABBS(BVHData& bvh, bool singleAABB)
 {
   //create array of indexes to be sorted with morton codes
@@ -593,22 +839,9 @@ VTKM_CONT void LinearBVHBuilder::Build(LinearBVH& linearBVH)
 
 
   // Find the extent of all bounding boxes to generate normalization for morton codes
-  vtkm::Vec3f_32 minExtent(vtkm::Infinity32(), vtkm::Infinity32(), vtkm::Infinity32());
-  vtkm::Vec3f_32 maxExtent(
-    vtkm::NegativeInfinity32(), vtkm::NegativeInfinity32(), vtkm::NegativeInfinity32());
-  maxExtent[0] = vtkm::cont::Algorithm::Reduce(bvh.AABB.xmaxs, maxExtent[0], MaxValue());
-  maxExtent[1] = vtkm::cont::Algorithm::Reduce(bvh.AABB.ymaxs, maxExtent[1], MaxValue());
-  maxExtent[2] = vtkm::cont::Algorithm::Reduce(bvh.AABB.zmaxs, maxExtent[2], MaxValue());
-  minExtent[0] = vtkm::cont::Algorithm::Reduce(bvh.AABB.xmins, minExtent[0], MinValue());
-  minExtent[1] = vtkm::cont::Algorithm::Reduce(bvh.AABB.ymins, minExtent[1], MinValue());
-  minExtent[2] = vtkm::cont::Algorithm::Reduce(bvh.AABB.zmins, minExtent[2], MinValue());
-
-  linearBVH.TotalBounds.X.Min = minExtent[0];
-  linearBVH.TotalBounds.X.Max = maxExtent[0];
-  linearBVH.TotalBounds.Y.Min = minExtent[1];
-  linearBVH.TotalBounds.Y.Max = maxExtent[1];
-  linearBVH.TotalBounds.Z.Min = minExtent[2];
-  linearBVH.TotalBounds.Z.Max = maxExtent[2];
+  vtkm::Vec3f_32 minExtent;
+  vtkm::Vec3f_32 maxExtent;
+  this->ComputeTotalBounds(linearBVH, minExtent, maxExtent);
 
   vtkm::Vec3f_32 deltaExtent = maxExtent - minExtent;
   vtkm::Vec3f_32 inverseExtent;
@@ -631,34 +864,94 @@ VTKM_CONT void LinearBVHBuilder::Build(LinearBVH& linearBVH)
 
   SortAABBS(bvh, singleAABB);
 
-  vtkm::worklet::DispatcherMapField<TreeBuilder> treeDispatch(
-    TreeBuilder(bvh.GetNumberOfPrimitives()));
-  treeDispatch.Invoke(bvh.leftChild, bvh.rightChild, bvh.mortonCodes, bvh.parent);
+  if (linearBVH.GetBuildMode() == LinearBVH::BuildMode::SAH)
+  {
+    this->BuildHierarchy(bvh);
+  }
+  else
+  {
+    vtkm::worklet::DispatcherMapField<TreeBuilder> treeDispatch(
+      TreeBuilder(bvh.GetNumberOfPrimitives()));
+    treeDispatch.Invoke(bvh.leftChild, bvh.rightChild, bvh.mortonCodes, bvh.parent);
+  }
+
+  linearBVH.Parents = bvh.parent;
+  linearBVH.LeftChildren = bvh.leftChild;
+  linearBVH.RightChildren = bvh.rightChild;
+  this->PropagateBounds(linearBVH);
+
+  linearBVH.Leafs = bvh.leafs;
+}
+
+VTKM_CONT void LinearBVHBuilder::Refit(LinearBVH& linearBVH, AABBs& aabbs)
+{
+  // Leaf i of the tree holds primitive Leafs[2 * i + 1], so gather the new boxes in the
+  // order of the leaves.
+  vtkm::cont::ArrayHandleStride<vtkm::Id> primitiveIds(
+    linearBVH.Leafs, linearBVH.LeafCount, 2, 1);
+  vtkm::worklet::DispatcherMapField<GatherFloat32> gatherDispatcher;
+  AABBs& sorted = linearBVH.GetAABBs();
+  gatherDispatcher.Invoke(primitiveIds, aabbs.xmins, sorted.xmins);
+  gatherDispatcher.Invoke(primitiveIds, aabbs.ymins, sorted.ymins);
+  gatherDispatcher.Invoke(primitiveIds, aabbs.zmins, sorted.zmins);
+  gatherDispatcher.Invoke(primitiveIds, aabbs.xmaxs, sorted.xmaxs);
+  gatherDispatcher.Invoke(primitiveIds, aabbs.ymaxs, sorted.ymaxs);
+  gatherDispatcher.Invoke(primitiveIds, aabbs.zmaxs, sorted.zmaxs);
+
+  vtkm::Vec3f_32 minExtent;
+  vtkm::Vec3f_32 maxExtent;
+  this->ComputeTotalBounds(linearBVH, minExtent, maxExtent);
+  this->PropagateBounds(linearBVH);
+}
+
+VTKM_CONT void LinearBVHBuilder::ComputeTotalBounds(LinearBVH& linearBVH,
+                                                    vtkm::Vec3f_32& minExtent,
+                                                    vtkm::Vec3f_32& maxExtent)
+{
+  AABBs& aabbs = linearBVH.GetAABBs();
+  minExtent = vtkm::Vec3f_32(vtkm::Infinity32(), vtkm::Infinity32(), vtkm::Infinity32());
+  maxExtent = vtkm::Vec3f_32(
+    vtkm::NegativeInfinity32(), vtkm::NegativeInfinity32(), vtkm::NegativeInfinity32());
+  maxExtent[0] = vtkm::cont::Algorithm::Reduce(aabbs.xmaxs, maxExtent[0], MaxValue());
+  maxExtent[1] = vtkm::cont::Algorithm::Reduce(aabbs.ymaxs, maxExtent[1], MaxValue());
+  maxExtent[2] = vtkm::cont::Algorithm::Reduce(aabbs.zmaxs, maxExtent[2], MaxValue());
+  minExtent[0] = vtkm::cont::Algorithm::Reduce(aabbs.xmins, minExtent[0], MinValue());
+  minExtent[1] = vtkm::cont::Algorithm::Reduce(aabbs.ymins, minExtent[1], MinValue());
+  minExtent[2] = vtkm::cont::Algorithm::Reduce(aabbs.zmins, minExtent[2], MinValue());
+
+  linearBVH.TotalBounds.X.Min = minExtent[0];
+  linearBVH.TotalBounds.X.Max = maxExtent[0];
+  linearBVH.TotalBounds.Y.Min = minExtent[1];
+  linearBVH.TotalBounds.Y.Max = maxExtent[1];
+  linearBVH.TotalBounds.Z.Min = minExtent[2];
+  linearBVH.TotalBounds.Z.Max = maxExtent[2];
+}
 
-  const vtkm::Int32 primitiveCount = vtkm::Int32(bvh.GetNumberOfPrimitives());
+VTKM_CONT void LinearBVHBuilder::PropagateBounds(LinearBVH& linearBVH)
+{
+  const vtkm::Int32 primitiveCount = vtkm::Int32(linearBVH.LeafCount);
 
   vtkm::cont::ArrayHandle<vtkm::Int32> counters;
-  counters.Allocate(bvh.GetNumberOfPrimitives() - 1);
+  counters.Allocate(linearBVH.LeafCount - 1);
 
-  vtkm::cont::ArrayHandleConstant<vtkm::Int32> zero(0, bvh.GetNumberOfPrimitives() - 1);
+  vtkm::cont::ArrayHandleConstant<vtkm::Int32> zero(0, linearBVH.LeafCount - 1);
   vtkm::cont::Algorithm::Copy(zero, counters);
 
   vtkm::worklet::DispatcherMapField<PropagateAABBs> propDispatch(PropagateAABBs{ primitiveCount });
 
-  propDispatch.Invoke(bvh.AABB.xmins,
-                      bvh.AABB.ymins,
-                      bvh.AABB.zmins,
-                      bvh.AABB.xmaxs,
-                      bvh.AABB.ymaxs,
-                      bvh.AABB.zmaxs,
-                      bvh.leafOffsets,
-                      bvh.parent,
-                      bvh.leftChild,
-                      bvh.rightChild,
+  AABBs& aabbs = linearBVH.GetAABBs();
+  propDispatch.Invoke(aabbs.xmins,
+                      aabbs.ymins,
+                      aabbs.zmins,
+                      aabbs.xmaxs,
+                      aabbs.ymaxs,
+                      aabbs.zmaxs,
+                      vtkm::cont::ArrayHandleCounting<vtkm::Id>(0, 2, linearBVH.LeafCount),
+                      linearBVH.Parents,
+                      linearBVH.LeftChildren,
+                      linearBVH.RightChildren,
                       counters,
                       linearBVH.FlatBVH);
-
-  linearBVH.Leafs = bvh.leafs;
 }
 } //namespace detail
 
@@ -679,9 +972,14 @@ LinearBVH::LinearBVH(const LinearBVH& other)
   : AABB(other.AABB)
   , FlatBVH(other.FlatBVH)
   , Leafs(other.Leafs)
+  , TotalBounds(other.TotalBounds)
   , LeafCount(other.LeafCount)
+  , Parents(other.Parents)
+  , LeftChildren(other.LeftChildren)
+  , RightChildren(other.RightChildren)
   , IsConstructed(other.IsConstructed)
   , CanConstruct(other.CanConstruct)
+  , Mode(other.Mode)
 {
 }
 
@@ -701,6 +999,7 @@ void LinearBVH::Construct()
 
   detail::LinearBVHBuilder builder;
   builder.Build(*this);
+  IsConstructed = true;
 }
 
 VTKM_CONT
@@ -711,6 +1010,37 @@ void LinearBVH::SetData(AABBs& aabbs)
   CanConstruct = true;
 }
 
+VTKM_CONT
+void LinearBVH::Refit(AABBs& aabbs)
+{
+  // a single box is duplicated into two leaves, so it is simply rebuilt
+  if (!IsConstructed || aabbs.xmins.GetNumberOfValues() != LeafCount || LeafCount < 3)
+  {
+    this->SetData(aabbs);
+    this->Construct();
+    return;
+  }
+
+  detail::LinearBVHBuilder builder;
+  builder.Refit(*this, aabbs);
+}
+
+VTKM_CONT
+void LinearBVH::SetBuildMode(BuildMode mode)
+{
+  if (mode != Mode)
+  {
+    Mode = mode;
+    IsConstructed = false;
+  }
+}
+
+VTKM_CONT
+LinearBVH::BuildMode LinearBVH::GetBuildMode() const
+{
+  return Mode;
+}
+
 // explicitly export
 //template VTKM_RENDERING_EXPORT void LinearBVH::ConstructOnDevice<
 //  vtkm::cont::DeviceAdapterTagSerial>(vtkm::cont::DeviceAdapterTagSerial);
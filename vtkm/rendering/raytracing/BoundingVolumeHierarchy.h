@@ -45,9 +45,27 @@ public:
   vtkm::Bounds TotalBounds;
   vtkm::Id LeafCount;
 
+  // Topology of the tree, kept to refit the node bounds. Leaves are numbered after the
+  // LeafCount - 1 inner nodes.
+  vtkm::cont::ArrayHandle<vtkm::Id> Parents;
+  vtkm::cont::ArrayHandle<vtkm::Id> LeftChildren;
+  vtkm::cont::ArrayHandle<vtkm::Id> RightChildren;
+
+  /// How the primitives are split into nodes.
+  enum struct BuildMode
+  {
+    /// Sort the primitives along a Morton curve and split at the highest differing bit of
+    /// the codes. Fastest to build.
+    Morton,
+    /// Split each node where a binned surface area heuristic is lowest. Slower to build,
+    /// but faster to trace, which pays off for geometry rendered many times.
+    SAH
+  };
+
 protected:
   bool IsConstructed;
   bool CanConstruct;
+  BuildMode Mode = BuildMode::Morton;
 
 public:
   LinearBVH();
@@ -66,6 +84,20 @@ public:
   VTKM_CONT
   void SetData(AABBs& aabbs);
 
+  /// \brief Updates the bounds of the nodes for new bounding boxes of the same primitives.
+  ///
+  /// The tree is kept as is, which is much faster than constructing a new one when the
+  /// primitives only moved a little. If the tree was not constructed or the number of
+  /// primitives changed, a new tree is constructed.
+  VTKM_CONT
+  void Refit(AABBs& aabbs);
+
+  VTKM_CONT
+  void SetBuildMode(BuildMode mode);
+
+  VTKM_CONT
+  BuildMode GetBuildMode() const;
+
   VTKM_CONT
   AABBs& GetAABBs();
 
@@ -462,7 +462,7 @@ void CylinderIntersector::IntersectRaysImp(Ray<Precision>& rays, bool vtkmNotUse
 
   detail::CylinderLeafWrapper leafIntersector(this->CylIds, Radii);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->PacketTraversal);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
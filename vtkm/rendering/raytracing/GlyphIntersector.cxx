@@ -574,7 +574,7 @@ void GlyphIntersector::IntersectRaysImp(Ray<Precision>& rays, bool vtkmNotUsed(r
 {
   detail::GlyphLeafWrapper leafIntersector(this->PointIds, Sizes, this->GlyphType);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->PacketTraversal);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
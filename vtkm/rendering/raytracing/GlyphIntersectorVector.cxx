@@ -651,7 +651,7 @@ void GlyphIntersectorVector::IntersectRaysImp(Ray<Precision>& rays,
   detail::GlyphVectorLeafWrapper leafIntersector(
     this->GlyphType, this->PointIds, this->Sizes, this->ArrowBodyRadius, this->ArrowHeadRadius);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->PacketTraversal);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
@@ -487,7 +487,7 @@ void QuadIntersector::IntersectRaysImp(Ray<Precision>& rays, bool vtkmNotUsed(re
 
   detail::QuadExecWrapper leafIntersector(this->QuadIds);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->PacketTraversal);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
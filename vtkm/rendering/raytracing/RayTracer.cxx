@@ -240,12 +240,22 @@ void RayTracer::SetColorMap(const vtkm::cont::ArrayHandle<vtkm::Vec4f_32>& color
 
 void RayTracer::Render(Ray<vtkm::Float32>& rays)
 {
-  RenderOnDevice(rays);
+  RenderOnDevice(rays, true);
 }
 
 void RayTracer::Render(Ray<vtkm::Float64>& rays)
 {
-  RenderOnDevice(rays);
+  RenderOnDevice(rays, true);
+}
+
+void RayTracer::ShadeRays(Ray<vtkm::Float32>& rays)
+{
+  RenderOnDevice(rays, false);
+}
+
+void RayTracer::ShadeRays(Ray<vtkm::Float64>& rays)
+{
+  RenderOnDevice(rays, false);
 }
 
 void RayTracer::SetShadingOn(bool on)
@@ -264,7 +274,7 @@ void RayTracer::Clear()
 }
 
 template <typename Precision>
-void RayTracer::RenderOnDevice(Ray<Precision>& rays)
+void RayTracer::RenderOnDevice(Ray<Precision>& rays, bool intersect)
 {
   using Timer = vtkm::cont::Timer;
 
@@ -286,11 +296,14 @@ void RayTracer::RenderOnDevice(Ray<Precision>& rays)
 
     for (size_t i = 0; i < numShapes; ++i)
     {
-      Intersectors[i]->IntersectRays(rays);
-      time = timer.GetElapsedTime();
-      logger->AddLogData("intersect", time);
+      if (intersect)
+      {
+        Intersectors[i]->IntersectRays(rays);
+        time = timer.GetElapsedTime();
+        logger->AddLogData("intersect", time);
+        timer.Start();
+      }
 
-      timer.Start();
       Intersectors[i]->IntersectionData(rays, ScalarField, ScalarRange);
       time = timer.GetElapsedTime();
       logger->AddLogData("intersection_data", time);
@@ -36,7 +36,7 @@ protected:
   bool Shade;
 
   template <typename Precision>
-  void RenderOnDevice(Ray<Precision>& rays);
+  void RenderOnDevice(Ray<Precision>& rays, bool intersect);
 
 public:
   VTKM_CONT
@@ -65,6 +65,14 @@ public:
   VTKM_CONT
   void Render(vtkm::rendering::raytracing::Ray<vtkm::Float64>& rays);
 
+  /// Colors rays that were already intersected by `Render` again, without tracing them. For a
+  /// new field, scalar range or color map on the same shapes.
+  VTKM_CONT
+  void ShadeRays(vtkm::rendering::raytracing::Ray<vtkm::Float32>& rays);
+
+  VTKM_CONT
+  void ShadeRays(vtkm::rendering::raytracing::Ray<vtkm::Float64>& rays);
+
   VTKM_CONT
   vtkm::Id GetNumberOfShapes() const;
 
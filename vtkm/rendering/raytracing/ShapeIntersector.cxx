@@ -87,12 +87,61 @@ vtkm::Bounds ShapeIntersector::GetShapeBounds() const
   return ShapeBounds;
 }
 
-void ShapeIntersector::SetAABBs(AABBs& aabbs)
+void ShapeIntersector::SetAABBs(AABBs& aabbs, bool samePrimitives)
 {
-  this->BVH.SetData(aabbs);
-  this->BVH.Construct();
+  if (samePrimitives)
+  {
+    this->BVH.Refit(aabbs);
+  }
+  else
+  {
+    this->BVH.SetData(aabbs);
+    this->BVH.Construct();
+  }
   this->ShapeBounds = this->BVH.TotalBounds;
 }
+
+void ShapeIntersector::CheckVersions(
+  const std::vector<vtkm::cont::UnknownArrayHandle>& primitiveArrays,
+  const std::vector<vtkm::cont::UnknownArrayHandle>& boundsArrays,
+  bool& samePrimitives,
+  bool& sameBounds)
+{
+  // buffer versions are unique and change on every modification, so equal versions mean the
+  // same unmodified buffers
+  std::vector<vtkm::UInt64> primitiveVersions;
+  for (const auto& array : primitiveArrays)
+  {
+    std::vector<vtkm::UInt64> versions = array.GetBufferVersions();
+    primitiveVersions.insert(primitiveVersions.end(), versions.begin(), versions.end());
+  }
+  std::vector<vtkm::UInt64> boundsVersions;
+  for (const auto& array : boundsArrays)
+  {
+    std::vector<vtkm::UInt64> versions = array.GetBufferVersions();
+    boundsVersions.insert(boundsVersions.end(), versions.begin(), versions.end());
+  }
+
+  samePrimitives = this->BVH.GetIsConstructed() && primitiveVersions == this->PrimitiveVersions;
+  sameBounds = samePrimitives && boundsVersions == this->BoundsVersions;
+  this->PrimitiveVersions = primitiveVersions;
+  this->BoundsVersions = boundsVersions;
+}
+
+void ShapeIntersector::SetBVHBuildMode(LinearBVH::BuildMode mode)
+{
+  this->BVH.SetBuildMode(mode);
+}
+
+void ShapeIntersector::SetPacketTraversal(bool packetTraversal)
+{
+  this->PacketTraversal = packetTraversal;
+}
+
+bool ShapeIntersector::GetPacketTraversal() const
+{
+  return this->PacketTraversal;
+}
 }
 }
 } //namespace vtkm::rendering::raytracing
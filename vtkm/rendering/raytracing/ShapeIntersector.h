@@ -14,6 +14,8 @@
 #include <vtkm/rendering/raytracing/BoundingVolumeHierarchy.h>
 #include <vtkm/rendering/raytracing/Ray.h>
 
+#include <vector>
+
 namespace vtkm
 {
 namespace rendering
@@ -27,12 +29,35 @@ protected:
   LinearBVH BVH;
   vtkm::cont::CoordinateSystem CoordsHandle;
   vtkm::Bounds ShapeBounds;
-  void SetAABBs(AABBs& aabbs);
+  bool PacketTraversal = false;
+
+  // Builds the BVH over the boxes. When the boxes belong to the same primitives as the last
+  // call, the BVH is refit instead.
+  void SetAABBs(AABBs& aabbs, bool samePrimitives = false);
+
+  // Compares the buffer versions of the arrays defining the primitives, and of the arrays
+  // that only move them, with the ones of the last call, then records the new versions.
+  void CheckVersions(const std::vector<vtkm::cont::UnknownArrayHandle>& primitiveArrays,
+                     const std::vector<vtkm::cont::UnknownArrayHandle>& boundsArrays,
+                     bool& samePrimitives,
+                     bool& sameBounds);
+
+private:
+  std::vector<vtkm::UInt64> PrimitiveVersions;
+  std::vector<vtkm::UInt64> BoundsVersions;
 
 public:
   ShapeIntersector();
   virtual ~ShapeIntersector();
 
+  /// Selects how the BVH is built. The BVH is rebuilt by the next SetData.
+  void SetBVHBuildMode(LinearBVH::BuildMode mode);
+
+  /// Traverses the BVH with packets of consecutive rays on host devices. This pays off for
+  /// coherent rays, like the primary rays of a camera.
+  void SetPacketTraversal(bool packetTraversal);
+  bool GetPacketTraversal() const;
+
   //
   //  Intersect Rays finds the nearest intersection shape contained in the derived
   //  class in between min and max distances. HitIdx will be set to the local
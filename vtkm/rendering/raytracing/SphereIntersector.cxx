@@ -304,9 +304,17 @@ void SphereIntersector::SetData(const vtkm::cont::CoordinateSystem& coords,
                                 vtkm::cont::ArrayHandle<vtkm::Id> pointIds,
                                 vtkm::cont::ArrayHandle<vtkm::Float32> radii)
 {
+  // Spheres that only moved or changed radius refit the BVH instead of building a new one.
+  bool sameSpheres;
+  bool sameBounds;
+  this->CheckVersions({ pointIds }, { radii, coords.GetData() }, sameSpheres, sameBounds);
   this->PointIds = pointIds;
   this->Radii = radii;
   this->CoordsHandle = coords;
+  if (sameBounds)
+  {
+    return;
+  }
   AABBs AABB;
   vtkm::worklet::DispatcherMapField<detail::FindSphereAABBs>(detail::FindSphereAABBs())
     .Invoke(PointIds,
@@ -319,7 +327,7 @@ void SphereIntersector::SetData(const vtkm::cont::CoordinateSystem& coords,
             AABB.zmaxs,
             CoordsHandle);
 
-  this->SetAABBs(AABB);
+  this->SetAABBs(AABB, sameSpheres);
 }
 
 void SphereIntersector::IntersectRays(Ray<vtkm::Float32>& rays, bool returnCellIndex)
@@ -338,7 +346,7 @@ void SphereIntersector::IntersectRaysImp(Ray<Precision>& rays, bool vtkmNotUsed(
 
   detail::SphereLeafWrapper leafIntersector(this->PointIds, Radii);
 
-  BVHTraverser traverser;
+  BVHTraverser traverser(this->PacketTraversal);
   traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
 
   RayOperations::UpdateRayStatus(rays);
@@ -389,6 +397,11 @@ void SphereIntersector::IntersectionData(Ray<vtkm::Float64>& rays,
   IntersectionDataImp(rays, scalarField, scalarRange);
 }
 
+vtkm::cont::ArrayHandle<vtkm::Id> SphereIntersector::GetPointIds() const
+{
+  return this->PointIds;
+}
+
 vtkm::Id SphereIntersector::GetNumberOfShapes() const
 {
   return PointIds.GetNumberOfValues();
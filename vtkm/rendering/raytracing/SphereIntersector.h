@@ -55,6 +55,8 @@ public:
                         const vtkm::cont::Field scalarField,
                         const vtkm::Range& scalarRange) override;
 
+  vtkm::cont::ArrayHandle<vtkm::Id> GetPointIds() const;
+
   vtkm::Id GetNumberOfShapes() const override;
 }; // class ShapeIntersector
 }
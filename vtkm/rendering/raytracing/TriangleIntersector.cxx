@@ -474,9 +474,16 @@ void TriangleIntersector::SetUseWaterTight(bool useIt)
 void TriangleIntersector::SetData(const vtkm::cont::CoordinateSystem& coords,
                                   vtkm::cont::ArrayHandle<vtkm::Id4> triangles)
 {
-
+  // Reusing the BVH of the same triangles is much cheaper than building a new one.
+  bool sameTriangles;
+  bool sameBounds;
+  this->CheckVersions({ triangles }, { coords.GetData() }, sameTriangles, sameBounds);
   CoordsHandle = coords;
   Triangles = triangles;
+  if (sameBounds)
+  {
+    return;
+  }
 
   vtkm::rendering::raytracing::AABBs AABB;
   vtkm::worklet::DispatcherMapField<detail::FindTriangleAABBs>(detail::FindTriangleAABBs())
@@ -489,7 +496,7 @@ void TriangleIntersector::SetData(const vtkm::cont::CoordinateSystem& coords,
             AABB.zmaxs,
             CoordsHandle);
 
-  this->SetAABBs(AABB);
+  this->SetAABBs(AABB, sameTriangles);
 }
 
 vtkm::cont::ArrayHandle<vtkm::Id4> TriangleIntersector::GetTriangles()
@@ -516,14 +523,14 @@ VTKM_CONT void TriangleIntersector::IntersectRaysImp(Ray<Precision>& rays, bool
   if (UseWaterTight)
   {
     detail::WaterTightExecWrapper leafIntersector(this->Triangles);
-    BVHTraverser traverser;
+    BVHTraverser traverser(this->PacketTraversal);
     traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
   }
   else
   {
     detail::MollerExecWrapper leafIntersector(this->Triangles);
 
-    BVHTraverser traverser;
+    BVHTraverser traverser(this->PacketTraversal);
     traverser.IntersectRays(rays, this->BVH, leafIntersector, this->CoordsHandle);
   }
   // Normally we return the index of the triangle hit,
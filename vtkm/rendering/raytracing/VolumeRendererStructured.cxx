@@ -11,8 +11,10 @@
 
 #include <cmath>
 #include <iostream>
+#include <vtkm/Swap.h>
 #include <vtkm/cont/ArrayHandleCartesianProduct.h>
 #include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
 #include <vtkm/cont/ArrayHandleUniformPointCoordinates.h>
 #include <vtkm/cont/CellLocatorRectilinearGrid.h>
 #include <vtkm/cont/CellLocatorUniformGrid.h>
@@ -185,6 +187,194 @@ public:
   }
 }; // class UniformLocatorAdapter
 
+// Execution side of the macro cell grid. A macro cell groups MacroCellSize^3 cells and is
+// flagged empty when every scalar inside it maps to a transparent color.
+class MacroCellSkipper
+{
+private:
+  using FlagPortal = typename vtkm::cont::ArrayHandle<vtkm::UInt8>::ReadPortalType;
+  FlagPortal EmptyMacroCells;
+  vtkm::Id3 CellDims;
+  vtkm::Id3 MacroDims;
+  vtkm::Id MacroCellSize;
+
+public:
+  template <typename Device>
+  VTKM_CONT MacroCellSkipper(const vtkm::cont::ArrayHandle<vtkm::UInt8>& emptyMacroCells,
+                             const vtkm::Id3& cellDims,
+                             const vtkm::Id3& macroDims,
+                             const vtkm::Id& macroCellSize,
+                             Device,
+                             vtkm::cont::Token& token)
+    : EmptyMacroCells(emptyMacroCells.PrepareForInput(Device(), token))
+    , CellDims(cellDims)
+    , MacroDims(macroDims)
+    , MacroCellSize(emptyMacroCells.GetNumberOfValues() > 0 ? macroCellSize : 0)
+  {
+  }
+
+  // If the cell lies in an empty macro cell, advances distance by whole sample steps to the
+  // first sample past the macro cell and returns true.
+  template <typename LocatorType>
+  VTKM_EXEC bool Leap(const LocatorType& locator,
+                      const vtkm::Id3& cell,
+                      const vtkm::Vec3f_32& rayOrigin,
+                      const vtkm::Vec3f_32& rayDir,
+                      const vtkm::Float32& sampleDistance,
+                      vtkm::Float32& distance) const
+  {
+    if (this->MacroCellSize == 0)
+    {
+      return false;
+    }
+    vtkm::Id3 lowCell;
+    vtkm::Id3 highCell;
+    vtkm::Id3 macro;
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      macro[i] = cell[i] / this->MacroCellSize;
+      lowCell[i] = macro[i] * this->MacroCellSize;
+      highCell[i] = vtkm::Min(lowCell[i] + this->MacroCellSize, this->CellDims[i]);
+    }
+    const vtkm::Id macroIndex =
+      (macro[2] * this->MacroDims[1] + macro[1]) * this->MacroDims[0] + macro[0];
+    if (this->EmptyMacroCells.Get(macroIndex) == 0)
+    {
+      return false;
+    }
+
+    // the low corner of the highest cell index is the far corner of the macro cell
+    vtkm::Vec3f_32 low;
+    vtkm::Vec3f_32 high;
+    locator.GetMinPoint(lowCell, low);
+    locator.GetMinPoint(highCell, high);
+    vtkm::Float32 exitDistance = vtkm::Infinity32();
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      if (rayDir[i] != 0.f)
+      {
+        const vtkm::Float32 plane = rayDir[i] > 0.f ? high[i] : low[i];
+        exitDistance = vtkm::Min(exitDistance, (plane - rayOrigin[i]) / rayDir[i]);
+      }
+    }
+    const vtkm::Float32 steps = vtkm::Ceil((exitDistance - distance) / sampleDistance);
+    distance += vtkm::Max(steps, 1.f) * sampleDistance;
+    return true;
+  }
+}; // class MacroCellSkipper
+
+// Computes the range of the field over each macro cell. Point fields include the points on the
+// far faces, which the samples of the last cells interpolate from.
+class MacroCellRange : public vtkm::worklet::WorkletMapField
+{
+private:
+  vtkm::Id3 ValueDims;
+  vtkm::Id3 MacroDims;
+  vtkm::Id MacroCellSize;
+  vtkm::Id Overlap;
+
+public:
+  VTKM_CONT
+  MacroCellRange(const vtkm::Id3& valueDims,
+                 const vtkm::Id3& macroDims,
+                 const vtkm::Id& macroCellSize,
+                 bool isAssocPoints)
+    : ValueDims(valueDims)
+    , MacroDims(macroDims)
+    , MacroCellSize(macroCellSize)
+    , Overlap(isAssocPoints ? 1 : 0)
+  {
+  }
+
+  using ControlSignature = void(FieldIn, WholeArrayIn, FieldOut);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename ScalarPortalType>
+  VTKM_EXEC void operator()(const vtkm::Id& macroIndex,
+                            const ScalarPortalType& scalars,
+                            vtkm::Vec2f_32& range) const
+  {
+    const vtkm::Id3 macro(macroIndex % this->MacroDims[0],
+                          (macroIndex / this->MacroDims[0]) % this->MacroDims[1],
+                          macroIndex / (this->MacroDims[0] * this->MacroDims[1]));
+    vtkm::Id3 start;
+    vtkm::Id3 end;
+    for (vtkm::IdComponent i = 0; i < 3; ++i)
+    {
+      start[i] = macro[i] * this->MacroCellSize;
+      end[i] = vtkm::Min(start[i] + this->MacroCellSize + this->Overlap, this->ValueDims[i]);
+    }
+
+    range = vtkm::Vec2f_32(vtkm::Infinity32(), vtkm::NegativeInfinity32());
+    for (vtkm::Id k = start[2]; k < end[2]; ++k)
+    {
+      for (vtkm::Id j = start[1]; j < end[1]; ++j)
+      {
+        for (vtkm::Id i = start[0]; i < end[0]; ++i)
+        {
+          const auto value =
+            vtkm::Float32(scalars.Get((k * this->ValueDims[1] + j) * this->ValueDims[0] + i));
+          range[0] = vtkm::Min(range[0], value);
+          range[1] = vtkm::Max(range[1], value);
+        }
+      }
+    }
+  }
+}; // class MacroCellRange
+
+// Flags the macro cells whose range only maps to transparent entries of the color map.
+class ClassifyMacroCells : public vtkm::worklet::WorkletMapField
+{
+private:
+  vtkm::Id ColorMapSize;
+  vtkm::Float32 MinScalar;
+  vtkm::Float32 InverseDeltaScalar;
+
+  VTKM_EXEC vtkm::Id ColorIndex(const vtkm::Float32& scalar) const
+  {
+    // same mapping as the samplers
+    vtkm::Float32 normalizedScalar = (scalar - MinScalar) * InverseDeltaScalar;
+    auto colorIndex =
+      static_cast<vtkm::Id>(normalizedScalar * static_cast<vtkm::Float32>(ColorMapSize));
+    return vtkm::Max(vtkm::Id(0), vtkm::Min(colorIndex, ColorMapSize));
+  }
+
+public:
+  VTKM_CONT
+  ClassifyMacroCells(const vtkm::Id& colorMapSize,
+                     const vtkm::Float32& minScalar,
+                     const vtkm::Float32& maxScalar)
+    : ColorMapSize(colorMapSize)
+    , MinScalar(minScalar)
+    , InverseDeltaScalar(minScalar)
+  {
+    if ((maxScalar - minScalar) != 0.f)
+    {
+      InverseDeltaScalar = 1.f / (maxScalar - minScalar);
+    }
+  }
+
+  using ControlSignature = void(FieldIn, WholeArrayIn, FieldOut);
+  using ExecutionSignature = void(_1, _2, _3);
+
+  template <typename CountPortalType>
+  VTKM_EXEC void operator()(const vtkm::Vec2f_32& range,
+                            const CountPortalType& visibleCounts,
+                            vtkm::UInt8& empty) const
+  {
+    vtkm::Id low = this->ColorIndex(range[0]);
+    vtkm::Id high = this->ColorIndex(range[1]);
+    if (low > high)
+    {
+      vtkm::Swap(low, high);
+    }
+    // widen by one entry so rounding in the interpolation cannot reach a visible color
+    low = vtkm::Max(low - 1, vtkm::Id(0));
+    high = vtkm::Min(high + 1, this->ColorMapSize);
+    empty = (visibleCounts.Get(high + 1) == visibleCounts.Get(low)) ? 1 : 0;
+  }
+}; // class ClassifyMacroCells
+
 } //namespace
 
 
@@ -201,6 +391,8 @@ private:
   vtkm::Float32 InverseDeltaScalar;
   LocatorType Locator;
   vtkm::Float32 MeshEpsilon;
+  MacroCellSkipper Skipper;
+  vtkm::Float32 OpacityThreshold;
 
 public:
   VTKM_CONT
@@ -210,6 +402,8 @@ public:
           const vtkm::Float32& sampleDistance,
           const LocatorType& locator,
           const vtkm::Float32& meshEpsilon,
+          const MacroCellSkipper& skipper,
+          const vtkm::Float32& opacityThreshold,
           vtkm::cont::Token& token)
     : ColorMap(colorMap.PrepareForInput(DeviceAdapterTag(), token))
     , MinScalar(minScalar)
@@ -217,6 +411,8 @@ public:
     , InverseDeltaScalar(minScalar)
     , Locator(locator)
     , MeshEpsilon(meshEpsilon)
+    , Skipper(skipper)
+    , OpacityThreshold(opacityThreshold)
   {
     ColorMapSize = colorMap.GetNumberOfValues() - 1;
     if ((maxScalar - minScalar) != 0.f)
@@ -299,8 +495,14 @@ public:
         newCell = true;
       if (newCell)
       {
-        vtkm::Vec<vtkm::Id, 8> cellIndices;
         Locator.LocateCell(cell, sampleLocation, invSpacing, parametric);
+        if (Skipper.Leap(Locator, cell, rayOrigin, rayDir, SampleDistance, distance))
+        {
+          // nothing visible in this macro cell, resume sampling past it
+          sampleLocation = rayOrigin + distance * rayDir;
+          continue;
+        }
+        vtkm::Vec<vtkm::Id, 8> cellIndices;
         Locator.GetCellIndices(cell, cellIndices);
         Locator.GetPoint(cellIndices[0], bottomLeft);
 
@@ -350,8 +552,8 @@ public:
       color[2] = color[2] + sampleColor[2] * alpha;
       color[3] = alpha + color[3];
 
-      // terminate the ray early if it became completely opaque.
-      if (color[3] >= 1.f)
+      // terminate the ray early once it is opaque enough.
+      if (color[3] >= OpacityThreshold)
         break;
 
       //advance
@@ -390,6 +592,8 @@ private:
   vtkm::Float32 InverseDeltaScalar;
   LocatorType Locator;
   vtkm::Float32 MeshEpsilon;
+  MacroCellSkipper Skipper;
+  vtkm::Float32 OpacityThreshold;
 
 public:
   VTKM_CONT
@@ -399,6 +603,8 @@ public:
                    const vtkm::Float32& sampleDistance,
                    const LocatorType& locator,
                    const vtkm::Float32& meshEpsilon,
+                   const MacroCellSkipper& skipper,
+                   const vtkm::Float32& opacityThreshold,
                    vtkm::cont::Token& token)
     : ColorMap(colorMap.PrepareForInput(DeviceAdapterTag(), token))
     , MinScalar(minScalar)
@@ -406,6 +612,8 @@ public:
     , InverseDeltaScalar(minScalar)
     , Locator(locator)
     , MeshEpsilon(meshEpsilon)
+    , Skipper(skipper)
+    , OpacityThreshold(opacityThreshold)
   {
     ColorMapSize = colorMap.GetNumberOfValues() - 1;
     if ((maxScalar - minScalar) != 0.f)
@@ -481,6 +689,12 @@ public:
       if (newCell)
       {
         Locator.LocateCell(cell, sampleLocation, invSpacing, parametric);
+        if (Skipper.Leap(Locator, cell, rayOrigin, rayDir, SampleDistance, distance))
+        {
+          // nothing visible in this macro cell, resume sampling past it
+          sampleLocation = rayOrigin + distance * rayDir;
+          continue;
+        }
         vtkm::Id cellId = Locator.GetCellIndex(cell);
         Locator.GetMinPoint(cell, bottomLeft);
 
@@ -505,8 +719,8 @@ public:
       color[2] = color[2] + sampleColor[2] * alpha;
       color[3] = alpha + color[3];
 
-      // terminate the ray early if it became completely opaque.
-      if (color[3] >= 1.f)
+      // terminate the ray early once it is opaque enough.
+      if (color[3] >= OpacityThreshold)
         break;
 
       //advance
@@ -646,6 +860,69 @@ void VolumeRendererStructured::Render(vtkm::rendering::raytracing::Ray<vtkm::Flo
 //  vtkm::cont::TryExecute(functor);
 //}
 
+template <typename Device>
+void VolumeRendererStructured::UpdateMacroCells(Device)
+{
+  if (this->MacroCellSize == 0)
+  {
+    this->MacroCellRanges.ReleaseResources();
+    this->MacroCellRangesKey.clear();
+    this->EmptyMacroCells.ReleaseResources();
+    return;
+  }
+
+  const bool isAssocPoints = this->ScalarField->IsPointField();
+  const vtkm::Id3 cellDims = this->Cellset.GetCellDimensions();
+  const vtkm::Id3 valueDims = isAssocPoints ? this->Cellset.GetPointDimensions() : cellDims;
+  for (vtkm::IdComponent i = 0; i < 3; ++i)
+  {
+    this->MacroCellDims[i] = (cellDims[i] + this->MacroCellSize - 1) / this->MacroCellSize;
+  }
+  const vtkm::Id numMacroCells =
+    this->MacroCellDims[0] * this->MacroCellDims[1] * this->MacroCellDims[2];
+
+  // The ranges only depend on the field values, so they are kept until the field changes.
+  std::vector<vtkm::UInt64> key = this->ScalarField->GetData().GetBufferVersions();
+  key.push_back(isAssocPoints ? 1 : 0);
+  key.push_back(static_cast<vtkm::UInt64>(valueDims[0]));
+  key.push_back(static_cast<vtkm::UInt64>(valueDims[1]));
+  key.push_back(static_cast<vtkm::UInt64>(valueDims[2]));
+  key.push_back(static_cast<vtkm::UInt64>(this->MacroCellSize));
+
+  vtkm::cont::Invoker invoke{ Device() };
+  if (key != this->MacroCellRangesKey)
+  {
+    invoke(MacroCellRange{ valueDims, this->MacroCellDims, this->MacroCellSize, isAssocPoints },
+           vtkm::cont::ArrayHandleIndex(numMacroCells),
+           vtkm::rendering::raytracing::GetScalarFieldArray(*this->ScalarField),
+           this->MacroCellRanges);
+    this->MacroCellRangesKey = std::move(key);
+  }
+
+  // The color map changes between renders, so the macro cells are classified each time.
+  // visibleCounts[i] is the number of visible colors before entry i.
+  const vtkm::Id numColors = this->ColorMap.GetNumberOfValues();
+  vtkm::cont::ArrayHandle<vtkm::Id> visibleCounts;
+  visibleCounts.Allocate(numColors + 1);
+  {
+    auto colorPortal = this->ColorMap.ReadPortal();
+    auto countPortal = visibleCounts.WritePortal();
+    vtkm::Id count = 0;
+    countPortal.Set(0, count);
+    for (vtkm::Id i = 0; i < numColors; ++i)
+    {
+      count += (colorPortal.Get(i)[3] > 0.f) ? 1 : 0;
+      countPortal.Set(i + 1, count);
+    }
+  }
+  invoke(ClassifyMacroCells{ numColors - 1,
+                             vtkm::Float32(this->ScalarRange.Min),
+                             vtkm::Float32(this->ScalarRange.Max) },
+         this->MacroCellRanges,
+         visibleCounts,
+         this->EmptyMacroCells);
+}
+
 template <typename Precision, typename Device>
 void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<Precision>& rays,
                                               Device)
@@ -663,10 +940,11 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
   extent[2] = static_cast<vtkm::Float32>(this->SpatialExtent.Z.Length());
   vtkm::Float32 mag_extent = vtkm::Magnitude(extent);
   vtkm::Float32 meshEpsilon = mag_extent * 0.0001f;
-  if (SampleDistance <= 0.f)
+  vtkm::Float32 sampleDistance = this->SampleDistance;
+  if (sampleDistance <= 0.f)
   {
     const vtkm::Float32 defaultNumberOfSamples = 200.f;
-    SampleDistance = mag_extent / defaultNumberOfSamples;
+    sampleDistance = mag_extent / defaultNumberOfSamples;
   }
 
   vtkm::cont::Invoker invoke;
@@ -691,6 +969,11 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
   }
   const bool isAssocPoints = ScalarField->IsPointField();
 
+  this->UpdateMacroCells(Device());
+  time = timer.GetElapsedTime();
+  logger->AddLogData("macro_cells", time);
+  timer.Start();
+
   if (IsUniformDataSet)
   {
     vtkm::cont::Token token;
@@ -701,15 +984,23 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
     uniLocator.SetCellSet(this->Cellset);
     uniLocator.SetCoordinates(this->Coordinates);
     UniformLocatorAdapter<Device> locator(vertices, this->Cellset, uniLocator, token);
+    MacroCellSkipper skipper(this->EmptyMacroCells,
+                             this->Cellset.GetCellDimensions(),
+                             this->MacroCellDims,
+                             this->MacroCellSize,
+                             Device(),
+                             token);
 
     if (isAssocPoints)
     {
       auto sampler = Sampler<Device, UniformLocatorAdapter<Device>>(ColorMap,
                                                                     vtkm::Float32(ScalarRange.Min),
                                                                     vtkm::Float32(ScalarRange.Max),
-                                                                    SampleDistance,
+                                                                    sampleDistance,
                                                                     locator,
                                                                     meshEpsilon,
+                                                                    skipper,
+                                                                    this->OpacityThreshold,
                                                                     token);
       invoke(sampler,
              rays.Dir,
@@ -725,9 +1016,11 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
         SamplerCellAssoc<Device, UniformLocatorAdapter<Device>>(ColorMap,
                                                                 vtkm::Float32(ScalarRange.Min),
                                                                 vtkm::Float32(ScalarRange.Max),
-                                                                SampleDistance,
+                                                                sampleDistance,
                                                                 locator,
                                                                 meshEpsilon,
+                                                                skipper,
+                                                                this->OpacityThreshold,
                                                                 token);
       invoke(sampler,
              rays.Dir,
@@ -747,6 +1040,12 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
     rectLocator.SetCellSet(this->Cellset);
     rectLocator.SetCoordinates(this->Coordinates);
     RectilinearLocatorAdapter<Device> locator(vertices, Cellset, rectLocator, token);
+    MacroCellSkipper skipper(this->EmptyMacroCells,
+                             this->Cellset.GetCellDimensions(),
+                             this->MacroCellDims,
+                             this->MacroCellSize,
+                             Device(),
+                             token);
 
     if (isAssocPoints)
     {
@@ -754,9 +1053,11 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
         Sampler<Device, RectilinearLocatorAdapter<Device>>(ColorMap,
                                                            vtkm::Float32(ScalarRange.Min),
                                                            vtkm::Float32(ScalarRange.Max),
-                                                           SampleDistance,
+                                                           sampleDistance,
                                                            locator,
                                                            meshEpsilon,
+                                                           skipper,
+                                                           this->OpacityThreshold,
                                                            token);
       invoke(sampler,
              rays.Dir,
@@ -772,9 +1073,11 @@ void VolumeRendererStructured::RenderOnDevice(vtkm::rendering::raytracing::Ray<P
         SamplerCellAssoc<Device, RectilinearLocatorAdapter<Device>>(ColorMap,
                                                                     vtkm::Float32(ScalarRange.Min),
                                                                     vtkm::Float32(ScalarRange.Max),
-                                                                    SampleDistance,
+                                                                    sampleDistance,
                                                                     locator,
                                                                     meshEpsilon,
+                                                                    skipper,
+                                                                    this->OpacityThreshold,
                                                                     token);
       invoke(sampler,
              rays.Dir,
@@ -799,6 +1102,36 @@ void VolumeRendererStructured::SetSampleDistance(const vtkm::Float32& distance)
     throw vtkm::cont::ErrorBadValue("Sample distance must be positive.");
   SampleDistance = distance;
 }
+
+void VolumeRendererStructured::SetOpacityThreshold(const vtkm::Float32& threshold)
+{
+  if (threshold <= 0.f || threshold > 1.f)
+    throw vtkm::cont::ErrorBadValue("Opacity threshold must be in (0, 1].");
+  OpacityThreshold = threshold;
+}
+
+void VolumeRendererStructured::SetMacroCellSize(const vtkm::Id& size)
+{
+  if (size < 0)
+    throw vtkm::cont::ErrorBadValue("Macro cell size must not be negative.");
+  MacroCellSize = size;
+}
+
+vtkm::Id VolumeRendererStructured::GetNumberOfMacroCells() const
+{
+  return this->EmptyMacroCells.GetNumberOfValues();
+}
+
+vtkm::Id VolumeRendererStructured::GetNumberOfEmptyMacroCells() const
+{
+  vtkm::Id count = 0;
+  auto portal = this->EmptyMacroCells.ReadPortal();
+  for (vtkm::Id i = 0; i < portal.GetNumberOfValues(); ++i)
+  {
+    count += (portal.Get(i) != 0) ? 1 : 0;
+  }
+  return count;
+}
 }
 }
 } //namespace vtkm::rendering::raytracing
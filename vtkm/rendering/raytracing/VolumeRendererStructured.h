@@ -15,6 +15,8 @@
 #include <vtkm/rendering/raytracing/Ray.h>
 #include <vtkm/rendering/vtkm_rendering_export.h>
 
+#include <vector>
+
 namespace vtkm
 {
 namespace rendering
@@ -44,10 +46,37 @@ public:
   VTKM_CONT
   void SetSampleDistance(const vtkm::Float32& distance);
 
+  /// \brief Sets the opacity at which a ray stops sampling.
+  ///
+  /// Must be in (0, 1]. The default of 1 only stops rays that became fully opaque. Lower values
+  /// trade a little accuracy for fewer samples behind opaque regions.
+  VTKM_CONT
+  void SetOpacityThreshold(const vtkm::Float32& threshold);
+
+  /// \brief Sets the number of cells along each axis of the macro cells used to skip empty space.
+  ///
+  /// The range of the field over each macro cell is computed once per field and compared with
+  /// the color map at each render. Rays leap over the macro cells where the color map is
+  /// transparent. 0 disables empty space skipping. The default is 8.
+  VTKM_CONT
+  void SetMacroCellSize(const vtkm::Id& size);
+
+  /// Number of macro cells of the last render.
+  VTKM_CONT
+  vtkm::Id GetNumberOfMacroCells() const;
+
+  /// Number of macro cells the last render skipped because the color map is transparent over
+  /// their range.
+  VTKM_CONT
+  vtkm::Id GetNumberOfEmptyMacroCells() const;
+
 protected:
   template <typename Precision, typename Device>
   VTKM_CONT void RenderOnDevice(vtkm::rendering::raytracing::Ray<Precision>& rays, Device);
 
+  template <typename Device>
+  VTKM_CONT void UpdateMacroCells(Device);
+
   bool IsSceneDirty = false;
   bool IsUniformDataSet = true;
   vtkm::Bounds SpatialExtent;
@@ -57,6 +86,13 @@ protected:
   vtkm::cont::ArrayHandle<vtkm::Vec4f_32> ColorMap;
   vtkm::Float32 SampleDistance = -1.f;
   vtkm::Range ScalarRange;
+  vtkm::Float32 OpacityThreshold = 1.f;
+  vtkm::Id MacroCellSize = 8;
+  vtkm::Id3 MacroCellDims{ 0, 0, 0 };
+  // min/max of the field over each macro cell, and what it was computed from
+  vtkm::cont::ArrayHandle<vtkm::Vec2f_32> MacroCellRanges;
+  std::vector<vtkm::UInt64> MacroCellRangesKey;
+  vtkm::cont::ArrayHandle<vtkm::UInt8> EmptyMacroCells;
 };
 }
 }
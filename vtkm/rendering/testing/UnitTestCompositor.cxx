@@ -0,0 +1,258 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/EnvironmentTracker.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/testing/Testing.h>
+#include <vtkm/rendering/Canvas.h>
+#include <vtkm/rendering/Compositor.h>
+#include <vtkm/rendering/internal/ImageCompositing.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+using Compositor = vtkm::rendering::Compositor;
+
+constexpr vtkm::Id WIDTH = 31;
+constexpr vtkm::Id HEIGHT = 17;
+
+// Image i is a translucent layer whose depth and color change over the pixels, so the images
+// overlap in a different order at each pixel.
+vtkm::Vec4f_32 ImageColor(vtkm::IdComponent image, vtkm::Id pixel)
+{
+  const vtkm::Float32 alpha = 0.2f + 0.1f * static_cast<vtkm::Float32>((image + pixel) % 7);
+  const vtkm::Float32 red = static_cast<vtkm::Float32>(image % 3) / 2.f;
+  const vtkm::Float32 green = static_cast<vtkm::Float32>(pixel % 5) / 4.f;
+  return vtkm::Vec4f_32(red * alpha, green * alpha, 0.5f * alpha, alpha);
+}
+
+vtkm::Float32 ImageDepth(vtkm::IdComponent image, vtkm::Id pixel)
+{
+  return static_cast<vtkm::Float32>((image * 13 + pixel * 7) % 11) / 11.f;
+}
+
+// Images are ordered back to front in their index.
+vtkm::Float32 ImageDistance(vtkm::IdComponent image, vtkm::IdComponent numImages)
+{
+  return static_cast<vtkm::Float32>(numImages - image);
+}
+
+void TestComposite(Compositor::CompositeMode mode,
+                   vtkm::IdComponent radix,
+                   vtkm::IdComponent numImages)
+{
+  const bool visibilityOrder = mode == Compositor::CompositeMode::VisibilityOrder;
+  std::cout << (visibilityOrder ? "Visibility order" : "Depth") << " compositing of " << numImages
+            << " images with radix " << radix << std::endl;
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+
+  // Images are dealt to the ranks in turn, so consecutive images live on different ranks.
+  Compositor compositor(mode);
+  compositor.SetRadix(radix);
+  vtkm::rendering::Canvas canvas(WIDTH, HEIGHT);
+  for (vtkm::IdComponent image = 0; image < numImages; ++image)
+  {
+    if (image % comm.size() != comm.rank())
+    {
+      continue;
+    }
+    auto colors = canvas.GetColorBuffer().WritePortal();
+    auto depths = canvas.GetDepthBuffer().WritePortal();
+    for (vtkm::Id pixel = 0; pixel < WIDTH * HEIGHT; ++pixel)
+    {
+      colors.Set(pixel, ImageColor(image, pixel));
+      depths.Set(pixel, ImageDepth(image, pixel));
+    }
+    compositor.AddImage(canvas, ImageDistance(image, numImages));
+  }
+  canvas.GetColorBuffer().Fill(vtkm::Vec4f_32(-1.f));
+  compositor.Composite(canvas);
+  VTKM_TEST_ASSERT(compositor.GetNumberOfImages() == 0);
+
+  auto colors = canvas.GetColorBuffer().ReadPortal();
+  auto depths = canvas.GetDepthBuffer().ReadPortal();
+  if (comm.rank() != 0)
+  {
+    VTKM_TEST_ASSERT(colors.Get(0) == vtkm::Vec4f_32(-1.f), "Only rank 0 gets the image");
+    return;
+  }
+  for (vtkm::Id pixel = 0; pixel < WIDTH * HEIGHT; ++pixel)
+  {
+    vtkm::Vec4f_32 color(0.f);
+    vtkm::Float32 depth = 1.f;
+    if (visibilityOrder)
+    {
+      for (vtkm::IdComponent image = numImages - 1; image >= 0; --image)
+      {
+        color = color + ImageColor(image, pixel) * (1.f - color[3]);
+        depth = vtkm::Min(depth, ImageDepth(image, pixel));
+      }
+    }
+    else
+    {
+      // equal depths keep the image of the lowest rank
+      vtkm::IdComponent closest = 0;
+      for (vtkm::IdComponent image = 1; image < numImages; ++image)
+      {
+        const vtkm::Float32 imageDepth = ImageDepth(image, pixel);
+        const vtkm::Float32 closestDepth = ImageDepth(closest, pixel);
+        if (imageDepth < closestDepth ||
+            (imageDepth == closestDepth && image % comm.size() < closest % comm.size()))
+        {
+          closest = image;
+        }
+      }
+      color = ImageColor(closest, pixel);
+      depth = ImageDepth(closest, pixel);
+    }
+    VTKM_TEST_ASSERT(test_equal(colors.Get(pixel), color), "Wrong color at pixel ", pixel);
+    VTKM_TEST_ASSERT(depths.Get(pixel) == depth, "Wrong depth at pixel ", pixel);
+  }
+}
+
+// The compositor blends the images of a rank locally, so with a single rank `TestComposite`
+// never exchanges image parts. This drives the radix-k exchange with several blocks per rank.
+void TestCompositeBlocks(bool visibilityOrder, vtkm::IdComponent radix, int numBlocks)
+{
+  std::cout << "Radix-k " << (visibilityOrder ? "visibility order" : "depth")
+            << " compositing of " << numBlocks << " blocks with radix " << radix << std::endl;
+  auto comm = vtkm::cont::EnvironmentTracker::GetCommunicator();
+
+  // Blocks are ordered front to back, so block b has image numBlocks - 1 - b.
+  std::vector<int> blockRanks;
+  std::vector<vtkm::rendering::internal::ImageBlock> localBlocks;
+  for (int gid = 0; gid < numBlocks; ++gid)
+  {
+    blockRanks.push_back(gid % comm.size());
+    if (blockRanks.back() != comm.rank())
+    {
+      continue;
+    }
+    const vtkm::IdComponent image = numBlocks - 1 - gid;
+    vtkm::rendering::internal::ImageBlock block;
+    block.Colors.Allocate(WIDTH * HEIGHT);
+    block.Depths.Allocate(WIDTH * HEIGHT);
+    auto colors = block.Colors.WritePortal();
+    auto depths = block.Depths.WritePortal();
+    for (vtkm::Id pixel = 0; pixel < WIDTH * HEIGHT; ++pixel)
+    {
+      colors.Set(pixel, ImageColor(image, pixel));
+      depths.Set(pixel, ImageDepth(image, pixel));
+    }
+    localBlocks.push_back(block);
+  }
+
+  const std::vector<vtkm::rendering::internal::ImageBlock> regions =
+    vtkm::rendering::internal::CompositeImageBlocks(
+      localBlocks, blockRanks, radix, visibilityOrder);
+  if (comm.rank() != 0)
+  {
+    VTKM_TEST_ASSERT(regions.empty(), "Only rank 0 gets the image");
+    return;
+  }
+  // Each block ends up with one part of the image.
+  VTKM_TEST_ASSERT(static_cast<int>(regions.size()) == numBlocks, "Wrong number of regions");
+
+  std::vector<bool> covered(static_cast<std::size_t>(WIDTH * HEIGHT), false);
+  for (const auto& region : regions)
+  {
+    auto colors = region.Colors.ReadPortal();
+    auto depths = region.Depths.ReadPortal();
+    for (vtkm::Id index = 0; index < colors.GetNumberOfValues(); ++index)
+    {
+      const vtkm::Id pixel = region.Begin + index;
+      VTKM_TEST_ASSERT(!covered[static_cast<std::size_t>(pixel)], "Pixel in two regions");
+      covered[static_cast<std::size_t>(pixel)] = true;
+
+      vtkm::Vec4f_32 color(0.f);
+      vtkm::Float32 depth = 1.f;
+      // equal depths keep the front block
+      vtkm::IdComponent closest = numBlocks - 1;
+      for (vtkm::IdComponent image = numBlocks - 1; image >= 0; --image)
+      {
+        color = color + ImageColor(image, pixel) * (1.f - color[3]);
+        depth = vtkm::Min(depth, ImageDepth(image, pixel));
+        if (ImageDepth(image, pixel) < ImageDepth(closest, pixel))
+        {
+          closest = image;
+        }
+      }
+      if (!visibilityOrder)
+      {
+        color = ImageColor(closest, pixel);
+        depth = ImageDepth(closest, pixel);
+      }
+      VTKM_TEST_ASSERT(test_equal(colors.Get(index), color), "Wrong color at pixel ", pixel);
+      VTKM_TEST_ASSERT(depths.Get(index) == depth, "Wrong depth at pixel ", pixel);
+    }
+  }
+  VTKM_TEST_ASSERT(std::all_of(covered.begin(), covered.end(), [](bool c) { return c; }),
+                   "Regions do not cover the image");
+}
+
+void TestErrors()
+{
+  std::cout << "Bad arguments" << std::endl;
+  Compositor compositor;
+  bool threw = false;
+  try
+  {
+    compositor.SetRadix(1);
+  }
+  catch (vtkm::cont::ErrorBadValue& error)
+  {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    threw = true;
+  }
+  VTKM_TEST_ASSERT(threw, "Radix 1 was accepted");
+
+  threw = false;
+  compositor.AddImage(vtkm::rendering::Canvas(8, 8));
+  try
+  {
+    vtkm::rendering::Canvas canvas(4, 4);
+    compositor.Composite(canvas);
+  }
+  catch (vtkm::cont::ErrorBadValue& error)
+  {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    threw = true;
+  }
+  VTKM_TEST_ASSERT(threw, "Image of the wrong size was accepted");
+}
+
+void Run()
+{
+  for (auto mode : { Compositor::CompositeMode::Depth, Compositor::CompositeMode::VisibilityOrder })
+  {
+    for (vtkm::IdComponent radix : { 2, 4 })
+    {
+      for (vtkm::IdComponent numImages : { 1, 6, 9 })
+      {
+        TestComposite(mode, radix, numImages);
+      }
+      for (int numBlocks : { 5, 8 })
+      {
+        TestCompositeBlocks(mode == Compositor::CompositeMode::VisibilityOrder, radix, numBlocks);
+      }
+    }
+  }
+  TestErrors();
+}
+
+} // anonymous namespace
+
+int UnitTestCompositor(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
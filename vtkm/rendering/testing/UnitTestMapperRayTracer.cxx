@@ -8,6 +8,7 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 
+#include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/rendering/Actor.h>
@@ -20,6 +21,167 @@
 namespace
 {
 
+vtkm::cont::ArrayHandle<vtkm::Vec4f_32> Render(
+  vtkm::rendering::MapperRayTracer& mapper,
+  const vtkm::cont::DataSet& dataSet,
+  const vtkm::rendering::Camera& camera,
+  vtkm::cont::ColorTable colorTable = vtkm::cont::ColorTable::Preset::Inferno,
+  vtkm::Float32 clipDepth = 1.f)
+{
+  vtkm::cont::Field field = dataSet.GetField("pointvar");
+  vtkm::Range range;
+  field.GetRange(&range);
+
+  // the canvas depth clips the rays like annotations drawn before the data do
+  vtkm::rendering::CanvasRayTracer canvas(128, 128);
+  canvas.Clear();
+  if (clipDepth < 1.f)
+  {
+    canvas.GetDepthBuffer().Fill(clipDepth);
+  }
+  mapper.SetCanvas(&canvas);
+  mapper.SetActiveColorTable(colorTable);
+  mapper.RenderCells(
+    dataSet.GetCellSet(), dataSet.GetCoordinateSystem(), field, colorTable, camera, range);
+  vtkm::cont::ArrayHandle<vtkm::Vec4f_32> colors;
+  colors.DeepCopyFrom(canvas.GetColorBuffer());
+  return colors;
+}
+
+void TestBVHBuildModes()
+{
+  std::cout << "Render with a SAH built BVH" << std::endl;
+  vtkm::cont::DataSet dataSet = vtkm::cont::testing::MakeTestDataSet{}.Make3DExplicitDataSet4();
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.f);
+  camera.Elevation(20.f);
+
+  vtkm::rendering::MapperRayTracer morton;
+  vtkm::rendering::MapperRayTracer sah;
+  sah.SetBVHBuildMode(vtkm::rendering::raytracing::LinearBVH::BuildMode::SAH);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(Render(sah, dataSet, camera),
+                                           Render(morton, dataSet, camera)));
+
+  std::cout << "Refit the BVH to moved points" << std::endl;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points;
+  vtkm::cont::ArrayCopy(dataSet.GetCoordinateSystem().GetData(), points);
+  {
+    auto portal = points.WritePortal();
+    for (vtkm::Id index = 0; index < portal.GetNumberOfValues(); ++index)
+    {
+      vtkm::Vec3f point = portal.Get(index);
+      portal.Set(index, point + vtkm::Vec3f(0.1f * point[1], 0.f, 0.2f * point[0]));
+    }
+  }
+  dataSet.AddCoordinateSystem(vtkm::cont::CoordinateSystem("coordinates", points));
+  vtkm::rendering::MapperRayTracer fresh;
+  VTKM_TEST_ASSERT(
+    test_equal_ArrayHandles(Render(sah, dataSet, camera), Render(fresh, dataSet, camera)));
+}
+
+void TestPacketTraversal()
+{
+  std::cout << "Render with packet traversal" << std::endl;
+  vtkm::cont::DataSet dataSet = vtkm::cont::testing::MakeTestDataSet{}.Make3DRegularDataSet0();
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(-40.f);
+  camera.Elevation(15.f);
+
+  vtkm::rendering::MapperRayTracer scalar;
+  vtkm::rendering::MapperRayTracer packets;
+  packets.SetPacketTraversal(true);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(Render(packets, dataSet, camera),
+                                           Render(scalar, dataSet, camera)));
+}
+
+void TestRayReuse()
+{
+  std::cout << "Reuse the rays of the previous frame" << std::endl;
+  vtkm::cont::DataSet dataSet = vtkm::cont::testing::MakeTestDataSet{}.Make3DExplicitDataSet4();
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.f);
+  camera.Elevation(20.f);
+
+  vtkm::rendering::MapperRayTracer mapper;
+  Render(mapper, dataSet, camera);
+  const vtkm::cont::ColorTable coolToWarm = vtkm::cont::ColorTable::Preset::CoolToWarm;
+  vtkm::rendering::MapperRayTracer fresh;
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(Render(mapper, dataSet, camera, coolToWarm),
+                                           Render(fresh, dataSet, camera, coolToWarm)));
+
+  std::cout << "Trace again when the canvas depth changes" << std::endl;
+  const vtkm::Float32 clipDepth = 0.5f;
+  auto clipped = Render(mapper, dataSet, camera, coolToWarm, clipDepth);
+  VTKM_TEST_ASSERT(!test_equal_ArrayHandles(clipped, Render(fresh, dataSet, camera, coolToWarm)),
+                   "The canvas depth does not clip the data");
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(clipped,
+                                           Render(fresh, dataSet, camera, coolToWarm, clipDepth)));
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(Render(mapper, dataSet, camera, coolToWarm),
+                                           Render(fresh, dataSet, camera, coolToWarm)));
+
+  std::cout << "Trace again when the camera changes" << std::endl;
+  camera.Azimuth(10.f);
+  vtkm::rendering::MapperRayTracer other;
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(Render(mapper, dataSet, camera),
+                                           Render(other, dataSet, camera)));
+}
+
+void TestProgressiveView()
+{
+  std::cout << "Progressive rendering in View3D" << std::endl;
+  vtkm::cont::DataSet dataSet = vtkm::cont::testing::MakeTestDataSet{}.Make3DRegularDataSet0();
+  vtkm::rendering::Scene scene;
+  scene.AddActor(vtkm::rendering::Actor(dataSet.GetCellSet(),
+                                        dataSet.GetCoordinateSystem(),
+                                        dataSet.GetField("pointvar"),
+                                        vtkm::cont::ColorTable::Preset::Inferno));
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(dataSet.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(-40.f);
+  camera.Elevation(15.f);
+  const vtkm::rendering::Color background(0.2f, 0.2f, 0.2f, 1.f);
+
+  vtkm::rendering::View3D progressive(scene,
+                                      vtkm::rendering::MapperRayTracer{},
+                                      vtkm::rendering::CanvasRayTracer(100, 90),
+                                      camera,
+                                      background);
+  vtkm::rendering::View3D reference(scene,
+                                    vtkm::rendering::MapperRayTracer{},
+                                    vtkm::rendering::CanvasRayTracer(100, 90),
+                                    camera,
+                                    background);
+  reference.Paint();
+  const auto& referenceColors = reference.GetCanvas().GetColorBuffer();
+
+  progressive.SetProgressiveLevels(3);
+  for (vtkm::IdComponent frame = 0; frame < 3; ++frame)
+  {
+    progressive.Paint();
+    const bool complete = progressive.IsFrameComplete();
+    VTKM_TEST_ASSERT(complete == (frame == 2), "Wrong level in frame ", frame);
+    const bool sameImage =
+      test_equal_ArrayHandles(progressive.GetCanvas().GetColorBuffer(), referenceColors);
+    VTKM_TEST_ASSERT(complete == sameImage, "Only the last frame has the full resolution");
+  }
+  progressive.Paint();
+  VTKM_TEST_ASSERT(progressive.IsFrameComplete());
+
+  std::cout << "Restart when the camera moves" << std::endl;
+  progressive.GetCamera().Azimuth(5.f);
+  progressive.Paint();
+  VTKM_TEST_ASSERT(!progressive.IsFrameComplete());
+
+  std::cout << "Start at the finest level that fits in the time budget" << std::endl;
+  progressive.SetProgressiveTimeBudget(1000.0);
+  progressive.GetCamera().Azimuth(5.f);
+  progressive.Paint();
+  VTKM_TEST_ASSERT(progressive.IsFrameComplete());
+}
+
 void RenderTests()
 {
   vtkm::cont::testing::MakeTestDataSet maker;
@@ -48,9 +210,18 @@ void RenderTests()
     maker.Make2DUniformDataSet1(), "pointvar", "rendering/raytracer/uniform2D.png", options);
 }
 
+void Run()
+{
+  RenderTests();
+  TestBVHBuildModes();
+  TestPacketTraversal();
+  TestRayReuse();
+  TestProgressiveView();
+}
+
 } //namespace
 
 int UnitTestMapperRayTracer(int argc, char* argv[])
 {
-  return vtkm::cont::testing::Testing::Run(RenderTests, argc, argv);
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
 }
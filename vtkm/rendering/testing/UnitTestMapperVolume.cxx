@@ -8,6 +8,7 @@
 //  PURPOSE.  See the above copyright notice for more information.
 //============================================================================
 
+#include <vtkm/cont/ErrorBadValue.h>
 #include <vtkm/cont/testing/MakeTestDataSet.h>
 #include <vtkm/cont/testing/Testing.h>
 #include <vtkm/filter/field_conversion/CellAverage.h>
@@ -99,10 +100,123 @@ void TestUniformGrid()
     tangleAvg, "tangle_avg", "rendering/volume/uniform_cell.png", options);
 }
 
+vtkm::Float32 MaxDifference(const vtkm::cont::ArrayHandle<vtkm::Vec4f_32>& expected,
+                            const vtkm::cont::ArrayHandle<vtkm::Vec4f_32>& actual)
+{
+  VTKM_TEST_ASSERT(expected.GetNumberOfValues() == actual.GetNumberOfValues());
+  auto expectedPortal = expected.ReadPortal();
+  auto actualPortal = actual.ReadPortal();
+  vtkm::Float32 maxDifference = 0.f;
+  for (vtkm::Id index = 0; index < expected.GetNumberOfValues(); ++index)
+  {
+    for (vtkm::IdComponent c = 0; c < 4; ++c)
+    {
+      maxDifference = vtkm::Max(
+        maxDifference, vtkm::Abs(expectedPortal.Get(index)[c] - actualPortal.Get(index)[c]));
+    }
+  }
+  return maxDifference;
+}
+
+void TestEmptySpaceSkipping()
+{
+  vtkm::cont::ColorTable colorTable = vtkm::cont::ColorTable::Preset::Inferno;
+  colorTable.AddPointAlpha(0.0, 0.2f);
+  colorTable.AddPointAlpha(0.2, 0.0f);
+  colorTable.AddPointAlpha(0.5, 0.0f);
+  colorTable.AddPointAlpha(0.8, 0.8f);
+
+  vtkm::source::Tangle tangle;
+  tangle.SetPointDimensions({ 50, 50, 50 });
+  vtkm::cont::DataSet tangleData = tangle.Execute();
+  vtkm::filter::field_conversion::CellAverage cellAverage;
+  cellAverage.SetActiveField("tangle");
+  cellAverage.SetOutputFieldName("tangle_avg");
+  tangleData = cellAverage.Execute(tangleData);
+
+  vtkm::rendering::Camera camera;
+  camera.ResetToBounds(tangleData.GetCoordinateSystem().GetBounds());
+  camera.Azimuth(30.f);
+  camera.Elevation(20.f);
+
+  vtkm::rendering::CanvasRayTracer canvas(128, 128);
+  auto render = [&](vtkm::rendering::MapperVolume& mapper, const std::string& fieldName) {
+    vtkm::cont::Field field = tangleData.GetField(fieldName);
+    vtkm::Range range;
+    field.GetRange(&range);
+    canvas.Clear();
+    mapper.SetCanvas(&canvas);
+    mapper.SetActiveColorTable(colorTable);
+    mapper.RenderCells(tangleData.GetCellSet(),
+                       tangleData.GetCoordinateSystem(),
+                       field,
+                       colorTable,
+                       camera,
+                       range);
+    vtkm::cont::ArrayHandle<vtkm::Vec4f_32> colors;
+    colors.DeepCopyFrom(canvas.GetColorBuffer());
+    return colors;
+  };
+
+  for (std::string fieldName : { "tangle", "tangle_avg" })
+  {
+    std::cout << "Empty space skipping on " << fieldName << std::endl;
+    vtkm::rendering::MapperVolume reference;
+    reference.SetMacroCellSize(0);
+    auto expected = render(reference, fieldName);
+    VTKM_TEST_ASSERT(reference.GetNumberOfMacroCells() == 0, "Skipping was not disabled");
+
+    vtkm::rendering::MapperVolume skipping;
+    for (vtkm::Id macroCellSize : { 8, 3 })
+    {
+      skipping.SetMacroCellSize(macroCellSize);
+      // render twice to also go through the cached macro cells
+      for (int pass = 0; pass < 2; ++pass)
+      {
+        vtkm::Float32 difference = MaxDifference(expected, render(skipping, fieldName));
+        std::cout << "  macro cell size " << macroCellSize << ": difference " << difference
+                  << std::endl;
+        VTKM_TEST_ASSERT(difference < 0.02f, "Skipping empty space changed the image");
+
+        // the color map is transparent over part of the field, so some but not all macro
+        // cells must be found empty, or the comparison above proves nothing
+        vtkm::Id numEmpty = skipping.GetNumberOfEmptyMacroCells();
+        vtkm::Id numMacroCells = skipping.GetNumberOfMacroCells();
+        std::cout << "  " << numEmpty << " of " << numMacroCells << " macro cells empty"
+                  << std::endl;
+        vtkm::Id numCellsPerAxis = (49 + macroCellSize - 1) / macroCellSize;
+        VTKM_TEST_ASSERT(numMacroCells == numCellsPerAxis * numCellsPerAxis * numCellsPerAxis,
+                         "Wrong number of macro cells");
+        VTKM_TEST_ASSERT(numEmpty > 0, "No macro cell was classified as empty");
+        VTKM_TEST_ASSERT(numEmpty < numMacroCells, "All macro cells were classified as empty");
+      }
+    }
+
+    std::cout << "Early ray termination on " << fieldName << std::endl;
+    skipping.SetOpacityThreshold(0.95f);
+    vtkm::Float32 difference = MaxDifference(expected, render(skipping, fieldName));
+    std::cout << "  difference " << difference << std::endl;
+    VTKM_TEST_ASSERT(difference < 0.06f, "Early termination changed the image too much");
+  }
+
+  bool threw = false;
+  try
+  {
+    vtkm::rendering::MapperVolume{}.SetOpacityThreshold(0.f);
+  }
+  catch (vtkm::cont::ErrorBadValue& error)
+  {
+    std::cout << "Got expected error: " << error.GetMessage() << std::endl;
+    threw = true;
+  }
+  VTKM_TEST_ASSERT(threw, "Opacity threshold of 0 was accepted");
+}
+
 void RenderTests()
 {
   TestRectilinear();
   TestUniformGrid();
+  TestEmptySpaceSkipping();
 }
 
 } //namespace
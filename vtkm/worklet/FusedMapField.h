@@ -0,0 +1,310 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_worklet_FusedMapField_h
+#define vtk_m_worklet_FusedMapField_h
+
+#include <vtkm/Tuple.h>
+#include <vtkm/internal/FunctionInterface.h>
+
+#include <vtkm/worklet/MaskNone.h>
+#include <vtkm/worklet/ScatterIdentity.h>
+#include <vtkm/worklet/WorkletMapField.h>
+#include <vtkm/worklet/internal/Placeholders.h>
+
+#include <vtkmstd/void_t.h>
+
+#include <type_traits>
+#include <utility>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+/// \brief A stage of a `FusedMapField` with an explicit output type.
+///
+/// Stages that write their result to an output argument (an `ExecutionSignature` of
+/// `void(_1, _2)`) do not advertise the type they produce. When such a stage is not the last
+/// one, the type of the value handed to the next stage is taken from the output parameter of
+/// its `operator()`. If `operator()` is a template or overloaded, the type cannot be deduced
+/// and the stage must be wrapped with `make_FusedStage<OutputType>` to give it.
+///
+template <typename WorkletType, typename OutputType>
+struct FusedStage
+{
+  WorkletType Worklet;
+};
+
+template <typename OutputType, typename WorkletType>
+VTKM_CONT FusedStage<WorkletType, OutputType> make_FusedStage(const WorkletType& worklet)
+{
+  return FusedStage<WorkletType, OutputType>{ worklet };
+}
+
+namespace detail
+{
+
+template <typename StageType>
+struct FusedStageTraits
+{
+  using WorkletType = StageType;
+
+  VTKM_EXEC_CONT static const WorkletType& GetWorklet(const StageType& stage) { return stage; }
+  VTKM_CONT static WorkletType& GetWorklet(StageType& stage) { return stage; }
+};
+
+template <typename W, typename O>
+struct FusedStageTraits<vtkm::worklet::FusedStage<W, O>>
+{
+  using WorkletType = W;
+
+  VTKM_EXEC_CONT static const WorkletType& GetWorklet(const vtkm::worklet::FusedStage<W, O>& stage)
+  {
+    return stage.Worklet;
+  }
+  VTKM_CONT static WorkletType& GetWorklet(vtkm::worklet::FusedStage<W, O>& stage)
+  {
+    return stage.Worklet;
+  }
+};
+
+// Stages either return their result (`_2(_1)`) or write it to their second argument.
+template <typename WorkletType>
+using FusedStageReturnsOutput = typename std::is_same<
+  typename vtkm::internal::detail::FunctionSigInfo<
+    typename vtkm::placeholders::GetExecSig<WorkletType>::ExecutionSignature>::ResultType,
+  vtkm::placeholders::Arg<2>>::type;
+
+template <typename WorkletType>
+using FusedStageExecInfo = vtkm::internal::detail::FunctionSigInfo<
+  typename vtkm::placeholders::GetExecSig<WorkletType>::ExecutionSignature>;
+
+template <typename WorkletType>
+struct FusedStageCheck
+  : std::integral_constant<
+      bool,
+      std::is_base_of<vtkm::worklet::WorkletMapField, WorkletType>::value &&
+        std::is_same<typename WorkletType::ScatterType, vtkm::worklet::ScatterIdentity>::value &&
+        std::is_same<typename WorkletType::MaskType, vtkm::worklet::MaskNone>::value &&
+        (vtkm::internal::detail::FunctionSigInfo<
+           typename WorkletType::ControlSignature>::Arity == 2) &&
+        (std::is_same<typename FusedStageExecInfo<WorkletType>::Parameters,
+                      vtkm::List<vtkm::placeholders::Arg<1>, vtkm::placeholders::Arg<2>>>::value ||
+         (std::is_same<typename FusedStageExecInfo<WorkletType>::Parameters,
+                       vtkm::List<vtkm::placeholders::Arg<1>>>::value &&
+          FusedStageReturnsOutput<WorkletType>::value))>
+{
+};
+
+template <typename WorkletType>
+struct FusedStageCall
+{
+  template <typename InputType>
+  using ReturnType = typename std::decay<decltype(
+    std::declval<const WorkletType&>()(std::declval<const InputType&>()))>::type;
+
+  template <typename InputType, typename OutputType>
+  VTKM_EXEC static void Call(const WorkletType& worklet,
+                             const InputType& input,
+                             OutputType& output,
+                             std::true_type)
+  {
+    output = static_cast<OutputType>(worklet(input));
+  }
+
+  template <typename InputType, typename OutputType>
+  VTKM_EXEC static void Call(const WorkletType& worklet,
+                             const InputType& input,
+                             OutputType& output,
+                             std::false_type)
+  {
+    worklet(input, output);
+  }
+};
+
+// The type of the output parameter of a non-template, non-overloaded `operator()`, or void
+// when it cannot be deduced.
+template <typename MethodType>
+struct FusedOutputParameter
+{
+  using type = void;
+};
+
+template <typename WorkletType, typename R, typename InputType, typename OutputType>
+struct FusedOutputParameter<R (WorkletType::*)(InputType, OutputType&) const>
+{
+  using type = OutputType;
+};
+
+template <typename WorkletType, typename = void>
+struct FusedDeducedOutput
+{
+  using type = void;
+};
+
+template <typename WorkletType>
+struct FusedDeducedOutput<WorkletType, vtkmstd::void_t<decltype(&WorkletType::operator())>>
+  : FusedOutputParameter<decltype(&WorkletType::operator())>
+{
+};
+
+// The type of the value a stage passes to the next one. Stages writing to an output argument
+// pass the type of the output parameter of their `operator()`, or the type given with
+// `FusedStage`.
+template <typename StageType, typename InputType, typename Returns>
+struct FusedIntermediate
+{
+  using type = typename FusedDeducedOutput<StageType>::type;
+  VTKM_STATIC_ASSERT_MSG(!std::is_void<type>::value,
+                         "The output type of a FusedMapField stage writing to an output argument "
+                         "cannot be deduced. Wrap the stage with make_FusedStage<OutputType>.");
+};
+
+template <typename StageType, typename InputType>
+struct FusedIntermediate<StageType, InputType, std::true_type>
+{
+  using type = typename FusedStageCall<StageType>::template ReturnType<InputType>;
+};
+
+template <typename W, typename O, typename InputType, typename Returns>
+struct FusedIntermediate<vtkm::worklet::FusedStage<W, O>, InputType, Returns>
+{
+  using type = O;
+};
+
+template <typename W, typename O, typename InputType>
+struct FusedIntermediate<vtkm::worklet::FusedStage<W, O>, InputType, std::true_type>
+{
+  using type = O;
+};
+
+template <vtkm::IdComponent Index, bool IsLast>
+struct FusedApply;
+
+template <vtkm::IdComponent Index>
+struct FusedApply<Index, true>
+{
+  template <typename StagesType, typename InputType, typename OutputType>
+  VTKM_EXEC static void Run(const StagesType& stages, const InputType& input, OutputType& output)
+  {
+    using StageType = vtkm::TupleElement<Index, StagesType>;
+    using WorkletType = typename FusedStageTraits<StageType>::WorkletType;
+    FusedStageCall<WorkletType>::Call(
+      FusedStageTraits<StageType>::GetWorklet(vtkm::Get<Index>(stages)),
+      input,
+      output,
+      FusedStageReturnsOutput<WorkletType>{});
+  }
+};
+
+template <vtkm::IdComponent Index>
+struct FusedApply<Index, false>
+{
+  template <typename StagesType, typename InputType, typename OutputType>
+  VTKM_EXEC static void Run(const StagesType& stages, const InputType& input, OutputType& output)
+  {
+    using StageType = vtkm::TupleElement<Index, StagesType>;
+    using WorkletType = typename FusedStageTraits<StageType>::WorkletType;
+    using Returns = FusedStageReturnsOutput<WorkletType>;
+    typename FusedIntermediate<StageType, InputType, Returns>::type value;
+    FusedStageCall<WorkletType>::Call(
+      FusedStageTraits<StageType>::GetWorklet(vtkm::Get<Index>(stages)), input, value, Returns{});
+    FusedApply<Index + 1, (Index + 2 == vtkm::TupleSize<StagesType>::value)>::Run(
+      stages, value, output);
+  }
+};
+
+struct FusedSetErrorMessageBuffer
+{
+  const vtkm::exec::internal::ErrorMessageBuffer& Buffer;
+
+  template <typename StageType>
+  VTKM_CONT void operator()(StageType& stage) const
+  {
+    FusedStageTraits<StageType>::GetWorklet(stage).SetErrorMessageBuffer(this->Buffer);
+  }
+};
+
+} // namespace detail
+
+/// \brief Composes several map field worklets into one.
+///
+/// `FusedMapField` runs a chain of `WorkletMapField`s in a single pass over the data. The
+/// output of each stage is given as the input of the next one without being written to an
+/// array, so a chain of operations on a field is done without allocating, writing, and reading
+/// back the intermediate arrays. Each stage must have the `ControlSignature`
+/// `void(FieldIn, FieldOut)` and an `ExecutionSignature` of either `_2(_1)` or `void(_1, _2)`,
+/// with the default scatter and mask. (Use separate invocations for worklets taking more
+/// arguments.) The fused worklet has the `ControlSignature` `void(FieldIn, FieldOut)`.
+///
+/// The value passed from a stage to the next has the type returned by the stage. For stages
+/// that write their result to an output argument, it has the type of the output parameter of
+/// the stage's `operator()`. When that type cannot be deduced (a template `operator()`), the
+/// stage must be wrapped in a `FusedStage` with `make_FusedStage`, or the fused worklet does not
+/// compile. The last stage writes directly to the output array.
+///
+/// \code{.cpp}
+/// invoke(vtkm::worklet::make_FusedMapField(
+///          vtkm::worklet::PointElevation(low, high, { 0, 1 }),
+///          vtkm::worklet::make_FusedStage<vtkm::FloatDefault>(LogFunWorklet<vtkm::Log>{ 1e-6 })),
+///        coordinates,
+///        logElevation);
+/// \endcode
+///
+template <typename... Stages>
+class FusedMapField : public vtkm::worklet::WorkletMapField
+{
+  VTKM_STATIC_ASSERT_MSG(sizeof...(Stages) > 0, "FusedMapField needs at least one stage.");
+
+public:
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = void(_1, _2);
+
+  FusedMapField() = default;
+
+  VTKM_CONT explicit FusedMapField(const Stages&... stages)
+    : StageWorklets(stages...)
+  {
+    using StageWorkletTypes =
+      vtkm::List<typename detail::FusedStageTraits<Stages>::WorkletType...>;
+    VTKM_STATIC_ASSERT_MSG(
+      (vtkm::ListAll<StageWorkletTypes, detail::FusedStageCheck>::value),
+      "The stages of FusedMapField must be WorkletMapFields with the ControlSignature "
+      "void(FieldIn, FieldOut) and the ExecutionSignature _2(_1) or void(_1, _2).");
+  }
+
+  /// Forward the error buffer to the stages so that they can raise errors.
+  VTKM_CONT void SetErrorMessageBuffer(const vtkm::exec::internal::ErrorMessageBuffer& buffer)
+  {
+    this->WorkletMapField::SetErrorMessageBuffer(buffer);
+    this->StageWorklets.ForEach(detail::FusedSetErrorMessageBuffer{ buffer });
+  }
+
+  template <typename InputType, typename OutputType>
+  VTKM_EXEC void operator()(const InputType& input, OutputType& output) const
+  {
+    detail::FusedApply<0, (sizeof...(Stages) == 1)>::Run(this->StageWorklets, input, output);
+  }
+
+private:
+  vtkm::Tuple<Stages...> StageWorklets;
+};
+
+/// Creates a `FusedMapField` running the given worklets one after the other.
+template <typename... Stages>
+VTKM_CONT vtkm::worklet::FusedMapField<Stages...> make_FusedMapField(const Stages&... stages)
+{
+  return vtkm::worklet::FusedMapField<Stages...>(stages...);
+}
+
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_FusedMapField_h
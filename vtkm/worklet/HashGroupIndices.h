@@ -0,0 +1,273 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+#ifndef vtk_m_worklet_HashGroupIndices_h
+#define vtk_m_worklet_HashGroupIndices_h
+
+#include <vtkm/Pair.h>
+#include <vtkm/TypeTraits.h>
+#include <vtkm/VecTraits.h>
+
+#include <vtkm/cont/Algorithm.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleCast.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <cstring>
+
+namespace vtkm
+{
+namespace worklet
+{
+
+namespace detail
+{
+
+// Hashes any key made of numbers (scalars, Vecs, and Pairs of them).
+template <typename T>
+VTKM_EXEC_CONT vtkm::UInt64 HashGroupKey(vtkm::UInt64 hash, const T& key);
+template <typename T1, typename T2>
+VTKM_EXEC_CONT vtkm::UInt64 HashGroupKey(vtkm::UInt64 hash, const vtkm::Pair<T1, T2>& key);
+
+template <typename T>
+VTKM_EXEC_CONT vtkm::UInt64 HashGroupKeyImpl(vtkm::UInt64 hash,
+                                             const T& key,
+                                             vtkm::TypeTraitsIntegerTag,
+                                             vtkm::TypeTraitsScalarTag)
+{
+  return (hash ^ static_cast<vtkm::UInt64>(key)) * 1099511628211ULL;
+}
+
+template <typename T>
+VTKM_EXEC_CONT vtkm::UInt64 HashGroupKeyImpl(vtkm::UInt64 hash,
+                                             const T& key,
+                                             vtkm::TypeTraitsRealTag,
+                                             vtkm::TypeTraitsScalarTag)
+{
+  // Equal numbers must hash the same, so -0 becomes 0.
+  const vtkm::Float64 value = (key == T(0)) ? 0.0 : static_cast<vtkm::Float64>(key);
+  vtkm::UInt64 bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (hash ^ bits) * 1099511628211ULL;
+}
+
+template <typename T, typename NumericTag>
+VTKM_EXEC_CONT vtkm::UInt64 HashGroupKeyImpl(vtkm::UInt64 hash,
+                                             const T& key,
+                                             NumericTag,
+                                             vtkm::TypeTraitsVectorTag)
+{
+  using Traits = vtkm::VecTraits<T>;
+  const vtkm::IdComponent numComponents = Traits::GetNumberOfComponents(key);
+  for (vtkm::IdComponent index = 0; index < numComponents; ++index)
+  {
+    hash = HashGroupKey(hash, Traits::GetComponent(key, index));
+  }
+  return hash;
+}
+
+template <typename T>
+VTKM_EXEC_CONT vtkm::UInt64 HashGroupKey(vtkm::UInt64 hash, const T& key)
+{
+  using Traits = vtkm::TypeTraits<T>;
+  return HashGroupKeyImpl(
+    hash, key, typename Traits::NumericTag{}, typename Traits::DimensionalityTag{});
+}
+
+template <typename T1, typename T2>
+VTKM_EXEC_CONT vtkm::UInt64 HashGroupKey(vtkm::UInt64 hash, const vtkm::Pair<T1, T2>& key)
+{
+  return HashGroupKey(HashGroupKey(hash, key.first), key.second);
+}
+
+} // namespace detail
+
+/// \brief Groups the indices of equal values of an array with a hash table.
+///
+/// This produces the same arrays as sorting the values and reducing the runs
+/// of equal values, but in linear time: the values are inserted in a
+/// concurrent open addressing hash table, which finds the first occurrence of
+/// each value. The unique values come out in the order of their first
+/// occurrence in the input, not sorted. The indices of each group are in
+/// increasing order on the Serial device, but may be in any order on parallel
+/// devices.
+///
+/// The values must support `operator==` and be made of numbers (scalars,
+/// `vtkm::Vec`, or `vtkm::Pair`).
+///
+struct HashGroupIndices
+{
+  // Inserts each value in the hash table. Each slot of the table holds the
+  // index of the first occurrence of a value, or -1 if it is empty.
+  struct InsertValues : vtkm::worklet::WorkletMapField
+  {
+    using ControlSignature = void(FieldIn value,
+                                  WholeArrayIn values,
+                                  AtomicArrayInOut table,
+                                  FieldOut slot);
+    using ExecutionSignature = void(_1, _2, _3, _4, WorkIndex);
+
+    template <typename T, typename ValuesPortal, typename TablePortal>
+    VTKM_EXEC void operator()(const T& value,
+                              const ValuesPortal& values,
+                              const TablePortal& table,
+                              vtkm::Id& slot,
+                              vtkm::Id index) const
+    {
+      const vtkm::UInt64 mask = static_cast<vtkm::UInt64>(table.GetNumberOfValues() - 1);
+      vtkm::UInt64 hash = detail::HashGroupKey(14695981039346656037ULL, value);
+      // Mix the high bits into the low bits used to pick the slot.
+      hash ^= hash >> 33;
+      hash *= 0xff51afd7ed558ccdULL;
+      hash ^= hash >> 33;
+
+      slot = static_cast<vtkm::Id>(hash & mask);
+      while (true)
+      {
+        // Only try to claim the slot when it looks empty. A failed exchange is as expensive as a
+        // successful one, and most values find their key already in the table.
+        vtkm::Id entry = table.Get(slot);
+        if ((entry < 0) && table.CompareExchange(slot, &entry, index))
+        {
+          return;
+        }
+        if (values.Get(entry) == value)
+        {
+          // Keep the smallest index so that the result does not depend on
+          // the order of the threads.
+          while ((index < entry) && !table.CompareExchange(slot, &entry, index))
+          {
+          }
+          return;
+        }
+        slot = static_cast<vtkm::Id>((static_cast<vtkm::UInt64>(slot) + 1) & mask);
+      }
+    }
+  };
+
+  struct FindFirstOccurrence : vtkm::worklet::WorkletMapField
+  {
+    using ControlSignature = void(FieldIn slot,
+                                  WholeArrayIn table,
+                                  FieldOut firstIndex,
+                                  FieldOut isFirst);
+    using ExecutionSignature = void(_1, _2, _3, _4, WorkIndex);
+
+    template <typename TablePortal>
+    VTKM_EXEC void operator()(vtkm::Id slot,
+                              const TablePortal& table,
+                              vtkm::Id& firstIndex,
+                              vtkm::Id& isFirst,
+                              vtkm::Id index) const
+    {
+      firstIndex = table.Get(slot);
+      isFirst = (firstIndex == index) ? 1 : 0;
+    }
+  };
+
+  struct CountGroups : vtkm::worklet::WorkletMapField
+  {
+    using ControlSignature = void(FieldIn firstIndex,
+                                  WholeArrayIn groupOfFirst,
+                                  FieldOut group,
+                                  AtomicArrayInOut counts);
+    using ExecutionSignature = void(_1, _2, _3, _4);
+
+    template <typename GroupPortal, typename CountsPortal>
+    VTKM_EXEC void operator()(vtkm::Id firstIndex,
+                              const GroupPortal& groupOfFirst,
+                              vtkm::Id& group,
+                              const CountsPortal& counts) const
+    {
+      group = groupOfFirst.Get(firstIndex);
+      counts.Add(group, 1);
+    }
+  };
+
+  struct PlaceIndices : vtkm::worklet::WorkletMapField
+  {
+    using ControlSignature = void(FieldIn group,
+                                  AtomicArrayInOut nextPosition,
+                                  WholeArrayOut groupedIndices);
+    using ExecutionSignature = void(_1, _2, _3, WorkIndex);
+
+    template <typename PositionPortal, typename IndicesPortal>
+    VTKM_EXEC void operator()(vtkm::Id group,
+                              const PositionPortal& nextPosition,
+                              const IndicesPortal& groupedIndices,
+                              vtkm::Id index) const
+    {
+      groupedIndices.Set(nextPosition.Add(group, 1), index);
+    }
+  };
+
+  /// Fills `uniqueValues` with one copy of each distinct value,
+  /// `groupedIndices` with the indices of the values grouped by value,
+  /// `counts` with the number of values in each group, and `offsets` with
+  /// the start of each group in `groupedIndices` (plus the total at the end,
+  /// as with `ScanExtended`).
+  template <typename ValueArrayType, typename T>
+  VTKM_CONT static void Run(vtkm::cont::DeviceAdapterId device,
+                            const ValueArrayType& values,
+                            vtkm::cont::ArrayHandle<T>& uniqueValues,
+                            vtkm::cont::ArrayHandle<vtkm::Id>& groupedIndices,
+                            vtkm::cont::ArrayHandle<vtkm::IdComponent>& counts,
+                            vtkm::cont::ArrayHandle<vtkm::Id>& offsets)
+  {
+    const vtkm::Id numValues = values.GetNumberOfValues();
+    vtkm::cont::Invoker invoke(device);
+
+    // Keep the table at most half full so that the probe sequences stay short.
+    vtkm::Id tableSize = 2;
+    while (tableSize < 2 * numValues)
+    {
+      tableSize *= 2;
+    }
+    vtkm::cont::ArrayHandle<vtkm::Id> table;
+    vtkm::cont::Algorithm::Copy(
+      device, vtkm::cont::ArrayHandleConstant<vtkm::Id>(-1, tableSize), table);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> slots;
+    invoke(InsertValues{}, values, values, table, slots);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> firstIndices;
+    vtkm::cont::ArrayHandle<vtkm::Id> isFirst;
+    invoke(FindFirstOccurrence{}, slots, table, firstIndices, isFirst);
+    table.ReleaseResources();
+    slots.ReleaseResources();
+
+    // Number the groups in the order of their first occurrence.
+    vtkm::cont::ArrayHandle<vtkm::Id> groupOfFirst;
+    const vtkm::Id numGroups = vtkm::cont::Algorithm::ScanExclusive(device, isFirst, groupOfFirst);
+    vtkm::cont::Algorithm::CopyIf(device, values, isFirst, uniqueValues);
+    isFirst.ReleaseResources();
+
+    vtkm::cont::Algorithm::Copy(
+      device, vtkm::cont::ArrayHandleConstant<vtkm::IdComponent>(0, numGroups), counts);
+    vtkm::cont::ArrayHandle<vtkm::Id> groups;
+    invoke(CountGroups{}, firstIndices, groupOfFirst, groups, counts);
+    firstIndices.ReleaseResources();
+    groupOfFirst.ReleaseResources();
+
+    vtkm::cont::Algorithm::ScanExtended(
+      device, vtkm::cont::make_ArrayHandleCast(counts, vtkm::Id()), offsets);
+
+    vtkm::cont::ArrayHandle<vtkm::Id> nextPosition;
+    vtkm::cont::Algorithm::CopySubRange(device, offsets, 0, numGroups, nextPosition);
+    groupedIndices.Allocate(numValues);
+    invoke(PlaceIndices{}, groups, nextPosition, groupedIndices);
+  }
+};
+}
+} // namespace vtkm::worklet
+
+#endif // vtk_m_worklet_HashGroupIndices_h
@@ -104,10 +104,17 @@ protected:
 /// Select the type of sort for BuildArrays calls. Unstable sorting is faster
 /// but will not produce consistent ordering for equal keys. Stable sorting
 /// is slower, but keeps equal keys in their original order.
+///
+/// Hashed grouping does not sort at all. It finds equal keys with a hash
+/// table in linear time, which is the fastest for large arrays when only the
+/// grouping matters. The unique keys are in the order of their first
+/// occurrence in the input rather than sorted. The order of equal keys is
+/// kept on the Serial device, but not on parallel devices.
 enum class KeysSortType
 {
   Unstable = 0,
-  Stable = 1
+  Stable = 1,
+  Hashed = 2
 };
 
 /// \brief Manage keys for a \c WorkletReduceByKey.
@@ -209,6 +216,10 @@ private:
   template <typename KeyArrayType>
   VTKM_CONT void BuildArraysInternalStable(const KeyArrayType& keys,
                                            vtkm::cont::DeviceAdapterId device);
+
+  template <typename KeyArrayType>
+  VTKM_CONT void BuildArraysInternalHashed(const KeyArrayType& keys,
+                                           vtkm::cont::DeviceAdapterId device);
   /// @endcond
 };
 
@@ -10,6 +10,7 @@
 #ifndef vtk_m_worklet_Keys_hxx
 #define vtk_m_worklet_Keys_hxx
 
+#include <vtkm/worklet/HashGroupIndices.h>
 #include <vtkm/worklet/Keys.h>
 
 namespace vtkm
@@ -40,6 +41,9 @@ VTKM_CONT void Keys<T>::BuildArrays(const KeyArrayType& keys,
     case KeysSortType::Stable:
       this->BuildArraysInternalStable(keys, device);
       break;
+    case KeysSortType::Hashed:
+      this->BuildArraysInternalHashed(keys, device);
+      break;
   }
 }
 
@@ -60,8 +64,16 @@ VTKM_CONT void Keys<T>::BuildArraysInPlace(KeyArrayType& keys,
       this->BuildArraysInternal(keys, device);
       break;
     case KeysSortType::Stable:
+    case KeysSortType::Hashed:
     {
-      this->BuildArraysInternalStable(keys, device);
+      if (sort == KeysSortType::Stable)
+      {
+        this->BuildArraysInternalStable(keys, device);
+      }
+      else
+      {
+        this->BuildArraysInternalHashed(keys, device);
+      }
       KeyArrayHandleType tmp;
       // Copy into a temporary array so that the permutation array copy
       // won't alias input/output memory:
@@ -130,6 +142,21 @@ VTKM_CONT void Keys<T>::BuildArraysInternalStable(const KeyArrayType& keys,
   VTKM_ASSERT(numKeys ==
               vtkm::cont::ArrayGetValue(this->Offsets.GetNumberOfValues() - 1, this->Offsets));
 }
+
+template <typename T>
+template <typename KeyArrayType>
+VTKM_CONT void Keys<T>::BuildArraysInternalHashed(const KeyArrayType& keys,
+                                                  vtkm::cont::DeviceAdapterId device)
+{
+  VTKM_LOG_SCOPE(vtkm::cont::LogLevel::Perf, "Keys::BuildArraysInternalHashed");
+
+  // Group the keys with a hash table instead of sorting them.
+  HashGroupIndices::Run(
+    device, keys, this->UniqueKeys, this->SortedValuesMap, this->Counts, this->Offsets);
+
+  VTKM_ASSERT(keys.GetNumberOfValues() ==
+              vtkm::cont::ArrayGetValue(this->Offsets.GetNumberOfValues() - 1, this->Offsets));
+}
 }
 }
 #endif
@@ -16,9 +16,11 @@
 #include <vtkm/internal/FunctionInterface.h>
 #include <vtkm/internal/Invocation.h>
 
+#include <vtkm/cont/ArrayHandle.h>
 #include <vtkm/cont/CastAndCall.h>
 #include <vtkm/cont/ErrorBadType.h>
 #include <vtkm/cont/Logging.h>
+#include <vtkm/cont/Profiler.h>
 #include <vtkm/cont/TryExecute.h>
 
 #include <vtkm/cont/arg/ControlSignatureTagBase.h>
@@ -38,6 +40,20 @@
 
 namespace vtkm
 {
+namespace cont
+{
+namespace arg
+{
+struct TransportTagArrayInOut;
+struct TransportTagArrayOut;
+struct TransportTagAtomicArray;
+struct TransportTagKeyedValuesInOut;
+struct TransportTagKeyedValuesOut;
+struct TransportTagWholeArrayInOut;
+struct TransportTagWholeArrayOut;
+}
+} // namespace cont::arg
+
 namespace worklet
 {
 namespace internal
@@ -274,6 +290,86 @@ inline vtkm::Id FlatRange(const vtkm::Id3& range)
   return range[0] * range[1] * range[2];
 }
 
+// Bytes of the arguments of a worklet counted by the profiler.
+struct DispatcherBaseProfileBytes
+{
+  vtkm::BufferSizeType Read = 0;
+  vtkm::BufferSizeType Written = 0;
+};
+
+// Whether the worklet reads and/or writes an argument with the given transport. Arguments that
+// are not arrays are not counted.
+template <typename TransportTag>
+struct DispatcherBaseTransportAccess
+{
+  static constexpr bool Read = true;
+  static constexpr bool Write = false;
+};
+template <typename TransportTag>
+struct DispatcherBaseTransportWrite
+{
+  static constexpr bool Read = false;
+  static constexpr bool Write = true;
+};
+template <typename TransportTag>
+struct DispatcherBaseTransportReadWrite
+{
+  static constexpr bool Read = true;
+  static constexpr bool Write = true;
+};
+template <>
+struct DispatcherBaseTransportAccess<vtkm::cont::arg::TransportTagArrayOut>
+  : DispatcherBaseTransportWrite<vtkm::cont::arg::TransportTagArrayOut>
+{
+};
+template <>
+struct DispatcherBaseTransportAccess<vtkm::cont::arg::TransportTagWholeArrayOut>
+  : DispatcherBaseTransportWrite<vtkm::cont::arg::TransportTagWholeArrayOut>
+{
+};
+template <>
+struct DispatcherBaseTransportAccess<vtkm::cont::arg::TransportTagKeyedValuesOut>
+  : DispatcherBaseTransportWrite<vtkm::cont::arg::TransportTagKeyedValuesOut>
+{
+};
+template <>
+struct DispatcherBaseTransportAccess<vtkm::cont::arg::TransportTagArrayInOut>
+  : DispatcherBaseTransportReadWrite<vtkm::cont::arg::TransportTagArrayInOut>
+{
+};
+template <>
+struct DispatcherBaseTransportAccess<vtkm::cont::arg::TransportTagWholeArrayInOut>
+  : DispatcherBaseTransportReadWrite<vtkm::cont::arg::TransportTagWholeArrayInOut>
+{
+};
+template <>
+struct DispatcherBaseTransportAccess<vtkm::cont::arg::TransportTagKeyedValuesInOut>
+  : DispatcherBaseTransportReadWrite<vtkm::cont::arg::TransportTagKeyedValuesInOut>
+{
+};
+template <>
+struct DispatcherBaseTransportAccess<vtkm::cont::arg::TransportTagAtomicArray>
+  : DispatcherBaseTransportReadWrite<vtkm::cont::arg::TransportTagAtomicArray>
+{
+};
+
+template <typename T>
+VTKM_CONT vtkm::BufferSizeType DispatcherBaseArgumentBytes(const T& array, std::true_type)
+{
+  vtkm::BufferSizeType numBytes = 0;
+  for (auto&& buffer : array.GetBuffers())
+  {
+    numBytes += buffer.GetNumberOfBytes();
+  }
+  return numBytes;
+}
+
+template <typename T>
+VTKM_CONT vtkm::BufferSizeType DispatcherBaseArgumentBytes(const T&, std::false_type)
+{
+  return 0;
+}
+
 // A functor used in a StaticCast of a FunctionInterface to transport arguments
 // from the control environment to the execution environment.
 template <typename ControlInterface, typename InputDomainType, typename Device>
@@ -283,6 +379,7 @@ struct DispatcherBaseTransportFunctor
   vtkm::Id InputRange;
   vtkm::Id OutputRange;
   vtkm::cont::Token& Token; // Warning: this is a reference
+  DispatcherBaseProfileBytes* ProfileBytes;
 
   // TODO: We need to think harder about how scheduling on 3D arrays works.
   // Chances are we need to allow the transport for each argument to manage
@@ -292,11 +389,13 @@ struct DispatcherBaseTransportFunctor
   VTKM_CONT DispatcherBaseTransportFunctor(const InputDomainType& inputDomain,
                                            const InputRangeType& inputRange,
                                            const OutputRangeType& outputRange,
-                                           vtkm::cont::Token& token)
+                                           vtkm::cont::Token& token,
+                                           DispatcherBaseProfileBytes* profileBytes = nullptr)
     : InputDomain(inputDomain)
     , InputRange(FlatRange(inputRange))
     , OutputRange(FlatRange(outputRange))
     , Token(token)
+    , ProfileBytes(profileBytes)
   {
   }
 
@@ -330,11 +429,21 @@ struct DispatcherBaseTransportFunctor
     vtkm::cont::arg::Transport<TransportTag, T, Device> transport;
 
     not_nullptr(invokeData, Index);
-    return transport(as_ref(invokeData),
-                     as_ref(this->InputDomain),
-                     this->InputRange,
-                     this->OutputRange,
-                     this->Token);
+    auto execObject = transport(as_ref(invokeData),
+                                as_ref(this->InputDomain),
+                                this->InputRange,
+                                this->OutputRange,
+                                this->Token);
+    if (this->ProfileBytes != nullptr)
+    {
+      // Counted after the transport, which allocates output arrays.
+      using Access = DispatcherBaseTransportAccess<TransportTag>;
+      vtkm::BufferSizeType numBytes = DispatcherBaseArgumentBytes(
+        as_ref(invokeData), typename vtkm::cont::internal::ArrayHandleCheck<T>::type{});
+      this->ProfileBytes->Read += Access::Read ? numBytes : 0;
+      this->ProfileBytes->Written += Access::Write ? numBytes : 0;
+    }
+    return execObject;
   }
 
 
@@ -597,6 +706,13 @@ public:
   VTKM_CONT vtkm::cont::DeviceAdapterId GetDevice() const { return this->Device; }
   ///@}
 
+  /// Attach the arguments of the invocation to the given `Token` instead of a temporary one.
+  /// The arguments remain attached to `token` after `Invoke` returns, which blocks any
+  /// conflicting access to them until `token` is detached. This is used to launch worklets
+  /// asynchronously.
+  ///
+  VTKM_CONT void SetToken(vtkm::cont::Token& token) { this->ExternalToken = &token; }
+
   using ScatterType = typename WorkletType::ScatterType;
   using MaskType = typename WorkletType::MaskType;
 
@@ -714,6 +830,7 @@ private:
   void operator=(const MyType&) = delete;
 
   vtkm::cont::DeviceAdapterId Device;
+  vtkm::cont::Token* ExternalToken = nullptr;
 
   template <typename Invocation,
             typename InputRangeType,
@@ -726,9 +843,15 @@ private:
                                            ThreadRangeType&& threadRange,
                                            DeviceAdapter device) const
   {
+    // When profiling, time the transport and the execution of the worklet.
+    const bool profile = vtkm::cont::GetProfilingEnabled();
+    vtkm::Float64 startTime = profile ? vtkm::cont::detail::ProfilerTime() : 0;
+    detail::DispatcherBaseProfileBytes profileBytes;
+
     // This token represents the scope of the execution objects. It should
     // exist as long as things run on the device.
-    vtkm::cont::Token token;
+    vtkm::cont::Token localToken;
+    vtkm::cont::Token& token = (this->ExternalToken != nullptr) ? *this->ExternalToken : localToken;
 
     // The first step in invoking a worklet is to transport the arguments to
     // the execution environment. The invocation object passed to this function
@@ -749,8 +872,12 @@ private:
     using ExecObjectParameters =
       typename ParameterInterfaceType::template StaticTransformType<TransportFunctorType>::type;
 
-    ExecObjectParameters execObjectParameters = parameters.StaticTransformCont(
-      TransportFunctorType(invocation.GetInputDomain(), inputRange, outputRange, token));
+    ExecObjectParameters execObjectParameters =
+      parameters.StaticTransformCont(TransportFunctorType(invocation.GetInputDomain(),
+                                                          inputRange,
+                                                          outputRange,
+                                                          token,
+                                                          profile ? &profileBytes : nullptr));
 
     // Get the arrays used for scattering input to output.
     typename ScatterType::OutputToInputMapType outputToInputMap =
@@ -777,6 +904,21 @@ private:
                         threadToOutputMap.PrepareForInput(device, token));
 
     this->InvokeSchedule(changedInvocation, threadRange, device);
+
+    if (profile)
+    {
+      vtkm::cont::DeviceAdapterAlgorithm<DeviceAdapter>::Synchronize();
+      vtkm::cont::ProfilerLaunchRecord record;
+      record.WorkletName = vtkm::cont::TypeToString<WorkletType>();
+      record.Device = device;
+      record.DomainSize = detail::FlatRange(threadRange);
+      record.BytesRead = profileBytes.Read;
+      record.BytesWritten = profileBytes.Written;
+      record.StartTime = startTime;
+      record.ElapsedTime = vtkm::cont::detail::ProfilerTime() - startTime;
+      record.ThreadIndex = vtkm::cont::detail::ProfilerThreadIndex();
+      vtkm::cont::detail::ProfilerRecordLaunch(std::move(record));
+    }
   }
 
   template <typename Invocation, typename RangeType, typename DeviceAdapter>
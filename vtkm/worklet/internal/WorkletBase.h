@@ -44,10 +44,24 @@
 #include <vtkm/worklet/ScatterIdentity.h>
 #include <vtkm/worklet/internal/Placeholders.h>
 
+#include <type_traits>
+
 namespace vtkm
 {
 namespace worklet
 {
+
+/// \brief The number of consecutive instances a worklet is called on as a batch.
+///
+/// Worklets opt in to batched execution on the host devices by redefining their `BatchLanes`
+/// type to a `BatchWidth` larger than 1. See `WorkletBase::BatchLanes`.
+///
+template <vtkm::IdComponent Width>
+struct BatchWidth : std::integral_constant<vtkm::IdComponent, Width>
+{
+  VTKM_STATIC_ASSERT_MSG(Width > 0, "The batch width must be positive.");
+};
+
 namespace internal
 {
 
@@ -130,6 +144,15 @@ public:
   /// everything in the output domain.
   using MaskType = vtkm::worklet::MaskNone;
 
+  /// Worklets can define the number of consecutive instances they are called on as a batch on
+  /// the host devices (Serial, TBB, and OpenMP). When this is larger than 1 (for example
+  /// `using BatchLanes = vtkm::worklet::BatchWidth<8>;`), the worklet has the default scatter and
+  /// mask, and every argument of the `ExecutionSignature` is a field of a basic or SOA array,
+  /// the values of each batch are loaded together, the worklet is called on each lane in a loop
+  /// the compiler can vectorize, and the results are stored together. Other invocations run one
+  /// instance at a time. Worklets that hold no state and do simple arithmetic benefit most.
+  using BatchLanes = vtkm::worklet::BatchWidth<1>;
+
   /// \c ControlSignature tag for whole input arrays.
   ///
   /// The \c WholeArrayIn control signature tag specifies an \c ArrayHandle
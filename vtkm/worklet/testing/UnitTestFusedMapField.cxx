@@ -0,0 +1,226 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ErrorExecution.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/filter/field_transform/worklet/LogValues.h>
+#include <vtkm/filter/field_transform/worklet/PointElevation.h>
+#include <vtkm/filter/vector_analysis/worklet/Magnitude.h>
+#include <vtkm/worklet/FusedMapField.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+namespace
+{
+
+constexpr vtkm::Id ARRAY_SIZE = 1000;
+
+// Returns its result.
+struct Scale : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = _2(_1);
+
+  vtkm::FloatDefault Factor = 1;
+
+  template <typename T>
+  VTKM_EXEC T operator()(const T& value) const
+  {
+    return static_cast<T>(this->Factor * value);
+  }
+};
+
+// Writes its result to a fixed type output argument.
+struct ToVector : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = void(_1, _2);
+
+  template <typename T>
+  VTKM_EXEC void operator()(const T& value, vtkm::Vec3f& vector) const
+  {
+    vector = vtkm::Vec3f(static_cast<vtkm::FloatDefault>(value), 1, 2);
+  }
+};
+
+// Writes its result to a non-template output argument of another type than its input.
+struct ToFloat32 : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_EXEC void operator()(const vtkm::Float64& value, vtkm::Float32& result) const
+  {
+    result = static_cast<vtkm::Float32>(value);
+  }
+};
+
+struct VectorLength : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = void(_1, _2);
+
+  VTKM_EXEC void operator()(const vtkm::Vec3f& vector, vtkm::FloatDefault& length) const
+  {
+    length = vtkm::Magnitude(vector);
+  }
+};
+
+// Returns the size of the type of its input.
+struct InputSize : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = _2(_1);
+
+  template <typename T>
+  VTKM_EXEC vtkm::IdComponent operator()(const T&) const
+  {
+    return static_cast<vtkm::IdComponent>(sizeof(T));
+  }
+};
+
+struct CheckPositive : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = _2(_1);
+
+  VTKM_EXEC vtkm::Vec3f operator()(const vtkm::Vec3f& value) const
+  {
+    if (value[0] < 0)
+    {
+      this->RaiseError("Expected error.");
+    }
+    return value;
+  }
+};
+
+vtkm::cont::ArrayHandle<vtkm::Vec3f> MakePoints()
+{
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points;
+  points.Allocate(ARRAY_SIZE);
+  auto portal = points.WritePortal();
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    portal.Set(index, TestValue(index, vtkm::Vec3f{}));
+  }
+  return points;
+}
+
+void TestFusedChain()
+{
+  std::cout << "Testing fused chain against separate invocations" << std::endl;
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points = MakePoints();
+
+  vtkm::worklet::PointElevation elevation({ 0, 0, 0 }, { 0, 0, 1 }, 1, 100);
+  vtkm::worklet::detail::LogFunWorklet<vtkm::Log> logValues{ 0.001f };
+  Scale scale;
+  scale.Factor = 3;
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> elevationArray;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> logArray;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> vectorArray;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> scaledArray;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> expected;
+  invoke(elevation, points, elevationArray);
+  invoke(logValues, elevationArray, logArray);
+  invoke(ToVector{}, logArray, vectorArray);
+  invoke(scale, vectorArray, scaledArray);
+  invoke(vtkm::worklet::Magnitude{}, scaledArray, expected);
+
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> fused;
+  invoke(vtkm::worklet::make_FusedMapField(
+           elevation,
+           vtkm::worklet::make_FusedStage<vtkm::FloatDefault>(logValues),
+           vtkm::worklet::make_FusedStage<vtkm::Vec3f>(ToVector{}),
+           scale,
+           vtkm::worklet::Magnitude{}),
+         points,
+         fused);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(fused, expected), "Wrong result for fused chain");
+
+  // A single stage gives the same result as the worklet itself.
+  vtkm::cont::ArrayHandle<vtkm::Float64> singleStage;
+  invoke(vtkm::worklet::make_FusedMapField(elevation), points, singleStage);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(singleStage, elevationArray),
+                   "Wrong result for single stage");
+}
+
+void TestFusedTypeChange()
+{
+  std::cout << "Testing stages changing the type of the value" << std::endl;
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points = MakePoints();
+
+  // The output type of stages writing to an output argument comes from their operator().
+  vtkm::worklet::PointElevation elevation({ 0, 0, 0 }, { 0, 0, 1 }, 1, 100);
+  vtkm::cont::ArrayHandle<vtkm::IdComponent> sizes;
+  invoke(vtkm::worklet::make_FusedMapField(elevation, ToFloat32{}, InputSize{}), points, sizes);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(
+                     sizes, vtkm::cont::make_ArrayHandleConstant<vtkm::IdComponent>(4, ARRAY_SIZE)),
+                   "Value after Float64 to Float32 stage has the wrong type");
+  invoke(vtkm::worklet::make_FusedMapField(VectorLength{}, InputSize{}), points, sizes);
+  VTKM_TEST_ASSERT(
+    test_equal_ArrayHandles(sizes,
+                            vtkm::cont::make_ArrayHandleConstant<vtkm::IdComponent>(
+                              static_cast<vtkm::IdComponent>(sizeof(vtkm::FloatDefault)),
+                              ARRAY_SIZE)),
+    "Value after vector to scalar stage has the wrong type");
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> elevationArray;
+  vtkm::cont::ArrayHandle<vtkm::Float32> narrowed;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> expected;
+  invoke(elevation, points, elevationArray);
+  invoke(ToFloat32{}, elevationArray, narrowed);
+  invoke(ToVector{}, narrowed, expected);
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> fused;
+  invoke(vtkm::worklet::make_FusedMapField(elevation, ToFloat32{}, ToVector{}), points, fused);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(fused, expected),
+                   "Wrong result for type changing chain");
+}
+
+void TestFusedError()
+{
+  std::cout << "Testing errors raised by fused stages" << std::endl;
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f> points = MakePoints();
+
+  Scale negate;
+  negate.Factor = -1;
+  vtkm::cont::ArrayHandle<vtkm::FloatDefault> result;
+  try
+  {
+    invoke(vtkm::worklet::make_FusedMapField(negate, CheckPositive{}, vtkm::worklet::Magnitude{}),
+           points,
+           result);
+    VTKM_TEST_FAIL("Error in fused stage was not reported.");
+  }
+  catch (vtkm::cont::ErrorExecution&)
+  {
+    std::cout << "Caught expected error." << std::endl;
+  }
+}
+
+void Run()
+{
+  TestFusedChain();
+  TestFusedTypeChange();
+  TestFusedError();
+}
+
+} // anonymous namespace
+
+int UnitTestFusedMapField(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
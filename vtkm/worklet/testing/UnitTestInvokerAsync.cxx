@@ -0,0 +1,240 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ErrorBadValue.h>
+#include <vtkm/cont/ErrorExecution.h>
+#include <vtkm/cont/Invoker.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+#include <future>
+#include <vector>
+
+namespace
+{
+
+constexpr vtkm::Id ARRAY_SIZE = 100000;
+
+struct Double : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldInOut);
+
+  VTKM_EXEC void operator()(vtkm::Id& value) const { value = 2 * value; }
+};
+
+struct Increment : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldInOut);
+
+  VTKM_EXEC void operator()(vtkm::Id& value) const { value = value + 1; }
+};
+
+struct Add : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldIn, FieldOut);
+
+  VTKM_EXEC void operator()(vtkm::Id a, vtkm::Id b, vtkm::Id& sum) const { sum = a + b; }
+};
+
+struct Fail : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldInOut);
+
+  VTKM_EXEC void operator()(vtkm::Id& value) const
+  {
+    if (value == 10)
+    {
+      this->RaiseError("Expected error.");
+    }
+  }
+};
+
+vtkm::Id Expected(vtkm::Id index, vtkm::IdComponent numSteps)
+{
+  vtkm::Id value = index;
+  for (vtkm::IdComponent step = 0; step < numSteps; ++step)
+  {
+    value = (step % 2 == 0) ? 2 * value : value + 1;
+  }
+  return value;
+}
+
+void TestOrderedLaunches()
+{
+  std::cout << "Testing that dependent launches run in order" << std::endl;
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> array;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), array);
+
+  // Doubling and incrementing do not commute, so the result is only right if the launches
+  // modify the array in the order they were made.
+  constexpr vtkm::IdComponent numSteps = 8;
+  std::vector<std::future<void>> launches;
+  for (vtkm::IdComponent step = 0; step < numSteps; ++step)
+  {
+    if (step % 2 == 0)
+    {
+      launches.push_back(invoke.Async(Double{}, array));
+    }
+    else
+    {
+      launches.push_back(invoke.Async(Increment{}, array));
+    }
+  }
+
+  // Reading the array waits for the launches writing it without waiting on the futures.
+  auto portal = array.ReadPortal();
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    VTKM_TEST_ASSERT(portal.Get(index) == Expected(index, numSteps), "Bad value at ", index);
+  }
+
+  for (auto& launch : launches)
+  {
+    launch.get();
+  }
+}
+
+void TestIndependentLaunches()
+{
+  std::cout << "Testing independent launches" << std::endl;
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> a;
+  vtkm::cont::ArrayHandle<vtkm::Id> b;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), a);
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), b);
+
+  // The first two launches touch different arrays and can run at the same time. The last one
+  // reads both and has to wait for them.
+  std::future<void> doubleA = invoke.Async(Double{}, a);
+  std::future<void> incrementB = invoke.Async(Increment{}, b);
+  vtkm::cont::ArrayHandle<vtkm::Id> sum;
+  std::future<void> addAB = invoke.Async(Add{}, a, b, sum);
+
+  addAB.get();
+  doubleA.get();
+  incrementB.get();
+
+  auto portal = sum.ReadPortal();
+  VTKM_TEST_ASSERT(portal.GetNumberOfValues() == ARRAY_SIZE);
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    VTKM_TEST_ASSERT(portal.Get(index) == 3 * index + 1, "Bad value at ", index);
+  }
+}
+
+void TestFailedLaunch()
+{
+  std::cout << "Testing errors in asynchronous launches" << std::endl;
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> array;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), array);
+
+  std::future<void> failed = invoke.Async(Fail{}, array);
+  std::future<void> next = invoke.Async(Increment{}, array);
+  try
+  {
+    failed.get();
+    VTKM_TEST_FAIL("Error in asynchronous launch was not reported.");
+  }
+  catch (vtkm::cont::ErrorExecution&)
+  {
+    std::cout << "Caught expected error." << std::endl;
+  }
+
+  // The array must still be usable by the following launches and the calling thread.
+  next.get();
+  auto portal = array.ReadPortal();
+  VTKM_TEST_ASSERT(portal.Get(ARRAY_SIZE - 1) == ARRAY_SIZE);
+}
+
+void TestLaunchFailingBeforeAccess()
+{
+  std::cout << "Testing asynchronous launches failing before using their arrays" << std::endl;
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> a;
+  vtkm::cont::ArrayHandle<vtkm::Id> b;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), a);
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(ARRAY_SIZE / 2), b);
+
+  // The size of b is checked before b and sum are used, so the launch never gets access to them.
+  vtkm::cont::ArrayHandle<vtkm::Id> sum;
+  std::future<void> failed = invoke.Async(Add{}, a, b, sum);
+  try
+  {
+    failed.get();
+    VTKM_TEST_FAIL("Error in asynchronous launch was not reported.");
+  }
+  catch (vtkm::cont::ErrorBadValue&)
+  {
+    std::cout << "Caught expected error." << std::endl;
+  }
+
+  // The failed launch must not keep its place in the queues of the arrays.
+  VTKM_TEST_ASSERT(b.ReadPortal().Get(1) == 1);
+  sum.Allocate(1);
+  sum.WritePortal().Set(0, 1);
+  invoke.Async(Increment{}, b).get();
+  VTKM_TEST_ASSERT(b.ReadPortal().Get(1) == 2);
+}
+
+void TestManyLaunches()
+{
+  std::cout << "Testing more launches than the queue holds" << std::endl;
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> array;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(1000), array);
+
+  // Async blocks once the queue is full instead of starting a thread per launch, and the
+  // launches keep their order.
+  const vtkm::IdComponent numLaunches =
+    3 * vtkm::cont::internal::AsyncInvokeQueue::GetMaximumPendingLaunches();
+  std::vector<std::future<void>> launches;
+  for (vtkm::IdComponent launch = 0; launch < numLaunches; ++launch)
+  {
+    launches.push_back(invoke.Async(Increment{}, array));
+  }
+  for (auto& launch : launches)
+  {
+    launch.get();
+  }
+
+  auto portal = array.ReadPortal();
+  for (vtkm::Id index = 0; index < portal.GetNumberOfValues(); ++index)
+  {
+    VTKM_TEST_ASSERT(portal.Get(index) == index + numLaunches, "Bad value at ", index);
+  }
+}
+
+void Run()
+{
+  TestOrderedLaunches();
+  TestIndependentLaunches();
+  TestFailedLaunch();
+  TestLaunchFailingBeforeAccess();
+  TestManyLaunches();
+}
+
+} // anonymous namespace
+
+int UnitTestInvokerAsync(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::Run(Run, argc, argv);
+}
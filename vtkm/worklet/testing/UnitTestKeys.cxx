@@ -71,6 +71,29 @@ void TryKeyType(KeyType)
                  keys.GetSortedValuesMap().ReadPortal(),
                  keys.GetOffsets().ReadPortal(),
                  keys.GetCounts().ReadPortal());
+
+  vtkm::worklet::Keys<KeyType> hashedKeys;
+  hashedKeys.BuildArrays(keyArray, vtkm::worklet::KeysSortType::Hashed);
+  VTKM_TEST_ASSERT(hashedKeys.GetInputRange() == NUM_UNIQUE, "Keys has bad input range.");
+
+  CheckKeyReduce(keyArray.ReadPortal(),
+                 hashedKeys.GetUniqueKeys().ReadPortal(),
+                 hashedKeys.GetSortedValuesMap().ReadPortal(),
+                 hashedKeys.GetOffsets().ReadPortal(),
+                 hashedKeys.GetCounts().ReadPortal());
+
+  // Hashed keys come out in the order of their first occurrence.
+  auto uniquePortal = hashedKeys.GetUniqueKeys().ReadPortal();
+  for (vtkm::Id uniqueIndex = 0; uniqueIndex < NUM_UNIQUE; uniqueIndex++)
+  {
+    VTKM_TEST_ASSERT(uniquePortal.Get(uniqueIndex) == keyBuffer[uniqueIndex],
+                     "Hashed keys not in order of first occurrence.");
+  }
+
+  vtkm::cont::ArrayHandle<KeyType> emptyKeys;
+  hashedKeys.BuildArrays(emptyKeys, vtkm::worklet::KeysSortType::Hashed);
+  VTKM_TEST_ASSERT(hashedKeys.GetInputRange() == 0, "Keys has bad input range.");
+  VTKM_TEST_ASSERT(hashedKeys.GetOffsets().GetNumberOfValues() == 1, "Bad offsets.");
 }
 
 void TestKeys()
@@ -0,0 +1,237 @@
+//============================================================================
+//  Copyright (c) Kitware, Inc.
+//  All rights reserved.
+//  See LICENSE.txt for details.
+//
+//  This software is distributed WITHOUT ANY WARRANTY; without even
+//  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+//  PURPOSE.  See the above copyright notice for more information.
+//============================================================================
+
+#include <vtkm/cont/ArrayCopy.h>
+#include <vtkm/cont/ArrayHandle.h>
+#include <vtkm/cont/ArrayHandleConstant.h>
+#include <vtkm/cont/ArrayHandleCounting.h>
+#include <vtkm/cont/ArrayHandleIndex.h>
+#include <vtkm/cont/ArrayHandleSOA.h>
+#include <vtkm/cont/ErrorExecution.h>
+#include <vtkm/cont/Invoker.h>
+#include <vtkm/cont/RuntimeDeviceTracker.h>
+
+#include <vtkm/worklet/WorkletMapField.h>
+
+#include <vtkm/cont/testing/Testing.h>
+
+namespace
+{
+
+// Not a multiple of the batch width so that the remainder is also done.
+constexpr vtkm::Id ARRAY_SIZE = 1003;
+
+template <vtkm::IdComponent Width>
+struct ScaleAndOffset : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = _2(_1);
+  using BatchLanes = vtkm::worklet::BatchWidth<Width>;
+
+  VTKM_EXEC vtkm::Float64 operator()(const vtkm::Vec3f_64& value) const
+  {
+    return 2 * vtkm::Dot(value, value) + 1;
+  }
+};
+
+template <vtkm::IdComponent Width>
+struct AccumulateLength : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldIn, FieldInOut);
+  using ExecutionSignature = void(_1, _2, _3);
+  using BatchLanes = vtkm::worklet::BatchWidth<Width>;
+
+  VTKM_EXEC void operator()(const vtkm::Vec3f_64& a,
+                            const vtkm::Vec3f_64& b,
+                            vtkm::Float64& accumulator) const
+  {
+    accumulator += vtkm::Magnitude(a - b);
+  }
+};
+
+// The lanes of a batch are all called before any of their results is stored. An instance that
+// sees the result of the instance before it still unset was called as part of a batch.
+struct FlagBatchedLanes : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldInOut);
+  using ExecutionSignature = void(_1, _2);
+  using BatchLanes = vtkm::worklet::BatchWidth<4>;
+
+  // The memory of the FieldInOut array.
+  const vtkm::Id* Flags = nullptr;
+
+  VTKM_EXEC void operator()(vtkm::Id index, vtkm::Id& flag) const
+  {
+    flag = ((index > 0) && (this->Flags[index - 1] == 0)) ? 1 : 2;
+  }
+};
+
+// Uses the work index, which cannot be batched.
+struct AddIndex : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = void(_1, _2, WorkIndex);
+  using BatchLanes = vtkm::worklet::BatchWidth<8>;
+
+  VTKM_EXEC void operator()(vtkm::Float64 value, vtkm::Float64& result, vtkm::Id index) const
+  {
+    result = value + static_cast<vtkm::Float64>(index);
+  }
+};
+
+struct CheckPositive : vtkm::worklet::WorkletMapField
+{
+  using ControlSignature = void(FieldIn, FieldOut);
+  using ExecutionSignature = _2(_1);
+  using BatchLanes = vtkm::worklet::BatchWidth<8>;
+
+  VTKM_EXEC vtkm::Float64 operator()(vtkm::Float64 value) const
+  {
+    if (value < 0)
+    {
+      this->RaiseError("Expected error.");
+    }
+    return value;
+  }
+};
+
+vtkm::cont::ArrayHandle<vtkm::Vec3f_64> MakeVectors()
+{
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> vectors;
+  vectors.Allocate(ARRAY_SIZE);
+  SetPortal(vectors.WritePortal());
+  return vectors;
+}
+
+void TestBasicArrays()
+{
+  std::cout << "Testing batches of basic arrays" << std::endl;
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> vectors = MakeVectors();
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> expected;
+  invoke(ScaleAndOffset<1>{}, vectors, expected);
+  auto expectedPortal = expected.ReadPortal();
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    vtkm::Vec3f_64 value = TestValue(index, vtkm::Vec3f_64{});
+    VTKM_TEST_ASSERT(test_equal(expectedPortal.Get(index), 2 * vtkm::Dot(value, value) + 1));
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> batched;
+  invoke(ScaleAndOffset<8>{}, vectors, batched);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(batched, expected), "Wrong result with 8 lanes");
+  invoke(ScaleAndOffset<5>{}, vectors, batched);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(batched, expected), "Wrong result with 5 lanes");
+}
+
+void TestSOAArrays()
+{
+  std::cout << "Testing batches of SOA and in-place arrays" << std::endl;
+  vtkm::cont::Invoker invoke;
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> vectors = MakeVectors();
+  vtkm::cont::ArrayHandleSOA<vtkm::Vec3f_64> soaVectors;
+  vtkm::cont::ArrayCopy(vectors, soaVectors);
+  vtkm::cont::ArrayHandle<vtkm::Vec3f_64> offsets;
+  vtkm::cont::ArrayCopy(vtkm::cont::make_ArrayHandleConstant(vtkm::Vec3f_64(1, 2, 3), ARRAY_SIZE),
+                        offsets);
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> expected;
+  vtkm::cont::ArrayHandle<vtkm::Float64> batched;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleCounting<vtkm::Float64>(0, 1, ARRAY_SIZE),
+                        expected);
+  vtkm::cont::ArrayCopy(expected, batched);
+  invoke(AccumulateLength<1>{}, vectors, offsets, expected);
+  invoke(AccumulateLength<4>{}, soaVectors, offsets, batched);
+  VTKM_TEST_ASSERT(test_equal_ArrayHandles(batched, expected), "Wrong result for SOA arrays");
+}
+
+void TestBatchedPath()
+{
+  std::cout << "Testing that worklets are called on whole batches" << std::endl;
+  // The serial device runs all the values in one tile, so the batches start at 0.
+  vtkm::cont::ScopedRuntimeDeviceTracker tracker(vtkm::cont::DeviceAdapterTagSerial{});
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::Id> indices;
+  vtkm::cont::ArrayCopy(vtkm::cont::ArrayHandleIndex(ARRAY_SIZE), indices);
+  vtkm::cont::ArrayHandleBasic<vtkm::Id> flags;
+  flags.AllocateAndFill(ARRAY_SIZE, 0);
+
+  FlagBatchedLanes worklet;
+  worklet.Flags = flags.GetReadPointer();
+  invoke(worklet, indices, flags);
+
+  constexpr vtkm::Id width = FlagBatchedLanes::BatchLanes::value;
+  auto portal = flags.ReadPortal();
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    const bool inBatch = (index < (ARRAY_SIZE / width) * width) && ((index % width) != 0);
+    VTKM_TEST_ASSERT(portal.Get(index) == (inBatch ? 1 : 2),
+                     "Instance ",
+                     index,
+                     (inBatch ? " was not called as part of a batch."
+                              : " was not called after the previous batch was stored."));
+  }
+}
+
+void TestFallback()
+{
+  std::cout << "Testing worklets and arrays that cannot be batched" << std::endl;
+  vtkm::cont::Invoker invoke;
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> result;
+  invoke(AddIndex{}, vtkm::cont::ArrayHandleCounting<vtkm::Float64>(1, 2, ARRAY_SIZE), result);
+  auto portal = result.ReadPortal();
+  for (vtkm::Id index = 0; index < ARRAY_SIZE; ++index)
+  {
+    VTKM_TEST_ASSERT(test_equal(portal.Get(index), 3 * index + 1));
+  }
+
+  vtkm::cont::ArrayHandleCounting<vtkm::Float64> negative(10, -1, ARRAY_SIZE);
+  try
+  {
+    invoke(CheckPositive{}, negative, result);
+    VTKM_TEST_FAIL("Error in implicit array was not reported.");
+  }
+  catch (vtkm::cont::ErrorExecution&)
+  {
+    std::cout << "Caught expected error." << std::endl;
+  }
+
+  vtkm::cont::ArrayHandle<vtkm::Float64> basicNegative;
+  vtkm::cont::ArrayCopy(negative, basicNegative);
+  try
+  {
+    invoke(CheckPositive{}, basicNegative, result);
+    VTKM_TEST_FAIL("Error in batch was not reported.");
+  }
+  catch (vtkm::cont::ErrorExecution&)
+  {
+    std::cout << "Caught expected error." << std::endl;
+  }
+}
+
+void TestWorkletMapFieldBatched(vtkm::cont::DeviceAdapterId id)
+{
+  std::cout << "Testing batched map field worklets on device adapter: " << id.GetName()
+            << std::endl;
+  TestBasicArrays();
+  TestSOAArrays();
+  TestBatchedPath();
+  TestFallback();
+}
+
+} // anonymous namespace
+
+int UnitTestWorkletMapFieldBatched(int argc, char* argv[])
+{
+  return vtkm::cont::testing::Testing::RunOnDevice(TestWorkletMapFieldBatched, argc, argv);
+}